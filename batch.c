@@ -0,0 +1,425 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include "restool.h"
+#include "batch.h"
+#include "utils.h"
+
+/**
+ * Maximum number of arguments of a batch line, and of variables of a batch
+ */
+#define BATCH_MAX_ARGS		64
+#define BATCH_MAX_VARS		256
+
+/**
+ * Maximum length of variable names and values (without including the null
+ * terminator)
+ */
+#define BATCH_VAR_NAME_MAX_LEN	31
+#define BATCH_VAR_VALUE_MAX_LEN	63
+
+struct batch_var {
+	char name[BATCH_VAR_NAME_MAX_LEN + 1];
+	char value[BATCH_VAR_VALUE_MAX_LEN + 1];
+};
+
+/**
+ * struct batch - state of a batch run, kept across its lines
+ */
+struct batch {
+	const char *source;
+	int line_num;
+	struct batch_var vars[BATCH_MAX_VARS];
+	int num_vars;
+
+	/**
+	 * global options given with --batch, restored before each line
+	 */
+	bool debug;
+	bool script;
+};
+
+static bool is_var_char(char c, bool first)
+{
+	return isalpha((unsigned char)c) || c == '_' ||
+	       (!first && isdigit((unsigned char)c));
+}
+
+static struct batch_var *find_var(struct batch *batch, const char *name,
+				  size_t name_len)
+{
+	for (int i = 0; i < batch->num_vars; i++) {
+		if (strlen(batch->vars[i].name) == name_len &&
+		    strncmp(batch->vars[i].name, name, name_len) == 0)
+			return &batch->vars[i];
+	}
+
+	return NULL;
+}
+
+static int set_var(struct batch *batch, const char *name,
+		   const char *value)
+{
+	struct batch_var *var = find_var(batch, name, strlen(name));
+
+	if (strlen(value) > BATCH_VAR_VALUE_MAX_LEN) {
+		ERROR_PRINTF("%s:%d: value too long for $%s\n",
+			     batch->source, batch->line_num, name);
+		return -E2BIG;
+	}
+
+	if (var == NULL) {
+		if (batch->num_vars == BATCH_MAX_VARS) {
+			ERROR_PRINTF("%s:%d: too many variables (max %d)\n",
+				     batch->source, batch->line_num,
+				     BATCH_MAX_VARS);
+			return -E2BIG;
+		}
+
+		var = &batch->vars[batch->num_vars++];
+		strcpy(var->name, name);
+	}
+
+	strcpy(var->value, value);
+	return 0;
+}
+
+/**
+ * Split batch line 'line' into arguments, in place, expanding $name and
+ * ${name} variable references outside of single quotes. Arguments may be
+ * quoted with single or double quotes.
+ */
+static int split_line(struct batch *batch, char *line, char *buf,
+		      size_t buf_size, char *argv[], int *argc)
+{
+	char *in = line;
+	char *out = buf;
+	char *buf_end = buf + buf_size - 1;
+
+	*argc = 0;
+	for (;;) {
+		char quote = '\0';
+
+		while (isspace((unsigned char)*in))
+			in++;
+
+		if (*in == '\0')
+			break;
+
+		if (*argc == BATCH_MAX_ARGS) {
+			ERROR_PRINTF("%s:%d: too many arguments (max %d)\n",
+				     batch->source, batch->line_num,
+				     BATCH_MAX_ARGS);
+			return -E2BIG;
+		}
+
+		argv[(*argc)++] = out;
+		while (*in != '\0' &&
+		       (quote != '\0' || !isspace((unsigned char)*in))) {
+			const char *value = NULL;
+
+			if (quote == '\0' && (*in == '\'' || *in == '"')) {
+				quote = *in++;
+				continue;
+			}
+
+			if (quote != '\0' && *in == quote) {
+				quote = '\0';
+				in++;
+				continue;
+			}
+
+			if (*in == '$' && quote != '\'') {
+				bool braces = in[1] == '{';
+				const char *name = in + 1 + braces;
+				size_t len = 0;
+				struct batch_var *var;
+
+				while (is_var_char(name[len], len == 0))
+					len++;
+
+				if (len == 0 || (braces && name[len] != '}')) {
+					ERROR_PRINTF("%s:%d: invalid variable reference\n",
+						     batch->source,
+						     batch->line_num);
+					return -EINVAL;
+				}
+
+				var = find_var(batch, name, len);
+				if (var == NULL) {
+					ERROR_PRINTF("%s:%d: undefined variable $%.*s\n",
+						     batch->source,
+						     batch->line_num,
+						     (int)len, name);
+					return -EINVAL;
+				}
+
+				value = var->value;
+				in = (char *)name + len + braces;
+			}
+
+			do {
+				if (out == buf_end) {
+					ERROR_PRINTF("%s:%d: line too long\n",
+						     batch->source,
+						     batch->line_num);
+					return -E2BIG;
+				}
+
+				*out++ = value != NULL ? *value++ : *in++;
+			} while (value != NULL && *value != '\0');
+		}
+
+		if (quote != '\0') {
+			ERROR_PRINTF("%s:%d: unterminated %c quote\n",
+				     batch->source, batch->line_num, quote);
+			return -EINVAL;
+		}
+
+		*out++ = '\0';
+	}
+
+	return 0;
+}
+
+/**
+ * struct batch_capture - results of a command captured for a variable
+ */
+struct batch_capture {
+	char value[BATCH_VAR_VALUE_MAX_LEN + 2];
+	size_t len;
+
+	/**
+	 * output function of the batch, errors are passed on to
+	 */
+	restool_output_fn_t *output;
+	void *output_arg;
+};
+
+static void capture_output(void *arg, enum restool_output_stream stream,
+			   const char *text, size_t len)
+{
+	struct batch_capture *capture = arg;
+	size_t room = sizeof(capture->value) - 1 - capture->len;
+
+	if (stream != RESTOOL_OUTPUT_RESULT) {
+		capture->output(capture->output_arg, stream, text, len);
+		return;
+	}
+
+	if (len > room)
+		len = room;
+
+	memcpy(&capture->value[capture->len], text, len);
+	capture->len += len;
+	capture->value[capture->len] = '\0';
+}
+
+/**
+ * Run an object command with its output captured, the way --script
+ * prints it, and store the first line of the output in variable 'name'
+ */
+static int run_captured(struct batch *batch, const char *name, int argc,
+			char *argv[])
+{
+	struct batch_capture capture = {
+		.output = restool.output,
+		.output_arg = restool.output_arg,
+	};
+	int error;
+
+	restool_cmd.output = capture_output;
+	restool_cmd.output_arg = &capture;
+	restool_cmd.script = true;
+	error = run_obj_command(argc, argv);
+	restool_cmd.output = NULL;
+	restool_cmd.output_arg = NULL;
+	if (error < 0)
+		return error;
+
+	capture.value[strcspn(capture.value, "\r\n")] = '\0';
+	if (capture.value[0] == '\0') {
+		ERROR_PRINTF("%s:%d: no output to store in $%s\n",
+			     batch->source, batch->line_num, name);
+		return -ENODATA;
+	}
+
+	return set_var(batch, name, capture.value);
+}
+
+/**
+ * Run one batch line:
+ *	[<name>=]<object-type> <command> [ARGS...]
+ *	echo [ARGS...]
+ * With the <name>= prefix, the object command runs as with --script and
+ * its output (e.g. the name of the object it created) is stored in
+ * variable <name> instead of being printed.
+ */
+static int run_line(struct batch *batch, char *line)
+{
+	char buf[4096];
+	char *argv[BATCH_MAX_ARGS + 1];
+	char *name = NULL;
+	char *cmd = line;
+	int argc;
+	int error;
+
+	while (isspace((unsigned char)*cmd))
+		cmd++;
+
+	if (is_var_char(*cmd, true)) {
+		char *end = cmd;
+
+		while (is_var_char(*end, false))
+			end++;
+
+		if (*end == '=') {
+			if (end - cmd > BATCH_VAR_NAME_MAX_LEN) {
+				ERROR_PRINTF("%s:%d: variable name too long\n",
+					     batch->source, batch->line_num);
+				return -EINVAL;
+			}
+
+			*end = '\0';
+			name = cmd;
+			cmd = end + 1;
+		}
+	}
+
+	error = split_line(batch, cmd, buf, sizeof(buf), argv, &argc);
+	if (error < 0)
+		return error;
+
+	argv[argc] = NULL;
+	restool.debug = batch->debug;
+	restool_cmd.script = batch->script;
+	if (argc > 0 && strcmp(argv[0], "echo") == 0 && name == NULL) {
+		for (int i = 1; i < argc; i++)
+			restool_printf("%s%s", argv[i],
+				       i + 1 < argc ? " " : "");
+
+		restool_printf("\n");
+		return 0;
+	}
+
+	if (name != NULL)
+		return run_captured(batch, name, argc, argv);
+
+	return run_obj_command(argc, argv);
+}
+
+static int run_batch_file(const char *path)
+{
+	struct batch *batch;
+	char *line = NULL;
+	size_t line_size = 0;
+	FILE *file;
+	int error = 0;
+
+	if (strcmp(path, "-") == 0) {
+		file = stdin;
+	} else {
+		file = fopen(path, "r");
+		if (file == NULL) {
+			error = -errno;
+			ERROR_PRINTF("Opening batch file %s failed (error %d)\n",
+				     path, error);
+			return error;
+		}
+	}
+
+	batch = calloc(1, sizeof(*batch));
+	if (batch == NULL) {
+		ERROR_PRINTF("calloc() failed\n");
+		error = -ENOMEM;
+		goto out;
+	}
+
+	batch->source = file == stdin ? "stdin" : path;
+	batch->debug = restool.debug;
+	batch->script = restool.script;
+	while (getline(&line, &line_size, file) != -1) {
+		char *cmd = line;
+
+		batch->line_num++;
+		line[strcspn(line, "\r\n")] = '\0';
+		while (isspace((unsigned char)*cmd))
+			cmd++;
+
+		if (*cmd == '\0' || *cmd == '#')
+			continue;
+
+		error = run_line(batch, cmd);
+
+		/*
+		 * Command output first, then its status
+		 */
+		fflush(stdout);
+		if (error < 0)
+			restool_eprintf("%s:%d: error %d\n", batch->source,
+					batch->line_num, error);
+		else if (!batch->script)
+			restool_eprintf("%s:%d: ok\n", batch->source,
+					batch->line_num);
+
+		if (error < 0)
+			break;
+	}
+
+	restool.debug = batch->debug;
+	restool_cmd.script = batch->script;
+out:
+	free(line);
+	free(batch);
+	if (file != stdin)
+		fclose(file);
+
+	return error;
+}
+
+/**
+ * Run the object commands of batch file 'path' ("-" for stdin), one per
+ * line, in context 'ctx', stopping at the first one that fails. The status
+ * of each line is reported to stderr; with --script, only failures are.
+ */
+int run_batch(struct restool_ctx *ctx, const char *path)
+{
+	struct restool_ctx *prev_ctx;
+	int error;
+
+	prev_ctx = restool_ctx_switch(ctx);
+	error = run_batch_file(path);
+	(void)restool_ctx_switch(prev_ctx);
+	return error;
+}
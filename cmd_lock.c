@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Open file description locks, which unlike POSIX record locks are owned
+ * by the open lock file rather than by the process, so that threads of
+ * one process running commands exclude each other as well
+ */
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "cmd_lock.h"
+#include "utils.h"
+
+/**
+ * Initialize 'lock', not held yet, on the whole container tree
+ */
+void cmd_lock_init(struct cmd_lock *lock, bool exclusive)
+{
+	memset(lock, 0, sizeof(*lock));
+	lock->fd = -1;
+	lock->exclusive = exclusive;
+}
+
+/**
+ * Scope 'lock' to container dprc.<dprc_id>, in addition to the containers
+ * it is already scoped to
+ */
+void cmd_lock_add_container(struct cmd_lock *lock, uint32_t dprc_id)
+{
+	int i;
+
+	for (i = 0; i < lock->num_containers; i++) {
+		if (lock->containers[i] == dprc_id)
+			return;
+
+		if (lock->containers[i] > dprc_id)
+			break;
+	}
+
+	if (lock->num_containers == CMD_LOCK_MAX_CONTAINERS) {
+		lock->too_many_containers = true;
+		return;
+	}
+
+	memmove(&lock->containers[i + 1], &lock->containers[i],
+		(lock->num_containers - i) * sizeof(lock->containers[0]));
+	lock->containers[i] = dprc_id;
+	lock->num_containers++;
+}
+
+/**
+ * Lock bytes [start, start + len) of the lock file, or the whole file if
+ * 'len' is 0, waiting for the processes holding conflicting locks
+ */
+static int lock_range(struct cmd_lock *lock, off_t start, off_t len)
+{
+	struct flock fl = {
+		.l_type = lock->exclusive ? F_WRLCK : F_RDLCK,
+		.l_whence = SEEK_SET,
+		.l_start = start,
+		.l_len = len,
+	};
+
+	if (fcntl(lock->fd, F_OFD_SETLK, &fl) == 0)
+		return 0;
+
+	if (errno != EAGAIN && errno != EACCES)
+		return -errno;
+
+	DEBUG_PRINTF("Waiting for %s lock on %s\n",
+		     lock->exclusive ? "exclusive" : "shared",
+		     len == 0 ? "container tree" : "container");
+
+	if (fcntl(lock->fd, F_OFD_SETLKW, &fl) == -1)
+		return -errno;
+
+	return 0;
+}
+
+/**
+ * Open lock file 'path', creating it and its directory if needed, and
+ * take 'lock' on it. Locks are taken in increasing container id order, so
+ * that commands locking several containers cannot deadlock.
+ */
+int cmd_lock_acquire(struct cmd_lock *lock, const char *path)
+{
+	char dir_path[PATH_MAX];
+	char *slash;
+	int error = 0;
+
+	if (snprintf(dir_path, sizeof(dir_path), "%s", path) >=
+	    (int)sizeof(dir_path))
+		return -ENAMETOOLONG;
+
+	slash = strrchr(dir_path, '/');
+	if (slash != NULL && slash != dir_path) {
+		*slash = '\0';
+		if (mkdir(dir_path, 0755) == -1 && errno != EEXIST)
+			return -errno;
+	}
+
+	lock->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (lock->fd == -1 && errno == EACCES && !lock->exclusive)
+		lock->fd = open(path, O_RDONLY | O_CLOEXEC);
+
+	if (lock->fd == -1)
+		return -errno;
+
+	if (lock->num_containers == 0 || lock->too_many_containers) {
+		error = lock_range(lock, 0, 0);
+	} else {
+		for (int i = 0; i < lock->num_containers; i++) {
+			error = lock_range(lock, lock->containers[i], 1);
+			if (error < 0)
+				break;
+		}
+	}
+
+	if (error < 0)
+		cmd_lock_release(lock);
+
+	return error;
+}
+
+void cmd_lock_release(struct cmd_lock *lock)
+{
+	if (lock->fd == -1)
+		return;
+
+	(void)close(lock->fd);
+	lock->fd = -1;
+}
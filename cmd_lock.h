@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _CMD_LOCK_H
+#define _CMD_LOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Maximum number of containers a command lock can be scoped to; a command
+ * naming more containers locks the whole container tree
+ */
+#define CMD_LOCK_MAX_CONTAINERS	8
+
+/**
+ * struct cmd_lock - reader/writer lock held by a restool command, shared
+ * with the other restool processes through a lock file
+ *
+ * Byte <id> of the lock file stands for container dprc.<id>, and the whole
+ * file for the whole container tree, so that commands locking distinct
+ * containers do not wait for each other.
+ */
+struct cmd_lock {
+	/**
+	 * lock file, -1 when the lock is not held
+	 */
+	int fd;
+	bool exclusive;
+
+	/**
+	 * containers the lock is scoped to, in increasing id order; with no
+	 * container, or too many of them, the whole tree is locked
+	 */
+	int num_containers;
+	uint32_t containers[CMD_LOCK_MAX_CONTAINERS];
+	bool too_many_containers;
+};
+
+void cmd_lock_init(struct cmd_lock *lock, bool exclusive);
+
+void cmd_lock_add_container(struct cmd_lock *lock, uint32_t dprc_id);
+
+int cmd_lock_acquire(struct cmd_lock *lock, const char *path);
+
+void cmd_lock_release(struct cmd_lock *lock);
+
+#endif /* _CMD_LOCK_H */
@@ -39,8 +39,6 @@
 #include "utils.h"
 #include "fsl_dpaiop.h"
 
-enum mc_cmd_status mc_status;
-
 /**
  * dpaiop info command options
  */
@@ -145,37 +143,37 @@ static int cmd_dpaiop_help(void)
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
 static void print_dpaiop_state(uint32_t state)
 {
-	printf("DPAIOP state: ");
+	restool_printf("DPAIOP state: ");
 	switch (state) {
 	case DPAIOP_STATE_RESET_DONE:
-		printf("DPAIOP_STATE_RESET_DONE\n");
+		restool_printf("DPAIOP_STATE_RESET_DONE\n");
 		break;
 	case DPAIOP_STATE_RESET_ONGOING:
-		printf("DPAIOP_STATE_RESET_ONGOING\n");
+		restool_printf("DPAIOP_STATE_RESET_ONGOING\n");
 		break;
 	case DPAIOP_STATE_LOAD_DONE:
-		printf("DPAIOP_STATE_LOAD_DONE\n");
+		restool_printf("DPAIOP_STATE_LOAD_DONE\n");
 		break;
 	case DPAIOP_STATE_LOAD_ONGIONG:
-		printf("DPAIOP_STATE_LOAD_ONGIONG\n");
+		restool_printf("DPAIOP_STATE_LOAD_ONGIONG\n");
 		break;
 	case DPAIOP_STATE_LOAD_ERROR:
-		printf("DPAIOP_STATE_LOAD_ERROR\n");
+		restool_printf("DPAIOP_STATE_LOAD_ERROR\n");
 		break;
 	case DPAIOP_STATE_BOOT_ONGOING:
-		printf("DPAIOP_STATE_BOOT_ONGOING\n");
+		restool_printf("DPAIOP_STATE_BOOT_ONGOING\n");
 		break;
 	case DPAIOP_STATE_BOOT_ERROR:
-		printf("DPAIOP_STATE_BOOT_ERROR\n");
+		restool_printf("DPAIOP_STATE_BOOT_ERROR\n");
 		break;
 	case DPAIOP_STATE_RUNNING:
-		printf("DPAIOP_STATE_RUNNING\n");
+		restool_printf("DPAIOP_STATE_RUNNING\n");
 		break;
 	default:
 		assert(false);
@@ -183,31 +181,16 @@ static void print_dpaiop_state(uint32_t state)
 	}
 }
 
-static int print_dpaiop_attr(uint32_t dpaiop_id,
-			struct dprc_obj_desc *target_obj_desc)
+static int print_dpaiop_attr(struct obj_info *info)
 {
-	uint16_t dpaiop_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dpaiop_id = info->desc.id;
+	uint16_t dpaiop_handle = info->handle;
 	int error;
 	struct dpaiop_attr dpaiop_attr;
 	struct dpaiop_sl_version dpaiop_sl_version;
 	uint32_t state;
-	bool dpaiop_opened = false;
-
-	error = dpaiop_open(&restool.mc_io, 0, dpaiop_id, &dpaiop_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
-	dpaiop_opened = true;
-	if (0 == dpaiop_handle) {
-		DEBUG_PRINTF(
-			"dpaiop_open() returned invalid handle (auth 0) for dpaiop.%u\n",
-			dpaiop_id);
-		error = -ENOENT;
-		goto out;
-	}
+	enum mc_cmd_status mc_status;
 
 	memset(&dpaiop_attr, 0, sizeof(dpaiop_attr));
 	error = dpaiop_get_attributes(&restool.mc_io, 0, dpaiop_handle,
@@ -220,10 +203,10 @@ static int print_dpaiop_attr(uint32_t dpaiop_id,
 	}
 	assert(dpaiop_id == (uint32_t)dpaiop_attr.id);
 
-	printf("dpaiop version: %u.%u\n", dpaiop_attr.version.major,
-	       dpaiop_attr.version.minor);
-	printf("dpaiop id: %d\n", dpaiop_attr.id);
-	printf("plugged state: %splugged\n",
+	restool_printf("dpaiop version: %u.%u\n", dpaiop_attr.version.major,
+		       dpaiop_attr.version.minor);
+	restool_printf("dpaiop id: %d\n", dpaiop_attr.id);
+	restool_printf("plugged state: %splugged\n",
 		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
 
 	memset(&dpaiop_sl_version, 0, sizeof(dpaiop_sl_version));
@@ -235,7 +218,7 @@ static int print_dpaiop_attr(uint32_t dpaiop_id,
 			     mc_status_to_string(mc_status), mc_status);
 		goto out;
 	}
-	printf("dpaiop server layer version: %u.%u.%u\n",
+	restool_printf("dpaiop server layer version: %u.%u.%u\n",
 		dpaiop_sl_version.major,
 		dpaiop_sl_version.minor,
 		dpaiop_sl_version.revision);
@@ -253,62 +236,34 @@ static int print_dpaiop_attr(uint32_t dpaiop_id,
 	error = 0;
 
 out:
-	if (dpaiop_opened) {
-		int error2;
-
-		error2 = dpaiop_close(&restool.mc_io, 0, dpaiop_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
 	return error;
 }
 
 static int print_dpaiop_info(uint32_t dpaiop_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dpaiop_id,
-				"dpaiop", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (strcmp(target_obj_desc.type, "dpaiop")) {
-		printf("dpaiop.%d does not exist\n", dpaiop_id);
-		return -EINVAL;
-	}
-
-	error = print_dpaiop_attr(dpaiop_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
-
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dpaiop_ops);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-out:
-	return error;
+	return print_obj_info("dpaiop", dpaiop_id, &dpaiop_ops, print_dpaiop_attr,
+			      verbose);
 }
 
 static int cmd_dpaiop_info(void)
 {
 	static const char usage_msg[] =
 	"\n"
-	"Usage: restool dpaiop info <dpaiop-object> [--verbose]\n"
+	"Usage: restool dpaiop info <dpaiop-object>|--label=<label> [--verbose]\n"
 	"   e.g. restool dpaiop info dpaiop.5\n"
 	"\n"
+	"--label=<label>\n"
+	"   Names the object by its label, in place of <dpaiop-object>.\n"
+	"   <dpaiop-object> may also be given as label:<label>\n"
+	"   e.g. restool dpaiop info --label=my-dpaiop\n"
+	"\n"
 	"--verbose\n"
 	"   Shows extended/verbose information about the object\n"
 	"   e.g. restool dpaiop info dpaiop.5 --verbose\n"
@@ -317,21 +272,21 @@ static int cmd_dpaiop_info(void)
 	uint32_t obj_id;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpaiop", &obj_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpaiop", &obj_id);
 	if (error < 0)
 		goto out;
 
@@ -348,6 +303,7 @@ static int cmd_dpaiop_create(void)
 		"\n"
 		"--aiop-container=<container-name>\n"
 		"   Specifies the AIOP container name, e.g. dprc.3, dprc.4, etc.\n"
+		"   or label:<label> for the container carrying that label\n"
 		"\n"
 		"OPTIONS:\n"
 		"--aiop-id=<number>\n"
@@ -367,30 +323,31 @@ static int cmd_dpaiop_create(void)
 	uint16_t dpaiop_handle;
 	struct dpaiop_attr dpaiop_attr;
 	uint32_t obj_id;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
-			     restool.obj_name);
-		printf(usage_msg);
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_AIOP_ID)) {
-		restool.cmd_option_mask &=
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_AIOP_ID)) {
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_AIOP_ID);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_AIOP_ID];
+		str = restool_cmd.option_args[CREATE_OPT_AIOP_ID];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
 		    (val != 0)) {
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			return -EINVAL;
 		}
 
@@ -399,22 +356,22 @@ static int cmd_dpaiop_create(void)
 		dpaiop_cfg.aiop_id = 0;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_AIOP_CONTAINER)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_AIOP_CONTAINER);
 		error = parse_object_name(
-			restool.cmd_option_args[CREATE_OPT_AIOP_CONTAINER],
+			restool_cmd.option_args[CREATE_OPT_AIOP_CONTAINER],
 			"dprc", &obj_id);
 		if (error < 0) {
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			return error;
 		}
 
 		dpaiop_cfg.aiop_container_id = obj_id;
 	} else {
 		ERROR_PRINTF("--aiop-container option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
@@ -436,7 +393,7 @@ static int cmd_dpaiop_create(void)
 		return error;
 	}
 	print_new_obj("dpaiop", dpaiop_attr.id,
-		restool.cmd_option_args[CREATE_OPT_AIOP_CONTAINER]);
+		restool_cmd.option_args[CREATE_OPT_AIOP_CONTAINER]);
 
 	error = dpaiop_close(&restool.mc_io, 0, dpaiop_handle);
 	if (error < 0) {
@@ -453,8 +410,13 @@ static int cmd_dpaiop_destroy(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpaiop destroy <dpaiop-object>\n"
+		"Usage: restool dpaiop destroy <dpaiop-object>|--label=<label>\n"
 		"   e.g. restool dpaiop destroy dpaiop.9\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpaiop-object>.\n"
+		"   <dpaiop-object> may also be given as label:<label>\n"
+		"   e.g. restool dpaiop destroy --label=my-dpaiop\n"
 		"\n";
 
 	int error;
@@ -462,26 +424,27 @@ static int cmd_dpaiop_destroy(void)
 	uint32_t dpaiop_id;
 	uint16_t dpaiop_handle;
 	bool dpaiop_opened = false;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpaiop", &dpaiop_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpaiop", &dpaiop_id);
 	if (error < 0)
 		goto out;
 
@@ -490,7 +453,7 @@ static int cmd_dpaiop_destroy(void)
 		goto out;
 	}
 
-	error = dpaiop_open(&restool.mc_io, 0, dpaiop_id, &dpaiop_handle);
+	error = open_obj("dpaiop", dpaiop_id, &dpaiop_ops, &dpaiop_handle);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -514,11 +477,12 @@ static int cmd_dpaiop_destroy(void)
 		goto out;
 	}
 	dpaiop_opened = false;
-	printf("dpaiop.%u is destroyed\n", dpaiop_id);
+	mc_handle_forget(&restool.handles, "dpaiop", dpaiop_id);
+	restool_printf("dpaiop.%u is destroyed\n", dpaiop_id);
 
 out:
 	if (dpaiop_opened) {
-		error2 = dpaiop_close(&restool.mc_io, 0, dpaiop_handle);
+		error2 = close_obj(&dpaiop_ops, dpaiop_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -40,8 +40,6 @@
 #include "utils.h"
 #include "fsl_dpbp.h"
 
-enum mc_cmd_status mc_status;
-
 /**
  * dpbp info command options
  */
@@ -138,33 +136,18 @@ static int cmd_dpbp_help(void)
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
-static int print_dpbp_attr(uint32_t dpbp_id,
-			struct dprc_obj_desc *target_obj_desc)
+static int print_dpbp_attr(struct obj_info *info)
 {
-	uint16_t dpbp_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dpbp_id = info->desc.id;
+	uint16_t dpbp_handle = info->handle;
 	int error;
 	struct dpbp_attr dpbp_attr;
-	bool dpbp_opened = false;
-
-	error = dpbp_open(&restool.mc_io, 0, dpbp_id, &dpbp_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
-	dpbp_opened = true;
-	if (0 == dpbp_handle) {
-		DEBUG_PRINTF(
-			"dpbp_open() returned invalid handle (auth 0) for dpbp.%u\n",
-			dpbp_id);
-		error = -ENOENT;
-		goto out;
-	}
+	enum mc_cmd_status mc_status;
 
 	memset(&dpbp_attr, 0, sizeof(dpbp_attr));
 	error = dpbp_get_attributes(&restool.mc_io, 0, dpbp_handle, &dpbp_attr);
@@ -176,72 +159,44 @@ static int print_dpbp_attr(uint32_t dpbp_id,
 	}
 	assert(dpbp_id == (uint32_t)dpbp_attr.id);
 
-	printf("dpbp version: %u.%u\n", dpbp_attr.version.major,
-	       dpbp_attr.version.minor);
-	printf("dpbp id: %d\n", dpbp_attr.id);
-	printf("plugged state: %splugged\n",
+	restool_printf("dpbp version: %u.%u\n", dpbp_attr.version.major,
+		       dpbp_attr.version.minor);
+	restool_printf("dpbp id: %d\n", dpbp_attr.id);
+	restool_printf("plugged state: %splugged\n",
 		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
-	printf("buffer pool id: %u\n", (unsigned int)dpbp_attr.bpid);
+	restool_printf("buffer pool id: %u\n", (unsigned int)dpbp_attr.bpid);
 	print_obj_label(target_obj_desc);
 
 	error = 0;
 out:
-	if (dpbp_opened) {
-		int error2;
-
-		error2 = dpbp_close(&restool.mc_io, 0, dpbp_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
 	return error;
 }
 
 static int print_dpbp_info(uint32_t dpbp_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dpbp_id,
-				"dpbp", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (strcmp(target_obj_desc.type, "dpbp")) {
-		printf("dpbp.%d does not exist\n", dpbp_id);
-		return -EINVAL;
-	}
-
-	error = print_dpbp_attr(dpbp_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
-
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dpbp_ops);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-out:
-	return error;
+	return print_obj_info("dpbp", dpbp_id, &dpbp_ops, print_dpbp_attr,
+			      verbose);
 }
 
 static int cmd_dpbp_info(void)
 {
 	static const char usage_msg[] =
 	"\n"
-	"Usage: restool dpbp info <dpbp-object> [--verbose]\n"
+	"Usage: restool dpbp info <dpbp-object>|--label=<label> [--verbose]\n"
 	"   e.g. restool dpbp info dpbp.5\n"
 	"\n"
+	"--label=<label>\n"
+	"   Names the object by its label, in place of <dpbp-object>.\n"
+	"   <dpbp-object> may also be given as label:<label>\n"
+	"   e.g. restool dpbp info --label=my-dpbp\n"
+	"\n"
 	"--verbose\n"
 	"   Shows extended/verbose information about the object\n"
 	"   e.g. restool dpbp info dpbp.5 --verbose\n"
@@ -250,21 +205,21 @@ static int cmd_dpbp_info(void)
 	uint32_t obj_id;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpbp", &obj_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpbp", &obj_id);
 	if (error < 0)
 		goto out;
 
@@ -296,29 +251,30 @@ static int cmd_dpbp_create(void)
 	struct dpbp_cfg dpbp_cfg;
 	uint16_t dpbp_handle;
 	struct dpbp_attr dpbp_attr;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
-			     restool.obj_name);
-		printf(usage_msg);
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_BUFFER_SIZE)) {
-		restool.cmd_option_mask &=
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_BUFFER_SIZE)) {
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_BUFFER_SIZE);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_BUFFER_SIZE];
+		str = restool_cmd.option_args[CREATE_OPT_BUFFER_SIZE];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) || (val < 0)) {
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			return -EINVAL;
 		}
 
@@ -359,8 +315,13 @@ static int cmd_dpbp_destroy(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpbp destroy <dpbp-object>\n"
+		"Usage: restool dpbp destroy <dpbp-object>|--label=<label>\n"
 		"   e.g. restool dpbp destroy dpbp.9\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpbp-object>.\n"
+		"   <dpbp-object> may also be given as label:<label>\n"
+		"   e.g. restool dpbp destroy --label=my-dpbp\n"
 		"\n";
 
 	int error;
@@ -368,26 +329,27 @@ static int cmd_dpbp_destroy(void)
 	uint32_t dpbp_id;
 	uint16_t dpbp_handle;
 	bool dpbp_opened = false;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpbp", &dpbp_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpbp", &dpbp_id);
 	if (error < 0)
 		goto out;
 
@@ -396,7 +358,7 @@ static int cmd_dpbp_destroy(void)
 		goto out;
 	}
 
-	error = dpbp_open(&restool.mc_io, 0, dpbp_id, &dpbp_handle);
+	error = open_obj("dpbp", dpbp_id, &dpbp_ops, &dpbp_handle);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -420,11 +382,12 @@ static int cmd_dpbp_destroy(void)
 		goto out;
 	}
 	dpbp_opened = false;
-	printf("dpbp.%u is destroyed\n", dpbp_id);
+	mc_handle_forget(&restool.handles, "dpbp", dpbp_id);
+	restool_printf("dpbp.%u is destroyed\n", dpbp_id);
 
 out:
 	if (dpbp_opened) {
-		error2 = dpbp_close(&restool.mc_io, 0, dpbp_handle);
+		error2 = close_obj(&dpbp_ops, dpbp_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
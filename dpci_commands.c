@@ -39,8 +39,6 @@
 #include "utils.h"
 #include "fsl_dpci.h"
 
-enum mc_cmd_status mc_status;
-
 /**
  * dpci info command options
  */
@@ -137,35 +135,20 @@ static int cmd_dpci_help(void)
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
-static int print_dpci_attr(uint32_t dpci_id,
-			struct dprc_obj_desc *target_obj_desc)
+static int print_dpci_attr(struct obj_info *info)
 {
-	uint16_t dpci_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dpci_id = info->desc.id;
+	uint16_t dpci_handle = info->handle;
 	int error;
 	struct dpci_attr dpci_attr;
 	struct dpci_peer_attr dpci_peer_attr;
-	bool dpci_opened = false;
 	int link_state;
-
-	error = dpci_open(&restool.mc_io, 0, dpci_id, &dpci_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
-	dpci_opened = true;
-	if (0 == dpci_handle) {
-		DEBUG_PRINTF(
-			"dpci_open() returned invalid handle (auth 0) for dpci.%u\n",
-			dpci_id);
-		error = -ENOENT;
-		goto out;
-	}
+	enum mc_cmd_status mc_status;
 
 	memset(&dpci_attr, 0, sizeof(dpci_attr));
 	error = dpci_get_attributes(&restool.mc_io, 0, dpci_handle, &dpci_attr);
@@ -195,85 +178,58 @@ static int print_dpci_attr(uint32_t dpci_id,
 		goto out;
 	}
 
-	printf("dpci version: %u.%u\n", dpci_attr.version.major,
-	       dpci_attr.version.minor);
-	printf("dpci id: %d\n", dpci_attr.id);
-	printf("plugged state: %splugged\n",
+	restool_printf("dpci version: %u.%u\n", dpci_attr.version.major,
+		       dpci_attr.version.minor);
+	restool_printf("dpci id: %d\n", dpci_attr.id);
+	restool_printf("plugged state: %splugged\n",
 		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
-	printf("num_of_priorities: %u\n",
-	       (unsigned int)dpci_attr.num_of_priorities);
-	printf("connected peer: ");
+	restool_printf("num_of_priorities: %u\n",
+		       (unsigned int)dpci_attr.num_of_priorities);
+	restool_printf("connected peer: ");
 	if (-1 == dpci_peer_attr.peer_id) {
-		printf("no peer\n");
+		restool_printf("no peer\n");
 	} else {
-		printf("dpci.%d\n", dpci_peer_attr.peer_id);
-		printf("peer's num_of_priorities: %u\n",
-		       (unsigned int)dpci_peer_attr.num_of_priorities);
+		restool_printf("dpci.%d\n", dpci_peer_attr.peer_id);
+		restool_printf("peer's num_of_priorities: %u\n",
+			       (unsigned int)dpci_peer_attr.num_of_priorities);
 	}
-	printf("link status: %d - ", link_state);
-	link_state == 0 ? printf("down\n") :
-	link_state == 1 ? printf("up\n") : printf("error state\n");
+	restool_printf("link status: %d - ", link_state);
+	link_state == 0 ? restool_printf("down\n") :
+	link_state == 1 ? restool_printf("up\n") :
+			  restool_printf("error state\n");
 	print_obj_label(target_obj_desc);
 
 	error = 0;
 
 out:
-	if (dpci_opened) {
-		int error2;
-
-		error2 = dpci_close(&restool.mc_io, 0, dpci_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
 	return error;
 }
 
 static int print_dpci_info(uint32_t dpci_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dpci_id,
-				"dpci", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (strcmp(target_obj_desc.type, "dpci")) {
-		printf("dpci.%d does not exist\n", dpci_id);
-		return -EINVAL;
-	}
-
-	error = print_dpci_attr(dpci_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
-
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dpci_ops);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-out:
-	return error;
+	return print_obj_info("dpci", dpci_id, &dpci_ops, print_dpci_attr,
+			      verbose);
 }
 
 static int cmd_dpci_info(void)
 {
 	static const char usage_msg[] =
 	"\n"
-	"Usage: restool dpci info <dpci-object> [--verbose]\n"
+	"Usage: restool dpci info <dpci-object>|--label=<label> [--verbose]\n"
 	"   e.g. restool dpci info dpci.8\n"
 	"\n"
+	"--label=<label>\n"
+	"   Names the object by its label, in place of <dpci-object>.\n"
+	"   <dpci-object> may also be given as label:<label>\n"
+	"   e.g. restool dpci info --label=my-dpci\n"
+	"\n"
 	"--verbose\n"
 	"   Shows extended/verbose information about the object\n"
 	"   e.g. restool dpci info dpci.8 --verbose\n"
@@ -282,21 +238,21 @@ static int cmd_dpci_info(void)
 	uint32_t obj_id;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpci", &obj_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpci", &obj_id);
 	if (error < 0)
 		goto out;
 
@@ -329,30 +285,31 @@ static int cmd_dpci_create(void)
 	struct dpci_cfg dpci_cfg;
 	uint16_t dpci_handle;
 	struct dpci_attr dpci_attr;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
-			     restool.obj_name);
-		printf(usage_msg);
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_NUM_PRIORITIES)) {
-		restool.cmd_option_mask &=
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_NUM_PRIORITIES)) {
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_NUM_PRIORITIES);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_NUM_PRIORITIES];
+		str = restool_cmd.option_args[CREATE_OPT_NUM_PRIORITIES];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno)/* ||
 		    (val < 1 || val > 2)*/) {
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			return -EINVAL;
 		}
 
@@ -393,8 +350,13 @@ static int cmd_dpci_destroy(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpci destroy <dpci-object>\n"
+		"Usage: restool dpci destroy <dpci-object>|--label=<label>\n"
 		"   e.g. restool dpci destroy dpci.3\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpci-object>.\n"
+		"   <dpci-object> may also be given as label:<label>\n"
+		"   e.g. restool dpci destroy --label=my-dpci\n"
 		"\n";
 
 	int error;
@@ -402,26 +364,27 @@ static int cmd_dpci_destroy(void)
 	uint32_t dpci_id;
 	uint16_t dpci_handle;
 	bool dpci_opened = false;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpci", &dpci_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpci", &dpci_id);
 	if (error < 0)
 		goto out;
 
@@ -430,7 +393,7 @@ static int cmd_dpci_destroy(void)
 		goto out;
 	}
 
-	error = dpci_open(&restool.mc_io, 0, dpci_id, &dpci_handle);
+	error = open_obj("dpci", dpci_id, &dpci_ops, &dpci_handle);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -454,11 +417,12 @@ static int cmd_dpci_destroy(void)
 		goto out;
 	}
 	dpci_opened = false;
-	printf("dpci.%u is destroyed\n", dpci_id);
+	mc_handle_forget(&restool.handles, "dpci", dpci_id);
+	restool_printf("dpci.%u is destroyed\n", dpci_id);
 
 out:
 	if (dpci_opened) {
-		error2 = dpci_close(&restool.mc_io, 0, dpci_handle);
+		error2 = close_obj(&dpci_ops, dpci_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
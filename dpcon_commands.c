@@ -39,8 +39,6 @@
 #include "utils.h"
 #include "fsl_dpcon.h"
 
-enum mc_cmd_status mc_status;
-
 /**
  * dpcon info command options
  */
@@ -137,33 +135,18 @@ static int cmd_dpcon_help(void)
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
-static int print_dpcon_attr(uint32_t dpcon_id,
-			struct dprc_obj_desc *target_obj_desc)
+static int print_dpcon_attr(struct obj_info *info)
 {
-	uint16_t dpcon_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dpcon_id = info->desc.id;
+	uint16_t dpcon_handle = info->handle;
 	int error;
 	struct dpcon_attr dpcon_attr;
-	bool dpcon_opened = false;
-
-	error = dpcon_open(&restool.mc_io, 0, dpcon_id, &dpcon_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
-	dpcon_opened = true;
-	if (0 == dpcon_handle) {
-		DEBUG_PRINTF(
-			"dpcon_open() returned invalid handle (auth 0) for dpcon.%u\n",
-			dpcon_id);
-		error = -ENOENT;
-		goto out;
-	}
+	enum mc_cmd_status mc_status;
 
 	memset(&dpcon_attr, 0, sizeof(dpcon_attr));
 	error = dpcon_get_attributes(&restool.mc_io, 0, dpcon_handle,
@@ -176,76 +159,48 @@ static int print_dpcon_attr(uint32_t dpcon_id,
 	}
 	assert(dpcon_id == (uint32_t)dpcon_attr.id);
 
-	printf("dpcon version: %u.%u\n", dpcon_attr.version.major,
-	       dpcon_attr.version.minor);
-	printf("dpcon id: %d\n", dpcon_attr.id);
-	printf("plugged state: %splugged\n",
+	restool_printf("dpcon version: %u.%u\n", dpcon_attr.version.major,
+		       dpcon_attr.version.minor);
+	restool_printf("dpcon id: %d\n", dpcon_attr.id);
+	restool_printf("plugged state: %splugged\n",
 		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
-	printf("qbman channel id to be used by dequeue operation: %u\n",
+	restool_printf("qbman channel id to be used by dequeue operation: %u\n",
 		dpcon_attr.qbman_ch_id);
-	printf("number of priorities for the DPCON channel: %u\n",
+	restool_printf("number of priorities for the DPCON channel: %u\n",
 		dpcon_attr.num_priorities);
 	print_obj_label(target_obj_desc);
 
 	error = 0;
 
 out:
-	if (dpcon_opened) {
-		int error2;
-
-		error2 = dpcon_close(&restool.mc_io, 0, dpcon_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
 	return error;
 }
 
 static int print_dpcon_info(uint32_t dpcon_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dpcon_id,
-				"dpcon", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (strcmp(target_obj_desc.type, "dpcon")) {
-		printf("dpcon.%d does not exist\n", dpcon_id);
-		return -EINVAL;
-	}
-
-	error = print_dpcon_attr(dpcon_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
-
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dpcon_ops);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-out:
-	return error;
+	return print_obj_info("dpcon", dpcon_id, &dpcon_ops, print_dpcon_attr,
+			      verbose);
 }
 
 static int cmd_dpcon_info(void)
 {
 	static const char usage_msg[] =
 	"\n"
-	"Usage: restool dpcon info <dpcon-object> [--verbose]\n"
+	"Usage: restool dpcon info <dpcon-object>|--label=<label> [--verbose]\n"
 	"   e.g. restool dpcon info dpcon.5\n"
 	"\n"
+	"--label=<label>\n"
+	"   Names the object by its label, in place of <dpcon-object>.\n"
+	"   <dpcon-object> may also be given as label:<label>\n"
+	"   e.g. restool dpcon info --label=my-dpcon\n"
+	"\n"
 	"--verbose\n"
 	"   Shows extended/verbose information about the object\n"
 	"   e.g. restool dpcon info dpcon.5 --verbose\n"
@@ -254,21 +209,21 @@ static int cmd_dpcon_info(void)
 	uint32_t obj_id;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpcon", &obj_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpcon", &obj_id);
 	if (error < 0)
 		goto out;
 
@@ -301,30 +256,31 @@ static int cmd_dpcon_create(void)
 	struct dpcon_cfg dpcon_cfg;
 	uint16_t dpcon_handle;
 	struct dpcon_attr dpcon_attr;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
-			     restool.obj_name);
-		printf(usage_msg);
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_NUM_PRIORITIES)) {
-		restool.cmd_option_mask &=
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_NUM_PRIORITIES)) {
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_NUM_PRIORITIES);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_NUM_PRIORITIES];
+		str = restool_cmd.option_args[CREATE_OPT_NUM_PRIORITIES];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
 		    (val < 1 || val > 8)) {
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			return -EINVAL;
 		}
 
@@ -367,8 +323,13 @@ static int cmd_dpcon_destroy(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpcon destroy <dpcon-object>\n"
+		"Usage: restool dpcon destroy <dpcon-object>|--label=<label>\n"
 		"   e.g. restool dpcon destroy dpcon.9\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpcon-object>.\n"
+		"   <dpcon-object> may also be given as label:<label>\n"
+		"   e.g. restool dpcon destroy --label=my-dpcon\n"
 		"\n";
 
 	int error;
@@ -376,26 +337,27 @@ static int cmd_dpcon_destroy(void)
 	uint32_t dpcon_id;
 	uint16_t dpcon_handle;
 	bool dpcon_opened = false;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpcon", &dpcon_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpcon", &dpcon_id);
 	if (error < 0)
 		goto out;
 
@@ -404,7 +366,7 @@ static int cmd_dpcon_destroy(void)
 		goto out;
 	}
 
-	error = dpcon_open(&restool.mc_io, 0, dpcon_id, &dpcon_handle);
+	error = open_obj("dpcon", dpcon_id, &dpcon_ops, &dpcon_handle);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -428,11 +390,12 @@ static int cmd_dpcon_destroy(void)
 		goto out;
 	}
 	dpcon_opened = false;
-	printf("dpcon.%u is destroyed\n", dpcon_id);
+	mc_handle_forget(&restool.handles, "dpcon", dpcon_id);
+	restool_printf("dpcon.%u is destroyed\n", dpcon_id);
 
 out:
 	if (dpcon_opened) {
-		error2 = dpcon_close(&restool.mc_io, 0, dpcon_handle);
+		error2 = close_obj(&dpcon_ops, dpcon_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -39,8 +39,6 @@
 #include "utils.h"
 #include "fsl_dpdcei.h"
 
-enum mc_cmd_status mc_status;
-
 /**
  * dpdcei info command options
  */
@@ -145,19 +143,19 @@ static int cmd_dpdcei_help(void)
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
 static void print_dpdcei_engine(enum dpdcei_engine engine)
 {
-	printf("DPDCEI engine: ");
+	restool_printf("DPDCEI engine: ");
 	switch (engine) {
 	case DPDCEI_ENGINE_COMPRESSION:
-		printf("DPDCEI_ENGINE_COMPRESSION\n");
+		restool_printf("DPDCEI_ENGINE_COMPRESSION\n");
 		break;
 	case DPDCEI_ENGINE_DECOMPRESSION:
-		printf("DPDCEI_ENGINE_DECOMPRESSION\n");
+		restool_printf("DPDCEI_ENGINE_DECOMPRESSION\n");
 		break;
 	default:
 		assert(false);
@@ -165,29 +163,14 @@ static void print_dpdcei_engine(enum dpdcei_engine engine)
 	}
 }
 
-static int print_dpdcei_attr(uint32_t dpdcei_id,
-			struct dprc_obj_desc *target_obj_desc)
+static int print_dpdcei_attr(struct obj_info *info)
 {
-	uint16_t dpdcei_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dpdcei_id = info->desc.id;
+	uint16_t dpdcei_handle = info->handle;
 	int error;
 	struct dpdcei_attr dpdcei_attr;
-	bool dpdcei_opened = false;
-
-	error = dpdcei_open(&restool.mc_io, 0, dpdcei_id, &dpdcei_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
-	dpdcei_opened = true;
-	if (0 == dpdcei_handle) {
-		DEBUG_PRINTF(
-			"dpdcei_open() returned invalid handle (auth 0) for dpdcei.%u\n",
-			dpdcei_id);
-		error = -ENOENT;
-		goto out;
-	}
+	enum mc_cmd_status mc_status;
 
 	memset(&dpdcei_attr, 0, sizeof(dpdcei_attr));
 	error = dpdcei_get_attributes(&restool.mc_io, 0, dpdcei_handle,
@@ -200,10 +183,10 @@ static int print_dpdcei_attr(uint32_t dpdcei_id,
 	}
 	assert(dpdcei_id == (uint32_t)dpdcei_attr.id);
 
-	printf("dpdcei version: %u.%u\n", dpdcei_attr.version.major,
-	       dpdcei_attr.version.minor);
-	printf("dpdcei id: %d\n", dpdcei_attr.id);
-	printf("plugged state: %splugged\n",
+	restool_printf("dpdcei version: %u.%u\n", dpdcei_attr.version.major,
+		       dpdcei_attr.version.minor);
+	restool_printf("dpdcei id: %d\n", dpdcei_attr.id);
+	restool_printf("plugged state: %splugged\n",
 		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
 	print_dpdcei_engine(dpdcei_attr.engine);
 	print_obj_label(target_obj_desc);
@@ -211,62 +194,34 @@ static int print_dpdcei_attr(uint32_t dpdcei_id,
 	error = 0;
 
 out:
-	if (dpdcei_opened) {
-		int error2;
-
-		error2 = dpdcei_close(&restool.mc_io, 0, dpdcei_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
 	return error;
 }
 
 static int print_dpdcei_info(uint32_t dpdcei_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dpdcei_id,
-				"dpdcei", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (strcmp(target_obj_desc.type, "dpdcei")) {
-		printf("dpdcei.%d does not exist\n", dpdcei_id);
-		return -EINVAL;
-	}
-
-	error = print_dpdcei_attr(dpdcei_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
-
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dpdcei_ops);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-out:
-	return error;
+	return print_obj_info("dpdcei", dpdcei_id, &dpdcei_ops, print_dpdcei_attr,
+			      verbose);
 }
 
 static int cmd_dpdcei_info(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpdcei info <dpdcei-object> [--verbose]\n"
+		"Usage: restool dpdcei info <dpdcei-object>|--label=<label> [--verbose]\n"
 		"   e.g. restool dpdcei info dpdcei.7\n"
 		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpdcei-object>.\n"
+		"   <dpdcei-object> may also be given as label:<label>\n"
+		"   e.g. restool dpdcei info --label=my-dpdcei\n"
+		"\n"
 		"--verbose\n"
 		"   Shows extended/verbose information about the object\n"
 		"   e.g. restool dpdcei info dpdcei.7 --verbose\n"
@@ -275,21 +230,21 @@ static int cmd_dpdcei_info(void)
 	uint32_t obj_id;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpdcei", &obj_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpdcei", &obj_id);
 	if (error < 0)
 		goto out;
 
@@ -310,7 +265,7 @@ static int parse_dpdcei_engine(char *engine_str, enum dpdcei_engine *engine)
 		return 0;
 	}
 
-	printf("Invalid dpdcei engine input.\n");
+	restool_printf("Invalid dpdcei engine input.\n");
 	return -EINVAL;
 }
 
@@ -336,25 +291,26 @@ static int cmd_dpdcei_create(void)
 	char *str;
 	char *endptr;
 	struct dpdcei_attr dpdcei_attr;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
-			     restool.obj_name);
-		printf(usage_msg);
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_ENGINE)) {
-		restool.cmd_option_mask &=
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_ENGINE)) {
+		restool_cmd.option_mask &=
 				~ONE_BIT_MASK(CREATE_OPT_ENGINE);
 		error = parse_dpdcei_engine(
-			restool.cmd_option_args[CREATE_OPT_ENGINE],
+			restool_cmd.option_args[CREATE_OPT_ENGINE],
 			&dpdcei_cfg.engine);
 		if (error < 0) {
 			DEBUG_PRINTF(
@@ -364,14 +320,14 @@ static int cmd_dpdcei_create(void)
 		}
 	} else {
 		ERROR_PRINTF("--engine option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_PRIORITY)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_PRIORITY);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_PRIORITY)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_PRIORITY);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_PRIORITY];
+		str = restool_cmd.option_args[CREATE_OPT_PRIORITY];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -383,7 +339,7 @@ static int cmd_dpdcei_create(void)
 		dpdcei_cfg.priority = (uint8_t)val;
 	} else {
 		ERROR_PRINTF("--priority option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
@@ -420,8 +376,13 @@ static int cmd_dpdcei_destroy(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpdcei destroy <dpdcei-object>\n"
+		"Usage: restool dpdcei destroy <dpdcei-object>|--label=<label>\n"
 		"   e.g. restool dpdcei destroy dpdcei.9\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpdcei-object>.\n"
+		"   <dpdcei-object> may also be given as label:<label>\n"
+		"   e.g. restool dpdcei destroy --label=my-dpdcei\n"
 		"\n";
 
 	int error;
@@ -429,27 +390,28 @@ static int cmd_dpdcei_destroy(void)
 	uint32_t dpdcei_id;
 	uint16_t dpdcei_handle;
 	bool dpdcei_opened = false;
+	enum mc_cmd_status mc_status;
 
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpdcei", &dpdcei_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpdcei", &dpdcei_id);
 	if (error < 0)
 		goto out;
 
@@ -458,7 +420,7 @@ static int cmd_dpdcei_destroy(void)
 		goto out;
 	}
 
-	error = dpdcei_open(&restool.mc_io, 0, dpdcei_id, &dpdcei_handle);
+	error = open_obj("dpdcei", dpdcei_id, &dpdcei_ops, &dpdcei_handle);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -482,11 +444,12 @@ static int cmd_dpdcei_destroy(void)
 		goto out;
 	}
 	dpdcei_opened = false;
-	printf("dpdcei.%u is destroyed\n", dpdcei_id);
+	mc_handle_forget(&restool.handles, "dpdcei", dpdcei_id);
+	restool_printf("dpdcei.%u is destroyed\n", dpdcei_id);
 
 out:
 	if (dpdcei_opened) {
-		error2 = dpdcei_close(&restool.mc_io, 0, dpdcei_handle);
+		error2 = close_obj(&dpdcei_ops, dpdcei_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
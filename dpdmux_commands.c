@@ -41,8 +41,6 @@
 
 #define ALL_DPDMUX_OPTS		DPDMUX_OPT_BRIDGE_EN
 
-enum mc_cmd_status mc_status;
-
 /**
  * dpdmux info command options
  */
@@ -187,95 +185,113 @@ static int cmd_dpdmux_help(void)
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
 static int print_dpdmux_endpoint(uint32_t target_id, uint16_t num_ifs)
 {
-	struct dprc_endpoint endpoint1;
-	struct dprc_endpoint endpoint2;
-	int state;
-	int error = 0;
+	struct dprc_endpoint *endpoints1;
+	struct dprc_endpoint *endpoints2;
+	int *states;
+	int error;
 	int k;
+	enum mc_cmd_status mc_status;
+
+	endpoints1 = calloc(num_ifs, sizeof(endpoints1[0]));
+	endpoints2 = calloc(num_ifs, sizeof(endpoints2[0]));
+	states = calloc(num_ifs, sizeof(states[0]));
+	if (endpoints1 == NULL || endpoints2 == NULL || states == NULL) {
+		ERROR_PRINTF("calloc() failed\n");
+		error = -ENOMEM;
+		goto out;
+	}
 
-	printf("endpoints:\n");
 	for (k = 0; k < num_ifs; ++k) {
-		memset(&endpoint1, 0, sizeof(struct dprc_endpoint));
-		memset(&endpoint2, 0, sizeof(struct dprc_endpoint));
-		strncpy(endpoint1.type, "dpdmux", EP_OBJ_TYPE_MAX_LEN);
-		endpoint1.type[EP_OBJ_TYPE_MAX_LEN] = '\0';
-		endpoint1.id = target_id;
-		endpoint1.if_id = k;
-
-		error = dprc_get_connection(&restool.mc_io, 0,
-					restool.root_dprc_handle,
-					&endpoint1,
-					&endpoint2,
-					&state);
-		printf("endpoint state: %d\n", state);
-
-		if (error == 0 && state == -1) {
-			printf("\tinterface %d: No object associated\n", k);
-		} else if (error == 0) {
-			if (strcmp(endpoint2.type, "dpsw") == 0 ||
-			    strcmp(endpoint2.type, "dpdmux") == 0) {
-				printf("\tinterface %d: %s.%d.%d",
-					k, endpoint2.type, endpoint2.id,
-					endpoint2.if_id);
-			} else if (endpoint2.if_id == 0) {
-				printf("\tinterface %d: %s.%d",
-					k, endpoint2.type, endpoint2.id);
-			}
+		strncpy(endpoints1[k].type, "dpdmux", EP_OBJ_TYPE_MAX_LEN);
+		endpoints1[k].type[EP_OBJ_TYPE_MAX_LEN] = '\0';
+		endpoints1[k].id = target_id;
+		endpoints1[k].if_id = k;
+	}
+
+	/*
+	 * Query the connections of all interfaces at once
+	 */
+	error = dprc_get_connections(&restool.mc_io, 0,
+				     restool.root_dprc_handle, num_ifs,
+				     endpoints1, endpoints2, states);
+	if (error < 0) {
+		mc_status = flib_error_to_mc_status(error);
+		ERROR_PRINTF("MC error: %s (status %#x)\n",
+			mc_status_to_string(mc_status), mc_status);
+		goto out;
+	}
 
-			if (state == 1)
-				printf(", link is up\n");
-			else if (state == 0)
-				printf(", link is down\n");
-			else
-				printf(", link is in error state\n");
+	restool_printf("endpoints:\n");
+	for (k = 0; k < num_ifs; ++k) {
+		struct dprc_endpoint *endpoint2 = &endpoints2[k];
 
-		} else {
-			mc_status = flib_error_to_mc_status(error);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				mc_status_to_string(mc_status), mc_status);
-			return error;
+		restool_printf("endpoint state: %d\n", states[k]);
+		if (states[k] == -1) {
+			restool_printf("\tinterface %d: No object associated\n", k);
+			continue;
+		}
+
+		if (strcmp(endpoint2->type, "dpsw") == 0 ||
+		    strcmp(endpoint2->type, "dpdmux") == 0) {
+			restool_printf("\tinterface %d: %s.%d.%d",
+				k, endpoint2->type, endpoint2->id,
+				endpoint2->if_id);
+		} else if (endpoint2->if_id == 0) {
+			restool_printf("\tinterface %d: %s.%d",
+				k, endpoint2->type, endpoint2->id);
 		}
+
+		if (states[k] == 1)
+			restool_printf(", link is up\n");
+		else if (states[k] == 0)
+			restool_printf(", link is down\n");
+		else
+			restool_printf(", link is in error state\n");
 	}
 
-	return 0;
+out:
+	free(states);
+	free(endpoints2);
+	free(endpoints1);
+	return error;
 }
 
 static void print_dpdmux_options(uint64_t options)
 {
 	if (options == 0 || (options & ~ALL_DPDMUX_OPTS) != 0) {
-		printf("\tUnrecognized options found...\n");
+		restool_printf("\tUnrecognized options found...\n");
 		return;
 	}
 
 	if (options & DPDMUX_OPT_BRIDGE_EN)
-		printf("\tDPDMUX_OPT_BRIDGE_EN\n");
+		restool_printf("\tDPDMUX_OPT_BRIDGE_EN\n");
 }
 
 static void print_dpdmux_method(enum dpdmux_method method)
 {
-	printf("DPDMUX address table method: ");
+	restool_printf("DPDMUX address table method: ");
 	switch (method) {
 	case DPDMUX_METHOD_NONE:
-		printf("DPDMUX_METHOD_NONE\n");
+		restool_printf("DPDMUX_METHOD_NONE\n");
 		break;
 	case DPDMUX_METHOD_C_VLAN_MAC:
-		printf("DPDMUX_METHOD_C_VLAN_MAC\n");
+		restool_printf("DPDMUX_METHOD_C_VLAN_MAC\n");
 		break;
 	case DPDMUX_METHOD_MAC:
-		printf("DPDMUX_METHOD_MAC\n");
+		restool_printf("DPDMUX_METHOD_MAC\n");
 		break;
 	case DPDMUX_METHOD_C_VLAN:
-		printf("DPDMUX_METHOD_C_VLAN\n");
+		restool_printf("DPDMUX_METHOD_C_VLAN\n");
 		break;
 #if 0 /* TODO: Enable when MC support added */
 	case DPDMUX_METHOD_S_VLAN:
-		printf("DPDMUX_METHOD_S_VLAN\n");
+		restool_printf("DPDMUX_METHOD_S_VLAN\n");
 		break;
 #endif
 	default:
@@ -286,14 +302,14 @@ static void print_dpdmux_method(enum dpdmux_method method)
 
 static void print_dpdmux_manip(enum dpdmux_manip manip)
 {
-	printf("DPDMUX manipulation type: ");
+	restool_printf("DPDMUX manipulation type: ");
 	switch (manip) {
 	case DPDMUX_MANIP_NONE:
-		printf("DPDMUX_MANIP_NONE\n");
+		restool_printf("DPDMUX_MANIP_NONE\n");
 		break;
 #if 0 /* TODO: Enable when MC support added */
 	case DPDMUX_MANIP_ADD_REMOVE_S_VLAN:
-		printf("DPDMUX_MANIP_ADD_REMOVE_S_VLAN\n");
+		restool_printf("DPDMUX_MANIP_ADD_REMOVE_S_VLAN\n");
 		break;
 #endif
 	default:
@@ -302,29 +318,14 @@ static void print_dpdmux_manip(enum dpdmux_manip manip)
 	}
 }
 
-static int print_dpdmux_attr(uint32_t dpdmux_id,
-			struct dprc_obj_desc *target_obj_desc)
+static int print_dpdmux_attr(struct obj_info *info)
 {
-	uint16_t dpdmux_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dpdmux_id = info->desc.id;
+	uint16_t dpdmux_handle = info->handle;
 	int error;
 	struct dpdmux_attr dpdmux_attr;
-	bool dpdmux_opened = false;
-
-	error = dpdmux_open(&restool.mc_io, 0, dpdmux_id, &dpdmux_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
-	dpdmux_opened = true;
-	if (0 == dpdmux_handle) {
-		DEBUG_PRINTF(
-			"dpdmux_open() returned invalid handle (auth 0) for dpdmux.%u\n",
-			dpdmux_id);
-		error = -ENOENT;
-		goto out;
-	}
+	enum mc_cmd_status mc_status;
 
 	memset(&dpdmux_attr, 0, sizeof(dpdmux_attr));
 	error = dpdmux_get_attributes(&restool.mc_io, 0, dpdmux_handle,
@@ -337,84 +338,56 @@ static int print_dpdmux_attr(uint32_t dpdmux_id,
 	}
 	assert(dpdmux_id == (uint32_t)dpdmux_attr.id);
 
-	printf("dpdmux version: %u.%u\n", dpdmux_attr.version.major,
-	       dpdmux_attr.version.minor);
-	printf("dpdmux id: %d\n", dpdmux_attr.id);
-	printf("plugged state: %splugged\n",
+	restool_printf("dpdmux version: %u.%u\n", dpdmux_attr.version.major,
+		       dpdmux_attr.version.minor);
+	restool_printf("dpdmux id: %d\n", dpdmux_attr.id);
+	restool_printf("plugged state: %splugged\n",
 		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
 	print_dpdmux_endpoint(dpdmux_id, dpdmux_attr.num_ifs + 1);
-	printf("dpdmux_attr.options value is: %#llx\n",
-	       (unsigned long long)dpdmux_attr.options);
+	restool_printf("dpdmux_attr.options value is: %#llx\n",
+		       (unsigned long long)dpdmux_attr.options);
 	print_dpdmux_options(dpdmux_attr.options);
 	print_dpdmux_method(dpdmux_attr.method);
 	print_dpdmux_manip(dpdmux_attr.manip);
-	printf("number of interfaces (excluding the uplink interface): %u\n",
+	restool_printf("number of interfaces (excluding the uplink interface): %u\n",
 		(uint32_t)dpdmux_attr.num_ifs);
-	printf("DPDMUX frame storage memory size: %u\n",
+	restool_printf("DPDMUX frame storage memory size: %u\n",
 		(uint32_t)dpdmux_attr.mem_size);
-	printf("control interface ID: %u\n",
-	       (uint32_t)dpdmux_attr.control_if);
+	restool_printf("control interface ID: %u\n",
+		       (uint32_t)dpdmux_attr.control_if);
 	print_obj_label(target_obj_desc);
 
 	error = 0;
 
 out:
-	if (dpdmux_opened) {
-		int error2;
-
-		error2 = dpdmux_close(&restool.mc_io, 0, dpdmux_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
 	return error;
 }
 
 static int print_dpdmux_info(uint32_t dpdmux_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dpdmux_id,
-				"dpdmux", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (strcmp(target_obj_desc.type, "dpdmux")) {
-		printf("dpdmux.%d does not exist\n", dpdmux_id);
-		return -EINVAL;
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-	error = print_dpdmux_attr(dpdmux_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
-
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dpdmux_ops);
-	}
-
-out:
-	return error;
+	return print_obj_info("dpdmux", dpdmux_id, &dpdmux_ops, print_dpdmux_attr,
+			      verbose);
 }
 
 static int cmd_dpdmux_info(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpdmux info <dpdmux-object> [--verbose]\n"
+		"Usage: restool dpdmux info <dpdmux-object>|--label=<label> [--verbose]\n"
 		"   e.g. restool dpdmux info dpdmux.7\n"
 		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpdmux-object>.\n"
+		"   <dpdmux-object> may also be given as label:<label>\n"
+		"   e.g. restool dpdmux info --label=my-dpdmux\n"
+		"\n"
 		"--verbose\n"
 		"   Shows extended/verbose information about the object\n"
 		"   e.g. restool dpdmux info dpdmux.7 --verbose\n"
@@ -423,21 +396,21 @@ static int cmd_dpdmux_info(void)
 	uint32_t obj_id;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpdmux", &obj_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpdmux", &obj_id);
 	if (error < 0)
 		goto out;
 
@@ -498,7 +471,7 @@ static int parse_dpdmux_manip(char *manip_str, enum dpdmux_manip *manip)
 	}
 #endif
 
-	printf("Invalid dpdmux manip input.\n");
+	restool_printf("Invalid dpdmux manip input.\n");
 	return -EINVAL;
 }
 
@@ -532,7 +505,7 @@ static int parse_dpdmux_method(char *method_str, enum dpdmux_method *method)
 	}
 #endif
 
-	printf("Invalid dpdmux method input.\n");
+	restool_printf("Invalid dpdmux method input.\n");
 	return -EINVAL;
 }
 
@@ -545,24 +518,25 @@ static int create_dpdmux(const char *usage_msg)
 	char *str;
 	char *endptr;
 	struct dpdmux_attr dpdmux_attr;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
-			     restool.obj_name);
-		printf(usage_msg);
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_OPTIONS)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_OPTIONS);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_OPTIONS)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_OPTIONS);
 		error = parse_dpdmux_create_options(
-				restool.cmd_option_args[CREATE_OPT_OPTIONS],
+				restool_cmd.option_args[CREATE_OPT_OPTIONS],
 				&dpdmux_cfg.adv.options);
 		if (error < 0) {
 			DEBUG_PRINTF(
@@ -574,11 +548,11 @@ static int create_dpdmux(const char *usage_msg)
 		dpdmux_cfg.adv.options = 0;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_METHOD)) {
-		restool.cmd_option_mask &=
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_METHOD)) {
+		restool_cmd.option_mask &=
 				~ONE_BIT_MASK(CREATE_OPT_METHOD);
 		error = parse_dpdmux_method(
-			restool.cmd_option_args[CREATE_OPT_METHOD],
+			restool_cmd.option_args[CREATE_OPT_METHOD],
 			&dpdmux_cfg.method);
 		if (error < 0) {
 			DEBUG_PRINTF(
@@ -590,11 +564,11 @@ static int create_dpdmux(const char *usage_msg)
 		dpdmux_cfg.method = DPDMUX_METHOD_C_VLAN_MAC;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_MANIP)) {
-		restool.cmd_option_mask &=
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_MANIP)) {
+		restool_cmd.option_mask &=
 				~ONE_BIT_MASK(CREATE_OPT_MANIP);
 		error = parse_dpdmux_manip(
-				restool.cmd_option_args[CREATE_OPT_MANIP],
+				restool_cmd.option_args[CREATE_OPT_MANIP],
 				&dpdmux_cfg.manip);
 		if (error < 0) {
 			DEBUG_PRINTF(
@@ -606,10 +580,10 @@ static int create_dpdmux(const char *usage_msg)
 		dpdmux_cfg.manip = DPDMUX_MANIP_NONE;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_NUM_IFS)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_NUM_IFS);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_NUM_IFS)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_NUM_IFS);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_NUM_IFS];
+		str = restool_cmd.option_args[CREATE_OPT_NUM_IFS];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -621,14 +595,14 @@ static int create_dpdmux(const char *usage_msg)
 		dpdmux_cfg.num_ifs = (uint16_t)val;
 	} else {
 		ERROR_PRINTF("--num-ifs option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_CONTROL_IF)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_CONTROL_IF);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_CONTROL_IF)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_CONTROL_IF);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_CONTROL_IF];
+		str = restool_cmd.option_args[CREATE_OPT_CONTROL_IF];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -642,16 +616,16 @@ static int create_dpdmux(const char *usage_msg)
 		dpdmux_cfg.control_if = val;
 	} else {
 		ERROR_PRINTF("--control-if option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_MAX_DMAT_ENTRIES)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAX_DMAT_ENTRIES);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_DMAT_ENTRIES];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_DMAT_ENTRIES];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -665,12 +639,12 @@ static int create_dpdmux(const char *usage_msg)
 		dpdmux_cfg.adv.max_dmat_entries = 0;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_MAX_MC_GROUPS)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAX_MC_GROUPS);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_MC_GROUPS];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_MC_GROUPS];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -765,8 +739,13 @@ static int cmd_dpdmux_destroy(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpdmux destroy <dpdmux-object>\n"
+		"Usage: restool dpdmux destroy <dpdmux-object>|--label=<label>\n"
 		"   e.g. restool dpdmux destroy dpdmux.9\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpdmux-object>.\n"
+		"   <dpdmux-object> may also be given as label:<label>\n"
+		"   e.g. restool dpdmux destroy --label=my-dpdmux\n"
 		"\n";
 
 	int error;
@@ -774,27 +753,28 @@ static int cmd_dpdmux_destroy(void)
 	uint32_t dpdmux_id;
 	uint16_t dpdmux_handle;
 	bool dpdmux_opened = false;
+	enum mc_cmd_status mc_status;
 
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpdmux", &dpdmux_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpdmux", &dpdmux_id);
 	if (error < 0)
 		goto out;
 
@@ -803,7 +783,7 @@ static int cmd_dpdmux_destroy(void)
 		goto out;
 	}
 
-	error = dpdmux_open(&restool.mc_io, 0, dpdmux_id, &dpdmux_handle);
+	error = open_obj("dpdmux", dpdmux_id, &dpdmux_ops, &dpdmux_handle);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -827,11 +807,12 @@ static int cmd_dpdmux_destroy(void)
 		goto out;
 	}
 	dpdmux_opened = false;
-	printf("dpdmux.%u is destroyed\n", dpdmux_id);
+	mc_handle_forget(&restool.handles, "dpdmux", dpdmux_id);
+	restool_printf("dpdmux.%u is destroyed\n", dpdmux_id);
 
 out:
 	if (dpdmux_opened) {
-		error2 = dpdmux_close(&restool.mc_io, 0, dpdmux_handle);
+		error2 = close_obj(&dpdmux_ops, dpdmux_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
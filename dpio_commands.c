@@ -40,8 +40,6 @@
 #include "utils.h"
 #include "fsl_dpio.h"
 
-enum mc_cmd_status mc_status;
-
 /**
  * dpio info command options
  */
@@ -146,33 +144,18 @@ static int cmd_dpio_help(void)
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
-static int print_dpio_attr(uint32_t dpio_id,
-			struct dprc_obj_desc *target_obj_desc)
+static int print_dpio_attr(struct obj_info *info)
 {
-	uint16_t dpio_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dpio_id = info->desc.id;
+	uint16_t dpio_handle = info->handle;
 	int error;
 	struct dpio_attr dpio_attr;
-	bool dpio_opened = false;
-
-	error = dpio_open(&restool.mc_io, 0, dpio_id, &dpio_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
-	dpio_opened = true;
-	if (0 == dpio_handle) {
-		DEBUG_PRINTF(
-			"dpio_open() returned invalid handle (auth 0) for dpio.%u\n",
-			dpio_id);
-		error = -ENOENT;
-		goto out;
-	}
+	enum mc_cmd_status mc_status;
 
 	memset(&dpio_attr, 0, sizeof(dpio_attr));
 	error = dpio_get_attributes(&restool.mc_io, 0, dpio_handle, &dpio_attr);
@@ -184,86 +167,58 @@ static int print_dpio_attr(uint32_t dpio_id,
 	}
 	assert(dpio_id == (uint32_t)dpio_attr.id);
 
-	printf("dpio version: %u.%u\n", dpio_attr.version.major,
-	       dpio_attr.version.minor);
-	printf("dpio id: %d\n", dpio_attr.id);
-	printf("plugged state: %splugged\n",
+	restool_printf("dpio version: %u.%u\n", dpio_attr.version.major,
+		       dpio_attr.version.minor);
+	restool_printf("dpio id: %d\n", dpio_attr.id);
+	restool_printf("plugged state: %splugged\n",
 		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
-	printf(
+	restool_printf(
 		"offset of qbman software portal cache-enabled area: %#llx\n",
 		(unsigned long long)dpio_attr.qbman_portal_ce_offset);
-	printf(
+	restool_printf(
 		"offset of qbman software portal cache-inhibited area: %#llx\n",
 		(unsigned long long)dpio_attr.qbman_portal_ci_offset);
-	printf("qbman software portal id: %#x\n",
-	       (unsigned int)dpio_attr.qbman_portal_id);
-	printf("dpio channel mode is: ");
-	dpio_attr.channel_mode == 0 ? printf("DPIO_NO_CHANNEL\n") :
-	dpio_attr.channel_mode == 1 ? printf("DPIO_LOCAL_CHANNEL\n") :
-	printf("wrong mode\n");
-	printf("number of priorities is: %#x\n",
-	       (unsigned int)dpio_attr.num_priorities);
+	restool_printf("qbman software portal id: %#x\n",
+		       (unsigned int)dpio_attr.qbman_portal_id);
+	restool_printf("dpio channel mode is: ");
+	dpio_attr.channel_mode == 0 ? restool_printf("DPIO_NO_CHANNEL\n") :
+	dpio_attr.channel_mode == 1 ? restool_printf("DPIO_LOCAL_CHANNEL\n") :
+	restool_printf("wrong mode\n");
+	restool_printf("number of priorities is: %#x\n",
+		       (unsigned int)dpio_attr.num_priorities);
 	print_obj_label(target_obj_desc);
 
 	error = 0;
 
 out:
-	if (dpio_opened) {
-		int error2;
-
-		error2 = dpio_close(&restool.mc_io, 0, dpio_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
 	return error;
 }
 
 static int print_dpio_info(uint32_t dpio_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dpio_id,
-				"dpio", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (strcmp(target_obj_desc.type, "dpio")) {
-		printf("dpio.%d does not exist\n", dpio_id);
-		return -EINVAL;
-	}
-
-	error = print_dpio_attr(dpio_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
-
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dpio_ops);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-out:
-	return error;
+	return print_obj_info("dpio", dpio_id, &dpio_ops, print_dpio_attr,
+			      verbose);
 }
 
 static int cmd_dpio_info(void)
 {
 	static const char usage_msg[] =
 	"\n"
-	"Usage: restool dpio info <dpio-object> [--verbose]\n"
+	"Usage: restool dpio info <dpio-object>|--label=<label> [--verbose]\n"
 	"   e.g. restool dpio info dpio.5\n"
 	"\n"
+	"--label=<label>\n"
+	"   Names the object by its label, in place of <dpio-object>.\n"
+	"   <dpio-object> may also be given as label:<label>\n"
+	"   e.g. restool dpio info --label=my-dpio\n"
+	"\n"
 	"--verbose\n"
 	"   Shows extended/verbose information about the object\n"
 	"   e.g. restool dpio info dpio.5 --verbose\n"
@@ -272,21 +227,21 @@ static int cmd_dpio_info(void)
 	uint32_t obj_id;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpio", &obj_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpio", &obj_id);
 	if (error < 0)
 		goto out;
 
@@ -321,49 +276,50 @@ static int cmd_dpio_create(void)
 	struct dpio_cfg dpio_cfg;
 	uint16_t dpio_handle;
 	struct dpio_attr dpio_attr;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
-			     restool.obj_name);
-		printf(usage_msg);
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_CHANNEL_MODE)) {
-		restool.cmd_option_mask &=
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_CHANNEL_MODE)) {
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_CHANNEL_MODE);
-		if (strcmp(restool.cmd_option_args[CREATE_OPT_CHANNEL_MODE],
+		if (strcmp(restool_cmd.option_args[CREATE_OPT_CHANNEL_MODE],
 		    "DPIO_LOCAL_CHANNEL") == 0) {
 			dpio_cfg.channel_mode = DPIO_LOCAL_CHANNEL;
 		} else if (
-			strcmp(restool.cmd_option_args[CREATE_OPT_CHANNEL_MODE],
+			strcmp(restool_cmd.option_args[CREATE_OPT_CHANNEL_MODE],
 			"DPIO_NO_CHANNEL") == 0) {
 			dpio_cfg.channel_mode = DPIO_NO_CHANNEL;
 		} else {
 			ERROR_PRINTF("wrong channel mode\n");
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			return -EINVAL;
 		}
 	} else {
 		dpio_cfg.channel_mode = DPIO_LOCAL_CHANNEL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_NUM_PRIORITIES)) {
-		restool.cmd_option_mask &=
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_NUM_PRIORITIES)) {
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_NUM_PRIORITIES);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_NUM_PRIORITIES];
+		str = restool_cmd.option_args[CREATE_OPT_NUM_PRIORITIES];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
 		    (val < 1 || val > 8)) {
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			return -EINVAL;
 		}
 
@@ -405,8 +361,13 @@ static int cmd_dpio_destroy(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpio destroy <dpio-object>\n"
+		"Usage: restool dpio destroy <dpio-object>|--label=<label>\n"
 		"   e.g. restool dpio destroy dpio.9\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpio-object>.\n"
+		"   <dpio-object> may also be given as label:<label>\n"
+		"   e.g. restool dpio destroy --label=my-dpio\n"
 		"\n";
 
 	int error;
@@ -414,26 +375,27 @@ static int cmd_dpio_destroy(void)
 	uint32_t dpio_id;
 	uint16_t dpio_handle;
 	bool dpio_opened = false;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpio", &dpio_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpio", &dpio_id);
 	if (error < 0)
 		goto out;
 
@@ -442,7 +404,7 @@ static int cmd_dpio_destroy(void)
 		goto out;
 	}
 
-	error = dpio_open(&restool.mc_io, 0, dpio_id, &dpio_handle);
+	error = open_obj("dpio", dpio_id, &dpio_ops, &dpio_handle);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -466,11 +428,12 @@ static int cmd_dpio_destroy(void)
 		goto out;
 	}
 	dpio_opened = false;
-	printf("dpio.%u is destroyed\n", dpio_id);
+	mc_handle_forget(&restool.handles, "dpio", dpio_id);
+	restool_printf("dpio.%u is destroyed\n", dpio_id);
 
 out:
 	if (dpio_opened) {
-		error2 = dpio_close(&restool.mc_io, 0, dpio_handle);
+		error2 = close_obj(&dpio_ops, dpio_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
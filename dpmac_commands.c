@@ -39,8 +39,6 @@
 #include "utils.h"
 #include "fsl_dpmac.h"
 
-enum mc_cmd_status mc_status;
-
 /**
  * dpmac info command options
  */
@@ -137,7 +135,7 @@ static int cmd_dpmac_help(void)
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
@@ -147,6 +145,7 @@ static int print_dpmac_endpoint(uint32_t target_id)
 	struct dprc_endpoint endpoint2;
 	int state;
 	int error = 0;
+	enum mc_cmd_status mc_status;
 
 	memset(&endpoint1, 0, sizeof(struct dprc_endpoint));
 	memset(&endpoint2, 0, sizeof(struct dprc_endpoint));
@@ -159,27 +158,27 @@ static int print_dpmac_endpoint(uint32_t target_id)
 	error = dprc_get_connection(&restool.mc_io, 0,
 					restool.root_dprc_handle,
 					&endpoint1, &endpoint2, &state);
-	printf("endpoint state: %d\n", state);
+	restool_printf("endpoint state: %d\n", state);
 
 	if (error == 0 && state == -1) {
-		printf("endpoint: No object associated\n");
+		restool_printf("endpoint: No object associated\n");
 	} else if (error == 0) {
 		if (strcmp(endpoint2.type, "dpsw") == 0 ||
 		    strcmp(endpoint2.type, "dpdmux") == 0) {
-			printf("endpoint: %s.%d.%d",
+			restool_printf("endpoint: %s.%d.%d",
 				endpoint2.type, endpoint2.id,
 				endpoint2.if_id);
 		} else if (endpoint2.if_id == 0) {
-			printf("endpoint: %s.%d",
+			restool_printf("endpoint: %s.%d",
 				endpoint2.type, endpoint2.id);
 		}
 
 		if (state == 1)
-			printf(", link is up\n");
+			restool_printf(", link is up\n");
 		else if (state == 0)
-			printf(", link is down\n");
+			restool_printf(", link is down\n");
 		else
-			printf(", link is in error state\n");
+			restool_printf(", link is in error state\n");
 
 	} else {
 		mc_status = flib_error_to_mc_status(error);
@@ -193,19 +192,19 @@ static int print_dpmac_endpoint(uint32_t target_id)
 
 static void print_dpmac_link_type(enum dpmac_link_type link_type)
 {
-	printf("DPMAC link type: ");
+	restool_printf("DPMAC link type: ");
 	switch (link_type) {
 	case DPMAC_LINK_TYPE_NONE:
-		printf("DPMAC_LINK_TYPE_NONE\n");
+		restool_printf("DPMAC_LINK_TYPE_NONE\n");
 		break;
 	case DPMAC_LINK_TYPE_FIXED:
-		printf("DPMAC_LINK_TYPE_FIXED\n");
+		restool_printf("DPMAC_LINK_TYPE_FIXED\n");
 		break;
 	case DPMAC_LINK_TYPE_PHY:
-		printf("DPMAC_LINK_TYPE_PHY\n");
+		restool_printf("DPMAC_LINK_TYPE_PHY\n");
 		break;
 	case DPMAC_LINK_TYPE_BACKPLANE:
-		printf("DPMAC_LINK_TYPE_BACKPLANE\n");
+		restool_printf("DPMAC_LINK_TYPE_BACKPLANE\n");
 		break;
 	default:
 		assert(false);
@@ -215,34 +214,34 @@ static void print_dpmac_link_type(enum dpmac_link_type link_type)
 
 static void print_dpmac_eth_if(enum dpmac_eth_if eth_if)
 {
-	printf("DPMAC ethernet interface: ");
+	restool_printf("DPMAC ethernet interface: ");
 	switch (eth_if) {
 	case DPMAC_ETH_IF_MII:
-		printf("DPMAC_ETH_IF_MII\n");
+		restool_printf("DPMAC_ETH_IF_MII\n");
 		break;
 	case DPMAC_ETH_IF_RMII:
-		printf("DPMAC_ETH_IF_RMII\n");
+		restool_printf("DPMAC_ETH_IF_RMII\n");
 		break;
 	case DPMAC_ETH_IF_SMII:
-		printf("DPMAC_ETH_IF_SMII\n");
+		restool_printf("DPMAC_ETH_IF_SMII\n");
 		break;
 	case DPMAC_ETH_IF_GMII:
-		printf("DPMAC_ETH_IF_GMII\n");
+		restool_printf("DPMAC_ETH_IF_GMII\n");
 		break;
 	case DPMAC_ETH_IF_RGMII:
-		printf("DPMAC_ETH_IF_RGMII\n");
+		restool_printf("DPMAC_ETH_IF_RGMII\n");
 		break;
 	case DPMAC_ETH_IF_SGMII:
-		printf("DPMAC_ETH_IF_SGMII\n");
+		restool_printf("DPMAC_ETH_IF_SGMII\n");
 		break;
 	case DPMAC_ETH_IF_QSGMII:
-		printf("DPMAC_ETH_IF_QSGMII\n");
+		restool_printf("DPMAC_ETH_IF_QSGMII\n");
 		break;
 	case DPMAC_ETH_IF_XAUI:
-		printf("DPMAC_ETH_IF_XAUI\n");
+		restool_printf("DPMAC_ETH_IF_XAUI\n");
 		break;
 	case DPMAC_ETH_IF_XFI:
-		printf("DPMAC_ETH_IF_XFI\n");
+		restool_printf("DPMAC_ETH_IF_XFI\n");
 		break;
 	default:
 		assert(false);
@@ -250,29 +249,14 @@ static void print_dpmac_eth_if(enum dpmac_eth_if eth_if)
 	}
 }
 
-static int print_dpmac_attr(uint32_t dpmac_id,
-			struct dprc_obj_desc *target_obj_desc)
+static int print_dpmac_attr(struct obj_info *info)
 {
-	uint16_t dpmac_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dpmac_id = info->desc.id;
+	uint16_t dpmac_handle = info->handle;
 	int error;
 	struct dpmac_attr dpmac_attr;
-	bool dpmac_opened = false;
-
-	error = dpmac_open(&restool.mc_io, 0, dpmac_id, &dpmac_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
-	dpmac_opened = true;
-	if (0 == dpmac_handle) {
-		DEBUG_PRINTF(
-			"dpmac_open() returned invalid handle (auth 0) for dpmac.%u\n",
-			dpmac_id);
-		error = -ENOENT;
-		goto out;
-	}
+	enum mc_cmd_status mc_status;
 
 	memset(&dpmac_attr, 0, sizeof(dpmac_attr));
 	error = dpmac_get_attributes(&restool.mc_io, 0,
@@ -285,77 +269,49 @@ static int print_dpmac_attr(uint32_t dpmac_id,
 	}
 	assert(dpmac_id == (uint32_t)dpmac_attr.id);
 
-	printf("dpmac version: %u.%u\n", dpmac_attr.version.major,
-	       dpmac_attr.version.minor);
-	printf("dpmac object id/portal id: %d\n", dpmac_attr.id);
-	printf("plugged state: %splugged\n",
+	restool_printf("dpmac version: %u.%u\n", dpmac_attr.version.major,
+		       dpmac_attr.version.minor);
+	restool_printf("dpmac object id/portal id: %d\n", dpmac_attr.id);
+	restool_printf("plugged state: %splugged\n",
 		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
 	print_dpmac_endpoint(dpmac_id);
 	print_dpmac_link_type(dpmac_attr.link_type);
 	print_dpmac_eth_if(dpmac_attr.eth_if);
-	printf("maximum supported rate %lu Mbps\n",
+	restool_printf("maximum supported rate %lu Mbps\n",
 			(unsigned long)dpmac_attr.max_rate);
 	print_obj_label(target_obj_desc);
 
 	error = 0;
 
 out:
-	if (dpmac_opened) {
-		int error2;
-
-		error2 = dpmac_close(&restool.mc_io, 0, dpmac_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
 	return error;
 }
 
 static int print_dpmac_info(uint32_t dpmac_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dpmac_id,
-				"dpmac", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (strcmp(target_obj_desc.type, "dpmac")) {
-		printf("dpmac.%d does not exist\n", dpmac_id);
-		return -EINVAL;
-	}
-
-	error = print_dpmac_attr(dpmac_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
-
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dpmac_ops);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-out:
-	return error;
+	return print_obj_info("dpmac", dpmac_id, &dpmac_ops, print_dpmac_attr,
+			      verbose);
 }
 
 static int cmd_dpmac_info(void)
 {
 	static const char usage_msg[] =
 	"\n"
-	"Usage: restool dpmac info <dpmac-object> [--verbose]\n"
+	"Usage: restool dpmac info <dpmac-object>|--label=<label> [--verbose]\n"
 	"   e.g. restool dpmac info dpmac.5\n"
 	"\n"
+	"--label=<label>\n"
+	"   Names the object by its label, in place of <dpmac-object>.\n"
+	"   <dpmac-object> may also be given as label:<label>\n"
+	"   e.g. restool dpmac info --label=my-dpmac\n"
+	"\n"
 	"--verbose\n"
 	"   Shows extended/verbose information about the object\n"
 	"   e.g. restool dpmac info dpmac.5 --verbose\n"
@@ -364,21 +320,21 @@ static int cmd_dpmac_info(void)
 	uint32_t obj_id;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpmac", &obj_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpmac", &obj_id);
 	if (error < 0)
 		goto out;
 
@@ -405,37 +361,38 @@ static int cmd_dpmac_create(void)
 	struct dpmac_cfg dpmac_cfg;
 	uint16_t dpmac_handle;
 	struct dpmac_attr dpmac_attr;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
-			     restool.obj_name);
-		printf(usage_msg);
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_MAC_ID)) {
-		restool.cmd_option_mask &=
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_MAC_ID)) {
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAC_ID);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAC_ID];
+		str = restool_cmd.option_args[CREATE_OPT_MAC_ID];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
 		    (val < 0 || val > INT32_MAX)) {
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			return -EINVAL;
 		}
 
 		dpmac_cfg.mac_id = val;
 	} else {
 		ERROR_PRINTF("--mac-id option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
@@ -473,8 +430,13 @@ static int cmd_dpmac_destroy(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpmac destroy <dpmac-object>\n"
+		"Usage: restool dpmac destroy <dpmac-object>|--label=<label>\n"
 		"   e.g. restool dpmac destroy dpmac.9\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpmac-object>.\n"
+		"   <dpmac-object> may also be given as label:<label>\n"
+		"   e.g. restool dpmac destroy --label=my-dpmac\n"
 		"\n";
 
 	int error;
@@ -482,26 +444,27 @@ static int cmd_dpmac_destroy(void)
 	uint32_t dpmac_id;
 	uint16_t dpmac_handle;
 	bool dpmac_opened = false;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpmac", &dpmac_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpmac", &dpmac_id);
 	if (error < 0)
 		goto out;
 
@@ -510,7 +473,7 @@ static int cmd_dpmac_destroy(void)
 		goto out;
 	}
 
-	error = dpmac_open(&restool.mc_io, 0, dpmac_id, &dpmac_handle);
+	error = open_obj("dpmac", dpmac_id, &dpmac_ops, &dpmac_handle);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -534,11 +497,12 @@ static int cmd_dpmac_destroy(void)
 		goto out;
 	}
 	dpmac_opened = false;
-	printf("dpmac.%u is destroyed\n", dpmac_id);
+	mc_handle_forget(&restool.handles, "dpmac", dpmac_id);
+	restool_printf("dpmac.%u is destroyed\n", dpmac_id);
 
 out:
 	if (dpmac_opened) {
-		error2 = dpmac_close(&restool.mc_io, 0, dpmac_handle);
+		error2 = close_obj(&dpmac_ops, dpmac_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -39,8 +39,6 @@
 #include "utils.h"
 #include "fsl_dpmcp.h"
 
-enum mc_cmd_status mc_status;
-
 /**
  * dpmcp info command options
  */
@@ -129,33 +127,18 @@ static int cmd_dpmcp_help(void)
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
-static int print_dpmcp_attr(uint32_t dpmcp_id,
-			struct dprc_obj_desc *target_obj_desc)
+static int print_dpmcp_attr(struct obj_info *info)
 {
-	uint16_t dpmcp_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dpmcp_id = info->desc.id;
+	uint16_t dpmcp_handle = info->handle;
 	int error;
 	struct dpmcp_attr dpmcp_attr;
-	bool dpmcp_opened = false;
-
-	error = dpmcp_open(&restool.mc_io, 0, dpmcp_id, &dpmcp_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
-	dpmcp_opened = true;
-	if (0 == dpmcp_handle) {
-		DEBUG_PRINTF(
-			"dpmcp_open() returned invalid handle (auth 0) for dpmcp.%u\n",
-			dpmcp_id);
-		error = -ENOENT;
-		goto out;
-	}
+	enum mc_cmd_status mc_status;
 
 	memset(&dpmcp_attr, 0, sizeof(dpmcp_attr));
 	error = dpmcp_get_attributes(&restool.mc_io, 0, dpmcp_handle,
@@ -168,72 +151,44 @@ static int print_dpmcp_attr(uint32_t dpmcp_id,
 	}
 	assert(dpmcp_id == (uint32_t)dpmcp_attr.id);
 
-	printf("dpmcp version: %u.%u\n", dpmcp_attr.version.major,
-	       dpmcp_attr.version.minor);
-	printf("dpmcp object id/portal id: %d\n", dpmcp_attr.id);
-	printf("plugged state: %splugged\n",
+	restool_printf("dpmcp version: %u.%u\n", dpmcp_attr.version.major,
+		       dpmcp_attr.version.minor);
+	restool_printf("dpmcp object id/portal id: %d\n", dpmcp_attr.id);
+	restool_printf("plugged state: %splugged\n",
 		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
 	print_obj_label(target_obj_desc);
 
 	error = 0;
 
 out:
-	if (dpmcp_opened) {
-		int error2;
-
-		error2 = dpmcp_close(&restool.mc_io, 0, dpmcp_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
 	return error;
 }
 
 static int print_dpmcp_info(uint32_t dpmcp_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dpmcp_id,
-				"dpmcp", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (strcmp(target_obj_desc.type, "dpmcp")) {
-		printf("dpmcp.%d does not exist\n", dpmcp_id);
-		return -EINVAL;
-	}
-
-	error = print_dpmcp_attr(dpmcp_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
-
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dpmcp_ops);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-out:
-	return error;
+	return print_obj_info("dpmcp", dpmcp_id, &dpmcp_ops, print_dpmcp_attr,
+			      verbose);
 }
 
 static int cmd_dpmcp_info(void)
 {
 	static const char usage_msg[] =
 	"\n"
-	"Usage: restool dpmcp info <dpmcp-object> [--verbose]\n"
+	"Usage: restool dpmcp info <dpmcp-object>|--label=<label> [--verbose]\n"
 	"   e.g. restool dpmcp info dpmcp.5\n"
 	"\n"
+	"--label=<label>\n"
+	"   Names the object by its label, in place of <dpmcp-object>.\n"
+	"   <dpmcp-object> may also be given as label:<label>\n"
+	"   e.g. restool dpmcp info --label=my-dpmcp\n"
+	"\n"
 	"--verbose\n"
 	"   Shows extended/verbose information about the object\n"
 	"   e.g. restool dpmcp info dpmcp.5 --verbose\n"
@@ -242,21 +197,21 @@ static int cmd_dpmcp_info(void)
 	uint32_t obj_id;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpmcp", &obj_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpmcp", &obj_id);
 	if (error < 0)
 		goto out;
 
@@ -279,17 +234,18 @@ static int cmd_dpmcp_create(void)
 	struct dpmcp_cfg dpmcp_cfg = {0};
 	uint16_t dpmcp_handle;
 	struct dpmcp_attr dpmcp_attr;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
-			     restool.obj_name);
-		printf(usage_msg);
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
@@ -329,8 +285,13 @@ static int cmd_dpmcp_destroy(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpmcp destroy <dpmcp-object>\n"
+		"Usage: restool dpmcp destroy <dpmcp-object>|--label=<label>\n"
 		"   e.g. restool dpmcp destroy dpmcp.9\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpmcp-object>.\n"
+		"   <dpmcp-object> may also be given as label:<label>\n"
+		"   e.g. restool dpmcp destroy --label=my-dpmcp\n"
 		"\n";
 
 	int error;
@@ -338,26 +299,27 @@ static int cmd_dpmcp_destroy(void)
 	uint32_t dpmcp_id;
 	uint16_t dpmcp_handle;
 	bool dpmcp_opened = false;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpmcp", &dpmcp_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpmcp", &dpmcp_id);
 	if (error < 0)
 		goto out;
 
@@ -366,7 +328,7 @@ static int cmd_dpmcp_destroy(void)
 		goto out;
 	}
 
-	error = dpmcp_open(&restool.mc_io, 0, dpmcp_id, &dpmcp_handle);
+	error = open_obj("dpmcp", dpmcp_id, &dpmcp_ops, &dpmcp_handle);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -390,11 +352,12 @@ static int cmd_dpmcp_destroy(void)
 		goto out;
 	}
 	dpmcp_opened = false;
-	printf("dpmcp.%u is destroyed\n", dpmcp_id);
+	mc_handle_forget(&restool.handles, "dpmcp", dpmcp_id);
+	restool_printf("dpmcp.%u is destroyed\n", dpmcp_id);
 
 out:
 	if (dpmcp_opened) {
-		error2 = dpmcp_close(&restool.mc_io, 0, dpmcp_handle);
+		error2 = close_obj(&dpmcp_ops, dpmcp_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -26,6 +26,7 @@
 #include <errno.h>
 #include "fsl_mc_sys.h"
 #include "fsl_mc_cmd.h"
+#include "mc_async.h"
 #include "fsl_dpni.h"
 #include "fsl_dpni_cmd.h"
 
@@ -478,6 +479,39 @@ int dpni_get_attributes(struct fsl_mc_io *mc_io,
 	return 0;
 }
 
+int dpni_get_attributes_async(struct mc_async *async,
+			      struct fsl_mc_io *mc_io,
+			      uint32_t cmd_flags,
+			      uint16_t token,
+			      struct mc_ticket *ticket)
+{
+	/* prepare command */
+	ticket->cmd = (struct mc_command){ 0 };
+	ticket->cmd.header = mc_encode_cmd_header(DPNI_CMDID_GET_ATTR,
+						  cmd_flags,
+						  token);
+
+	/* submit command to mc*/
+	return mc_async_submit(async, mc_io, ticket);
+}
+
+int dpni_get_attributes_complete(struct mc_async *async,
+				 struct mc_ticket *ticket,
+				 struct dpni_attr *attr)
+{
+	int err;
+
+	/* wait for the response */
+	err = mc_async_wait(async, ticket);
+	if (err)
+		return err;
+
+	/* retrieve response parameters */
+	DPNI_RSP_GET_ATTR(ticket->cmd, attr);
+
+	return 0;
+}
+
 int dpni_set_errors_behavior(struct fsl_mc_io *mc_io,
 			     uint32_t cmd_flags,
 			     uint16_t token,
@@ -857,6 +891,39 @@ int dpni_get_link_state(struct fsl_mc_io *mc_io,
 	return 0;
 }
 
+int dpni_get_link_state_async(struct mc_async *async,
+			      struct fsl_mc_io *mc_io,
+			      uint32_t cmd_flags,
+			      uint16_t token,
+			      struct mc_ticket *ticket)
+{
+	/* prepare command */
+	ticket->cmd = (struct mc_command){ 0 };
+	ticket->cmd.header = mc_encode_cmd_header(DPNI_CMDID_GET_LINK_STATE,
+						  cmd_flags,
+						  token);
+
+	/* submit command to mc*/
+	return mc_async_submit(async, mc_io, ticket);
+}
+
+int dpni_get_link_state_complete(struct mc_async *async,
+				 struct mc_ticket *ticket,
+				 struct dpni_link_state *state)
+{
+	int err;
+
+	/* wait for the response */
+	err = mc_async_wait(async, ticket);
+	if (err)
+		return err;
+
+	/* retrieve response parameters */
+	DPNI_RSP_GET_LINK_STATE(ticket->cmd, state);
+
+	return 0;
+}
+
 int dpni_set_tx_shaping(struct fsl_mc_io *mc_io,
 			uint32_t cmd_flags,
 			uint16_t token,
@@ -1079,6 +1146,39 @@ int dpni_get_primary_mac_addr(struct fsl_mc_io *mc_io,
 	return 0;
 }
 
+int dpni_get_primary_mac_addr_async(struct mc_async *async,
+				    struct fsl_mc_io *mc_io,
+				    uint32_t cmd_flags,
+				    uint16_t token,
+				    struct mc_ticket *ticket)
+{
+	/* prepare command */
+	ticket->cmd = (struct mc_command){ 0 };
+	ticket->cmd.header = mc_encode_cmd_header(DPNI_CMDID_GET_PRIM_MAC,
+						  cmd_flags,
+						  token);
+
+	/* submit command to mc*/
+	return mc_async_submit(async, mc_io, ticket);
+}
+
+int dpni_get_primary_mac_addr_complete(struct mc_async *async,
+				       struct mc_ticket *ticket,
+				       uint8_t mac_addr[6])
+{
+	int err;
+
+	/* wait for the response */
+	err = mc_async_wait(async, ticket);
+	if (err)
+		return err;
+
+	/* retrieve response parameters */
+	DPNI_RSP_GET_PRIMARY_MAC_ADDR(ticket->cmd, mac_addr);
+
+	return 0;
+}
+
 int dpni_add_mac_addr(struct fsl_mc_io *mc_io,
 		      uint32_t cmd_flags,
 		      uint16_t token,
@@ -55,8 +55,6 @@
 	DPNI_OPT_QOS_MASK_SUPPORT |			\
 	DPNI_OPT_FS_MASK_SUPPORT)
 
-enum mc_cmd_status mc_status;
-
 /**
  * dpni info command options
  */
@@ -233,96 +231,105 @@ static int cmd_dpni_help(void)
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
 static void print_dpni_options(uint32_t options)
 {
 	if (options == 0 || (options & ~ALL_DPNI_OPTS) != 0) {
-		printf("\tUnrecognized options found...\n");
+		restool_printf("\tUnrecognized options found...\n");
 		return;
 	}
 
 	if (options & DPNI_OPT_ALLOW_DIST_KEY_PER_TC)
-		printf("\tDPNI_OPT_ALLOW_DIST_KEY_PER_TC\n");
+		restool_printf("\tDPNI_OPT_ALLOW_DIST_KEY_PER_TC\n");
 
 	if (options & DPNI_OPT_TX_CONF_DISABLED)
-		printf("\tDPNI_OPT_TX_CONF_DISABLED\n");
+		restool_printf("\tDPNI_OPT_TX_CONF_DISABLED\n");
 
 	if (options & DPNI_OPT_PRIVATE_TX_CONF_ERROR_DISABLED)
-		printf("\tDPNI_OPT_PRIVATE_TX_CONF_ERROR_DISABLED\n");
+		restool_printf("\tDPNI_OPT_PRIVATE_TX_CONF_ERROR_DISABLED\n");
 
 	if (options & DPNI_OPT_DIST_HASH)
-		printf("\tDPNI_OPT_DIST_HASH\n");
+		restool_printf("\tDPNI_OPT_DIST_HASH\n");
 
 	if (options & DPNI_OPT_DIST_FS)
-		printf("\tDPNI_OPT_DIST_FS\n");
+		restool_printf("\tDPNI_OPT_DIST_FS\n");
 
 	if (options & DPNI_OPT_UNICAST_FILTER)
-		printf("\tDPNI_OPT_UNICAST_FILTER\n");
+		restool_printf("\tDPNI_OPT_UNICAST_FILTER\n");
 
 	if (options & DPNI_OPT_MULTICAST_FILTER)
-		printf("\tDPNI_OPT_MULTICAST_FILTER\n");
+		restool_printf("\tDPNI_OPT_MULTICAST_FILTER\n");
 
 	if (options & DPNI_OPT_VLAN_FILTER)
-		printf("\tDPNI_OPT_VLAN_FILTER\n");
+		restool_printf("\tDPNI_OPT_VLAN_FILTER\n");
 
 	if (options & DPNI_OPT_IPR)
-		printf("\tDPNI_OPT_IPR\n");
+		restool_printf("\tDPNI_OPT_IPR\n");
 
 	if (options & DPNI_OPT_IPF)
-		printf("\tDPNI_OPT_IPF\n");
+		restool_printf("\tDPNI_OPT_IPF\n");
 
 	if (options & DPNI_OPT_VLAN_MANIPULATION)
-		printf("\tDPNI_OPT_VLAN_MANIPULATION\n");
+		restool_printf("\tDPNI_OPT_VLAN_MANIPULATION\n");
 
 	if (options & DPNI_OPT_QOS_MASK_SUPPORT)
-		printf("\tDPNI_OPT_QOS_MASK_SUPPORT\n");
+		restool_printf("\tDPNI_OPT_QOS_MASK_SUPPORT\n");
 
 	if (options & DPNI_OPT_FS_MASK_SUPPORT)
-		printf("\tDPNI_OPT_FS_MASK_SUPPORT\n");
+		restool_printf("\tDPNI_OPT_FS_MASK_SUPPORT\n");
 }
 
-static int print_dpni_endpoint(uint32_t target_id)
+static int submit_dpni_endpoint(uint32_t target_id, struct mc_ticket *ticket)
 {
 	struct dprc_endpoint endpoint1;
-	struct dprc_endpoint endpoint2;
-	int state;
-	int error = 0;
 
 	memset(&endpoint1, 0, sizeof(struct dprc_endpoint));
-	memset(&endpoint2, 0, sizeof(struct dprc_endpoint));
 
 	strncpy(endpoint1.type, "dpni", EP_OBJ_TYPE_MAX_LEN);
 	endpoint1.type[EP_OBJ_TYPE_MAX_LEN] = '\0';
 	endpoint1.id = target_id;
 	endpoint1.if_id = 0;
 
-	error = dprc_get_connection(&restool.mc_io, 0,
-					restool.root_dprc_handle,
-					&endpoint1, &endpoint2, &state);
-	printf("endpoint state: %d\n", state);
+	return dprc_get_connection_async(&restool.mc_async, &restool.mc_io, 0,
+					 restool.root_dprc_handle, &endpoint1,
+					 ticket);
+}
+
+static int print_dpni_endpoint(struct mc_ticket *ticket)
+{
+	struct dprc_endpoint endpoint2;
+	int state = -1;
+	int error = 0;
+	enum mc_cmd_status mc_status;
+
+	memset(&endpoint2, 0, sizeof(struct dprc_endpoint));
+
+	error = dprc_get_connection_complete(&restool.mc_async, ticket,
+					     &endpoint2, &state);
+	restool_printf("endpoint state: %d\n", state);
 
 	if (error == 0 && state == -1) {
-		printf("endpoint: No object associated\n");
+		restool_printf("endpoint: No object associated\n");
 	} else if (error == 0) {
 		if (strcmp(endpoint2.type, "dpsw") == 0 ||
 		    strcmp(endpoint2.type, "dpdmux") == 0) {
-			printf("endpoint: %s.%d.%d",
+			restool_printf("endpoint: %s.%d.%d",
 				endpoint2.type, endpoint2.id,
 				endpoint2.if_id);
 		} else if (endpoint2.if_id == 0) {
-			printf("endpoint: %s.%d",
+			restool_printf("endpoint: %s.%d",
 				endpoint2.type, endpoint2.id);
 		}
 
 		if (state == 1)
-			printf(", link is up\n");
+			restool_printf(", link is up\n");
 		else if (state == 0)
-			printf(", link is down\n");
+			restool_printf(", link is down\n");
 		else
-			printf(", link is in error state\n");
+			restool_printf(", link is in error state\n");
 
 	} else {
 		mc_status = flib_error_to_mc_status(error);
@@ -334,34 +341,49 @@ static int print_dpni_endpoint(uint32_t target_id)
 	return 0;
 }
 
-static int print_dpni_attr(uint32_t dpni_id,
-			struct dprc_obj_desc *target_obj_desc)
+static int print_dpni_attr(struct obj_info *info)
 {
-	uint16_t dpni_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dpni_id = info->desc.id;
+	uint16_t dpni_handle = info->handle;
 	int error;
 	struct dpni_attr dpni_attr;
 	uint8_t mac_addr[6];
-	bool dpni_opened = false;
 	struct dpni_link_state link_state;
+	struct mc_ticket attr_ticket = { 0 };
+	struct mc_ticket endpoint_ticket = { 0 };
+	struct mc_ticket link_state_ticket = { 0 };
+	struct mc_ticket mac_addr_ticket = { 0 };
+	enum mc_cmd_status mc_status;
+
+	/*
+	 * Keep all queries in flight at once, submitted in the order their
+	 * results are printed, so that each result is printed while the MC
+	 * still processes the following queries
+	 */
+	error = dpni_get_attributes_async(&restool.mc_async, &restool.mc_io,
+					  0, dpni_handle, &attr_ticket);
+	if (error < 0)
+		goto out;
 
-	error = dpni_open(&restool.mc_io, 0, dpni_id, &dpni_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
+	error = submit_dpni_endpoint(dpni_id, &endpoint_ticket);
+	if (error < 0)
 		goto out;
-	}
-	dpni_opened = true;
-	if (0 == dpni_handle) {
-		DEBUG_PRINTF(
-			"dpni_open() returned invalid handle (auth 0) for dpni.%u\n",
-			dpni_id);
-		error = -ENOENT;
+
+	error = dpni_get_link_state_async(&restool.mc_async, &restool.mc_io,
+					  0, dpni_handle, &link_state_ticket);
+	if (error < 0)
+		goto out;
+
+	error = dpni_get_primary_mac_addr_async(&restool.mc_async,
+						&restool.mc_io, 0, dpni_handle,
+						&mac_addr_ticket);
+	if (error < 0)
 		goto out;
-	}
 
 	memset(&dpni_attr, 0, sizeof(dpni_attr));
-	error = dpni_get_attributes(&restool.mc_io, 0, dpni_handle, &dpni_attr);
+	error = dpni_get_attributes_complete(&restool.mc_async, &attr_ticket,
+					     &dpni_attr);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -371,8 +393,16 @@ static int print_dpni_attr(uint32_t dpni_id,
 	assert(dpni_id == (uint32_t)dpni_attr.id);
 	assert(DPNI_MAX_TC >= dpni_attr.max_tcs);
 
-	error = dpni_get_primary_mac_addr(&restool.mc_io, 0,
-					dpni_handle, mac_addr);
+	restool_printf("dpni version: %u.%u\n", dpni_attr.version.major,
+		       dpni_attr.version.minor);
+	restool_printf("dpni id: %d\n", dpni_attr.id);
+	restool_printf("plugged state: %splugged\n",
+		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
+	print_dpni_endpoint(&endpoint_ticket);
+
+	memset(&link_state, 0, sizeof(link_state));
+	error = dpni_get_link_state_complete(&restool.mc_async,
+					     &link_state_ticket, &link_state);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -380,9 +410,13 @@ static int print_dpni_attr(uint32_t dpni_id,
 		goto out;
 	}
 
-	memset(&link_state, 0, sizeof(link_state));
-	error = dpni_get_link_state(&restool.mc_io, 0, dpni_handle,
-					&link_state);
+	restool_printf("link status: %d - ", link_state.up);
+	link_state.up == 0 ? restool_printf("down\n") :
+	link_state.up == 1 ? restool_printf("up\n") :
+			     restool_printf("error state\n");
+
+	error = dpni_get_primary_mac_addr_complete(&restool.mc_async,
+						   &mac_addr_ticket, mac_addr);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -390,98 +424,69 @@ static int print_dpni_attr(uint32_t dpni_id,
 		goto out;
 	}
 
-	printf("dpni version: %u.%u\n", dpni_attr.version.major,
-	       dpni_attr.version.minor);
-	printf("dpni id: %d\n", dpni_attr.id);
-	printf("plugged state: %splugged\n",
-		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
-	print_dpni_endpoint(dpni_id);
-	printf("link status: %d - ", link_state.up);
-	link_state.up == 0 ? printf("down\n") :
-	link_state.up == 1 ? printf("up\n") : printf("error state\n");
-	printf("mac address: ");
+	restool_printf("mac address: ");
 	for (int j = 0; j < 5; ++j)
-		printf("%02x:", mac_addr[j]);
-	printf("%02x\n", mac_addr[5]);
-	printf("dpni_attr.options value is: %#lx\n",
-	       (unsigned long)dpni_attr.options);
+		restool_printf("%02x:", mac_addr[j]);
+	restool_printf("%02x\n", mac_addr[5]);
+	restool_printf("dpni_attr.options value is: %#lx\n",
+		       (unsigned long)dpni_attr.options);
 	print_dpni_options(dpni_attr.options);
-	printf("max senders: %u\n", (uint32_t)dpni_attr.max_senders);
-	printf("max traffic classes: %u\n", (uint32_t)dpni_attr.max_tcs);
-	printf("max distribution's size per RX traffic class:\n");
+	restool_printf("max senders: %u\n", (uint32_t)dpni_attr.max_senders);
+	restool_printf("max traffic classes: %u\n", (uint32_t)dpni_attr.max_tcs);
+	restool_printf("max distribution's size per RX traffic class:\n");
 	for (int k = 0; k < dpni_attr.max_tcs; ++k)
-		printf("\tclass %d's size: %u\n", k,
-		       (uint32_t)dpni_attr.max_dist_per_tc[k]);
-	printf("max unicast filters: %u\n",
-	       (uint32_t)dpni_attr.max_unicast_filters);
-	printf("max multicast filters: %u\n",
-	       (uint32_t)dpni_attr.max_multicast_filters);
-	printf("max vlan filters: %u\n", (uint32_t)dpni_attr.max_vlan_filters);
-	printf("max QoS entries: %u\n", (uint32_t)dpni_attr.max_qos_entries);
-	printf("max QoS key size: %u\n", (uint32_t)dpni_attr.max_qos_key_size);
-	printf("max distribution key size: %u\n",
-	       (uint32_t)dpni_attr.max_dist_key_size);
+		restool_printf("\tclass %d's size: %u\n", k,
+			       (uint32_t)dpni_attr.max_dist_per_tc[k]);
+	restool_printf("max unicast filters: %u\n",
+		       (uint32_t)dpni_attr.max_unicast_filters);
+	restool_printf("max multicast filters: %u\n",
+		       (uint32_t)dpni_attr.max_multicast_filters);
+	restool_printf("max vlan filters: %u\n", (uint32_t)dpni_attr.max_vlan_filters);
+	restool_printf("max QoS entries: %u\n", (uint32_t)dpni_attr.max_qos_entries);
+	restool_printf("max QoS key size: %u\n", (uint32_t)dpni_attr.max_qos_key_size);
+	restool_printf("max distribution key size: %u\n",
+		       (uint32_t)dpni_attr.max_dist_key_size);
 	print_obj_label(target_obj_desc);
 
 	error = 0;
 
 out:
-	if (dpni_opened) {
-		int error2;
-
-		error2 = dpni_close(&restool.mc_io, 0, dpni_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
+	/*
+	 * Collect the queries still in flight before closing the object
+	 */
+	(void)mc_async_wait(&restool.mc_async, &attr_ticket);
+	(void)mc_async_wait(&restool.mc_async, &endpoint_ticket);
+	(void)mc_async_wait(&restool.mc_async, &link_state_ticket);
+	(void)mc_async_wait(&restool.mc_async, &mac_addr_ticket);
 
 	return error;
 }
 
 static int print_dpni_info(uint32_t dpni_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dpni_id,
-				"dpni", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
-
-	if (strcmp(target_obj_desc.type, "dpni")) {
-		printf("dpni.%d does not exist\n", dpni_id);
-		return -EINVAL;
-	}
-
-	error = print_dpni_attr(dpni_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dpni_ops);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-out:
-	return error;
+	return print_obj_info("dpni", dpni_id, &dpni_ops, print_dpni_attr,
+			      verbose);
 }
 
 static int cmd_dpni_info(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpni info <dpni-object> [--verbose]\n"
+		"Usage: restool dpni info <dpni-object>|--label=<label> [--verbose]\n"
 		"   e.g. restool dpni info dpni.7\n"
 		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpni-object>.\n"
+		"   <dpni-object> may also be given as label:<label>\n"
+		"   e.g. restool dpni info --label=my-dpni\n"
+		"\n"
 		"--verbose\n"
 		"   Shows extended/verbose information about the object\n"
 		"   e.g. restool dpni info dpni.7 --verbose\n"
@@ -490,21 +495,21 @@ static int cmd_dpni_info(void)
 	uint32_t obj_id;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpni", &obj_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpni", &obj_id);
 	if (error < 0)
 		goto out;
 
@@ -658,26 +663,27 @@ static int create_dpni(const char *usage_msg)
 	char *str;
 	char *endptr;
 	struct dpni_attr dpni_attr;
+	enum mc_cmd_status mc_status;
 
 	memset(&dpni_cfg, 0, sizeof(dpni_cfg));
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
-			     restool.obj_name);
-		printf(usage_msg);
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_OPTIONS)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_OPTIONS);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_OPTIONS)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_OPTIONS);
 		error = parse_dpni_create_options(
-				restool.cmd_option_args[CREATE_OPT_OPTIONS],
+				restool_cmd.option_args[CREATE_OPT_OPTIONS],
 				&dpni_cfg.adv.options);
 		if (error < 0) {
 			DEBUG_PRINTF(
@@ -690,15 +696,15 @@ static int create_dpni(const char *usage_msg)
 				       DPNI_OPT_MULTICAST_FILTER;
 	}
 
-	if (!(restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_MAC_ADDR))) {
+	if (!(restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_MAC_ADDR))) {
 		ERROR_PRINTF("--mac-addr option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_MAC_ADDR);
+	restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_MAC_ADDR);
 	error  = parse_dpni_mac_addr(
-			restool.cmd_option_args[CREATE_OPT_MAC_ADDR],
+			restool_cmd.option_args[CREATE_OPT_MAC_ADDR],
 			dpni_cfg.mac_addr);
 	if (error < 0) {
 		DEBUG_PRINTF(
@@ -707,10 +713,10 @@ static int create_dpni(const char *usage_msg)
 		return error;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_MAX_TCS)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_MAX_TCS);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_MAX_TCS)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_MAX_TCS);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_TCS];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_TCS];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -724,12 +730,12 @@ static int create_dpni(const char *usage_msg)
 		dpni_cfg.adv.max_tcs = 1; /* set default value 1 */
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_MAX_DIST_PER_TC)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAX_DIST_PER_TC);
 		error = parse_dpni_max_dist_per_tc(
-			restool.cmd_option_args[CREATE_OPT_MAX_DIST_PER_TC],
+			restool_cmd.option_args[CREATE_OPT_MAX_DIST_PER_TC],
 			dpni_cfg.adv.max_dist_per_tc,
 			dpni_cfg.adv.max_tcs);
 		if (error < 0) {
@@ -748,11 +754,11 @@ static int create_dpni(const char *usage_msg)
 		}
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_MAX_SENDERS)) {
-		restool.cmd_option_mask &=
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_MAX_SENDERS)) {
+		restool_cmd.option_mask &=
 				~ONE_BIT_MASK(CREATE_OPT_MAX_SENDERS);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_SENDERS];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_SENDERS];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -766,12 +772,12 @@ static int create_dpni(const char *usage_msg)
 		dpni_cfg.adv.max_senders = 1;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_MAX_UNICAST_FILTERS)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAX_UNICAST_FILTERS);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_UNICAST_FILTERS];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_UNICAST_FILTERS];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -785,12 +791,12 @@ static int create_dpni(const char *usage_msg)
 		dpni_cfg.adv.max_unicast_filters = 0;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_MAX_MULTICAST_FILTERS)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAX_MULTICAST_FILTERS);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_MULTICAST_FILTERS];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_MULTICAST_FILTERS];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -804,12 +810,12 @@ static int create_dpni(const char *usage_msg)
 		dpni_cfg.adv.max_multicast_filters = 0;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_MAX_VLAN_FILTERS)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAX_VLAN_FILTERS);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_VLAN_FILTERS];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_VLAN_FILTERS];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -823,12 +829,12 @@ static int create_dpni(const char *usage_msg)
 		dpni_cfg.adv.max_vlan_filters = 0;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_MAX_QOS_ENTRIES)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAX_QOS_ENTRIES);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_QOS_ENTRIES];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_QOS_ENTRIES];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -842,12 +848,12 @@ static int create_dpni(const char *usage_msg)
 		dpni_cfg.adv.max_qos_entries = 0;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_MAX_QOS_KEY_SIZE)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAX_QOS_KEY_SIZE);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_QOS_KEY_SIZE];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_QOS_KEY_SIZE];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -861,15 +867,15 @@ static int create_dpni(const char *usage_msg)
 		dpni_cfg.adv.max_qos_key_size = 0;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_MAX_DIST_KEY_SIZE)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAX_DIST_KEY_SIZE);
 		dpni_cfg.adv.max_dist_key_size = (uint8_t)strtol(
-			restool.cmd_option_args[CREATE_OPT_MAX_DIST_KEY_SIZE],
+			restool_cmd.option_args[CREATE_OPT_MAX_DIST_KEY_SIZE],
 			(char **)NULL, 0);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_DIST_KEY_SIZE];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_DIST_KEY_SIZE];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -974,8 +980,13 @@ static int cmd_dpni_destroy(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpni destroy <dpni-object>\n"
+		"Usage: restool dpni destroy <dpni-object>|--label=<label>\n"
 		"   e.g. restool dpni destroy dpni.9\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpni-object>.\n"
+		"   <dpni-object> may also be given as label:<label>\n"
+		"   e.g. restool dpni destroy --label=my-dpni\n"
 		"\n";
 
 	int error;
@@ -983,27 +994,28 @@ static int cmd_dpni_destroy(void)
 	uint32_t dpni_id;
 	uint16_t dpni_handle;
 	bool dpni_opened = false;
+	enum mc_cmd_status mc_status;
 
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpni", &dpni_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpni", &dpni_id);
 	if (error < 0)
 		goto out;
 
@@ -1012,7 +1024,7 @@ static int cmd_dpni_destroy(void)
 		goto out;
 	}
 
-	error = dpni_open(&restool.mc_io, 0, dpni_id, &dpni_handle);
+	error = open_obj("dpni", dpni_id, &dpni_ops, &dpni_handle);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -1036,11 +1048,12 @@ static int cmd_dpni_destroy(void)
 		goto out;
 	}
 	dpni_opened = false;
-	printf("dpni.%u is destroyed\n", dpni_id);
+	mc_handle_forget(&restool.handles, "dpni", dpni_id);
+	restool_printf("dpni.%u is destroyed\n", dpni_id);
 
 out:
 	if (dpni_opened) {
-		error2 = dpni_close(&restool.mc_io, 0, dpni_handle);
+		error2 = close_obj(&dpni_ops, dpni_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -23,8 +23,10 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
+#include <errno.h>
 #include "fsl_mc_sys.h"
 #include "fsl_mc_cmd.h"
+#include "mc_async.h"
 #include "fsl_dprc.h"
 #include "fsl_dprc_cmd.h"
 
@@ -535,6 +537,49 @@ int dprc_get_obj(struct fsl_mc_io *mc_io,
 	return 0;
 }
 
+int dprc_get_objs(struct fsl_mc_io *mc_io,
+		  uint32_t cmd_flags,
+		  uint16_t token,
+		  int first_index,
+		  int num_objs,
+		  struct dprc_obj_desc *obj_descs)
+{
+	struct mc_command cmds[DPRC_GET_OBJS_BATCH_SIZE];
+	int status[DPRC_GET_OBJS_BATCH_SIZE];
+	int i, j, n;
+	int err;
+
+	for (i = 0; i < num_objs; i += n) {
+		n = num_objs - i;
+		if (n > DPRC_GET_OBJS_BATCH_SIZE)
+			n = DPRC_GET_OBJS_BATCH_SIZE;
+
+		/* prepare commands */
+		for (j = 0; j < n; j++) {
+			cmds[j] = (struct mc_command){ 0 };
+			cmds[j].header = mc_encode_cmd_header(
+						DPRC_CMDID_GET_OBJ,
+						cmd_flags,
+						token);
+			DPRC_CMD_GET_OBJ(cmds[j], first_index + i + j);
+		}
+
+		/* send commands to mc*/
+		err = mc_send_commands(mc_io, cmds, n, status);
+		if (err)
+			return err;
+
+		/* retrieve response parameters */
+		for (j = 0; j < n; j++) {
+			struct dprc_obj_desc *obj_desc = &obj_descs[i + j];
+
+			DPRC_RSP_GET_OBJ(cmds[j], obj_desc);
+		}
+	}
+
+	return 0;
+}
+
 int dprc_get_obj_desc(struct fsl_mc_io *mc_io,
 		      uint32_t cmd_flags,
 		      uint16_t token,
@@ -778,3 +823,93 @@ int dprc_get_connection(struct fsl_mc_io *mc_io,
 
 	return 0;
 }
+
+int dprc_get_connection_async(struct mc_async *async,
+			      struct fsl_mc_io *mc_io,
+			      uint32_t cmd_flags,
+			      uint16_t token,
+			      const struct dprc_endpoint *endpoint1,
+			      struct mc_ticket *ticket)
+{
+	/* prepare command */
+	ticket->cmd = (struct mc_command){ 0 };
+	ticket->cmd.header = mc_encode_cmd_header(DPRC_CMDID_GET_CONNECTION,
+						  cmd_flags,
+						  token);
+	DPRC_CMD_GET_CONNECTION(ticket->cmd, endpoint1);
+
+	/* submit command to mc*/
+	return mc_async_submit(async, mc_io, ticket);
+}
+
+int dprc_get_connection_complete(struct mc_async *async,
+				 struct mc_ticket *ticket,
+				 struct dprc_endpoint *endpoint2,
+				 int *state)
+{
+	int err;
+
+	/* wait for the response */
+	err = mc_async_wait(async, ticket);
+	if (err)
+		return err;
+
+	/* retrieve response parameters */
+	DPRC_RSP_GET_CONNECTION(ticket->cmd, endpoint2, *state);
+
+	return 0;
+}
+
+int dprc_get_connections(struct fsl_mc_io *mc_io,
+			 uint32_t cmd_flags,
+			 uint16_t token,
+			 int num_endpoints,
+			 const struct dprc_endpoint *endpoints1,
+			 struct dprc_endpoint *endpoints2,
+			 int *states)
+{
+	struct mc_command cmds[DPRC_GET_OBJS_BATCH_SIZE];
+	int status[DPRC_GET_OBJS_BATCH_SIZE];
+	int i, j, n;
+
+	for (i = 0; i < num_endpoints; i += n) {
+		n = num_endpoints - i;
+		if (n > DPRC_GET_OBJS_BATCH_SIZE)
+			n = DPRC_GET_OBJS_BATCH_SIZE;
+
+		/* prepare commands */
+		for (j = 0; j < n; j++) {
+			const struct dprc_endpoint *endpoint1 =
+				&endpoints1[i + j];
+
+			cmds[j] = (struct mc_command){ 0 };
+			cmds[j].header = mc_encode_cmd_header(
+						DPRC_CMDID_GET_CONNECTION,
+						cmd_flags,
+						token);
+			DPRC_CMD_GET_CONNECTION(cmds[j], endpoint1);
+		}
+
+		/* send commands to mc*/
+		(void)mc_send_commands(mc_io, cmds, n, status);
+
+		/* retrieve response parameters */
+		for (j = 0; j < n; j++) {
+			struct dprc_endpoint *endpoint2 = &endpoints2[i + j];
+
+			if (status[j] == -ENAVAIL) {
+				*endpoint2 = (struct dprc_endpoint){ 0 };
+				states[i + j] = -1;
+				continue;
+			}
+
+			if (status[j])
+				return status[j];
+
+			DPRC_RSP_GET_CONNECTION(cmds[j], endpoint2,
+						states[i + j]);
+		}
+	}
+
+	return 0;
+}
@@ -36,8 +36,11 @@
 #include <assert.h>
 #include <getopt.h>
 #include <math.h>
+#include <time.h>
+#include <signal.h>
 #include <sys/ioctl.h>
 #include "restool.h"
+#include "dprc_walk.h"
 #include "utils.h"
 
 #define ALL_DPRC_OPTS (				\
@@ -49,8 +52,6 @@
 	DPRC_CFG_OPT_AIOP |			\
 	DPRC_CFG_OPT_IRQ_CFG_ALLOWED)
 
-enum mc_cmd_status mc_status;
-
 /**
  * dprc sync command options
  */
@@ -74,6 +75,9 @@ C_ASSERT(ARRAY_SIZE(dprc_sync_options) <= MAX_NUM_CMD_LINE_OPTIONS + 1);
  */
 enum dprc_list_options {
 	LIST_OPT_HELP = 0,
+	LIST_OPT_FULL_PATH,
+	LIST_OPT_OBJECTS,
+	LIST_OPT_TYPE,
 };
 
 static struct option dprc_list_options[] = {
@@ -81,6 +85,19 @@ static struct option dprc_list_options[] = {
 		.name = "help",
 	},
 
+	[LIST_OPT_FULL_PATH] = {
+		.name = "full-path",
+	},
+
+	[LIST_OPT_OBJECTS] = {
+		.name = "objects",
+	},
+
+	[LIST_OPT_TYPE] = {
+		.name = "type",
+		.has_arg = 1,
+	},
+
 	{ 0 },
 };
 
@@ -339,6 +356,35 @@ static struct option dprc_disconnect_options[] = {
 
 C_ASSERT(ARRAY_SIZE(dprc_disconnect_options) <= MAX_NUM_CMD_LINE_OPTIONS + 1);
 
+/**
+ * dprc watch command options
+ */
+enum dprc_watch_options {
+	WATCH_OPT_HELP = 0,
+	WATCH_OPT_INTERVAL,
+	WATCH_OPT_COUNT,
+};
+
+static struct option dprc_watch_options[] = {
+	[WATCH_OPT_HELP] = {
+		.name = "help",
+	},
+
+	[WATCH_OPT_INTERVAL] = {
+		.name = "interval",
+		.has_arg = 1,
+	},
+
+	[WATCH_OPT_COUNT] = {
+		.name = "count",
+		.has_arg = 1,
+	},
+
+	{ 0 },
+};
+
+C_ASSERT(ARRAY_SIZE(dprc_watch_options) <= MAX_NUM_CMD_LINE_OPTIONS + 1);
+
 static const struct flib_ops dprc_ops = {
 	.obj_open = dprc_open,
 	.obj_close = dprc_close,
@@ -367,11 +413,13 @@ static int cmd_dprc_help(void)
 		"   connect - connects 2 objects, creating a link between them.\n"
 		"   disconnect - removes the link between two objects. Either endpoint can be specified\n"
 		"		 as the target of the operation.\n"
+		"   watch - follows changes of the container tree, printing objects added,\n"
+		"	    removed, moved or changed as they happen.\n"
 		"\n"
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
@@ -384,16 +432,16 @@ static int cmd_dprc_sync(void)
 		"Usage: restool dprc sync\n"
 		"\n";
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(SYNC_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(SYNC_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(SYNC_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(SYNC_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF(
-			"Unexpected argument: \'%s\'\n\n", restool.obj_name);
-		printf(usage_msg);
+			"Unexpected argument: \'%s\'\n\n", restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
@@ -409,80 +457,270 @@ static int cmd_dprc_sync(void)
 	return error;
 }
 
+static int list_dprc_enter(const struct dprc_obj_desc *dprc, int depth,
+			   int num_objs, void *arg)
+{
+	(void)num_objs;
+	(void)arg;
+	for (int i = 0; i < depth; i++)
+		restool_printf("  ");
+
+	restool_printf("dprc.%u\n", dprc->id);
+	return DPRC_WALK_CONTINUE;
+}
+
+static int list_dprc_object(const struct dprc_obj_desc *obj,
+			    const struct dprc_obj_desc *parent, int depth,
+			    void *arg)
+{
+	(void)parent;
+	(void)arg;
+	if (strcmp(obj->type, "dprc") == 0)
+		return DPRC_WALK_CONTINUE;
+
+	for (int i = 0; i < depth; i++)
+		restool_printf("  ");
+
+	restool_printf("%s.%u\n", obj->type, obj->id);
+	return DPRC_WALK_CONTINUE;
+}
+
 /**
- * Lists nested DPRCs inside a given DPRC, recursively
+ * Lists the DPRCs of the container tree, each indented by its nesting level,
+ * along with the objects of type 'obj_type' (all types if NULL) if
+ * 'show_non_dprc_objects'
  */
-static int list_dprc(uint32_t dprc_id, uint16_t dprc_handle,
-		     int nesting_level, bool show_non_dprc_objects)
+static int list_dprc(bool show_non_dprc_objects, const char *obj_type)
 {
-	int num_child_devices;
-	int error = 0;
+	struct dprc_visitor visitor = {
+		.enter = list_dprc_enter,
+		.object = show_non_dprc_objects ? list_dprc_object : NULL,
+		.type_filter = obj_type,
+	};
 
-	assert(nesting_level <= MAX_DPRC_NESTING);
+	return dprc_walk(restool.root_dprc_id, &visitor);
+}
 
-	for (int i = 0; i < nesting_level; i++)
-		printf("  ");
+/**
+ * struct full_path_obj - object listed with its full path
+ */
+struct full_path_obj {
+	char *path;
+	struct dprc_obj_desc desc;
 
-	printf("dprc.%u\n", dprc_id);
+	/**
+	 * walk order of the object's container, then of the object
+	 */
+	int container_seq;
+	int seq;
+};
 
-	error = dprc_get_obj_count(&restool.mc_io, 0,
-				   dprc_handle,
-				   &num_child_devices);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
+/**
+ * struct full_path_list - state of a full path listing walk
+ */
+struct full_path_list {
+	bool objects;
 
-	for (int i = 0; i < num_child_devices; i++) {
-		struct dprc_obj_desc obj_desc;
-		uint16_t child_dprc_handle;
-		int error2;
+	/**
+	 * path of the container being walked, and its length at each level
+	 */
+	char path[(MAX_DPRC_NESTING + 1) * (sizeof("dprc.") + 11)];
+	int path_len[MAX_DPRC_NESTING + 1];
 
-		error = dprc_get_obj(
-				&restool.mc_io, 0,
-				dprc_handle,
-				i,
-				&obj_desc);
-		if (error < 0) {
-			DEBUG_PRINTF(
-				"dprc_get_object(%u) failed with error %d\n",
-				i, error);
-			goto out;
-		}
+	/**
+	 * walk order of the container being walked at each level
+	 */
+	int container_seq[MAX_DPRC_NESTING + 1];
 
-		if (strcmp(obj_desc.type, "dprc") != 0) {
-			if (show_non_dprc_objects) {
-				for (int i = 0; i < nesting_level + 1; i++)
-					printf("  ");
+	int num_containers;
+	struct full_path_obj *objs;
+	int num_objs;
+	int max_objs;
+};
 
-				printf("%s.%u\n", obj_desc.type, obj_desc.id);
-			}
+static int full_path_enter(const struct dprc_obj_desc *dprc, int depth,
+			   int num_objs, void *arg)
+{
+	struct full_path_list *list = arg;
+	int len = depth == 0 ? 0 : list->path_len[depth - 1];
+
+	(void)num_objs;
+	list->path_len[depth] = len +
+		snprintf(&list->path[len], sizeof(list->path) - len, "%sdprc.%u",
+			 depth == 0 ? "" : "/", dprc->id);
+	list->container_seq[depth] = list->num_containers++;
+	if (!list->objects)
+		restool_printf("%s\n", list->path);
+
+	return DPRC_WALK_CONTINUE;
+}
 
-			continue;
+static int full_path_object(const struct dprc_obj_desc *obj,
+			    const struct dprc_obj_desc *parent, int depth,
+			    void *arg)
+{
+	struct full_path_list *list = arg;
+	struct full_path_obj *path_obj;
+	int path_size;
+
+	(void)parent;
+	if (list->num_objs == list->max_objs) {
+		int max_objs = list->max_objs == 0 ? 64 : list->max_objs * 2;
+
+		path_obj = realloc(list->objs, max_objs * sizeof(list->objs[0]));
+		if (path_obj == NULL) {
+			ERROR_PRINTF("realloc() failed\n");
+			return -ENOMEM;
 		}
 
-		error = open_dprc(obj_desc.id, &child_dprc_handle);
-		if (error < 0)
-			goto out;
+		list->objs = path_obj;
+		list->max_objs = max_objs;
+	}
 
-		error = list_dprc(obj_desc.id, child_dprc_handle,
-				  nesting_level + 1, show_non_dprc_objects);
+	path_obj = &list->objs[list->num_objs];
+	path_size = list->path_len[depth - 1] + sizeof(obj->type) + 13;
+	path_obj->path = malloc(path_size);
+	if (path_obj->path == NULL) {
+		ERROR_PRINTF("malloc() failed\n");
+		return -ENOMEM;
+	}
 
-		error2 = dprc_close(&restool.mc_io, 0, child_dprc_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
+	snprintf(path_obj->path, path_size, "%.*s/%s.%d",
+		 list->path_len[depth - 1], list->path, obj->type, obj->id);
+
+	path_obj->desc = *obj;
+	path_obj->container_seq = list->container_seq[depth - 1];
+	path_obj->seq = list->num_objs++;
+	return DPRC_WALK_CONTINUE;
+}
+
+/**
+ * Order objects by container, the way dprc show lists them
+ */
+static int compare_full_path_objs(const void *p1, const void *p2)
+{
+	const struct full_path_obj *obj1 = p1;
+	const struct full_path_obj *obj2 = p2;
+
+	if (obj1->container_seq != obj2->container_seq)
+		return obj1->container_seq - obj2->container_seq;
+
+	return obj1->seq - obj2->seq;
+}
+
+static bool has_single_if(const char *obj_type)
+{
+	return strcmp(obj_type, "dpni") == 0 ||
+	       strcmp(obj_type, "dpmac") == 0 ||
+	       strcmp(obj_type, "dpci") == 0;
+}
+
+/**
+ * Print the listed objects with their label and endpoint, getting the
+ * endpoints of all of them at once
+ */
+static int print_full_path_objs(struct full_path_list *list)
+{
+	struct dprc_endpoint *endpoints1 = NULL;
+	struct dprc_endpoint *endpoints2 = NULL;
+	int *states = NULL;
+	int *endpoint_idx = NULL;
+	int num_endpoints = 0;
+	int error = 0;
+	enum mc_cmd_status mc_status;
+
+	if (list->num_objs == 0)
+		return 0;
+
+	qsort(list->objs, list->num_objs, sizeof(list->objs[0]),
+	      compare_full_path_objs);
+
+	endpoints1 = calloc(list->num_objs, sizeof(endpoints1[0]));
+	endpoints2 = calloc(list->num_objs, sizeof(endpoints2[0]));
+	states = calloc(list->num_objs, sizeof(states[0]));
+	endpoint_idx = calloc(list->num_objs, sizeof(endpoint_idx[0]));
+	if (endpoints1 == NULL || endpoints2 == NULL || states == NULL ||
+	    endpoint_idx == NULL) {
+		ERROR_PRINTF("calloc() failed\n");
+		error = -ENOMEM;
+		goto out;
+	}
+
+	for (int i = 0; i < list->num_objs; i++) {
+		const struct dprc_obj_desc *obj_desc = &list->objs[i].desc;
+
+		endpoint_idx[i] = -1;
+		if (!has_single_if(obj_desc->type))
+			continue;
+
+		strcpy(endpoints1[num_endpoints].type, obj_desc->type);
+		endpoints1[num_endpoints].id = obj_desc->id;
+		endpoint_idx[i] = num_endpoints++;
+	}
+
+	if (num_endpoints != 0) {
+		error = dprc_get_connections(&restool.mc_io, 0,
+					     restool.root_dprc_handle,
+					     num_endpoints, endpoints1,
+					     endpoints2, states);
+		if (error < 0) {
+			mc_status = flib_error_to_mc_status(error);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
 				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-
 			goto out;
 		}
 	}
 
+	for (int i = 0; i < list->num_objs; i++) {
+		const struct dprc_obj_desc *obj_desc = &list->objs[i].desc;
+		int k = endpoint_idx[i];
+
+		restool_printf("%s %s ", list->objs[i].path,
+			       obj_desc->label[0] != '\0' ? obj_desc->label : "-");
+		if (k < 0 || states[k] == -1)
+			restool_printf("-\n");
+		else if (strcmp(endpoints2[k].type, "dpsw") == 0 ||
+			 strcmp(endpoints2[k].type, "dpdmux") == 0)
+			restool_printf("%s.%d.%d\n", endpoints2[k].type,
+				       endpoints2[k].id, endpoints2[k].if_id);
+		else
+			restool_printf("%s.%d\n", endpoints2[k].type, endpoints2[k].id);
+	}
+
 out:
+	free(endpoint_idx);
+	free(states);
+	free(endpoints2);
+	free(endpoints1);
+	return error;
+}
+
+/**
+ * Lists the DPRCs of the container tree as full paths, one per line. If
+ * 'objects', lists the objects of type 'obj_type' (all types if NULL)
+ * instead, followed by their label and endpoint.
+ */
+static int list_dprc_full_path(bool objects, const char *obj_type)
+{
+	struct full_path_list list = {
+		.objects = objects,
+	};
+	struct dprc_visitor visitor = {
+		.enter = full_path_enter,
+		.object = objects ? full_path_object : NULL,
+		.type_filter = obj_type,
+		.arg = &list,
+	};
+	int error;
+
+	error = dprc_walk(restool.root_dprc_id, &visitor);
+	if (error == 0 && objects)
+		error = print_full_path_objs(&list);
+
+	for (int i = 0; i < list.num_objs; i++)
+		free(list.objs[i].path);
+
+	free(list.objs);
 	return error;
 }
 
@@ -490,24 +728,58 @@ static int cmd_dprc_list(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dprc list\n"
+		"Usage: restool dprc list [--full-path] [--objects] [--type=<obj-type>]\n"
+		"\n"
+		"--full-path\n"
+		"   Display full container paths (e.g. dprc.1/dprc.2) instead of\n"
+		"   indenting containers by nesting level.\n"
+		"--objects\n"
+		"   Also display the objects of each container. With --full-path, only\n"
+		"   objects are displayed, one per line, as:\n"
+		"   <path> <label> <endpoint>\n"
+		"   with '-' for an empty label or no endpoint.\n"
+		"--type=<obj-type>\n"
+		"   Only display objects of this type; implies --objects.\n"
+		"   e.g. restool dprc list --full-path --objects --type=dpni\n"
 		"\n";
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(LIST_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(LIST_OPT_HELP);
+	bool full_path = false;
+	bool objects = false;
+	const char *obj_type = NULL;
+
+	if (restool_cmd.option_mask & ONE_BIT_MASK(LIST_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(LIST_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF(
-			"Unexpected argument: \'%s\'\n\n", restool.obj_name);
-		printf(usage_msg);
+			"Unexpected argument: \'%s\'\n\n", restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	return list_dprc(
-		restool.root_dprc_id, restool.root_dprc_handle, 0, false);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(LIST_OPT_FULL_PATH)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(LIST_OPT_FULL_PATH);
+		full_path = true;
+	}
+
+	if (restool_cmd.option_mask & ONE_BIT_MASK(LIST_OPT_OBJECTS)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(LIST_OPT_OBJECTS);
+		objects = true;
+	}
+
+	if (restool_cmd.option_mask & ONE_BIT_MASK(LIST_OPT_TYPE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(LIST_OPT_TYPE);
+		obj_type = restool_cmd.option_args[LIST_OPT_TYPE];
+		objects = true;
+	}
+
+	if (full_path)
+		return list_dprc_full_path(objects, obj_type);
+
+	return list_dprc(objects, obj_type);
 }
 
 static int show_one_resource_type(uint16_t dprc_handle,
@@ -517,6 +789,7 @@ static int show_one_resource_type(uint16_t dprc_handle,
 	int res_discovered_count;
 	struct dprc_res_ids_range_desc range_desc;
 	int error;
+	enum mc_cmd_status mc_status;
 
 	error = dprc_get_res_count(&restool.mc_io, 0, dprc_handle,
 				   (char *)mc_res_type, &res_count);
@@ -528,7 +801,7 @@ static int show_one_resource_type(uint16_t dprc_handle,
 	}
 
 	if (res_count == 0) {
-		printf("Don't have any %s resource\n", mc_res_type);
+		restool_printf("Don't have any %s resource\n", mc_res_type);
 		goto out;
 	}
 
@@ -547,11 +820,11 @@ static int show_one_resource_type(uint16_t dprc_handle,
 		}
 
 		if (range_desc.base_id == range_desc.last_id)
-			printf("%s.%d\n", mc_res_type, range_desc.base_id);
+			restool_printf("%s.%d\n", mc_res_type, range_desc.base_id);
 		else
-			printf("%s.%d - %s.%d\n",
-			       mc_res_type, range_desc.base_id,
-			       mc_res_type, range_desc.last_id);
+			restool_printf("%s.%d - %s.%d\n",
+				       mc_res_type, range_desc.base_id,
+				       mc_res_type, range_desc.last_id);
 
 		for (id = range_desc.base_id; id <= range_desc.last_id; id++)
 			res_discovered_count++;
@@ -567,6 +840,7 @@ static int show_one_resource_type_count(uint16_t dprc_handle,
 {
 	int res_count = -1;
 	int error;
+	enum mc_cmd_status mc_status;
 
 	error = dprc_get_res_count(&restool.mc_io, 0, dprc_handle,
 				   (char *)mc_res_type, &res_count);
@@ -578,7 +852,7 @@ static int show_one_resource_type_count(uint16_t dprc_handle,
 	}
 
 	assert(res_count >= 0);
-	printf("%s: %d\n", mc_res_type, res_count);
+	restool_printf("%s: %d\n", mc_res_type, res_count);
 out:
 	return error;
 }
@@ -592,6 +866,7 @@ static int show_mc_resources(uint16_t dprc_handle)
 	char res_type[RES_TYPE_MAX_LENGTH + 1];
 	int error;
 	int ret_error = 0;
+	enum mc_cmd_status mc_status;
 
 	error = dprc_get_pool_count(&restool.mc_io, 0, dprc_handle,
 				    &pool_count);
@@ -604,7 +879,7 @@ static int show_mc_resources(uint16_t dprc_handle)
 
 	assert(pool_count >= 0);
 	if (0 == pool_count) {
-		printf("Don't have any resource in current dprc container.\n");
+		restool_printf("Don't have any resource in current dprc container.\n");
 		return 0;
 	}
 	for (int i = 0; i < pool_count; i++) {
@@ -638,85 +913,83 @@ out:
 	return ret_error;
 }
 
-static int show_mc_objects(uint16_t dprc_handle, const char *dprc_name)
+static int show_mc_objects_enter(const struct dprc_obj_desc *dprc,
+				 int depth, int num_objs, void *arg)
+{
+	const char *dprc_name = arg;
+
+	(void)dprc;
+	(void)depth;
+	restool_printf("%s contains %u objects%c\n", dprc_name, num_objs,
+		       num_objs == 0 ? '.' : ':');
+	restool_printf("object\t\tlabel\t\tplugged-state\n");
+	return DPRC_WALK_CONTINUE;
+}
+
+static int show_mc_objects_object(const struct dprc_obj_desc *obj_desc,
+				  const struct dprc_obj_desc *parent,
+				  int depth, void *arg)
 {
-	int num_child_devices;
-	int error;
 	int width;
 	int labelen;
 	char plug_stat[10] = {'\0'};
-	struct dprc_obj_desc obj_desc;
 
-	error = dprc_get_obj_count(&restool.mc_io, 0,
-				   dprc_handle,
-				   &num_child_devices);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
+	(void)parent;
+	(void)depth;
+	(void)arg;
 
-	printf("%s contains %u objects%c\n", dprc_name, num_child_devices,
-	       num_child_devices == 0 ? '.' : ':');
-	printf("object\t\tlabel\t\tplugged-state\n");
+	plug_stat[0] = '\0';
+	assert(strlen(obj_desc->label) <= MC_OBJ_LABEL_MAX_LENGTH);
 
-	for (int i = 0; i < num_child_devices; i++) {
-		plug_stat[0] = '\0';
-		memset(&obj_desc, 0, sizeof(obj_desc));
-		error = dprc_get_obj(&restool.mc_io, 0,
-				     dprc_handle,
-				     i,
-				     &obj_desc);
-		if (error < 0) {
-			DEBUG_PRINTF(
-				"dprc_get_object(%u) failed with error %d\n",
-				i, error);
-			goto out;
-		}
-		assert(strlen(obj_desc.label) <= MC_OBJ_LABEL_MAX_LENGTH);
+	if (obj_desc->id < 0)
+		width = strlen(obj_desc->type) + 1 +
+			(2 + (int)log10(0 - obj_desc->id));
+	else if (obj_desc->id == 0)
+		width = strlen(obj_desc->type) + 1 + 1;
+	else
+		width = strlen(obj_desc->type) + 1 +
+			(1 + (int)log10(obj_desc->id));
 
-		if (obj_desc.id < 0)
-			width = strlen(obj_desc.type) + 1 +
-				(2 + (int)log10(0 - obj_desc.id));
-		else if (obj_desc.id == 0)
-			width = strlen(obj_desc.type) + 1 + 1;
-		else
-			width = strlen(obj_desc.type) + 1 +
-				(1 + (int)log10(obj_desc.id));
+	labelen = strlen(obj_desc->label);
 
-		labelen = strlen(obj_desc.label);
+	DEBUG_PRINTF("%s.%d name length=%d\n",
+			obj_desc->type, obj_desc->id, width);
+	DEBUG_PRINTF("label \"%s\" length=%d\n",
+			obj_desc->label, labelen);
 
-		DEBUG_PRINTF("%s.%d name length=%d\n",
-				obj_desc.type, obj_desc.id, width);
-		DEBUG_PRINTF("label \"%s\" length=%d\n",
-				obj_desc.label, labelen);
+	if (strcmp(obj_desc->label, "dprc") == 0)
+		plug_stat[0] = '\0';
+	else if (obj_desc->state & DPRC_OBJ_STATE_PLUGGED)
+		strncpy(plug_stat, "plugged", 9);
+	else
+		strncpy(plug_stat, "unplugged", 9);
+	plug_stat[9] = '\0';
+
+	if (width < 8 && labelen < 8)
+		restool_printf("%s.%d\t\t%s\t\t%s\n",
+		obj_desc->type, obj_desc->id, obj_desc->label, plug_stat);
+	else if (width < 8 && labelen >= 8)
+		restool_printf("%s.%d\t\t%s\t%s\n",
+		obj_desc->type, obj_desc->id, obj_desc->label, plug_stat);
+	else if (width >= 8 && labelen < 8)
+		restool_printf("%s.%d\t%s\t\t%s\n",
+		obj_desc->type, obj_desc->id, obj_desc->label, plug_stat);
+	else
+		restool_printf("%s.%d\t%s\t%s\n",
+		obj_desc->type, obj_desc->id, obj_desc->label, plug_stat);
+
+	return DPRC_WALK_SKIP;
+}
 
-		if (strcmp(obj_desc.label, "dprc") == 0)
-			plug_stat[0] = '\0';
-		else if (obj_desc.state & DPRC_OBJ_STATE_PLUGGED)
-			strncpy(plug_stat, "plugged", 9);
-		else
-			strncpy(plug_stat, "unplugged", 9);
-		plug_stat[9] = '\0';
-
-		if (width < 8 && labelen < 8)
-			printf("%s.%d\t\t%s\t\t%s\n",
-			obj_desc.type, obj_desc.id, obj_desc.label, plug_stat);
-		else if (width < 8 && labelen >= 8)
-			printf("%s.%d\t\t%s\t%s\n",
-			obj_desc.type, obj_desc.id, obj_desc.label, plug_stat);
-		else if (width >= 8 && labelen < 8)
-			printf("%s.%d\t%s\t\t%s\n",
-			obj_desc.type, obj_desc.id, obj_desc.label, plug_stat);
-		else
-			printf("%s.%d\t%s\t%s\n",
-			obj_desc.type, obj_desc.id, obj_desc.label, plug_stat);
-	}
+static int show_mc_objects(uint32_t dprc_id, const char *dprc_name)
+{
+	struct dprc_visitor visitor = {
+		.enter = show_mc_objects_enter,
+		.object = show_mc_objects_object,
+		.arg = (void *)dprc_name,
+	};
 
-	error = 0;
-out:
-	return error;
+	return dprc_walk(dprc_id, &visitor);
 }
 
 static int cmd_dprc_show(void)
@@ -735,22 +1008,23 @@ static int cmd_dprc_show(void)
 	int error;
 	bool dprc_opened = false;
 	const char *res_type;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(SHOW_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(SHOW_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(SHOW_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(SHOW_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	dprc_name = restool.obj_name;
+	dprc_name = restool_cmd.obj_name;
 	if (strcmp(dprc_name, "mc.global") == 0)
 		dprc_name = "dprc.0";
 
@@ -768,28 +1042,28 @@ static int cmd_dprc_show(void)
 		dprc_handle = restool.root_dprc_handle;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(SHOW_OPT_RESOURCES)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(SHOW_OPT_RESOURCES);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(SHOW_OPT_RESOURCES)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(SHOW_OPT_RESOURCES);
 		error = show_mc_resources(dprc_handle);
-	} else if (restool.cmd_option_mask & ONE_BIT_MASK(SHOW_OPT_RES_TYPE)) {
-		assert(restool.cmd_option_args[SHOW_OPT_RES_TYPE] != NULL);
+	} else if (restool_cmd.option_mask & ONE_BIT_MASK(SHOW_OPT_RES_TYPE)) {
+		assert(restool_cmd.option_args[SHOW_OPT_RES_TYPE] != NULL);
 		error = check_resource_type(
-			restool.cmd_option_args[SHOW_OPT_RES_TYPE]);
+			restool_cmd.option_args[SHOW_OPT_RES_TYPE]);
 		if (error < 0) {
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			goto out;
 		}
-		res_type = restool.cmd_option_args[SHOW_OPT_RES_TYPE];
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(SHOW_OPT_RES_TYPE);
+		res_type = restool_cmd.option_args[SHOW_OPT_RES_TYPE];
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(SHOW_OPT_RES_TYPE);
 		error = show_one_resource_type(dprc_handle, res_type);
 	} else {
-		error = show_mc_objects(dprc_handle, dprc_name);
+		error = show_mc_objects(dprc_id, dprc_name);
 	}
 out:
 	if (dprc_opened) {
 		int error2;
 
-		error2 = dprc_close(&restool.mc_io, 0, dprc_handle);
+		error2 = close_dprc(dprc_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -805,49 +1079,40 @@ out:
 static void print_dprc_options(uint64_t options)
 {
 	if (options == 0 || (options & ~ALL_DPRC_OPTS) != 0) {
-		printf("\tUnrecognized options found...\n");
+		restool_printf("\tUnrecognized options found...\n");
 		return;
 	}
 
 	if (options & DPRC_CFG_OPT_SPAWN_ALLOWED)
-		printf("\tDPRC_CFG_OPT_SPAWN_ALLOWED\n");
+		restool_printf("\tDPRC_CFG_OPT_SPAWN_ALLOWED\n");
 
 	if (options & DPRC_CFG_OPT_ALLOC_ALLOWED)
-		printf("\tDPRC_CFG_OPT_ALLOC_ALLOWED\n");
+		restool_printf("\tDPRC_CFG_OPT_ALLOC_ALLOWED\n");
 
 	if (options & DPRC_CFG_OPT_OBJ_CREATE_ALLOWED)
-		printf("\tDPRC_CFG_OPT_OBJ_CREATE_ALLOWED\n");
+		restool_printf("\tDPRC_CFG_OPT_OBJ_CREATE_ALLOWED\n");
 
 	if (options & DPRC_CFG_OPT_TOPOLOGY_CHANGES_ALLOWED)
-		printf("\tDPRC_CFG_OPT_TOPOLOGY_CHANGES_ALLOWED\n");
+		restool_printf("\tDPRC_CFG_OPT_TOPOLOGY_CHANGES_ALLOWED\n");
 
 	if (options & DPRC_CFG_OPT_IOMMU_BYPASS)
-		printf("\tDPRC_CFG_OPT_IOMMU_BYPASS\n");
+		restool_printf("\tDPRC_CFG_OPT_IOMMU_BYPASS\n");
 
 	if (options & DPRC_CFG_OPT_AIOP)
-		printf("\tDPRC_CFG_OPT_AIOP\n");
+		restool_printf("\tDPRC_CFG_OPT_AIOP\n");
 
 	if (options & DPRC_CFG_OPT_IRQ_CFG_ALLOWED)
-		printf("\tDPRC_CFG_OPT_IRQ_CFG_ALLOWED\n");
+		restool_printf("\tDPRC_CFG_OPT_IRQ_CFG_ALLOWED\n");
 }
 
-static int print_dprc_attr(uint32_t dprc_id,
-			   struct dprc_obj_desc *target_obj_desc)
+static int print_dprc_attr(struct obj_info *info)
 {
-	uint16_t dprc_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dprc_id = info->desc.id;
+	uint16_t dprc_handle = info->handle;
 	int error;
 	struct dprc_attributes dprc_attr;
-	bool dprc_opened = false;
-
-	if (dprc_id != restool.root_dprc_id) {
-		error = open_dprc(dprc_id, &dprc_handle);
-		if (error < 0)
-			goto out;
-
-		dprc_opened = true;
-	} else {
-		dprc_handle = restool.root_dprc_handle;
-	}
+	enum mc_cmd_status mc_status;
 
 	memset(&dprc_attr, 0, sizeof(dprc_attr));
 	error = dprc_get_attributes(&restool.mc_io, 0, dprc_handle, &dprc_attr);
@@ -859,7 +1124,7 @@ static int print_dprc_attr(uint32_t dprc_id,
 	}
 
 	assert(dprc_id == (uint32_t)dprc_attr.container_id);
-	printf(
+	restool_printf(
 		"container id: %d\n"
 		"icid: %u\n"
 		"portal id: %d\n"
@@ -877,60 +1142,32 @@ static int print_dprc_attr(uint32_t dprc_id,
 	error = 0;
 
 out:
-	if (dprc_opened) {
-		int error2;
-
-		error2 = dprc_close(&restool.mc_io, 0, dprc_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
 	return error;
 }
 
 static int print_dprc_info(uint32_t dprc_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dprc_id,
-				"dprc", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
-
-	if (strcmp(target_obj_desc.type, "dprc")) {
-		printf("dprc.%d does not exist\n", dprc_id);
-		return -EINVAL;
-	}
-
-	error = print_dprc_attr(dprc_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dprc_ops);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-out:
-	return error;
+	return print_obj_info("dprc", dprc_id, &dprc_ops, print_dprc_attr,
+			      verbose);
 }
 
 static int cmd_dprc_info(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dprc info <dprc-object> [--verbose]\n"
+		"Usage: restool dprc info <dprc-object>|--label=<label> [--verbose]\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dprc-object>.\n"
+		"   <dprc-object> may also be given as label:<label>\n"
+		"   e.g. restool dprc info --label=my-dprc\n"
 		"\n"
 		"--verbose\n"
 		"   Shows extended/verbose information about the object\n"
@@ -940,21 +1177,21 @@ static int cmd_dprc_info(void)
 	const char *dprc_name;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	dprc_name = restool.obj_name;
+	dprc_name = restool_cmd.obj_name;
 	if (strcmp(dprc_name, "mc.global") == 0)
 		dprc_name = "dprc.0";
 
@@ -980,6 +1217,7 @@ static int create_child_dprc(uint16_t dprc_handle, uint64_t options,
 	int child_dprc_id;
 	uint64_t mc_portal_offset;
 	bool child_dprc_created = false;
+	enum mc_cmd_status mc_status;
 
 	assert(dprc_handle != 0);
 
@@ -988,7 +1226,7 @@ static int create_child_dprc(uint16_t dprc_handle, uint64_t options,
 	cfg.options = options;
 	if (has_label) {
 		strncpy(cfg.label,
-			restool.cmd_option_args[CREATE_OPT_LABEL],
+			restool_cmd.option_args[CREATE_OPT_LABEL],
 			MC_OBJ_LABEL_MAX_LENGTH);
 		cfg.label[15] = '\0';
 	} else
@@ -1007,7 +1245,7 @@ static int create_child_dprc(uint16_t dprc_handle, uint64_t options,
 	}
 
 	child_dprc_created = true;
-	print_new_obj("dprc", child_dprc_id, restool.obj_name);
+	print_new_obj("dprc", child_dprc_id, restool_cmd.obj_name);
 	DEBUG_PRINTF("dprc.%u's MC portal id %u, portal addr %#llx\n",
 		child_dprc_id,
 		(unsigned int)MC_PORTAL_OFFSET_TO_PORTAL_ID(mc_portal_offset),
@@ -1113,22 +1351,23 @@ static int cmd_dprc_create_child(void)
 	uint32_t dprc_id;
 	uint64_t options = 0;
 	bool has_label = false;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name,
+	error = parse_object_name(restool_cmd.obj_name,
 				  "dprc", &dprc_id);
 	if (error < 0)
 		goto out;
@@ -1144,10 +1383,10 @@ static int cmd_dprc_create_child(void)
 	}
 	DEBUG_PRINTF("dprc.%d's handle is: %#x\n", dprc_id, dprc_handle);
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_OPTIONS)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_OPTIONS);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_OPTIONS)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_OPTIONS);
 		error = parse_create_options(
-				restool.cmd_option_args[CREATE_OPT_OPTIONS],
+				restool_cmd.option_args[CREATE_OPT_OPTIONS],
 				&options);
 		if (error < 0)
 			goto out;
@@ -1158,17 +1397,17 @@ static int cmd_dprc_create_child(void)
 			  DPRC_CFG_OPT_IRQ_CFG_ALLOWED;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_LABEL)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_LABEL);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_LABEL)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_LABEL);
 		has_label = true;
 		DEBUG_PRINTF("Object label length: %d\n",
-		(int)strlen(restool.cmd_option_args[CREATE_OPT_LABEL]));
-		if (strlen(restool.cmd_option_args[CREATE_OPT_LABEL]) >
+		(int)strlen(restool_cmd.option_args[CREATE_OPT_LABEL]));
+		if (strlen(restool_cmd.option_args[CREATE_OPT_LABEL]) >
 		    MC_OBJ_LABEL_MAX_LENGTH) {
 			ERROR_PRINTF("object label length exceeding %d\n",
 					MC_OBJ_LABEL_MAX_LENGTH);
 			error = -EINVAL;
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			goto out;
 		}
 	} else {
@@ -1180,7 +1419,7 @@ out:
 	if (dprc_opened) {
 		int error2;
 
-		error2 = dprc_close(&restool.mc_io, 0, dprc_handle);
+		error2 = close_dprc(dprc_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -1197,7 +1436,12 @@ static int cmd_dprc_destroy_child(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dprc destroy <container>\n"
+		"Usage: restool dprc destroy <container>|--label=<label>\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <container>.\n"
+		"   <container> may also be given as label:<label>\n"
+		"   e.g. restool dprc destroy --label=my-dprc\n"
 		"\n"
 		"NOTE: <container> cannot be the root container (dprc.1)\n"
 		"\n";
@@ -1208,33 +1452,34 @@ static int cmd_dprc_destroy_child(void)
 	uint32_t parent_dprc_id;
 	uint16_t parent_dprc_handle;
 	bool found = false;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name,
+	error = parse_object_name(restool_cmd.obj_name,
 				  "dprc", &child_dprc_id);
 	if (error < 0)
 		goto out;
 
 	if (child_dprc_id == restool.root_dprc_id) {
 		ERROR_PRINTF("The root DPRC (%s) cannot be destroyed\n",
-			     restool.obj_name);
+			     restool_cmd.obj_name);
 		error = -EINVAL;
 		goto out;
 	}
@@ -1246,7 +1491,7 @@ static int cmd_dprc_destroy_child(void)
 				&parent_dprc_id, &found);
 
 	if (!found && error < 0) {
-		printf("%s does not exist\n", restool.obj_name);
+		restool_printf("%s does not exist\n", restool_cmd.obj_name);
 		error = -EINVAL;
 		goto out;
 	}
@@ -1259,6 +1504,14 @@ static int cmd_dprc_destroy_child(void)
 		if (error < 0)
 			goto out;
 	}
+	error = mc_handle_evict(&restool.handles, "dprc", child_dprc_id);
+	if (error < 0) {
+		mc_status = flib_error_to_mc_status(error);
+		ERROR_PRINTF("MC error: %s (status %#x)\n",
+			     mc_status_to_string(mc_status), mc_status);
+		goto out;
+	}
+
 	/*
 	 * Destroy child container in the MC:
 	 */
@@ -1272,88 +1525,77 @@ static int cmd_dprc_destroy_child(void)
 		goto out;
 	}
 
-	printf("dprc.%u is destroyed\n", child_dprc_id);
+	restool_printf("dprc.%u is destroyed\n", child_dprc_id);
 
 	if (parent_dprc_id != restool.root_dprc_id)
-		error = dprc_close(&restool.mc_io, 0, parent_dprc_handle);
+		error = close_dprc(parent_dprc_handle);
 
 out:
 	return error;
 }
 
+struct lookup_obj_ctx {
+	int obj_id;
+	struct dprc_obj_desc *obj_desc;
+};
+
+static int lookup_obj_enter(const struct dprc_obj_desc *dprc, int depth,
+			    int num_objs, void *arg)
+{
+	(void)dprc;
+	(void)num_objs;
+	(void)arg;
+	return depth == 0 ? DPRC_WALK_CONTINUE : DPRC_WALK_SKIP;
+}
+
+static int lookup_obj_visit(const struct dprc_obj_desc *obj,
+			    const struct dprc_obj_desc *parent, int depth,
+			    void *arg)
+{
+	struct lookup_obj_ctx *ctx = arg;
+
+	(void)parent;
+	(void)depth;
+	if (obj->id != ctx->obj_id)
+		return DPRC_WALK_CONTINUE;
+
+	*ctx->obj_desc = *obj;
+	return DPRC_WALK_STOP;
+}
+
 static int lookup_obj_desc(uint32_t parent_dprc_id,
 			   const char *obj_type,
 			   int obj_id,
 			   struct dprc_obj_desc *obj_desc_out)
 {
-	uint16_t dprc_handle;
-	int i;
+	struct lookup_obj_ctx ctx = {
+		.obj_id = obj_id,
+		.obj_desc = obj_desc_out,
+	};
+	struct dprc_visitor visitor = {
+		.enter = lookup_obj_enter,
+		.object = lookup_obj_visit,
+		.type_filter = obj_type,
+		.arg = &ctx,
+	};
 	int error;
-	int num_child_devices;
-	bool dprc_opened = false;
-
-	if (parent_dprc_id != restool.root_dprc_id) {
-		error = open_dprc(parent_dprc_id, &dprc_handle);
-		if (error < 0)
-			goto out;
-
-		dprc_opened = true;
-	} else {
-		dprc_handle = restool.root_dprc_handle;
-	}
 
-	error = dprc_get_obj_count(&restool.mc_io, 0,
-				   dprc_handle,
-				   &num_child_devices);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
-
-	for (i = 0; i < num_child_devices; i++) {
-		struct dprc_obj_desc obj_desc;
-
-		error = dprc_get_obj(&restool.mc_io, 0,
-				     dprc_handle,
-				     i,
-				     &obj_desc);
-		if (error < 0) {
-			DEBUG_PRINTF(
-				"dprc_get_object(%u) failed with error %d\n",
-				i, error);
-			goto out;
-		}
+	if (!has_topology() &&
+	    get_obj_desc_in_dprc(parent_dprc_id, obj_type, obj_id,
+				 obj_desc_out))
+		return 0;
 
-		if (strcmp(obj_desc.type, obj_type) == 0 &&
-		    obj_desc.id == obj_id) {
-			*obj_desc_out = obj_desc;
-			break;
-		}
-	}
+	error = dprc_walk(parent_dprc_id, &visitor);
+	if (error < 0)
+		return error;
 
-	if (i == num_child_devices) {
-		error = -ENOENT;
+	if (error != DPRC_WALK_STOP) {
 		ERROR_PRINTF("%s.%d does not exist in dprc.%u\n",
 			     obj_type, obj_id, parent_dprc_id);
+		return -ENOENT;
 	}
 
-out:
-	if (dprc_opened) {
-		int error2;
-
-		error2 = dprc_close(&restool.mc_io, 0, dprc_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
-	return error;
+	return 0;
 }
 
 static int do_dprc_assign_or_unassign(const char *usage_msg, bool do_assign)
@@ -1364,23 +1606,24 @@ static int do_dprc_assign_or_unassign(const char *usage_msg, bool do_assign)
 	uint32_t parent_dprc_id;
 	uint32_t child_dprc_id;
 	struct dprc_res_req res_req;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(ASSIGN_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(ASSIGN_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(ASSIGN_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(ASSIGN_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<parent-container> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
 	memset(&res_req, 0, sizeof(res_req));
-	error = parse_object_name(restool.obj_name,
+	error = parse_object_name(restool_cmd.obj_name,
 				  "dprc", &parent_dprc_id);
 	if (error < 0)
 		goto out;
@@ -1395,11 +1638,11 @@ static int do_dprc_assign_or_unassign(const char *usage_msg, bool do_assign)
 		dprc_handle = restool.root_dprc_handle;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(ASSIGN_OPT_CHILD)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(ASSIGN_OPT_CHILD);
-		assert(restool.cmd_option_args[ASSIGN_OPT_CHILD] != NULL);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(ASSIGN_OPT_CHILD)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(ASSIGN_OPT_CHILD);
+		assert(restool_cmd.option_args[ASSIGN_OPT_CHILD] != NULL);
 		error = parse_object_name(
-				restool.cmd_option_args[ASSIGN_OPT_CHILD],
+				restool_cmd.option_args[ASSIGN_OPT_CHILD],
 				"dprc", &child_dprc_id);
 		if (error < 0)
 			goto out;
@@ -1407,29 +1650,29 @@ static int do_dprc_assign_or_unassign(const char *usage_msg, bool do_assign)
 		child_dprc_id = parent_dprc_id;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(ASSIGN_OPT_RES_TYPE)) {
+	if (restool_cmd.option_mask & ONE_BIT_MASK(ASSIGN_OPT_RES_TYPE)) {
 		/* moving resource case */
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(ASSIGN_OPT_RES_TYPE);
-		assert(restool.cmd_option_args[ASSIGN_OPT_RES_TYPE] != NULL);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(ASSIGN_OPT_RES_TYPE);
+		assert(restool_cmd.option_args[ASSIGN_OPT_RES_TYPE] != NULL);
 		error = check_resource_type(
-			restool.cmd_option_args[ASSIGN_OPT_RES_TYPE]);
+			restool_cmd.option_args[ASSIGN_OPT_RES_TYPE]);
 		if (error < 0) {
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			goto out;
 		}
 		strcpy(res_req.type,
-		       restool.cmd_option_args[ASSIGN_OPT_RES_TYPE]);
+		       restool_cmd.option_args[ASSIGN_OPT_RES_TYPE]);
 
-		if (!(restool.cmd_option_mask &
+		if (!(restool_cmd.option_mask &
 		    ONE_BIT_MASK(ASSIGN_OPT_COUNT))) {
 			ERROR_PRINTF("--count option missing\n");
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			error = -EINVAL;
 			goto out;
 		}
 
-		assert(restool.cmd_option_args[ASSIGN_OPT_COUNT] != NULL);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(ASSIGN_OPT_COUNT);
+		assert(restool_cmd.option_args[ASSIGN_OPT_COUNT] != NULL);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(ASSIGN_OPT_COUNT);
 
 		if (parent_dprc_id == child_dprc_id && !do_assign) {
 			ERROR_PRINTF(
@@ -1438,30 +1681,30 @@ static int do_dprc_assign_or_unassign(const char *usage_msg, bool do_assign)
 			error = -EINVAL;
 			goto out;
 		}
-		res_req.num = atoi(restool.cmd_option_args[ASSIGN_OPT_COUNT]);
+		res_req.num = atoi(restool_cmd.option_args[ASSIGN_OPT_COUNT]);
 		if (res_req.num <= 0) {
 			ERROR_PRINTF("Invalid --count arg: %s\n",
-				     restool.cmd_option_args[ASSIGN_OPT_COUNT]);
+				     restool_cmd.option_args[ASSIGN_OPT_COUNT]);
 			error = -EINVAL;
 			goto out;
 		}
 
 		res_req.options = 0;
 		res_req.id_base_align = 0;
-	} else if (restool.cmd_option_mask & ONE_BIT_MASK(ASSIGN_OPT_OBJECT)) {
+	} else if (restool_cmd.option_mask & ONE_BIT_MASK(ASSIGN_OPT_OBJECT)) {
 		/* changing plugged state, moving object case */
 		int n;
 		int state;
 
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(ASSIGN_OPT_OBJECT);
-		assert(restool.cmd_option_args[ASSIGN_OPT_OBJECT] != NULL);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(ASSIGN_OPT_OBJECT);
+		assert(restool_cmd.option_args[ASSIGN_OPT_OBJECT] != NULL);
 
-		n = sscanf(restool.cmd_option_args[ASSIGN_OPT_OBJECT],
+		n = sscanf(restool_cmd.option_args[ASSIGN_OPT_OBJECT],
 			   "%" STRINGIFY(OBJ_TYPE_MAX_LENGTH) "[a-z].%d",
 			   res_req.type, &res_req.id_base_align);
 		if (n != 2) {
 			ERROR_PRINTF("Invalid --object arg: \'%s\'\n",
-				restool.cmd_option_args[ASSIGN_OPT_OBJECT]);
+				restool_cmd.option_args[ASSIGN_OPT_OBJECT]);
 
 			error = -EINVAL;
 			goto out;
@@ -1476,10 +1719,10 @@ static int do_dprc_assign_or_unassign(const char *usage_msg, bool do_assign)
 
 		res_req.options = DPRC_RES_REQ_OPT_EXPLICIT;
 
-		if (restool.cmd_option_mask &
+		if (restool_cmd.option_mask &
 		    ONE_BIT_MASK(ASSIGN_OPT_PLUGGED)) {
 			/* changing plugged state case*/
-			restool.cmd_option_mask &=
+			restool_cmd.option_mask &=
 				~ONE_BIT_MASK(ASSIGN_OPT_PLUGGED);
 
 			if (!do_assign) {
@@ -1488,21 +1731,21 @@ static int do_dprc_assign_or_unassign(const char *usage_msg, bool do_assign)
 				error = -EINVAL;
 				goto out;
 			}
-			if (in_use(restool.cmd_option_args[ASSIGN_OPT_OBJECT],
+			if (in_use(restool_cmd.option_args[ASSIGN_OPT_OBJECT],
 			    "changed plugged state")) {
 				error = -EBUSY;
 				goto out;
 			}
 
-			assert(restool.cmd_option_args[ASSIGN_OPT_PLUGGED] !=
+			assert(restool_cmd.option_args[ASSIGN_OPT_PLUGGED] !=
 			       NULL);
-			state = atoi(restool.
-					cmd_option_args[ASSIGN_OPT_PLUGGED]);
+			state = atoi(restool_cmd.
+					option_args[ASSIGN_OPT_PLUGGED]);
 
 			if (state < 0 || state > 1) {
 				ERROR_PRINTF(
 				    "Invalid --plugged arg: \'%s\'\n",
-				restool.cmd_option_args[ASSIGN_OPT_PLUGGED]);
+				restool_cmd.option_args[ASSIGN_OPT_PLUGGED]);
 				error = -EINVAL;
 				goto out;
 			}
@@ -1514,11 +1757,11 @@ static int do_dprc_assign_or_unassign(const char *usage_msg, bool do_assign)
 				ERROR_PRINTF(
 					"change plugged state? --plugged option required\n"
 					"move objects? child-container should be different from parent-container\n");
-				printf(usage_msg);
+				restool_printf(usage_msg);
 				error = -EINVAL;
 				goto out;
 			}
-			if (in_use(restool.cmd_option_args[ASSIGN_OPT_OBJECT],
+			if (in_use(restool_cmd.option_args[ASSIGN_OPT_OBJECT],
 			    "moved"))  {
 				error = -EBUSY;
 				goto out;
@@ -1537,7 +1780,7 @@ static int do_dprc_assign_or_unassign(const char *usage_msg, bool do_assign)
 				ERROR_PRINTF(
 				"%s cannot be moved because it is currently in plugged state\n"
 				"unplug it first\n",
-				restool.cmd_option_args[ASSIGN_OPT_OBJECT]);
+				restool_cmd.option_args[ASSIGN_OPT_OBJECT]);
 
 				error = -EBUSY;
 				goto out;
@@ -1545,7 +1788,7 @@ static int do_dprc_assign_or_unassign(const char *usage_msg, bool do_assign)
 		}
 	} else { /* invalid command case */
 		ERROR_PRINTF("Invalid command line\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
@@ -1575,7 +1818,7 @@ out:
 	if (dprc_opened) {
 		int error2;
 
-		error2 = dprc_close(&restool.mc_io, 0, dprc_handle);
+		error2 = close_dprc(dprc_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -1629,6 +1872,12 @@ static int cmd_dprc_assign(void)
 		"   String specifying the resource type to assign (e.g, \'mcp\', \'fq\', \'cg\', etc)\n"
 		"--count=<number>\n"
 		"   Number of resources to assign.\n"
+		"--label=<label>\n"
+		"   Names <parent-container> by its label\n"
+		"\n"
+		"<parent-container>, <child-container> and <object> may also be given\n"
+		"by label, as label:<label>\n"
+		"e.g. restool dprc assign dprc.1 --child=label:my-dprc --object=label:my-dpbp\n"
 		"\n";
 
 	return do_dprc_assign_or_unassign(usage_msg, true);
@@ -1666,6 +1915,12 @@ static int cmd_dprc_unassign(void)
 		"   String specifying the resource type to unassign (e.g, \'mcp\', \'fq\', \'cg\', etc)\n"
 		"--count=<number>\n"
 		"   Number of resources to unassign.\n"
+		"--label=<label>\n"
+		"   Names <parent-container> by its label\n"
+		"\n"
+		"<parent-container>, <child-container> and <object> may also be given\n"
+		"by label, as label:<label>\n"
+		"e.g. restool dprc unassign dprc.1 --child=label:my-dprc --object=label:my-dpbp\n"
 		"\n";
 
 	return do_dprc_assign_or_unassign(usage_msg, false);
@@ -1691,7 +1946,8 @@ static int cmd_dprc_set_quota(void)
 		"--count=<number>\n"
 		"   Max number of resources the child is able to allocate\n"
 		"--child-container=<container>\n"
-		"   Child container for which the quota is being set\n"
+		"   Child container for which the quota is being set, also given by\n"
+		"   label as label:<label>\n"
 		"\n";
 
 	uint16_t dprc_handle;
@@ -1701,22 +1957,23 @@ static int cmd_dprc_set_quota(void)
 	uint32_t child_dprc_id;
 	char *res_type;
 	int quota;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(SET_QUOTA_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(SET_QUOTA_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(SET_QUOTA_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(SET_QUOTA_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<parent-container> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name,
+	error = parse_object_name(restool_cmd.obj_name,
 				  "dprc", &parent_dprc_id);
 	if (error < 0)
 		goto out;
@@ -1731,50 +1988,50 @@ static int cmd_dprc_set_quota(void)
 		dprc_handle = restool.root_dprc_handle;
 	}
 
-	if (!(restool.cmd_option_mask & ONE_BIT_MASK(SET_QUOTA_OPT_RES_TYPE))) {
+	if (!(restool_cmd.option_mask & ONE_BIT_MASK(SET_QUOTA_OPT_RES_TYPE))) {
 		ERROR_PRINTF("--resource-type option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	restool.cmd_option_mask &= ~ONE_BIT_MASK(SET_QUOTA_OPT_RES_TYPE);
-	assert(restool.cmd_option_args[SET_QUOTA_OPT_RES_TYPE] != NULL);
+	restool_cmd.option_mask &= ~ONE_BIT_MASK(SET_QUOTA_OPT_RES_TYPE);
+	assert(restool_cmd.option_args[SET_QUOTA_OPT_RES_TYPE] != NULL);
 	error = check_resource_type(
-			restool.cmd_option_args[SET_QUOTA_OPT_RES_TYPE]);
+			restool_cmd.option_args[SET_QUOTA_OPT_RES_TYPE]);
 	if (error < 0) {
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		goto out;
 	}
-	res_type = restool.cmd_option_args[SET_QUOTA_OPT_RES_TYPE];
+	res_type = restool_cmd.option_args[SET_QUOTA_OPT_RES_TYPE];
 
-	if (!(restool.cmd_option_mask & ONE_BIT_MASK(SET_QUOTA_OPT_COUNT))) {
+	if (!(restool_cmd.option_mask & ONE_BIT_MASK(SET_QUOTA_OPT_COUNT))) {
 		ERROR_PRINTF("--count option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	assert(restool.cmd_option_args[SET_QUOTA_OPT_COUNT] != NULL);
-	restool.cmd_option_mask &= ~ONE_BIT_MASK(SET_QUOTA_OPT_COUNT);
-	quota = atoi(restool.cmd_option_args[SET_QUOTA_OPT_COUNT]);
+	assert(restool_cmd.option_args[SET_QUOTA_OPT_COUNT] != NULL);
+	restool_cmd.option_mask &= ~ONE_BIT_MASK(SET_QUOTA_OPT_COUNT);
+	quota = atoi(restool_cmd.option_args[SET_QUOTA_OPT_COUNT]);
 	if (quota <= 0 || quota > UINT16_MAX) {
 		ERROR_PRINTF("Invalid --count arg: %s\n",
-			     restool.cmd_option_args[SET_QUOTA_OPT_COUNT]);
+			     restool_cmd.option_args[SET_QUOTA_OPT_COUNT]);
 		error = -ERANGE;
 		goto out;
 	}
 
-	if (!(restool.cmd_option_mask & ONE_BIT_MASK(SET_QUOTA_OPT_CHILD))) {
+	if (!(restool_cmd.option_mask & ONE_BIT_MASK(SET_QUOTA_OPT_CHILD))) {
 		ERROR_PRINTF("--child-container option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	restool.cmd_option_mask &= ~ONE_BIT_MASK(SET_QUOTA_OPT_CHILD);
-	assert(restool.cmd_option_args[SET_QUOTA_OPT_CHILD] != NULL);
-	error = parse_object_name(restool.cmd_option_args[SET_QUOTA_OPT_CHILD],
+	restool_cmd.option_mask &= ~ONE_BIT_MASK(SET_QUOTA_OPT_CHILD);
+	assert(restool_cmd.option_args[SET_QUOTA_OPT_CHILD] != NULL);
+	error = parse_object_name(restool_cmd.option_args[SET_QUOTA_OPT_CHILD],
 				  "dprc", &child_dprc_id);
 	if (error < 0)
 		goto out;
@@ -1794,7 +2051,7 @@ out:
 	if (dprc_opened) {
 		int error2;
 
-		error2 = dprc_close(&restool.mc_io, 0, dprc_handle);
+		error2 = close_dprc(dprc_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -1828,55 +2085,56 @@ static int cmd_dprc_set_label(void)
 	uint32_t target_parent_dprc_id;
 	uint16_t target_parent_dprc_handle;
 	bool found;
+	enum mc_cmd_status mc_status;
 
 	memset(&target_obj_desc, 0, sizeof(target_obj_desc));
-	if (restool.cmd_option_mask & ONE_BIT_MASK(SET_LABEL_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(SET_LABEL_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(SET_LABEL_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(SET_LABEL_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	n = sscanf(restool.obj_name, "%" STRINGIFY(OBJ_TYPE_MAX_LENGTH)
+	n = sscanf(restool_cmd.obj_name, "%" STRINGIFY(OBJ_TYPE_MAX_LENGTH)
 		   "[a-z].%u", obj_type, &obj_id);
 	if (n != 2) {
-		ERROR_PRINTF("Invalid MC object name: %s\n", restool.obj_name);
+		ERROR_PRINTF("Invalid MC object name: %s\n", restool_cmd.obj_name);
 		return -EINVAL;
 	}
 
 	if (strcmp(obj_type, "dprc") == 0 && obj_id == restool.root_dprc_id) {
 		ERROR_PRINTF("CANNOT set label for root dprc, i.e. dprc.1\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(SET_LABEL_OPT_LABEL)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(SET_LABEL_OPT_LABEL);
-		if (strlen(restool.cmd_option_args[SET_LABEL_OPT_LABEL]) >
+	if (restool_cmd.option_mask & ONE_BIT_MASK(SET_LABEL_OPT_LABEL)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(SET_LABEL_OPT_LABEL);
+		if (strlen(restool_cmd.option_args[SET_LABEL_OPT_LABEL]) >
 		    MC_OBJ_LABEL_MAX_LENGTH) {
 			ERROR_PRINTF("label length > %d characters\n",
 					MC_OBJ_LABEL_MAX_LENGTH);
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			error = -EINVAL;
 			goto out;
 		}
-		if (strlen(restool.cmd_option_args[SET_LABEL_OPT_LABEL]) == 0) {
+		if (strlen(restool_cmd.option_args[SET_LABEL_OPT_LABEL]) == 0) {
 			ERROR_PRINTF("label length = 0 charcter\n");
-			printf(usage_msg);
+			restool_printf(usage_msg);
 			error = -EINVAL;
 			goto out;
 		}
 	} else {
 		ERROR_PRINTF("missing --label option\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
@@ -1886,7 +2144,7 @@ static int cmd_dprc_set_label(void)
 			&target_obj_desc, &target_parent_dprc_id, &found);
 
 	if (!found && error < 0) {
-		printf("%s does not exist\n", restool.obj_name);
+		restool_printf("%s does not exist\n", restool_cmd.obj_name);
 		error = -EINVAL;
 		goto out;
 	}
@@ -1906,7 +2164,7 @@ static int cmd_dprc_set_label(void)
 
 	error = dprc_set_obj_label(&restool.mc_io, 0,
 			target_parent_dprc_handle, obj_type, obj_id,
-			restool.cmd_option_args[SET_LABEL_OPT_LABEL]);
+			restool_cmd.option_args[SET_LABEL_OPT_LABEL]);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -1920,8 +2178,7 @@ out:
 	if (target_parent_dprc_opened) {
 		int error2;
 
-		error2 = dprc_close(&restool.mc_io, 0,
-					target_parent_dprc_handle);
+		error2 = close_dprc(target_parent_dprc_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -1958,7 +2215,7 @@ static int cmd_dprc_connect(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dprc connect <parent-container> --endpoint1=<object> --endpoint2=<object>\n"
+		"Usage: restool dprc connect <parent-container>|--label=<label> --endpoint1=<object> --endpoint2=<object>\n"
 		"\n"
 		"<parent-container> should be a shared parent (grand parent) of both endpoints\n"
 		"it is always true to utilize root container dprc.1\n"
@@ -1984,6 +2241,14 @@ static int cmd_dprc_connect(void)
 		"or restool dprc disconnect dprc.1 --endpoint=dpni.8\n"
 		"restool dprc disconnect dprc.1 --endpoint=dpsw.1.0\n"
 		"restool dprc connect dprc.1 --endpoint1=dpni.8 --endpoint2=dpsw.1.0\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names <parent-container> by its label\n"
+		"\n"
+		"<parent-container> and the endpoints may also be given by label, as\n"
+		"label:<label>, followed by .<interface> for an interface of a labeled\n"
+		"dpsw or dpdmux\n"
+		"e.g. restool dprc connect dprc.1 --endpoint1=label:eth0 --endpoint2=label:sw0.0\n"
 		"\n";
 
 	uint16_t dprc_handle;
@@ -1992,6 +2257,7 @@ static int cmd_dprc_connect(void)
 	uint32_t parent_dprc_id;
 	struct dprc_endpoint endpoint1;
 	struct dprc_endpoint endpoint2;
+	enum mc_cmd_status mc_status;
 	struct dprc_connection_cfg dprc_connection_cfg = {
 		/* If both rates are zero the connection */
 		/* will be configured in "best effort" mode. */
@@ -1999,21 +2265,21 @@ static int cmd_dprc_connect(void)
 		.max_rate = 0
 	};
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CONNECT_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CONNECT_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CONNECT_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CONNECT_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<parent-container> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name,
+	error = parse_object_name(restool_cmd.obj_name,
 				  "dprc", &parent_dprc_id);
 	if (error < 0)
 		goto out;
@@ -2028,37 +2294,37 @@ static int cmd_dprc_connect(void)
 		dprc_handle = restool.root_dprc_handle;
 	}
 
-	if (!(restool.cmd_option_mask & ONE_BIT_MASK(CONNECT_OPT_ENDPOINT1))) {
+	if (!(restool_cmd.option_mask & ONE_BIT_MASK(CONNECT_OPT_ENDPOINT1))) {
 		ERROR_PRINTF("--endpoint1 option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	restool.cmd_option_mask &= ~ONE_BIT_MASK(CONNECT_OPT_ENDPOINT1);
-	assert(restool.cmd_option_args[CONNECT_OPT_ENDPOINT1] != NULL);
-	error = parse_endpoint(restool.cmd_option_args[CONNECT_OPT_ENDPOINT1],
+	restool_cmd.option_mask &= ~ONE_BIT_MASK(CONNECT_OPT_ENDPOINT1);
+	assert(restool_cmd.option_args[CONNECT_OPT_ENDPOINT1] != NULL);
+	error = parse_endpoint(restool_cmd.option_args[CONNECT_OPT_ENDPOINT1],
 			       &endpoint1);
 	if (error < 0) {
 		ERROR_PRINTF("Invalid --endpoint1 arg: '%s'\n",
-			     restool.cmd_option_args[CONNECT_OPT_ENDPOINT1]);
+			     restool_cmd.option_args[CONNECT_OPT_ENDPOINT1]);
 		goto out;
 	}
 
-	if (!(restool.cmd_option_mask & ONE_BIT_MASK(CONNECT_OPT_ENDPOINT2))) {
+	if (!(restool_cmd.option_mask & ONE_BIT_MASK(CONNECT_OPT_ENDPOINT2))) {
 		ERROR_PRINTF("--endpoint2 option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	restool.cmd_option_mask &= ~ONE_BIT_MASK(CONNECT_OPT_ENDPOINT2);
-	assert(restool.cmd_option_args[CONNECT_OPT_ENDPOINT2] != NULL);
-	error = parse_endpoint(restool.cmd_option_args[CONNECT_OPT_ENDPOINT2],
+	restool_cmd.option_mask &= ~ONE_BIT_MASK(CONNECT_OPT_ENDPOINT2);
+	assert(restool_cmd.option_args[CONNECT_OPT_ENDPOINT2] != NULL);
+	error = parse_endpoint(restool_cmd.option_args[CONNECT_OPT_ENDPOINT2],
 			       &endpoint2);
 	if (error < 0) {
 		ERROR_PRINTF("Invalid --endpoint2 arg: '%s'\n",
-			     restool.cmd_option_args[CONNECT_OPT_ENDPOINT2]);
+			     restool_cmd.option_args[CONNECT_OPT_ENDPOINT2]);
 		goto out;
 	}
 
@@ -2077,7 +2343,7 @@ out:
 	if (dprc_opened) {
 		int error2;
 
-		error2 = dprc_close(&restool.mc_io, 0, dprc_handle);
+		error2 = close_dprc(dprc_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -2094,7 +2360,7 @@ static int cmd_dprc_disconnect(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dprc disconnect <parent-container> --endpoint=<object>\n"
+		"Usage: restool dprc disconnect <parent-container>|--label=<label> --endpoint=<object>\n"
 		"\n"
 		"<parent-container> is the parent or grand parent of endpoint\n"
 		"It is always true if you utilize root container dprc.1\n"
@@ -2103,6 +2369,14 @@ static int cmd_dprc_disconnect(void)
 		"e.g. dprc.1 -> dprc.3 -> dpni.7\n"
 		"restool dprc disconnnect dprc.3 --endpoint=dpni.7\n"
 		"restool dprc disconnnect dprc.1 --endpoint=dpni.7\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names <parent-container> by its label\n"
+		"\n"
+		"<parent-container> and the endpoint may also be given by label, as\n"
+		"label:<label>, followed by .<interface> for an interface of a labeled\n"
+		"dpsw or dpdmux\n"
+		"e.g. restool dprc disconnect dprc.1 --endpoint=label:sw0.0\n"
 		"\n";
 
 	uint16_t dprc_handle;
@@ -2110,22 +2384,23 @@ static int cmd_dprc_disconnect(void)
 	bool dprc_opened = false;
 	uint32_t parent_dprc_id;
 	struct dprc_endpoint endpoint;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DISCONNECT_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DISCONNECT_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DISCONNECT_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DISCONNECT_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<parent-container> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name,
+	error = parse_object_name(restool_cmd.obj_name,
 				  "dprc", &parent_dprc_id);
 	if (error < 0)
 		goto out;
@@ -2140,21 +2415,21 @@ static int cmd_dprc_disconnect(void)
 		dprc_handle = restool.root_dprc_handle;
 	}
 
-	if (!(restool.cmd_option_mask &
+	if (!(restool_cmd.option_mask &
 	    ONE_BIT_MASK(DISCONNECT_OPT_ENDPOINT))) {
 		ERROR_PRINTF("--endpoint option missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	restool.cmd_option_mask &= ~ONE_BIT_MASK(DISCONNECT_OPT_ENDPOINT);
-	assert(restool.cmd_option_args[DISCONNECT_OPT_ENDPOINT] != NULL);
-	error = parse_endpoint(restool.cmd_option_args[DISCONNECT_OPT_ENDPOINT],
+	restool_cmd.option_mask &= ~ONE_BIT_MASK(DISCONNECT_OPT_ENDPOINT);
+	assert(restool_cmd.option_args[DISCONNECT_OPT_ENDPOINT] != NULL);
+	error = parse_endpoint(restool_cmd.option_args[DISCONNECT_OPT_ENDPOINT],
 			       &endpoint);
 	if (error < 0) {
 		ERROR_PRINTF("Invalid --endpoint arg: '%s'\n",
-			     restool.cmd_option_args[DISCONNECT_OPT_ENDPOINT]);
+			     restool_cmd.option_args[DISCONNECT_OPT_ENDPOINT]);
 		goto out;
 	}
 
@@ -2171,7 +2446,7 @@ out:
 	if (dprc_opened) {
 		int error2;
 
-		error2 = dprc_close(&restool.mc_io, 0, dprc_handle);
+		error2 = close_dprc(dprc_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -2184,6 +2459,238 @@ out:
 	return error;
 }
 
+/**
+ * Set by SIGINT and SIGTERM, for dprc watch to stop
+ */
+static volatile sig_atomic_t watch_stopped;
+
+static void watch_stop_handler(int signum)
+{
+	(void)signum;
+	watch_stopped = 1;
+}
+
+static void print_watch_time(void)
+{
+	struct timespec now;
+	struct tm tm;
+	char buf[32];
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	localtime_r(&now.tv_sec, &tm);
+	strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+	restool_printf("%s.%03ld ", buf, now.tv_nsec / 1000000);
+}
+
+static uint32_t watch_parent_id(const struct topology *topo, int idx)
+{
+	int parent = topo->objs[idx].parent;
+
+	return parent < 0 ? 0 : topo->objs[parent].desc.id;
+}
+
+/**
+ * Print the differences between two snapshots of the container tree, as
+ * one event per object removed, added, moved or changed
+ */
+static void print_watch_events(const struct topology *prev,
+			       const struct topology *topo)
+{
+	for (int i = 0; i < prev->num_objs; i++) {
+		const struct dprc_obj_desc *desc = &prev->objs[i].desc;
+
+		if (topology_lookup(topo, desc->type, desc->id) >= 0)
+			continue;
+
+		print_watch_time();
+		restool_printf("removed %s.%u from dprc.%u\n", desc->type, desc->id,
+			       watch_parent_id(prev, i));
+
+		/*
+		 * The object was destroyed: a token cached for it is stale
+		 */
+		mc_handle_forget(&restool.handles, desc->type, desc->id);
+	}
+
+	for (int i = 0; i < topo->num_objs; i++) {
+		const struct dprc_obj_desc *desc = &topo->objs[i].desc;
+		const struct dprc_obj_desc *prev_desc;
+		uint32_t parent_id = watch_parent_id(topo, i);
+		uint32_t prev_parent_id;
+		bool plugged_changed;
+		bool label_changed;
+		bool version_changed;
+		int prev_idx;
+
+		prev_idx = topology_lookup(prev, desc->type, desc->id);
+		if (prev_idx < 0) {
+			print_watch_time();
+			restool_printf("added %s.%u to dprc.%u\n", desc->type, desc->id,
+				       parent_id);
+			continue;
+		}
+
+		prev_desc = &prev->objs[prev_idx].desc;
+		prev_parent_id = watch_parent_id(prev, prev_idx);
+		if (prev_parent_id != parent_id) {
+			print_watch_time();
+			restool_printf("moved %s.%u from dprc.%u to dprc.%u\n",
+				       desc->type, desc->id, prev_parent_id, parent_id);
+		}
+
+		/*
+		 * The open state is left out: it follows the handles of any
+		 * MC user, the watch itself included
+		 */
+		plugged_changed = (prev_desc->state ^ desc->state) &
+				  DPRC_OBJ_STATE_PLUGGED;
+		label_changed = strncmp(prev_desc->label, desc->label,
+					sizeof(desc->label)) != 0;
+		version_changed = prev_desc->ver_major != desc->ver_major ||
+				  prev_desc->ver_minor != desc->ver_minor;
+		if (!plugged_changed && !label_changed && !version_changed)
+			continue;
+
+		print_watch_time();
+		restool_printf("changed %s.%u in dprc.%u:", desc->type, desc->id,
+			       parent_id);
+		if (plugged_changed)
+			restool_printf(" %s",
+				       desc->state & DPRC_OBJ_STATE_PLUGGED ?
+					"plugged" : "unplugged");
+
+		if (label_changed)
+			restool_printf(" label \'%.*s\'", (int)sizeof(desc->label),
+				       desc->label);
+
+		if (version_changed)
+			restool_printf(" version %u.%u", desc->ver_major,
+				       desc->ver_minor);
+
+		restool_printf("\n");
+	}
+}
+
+static int cmd_dprc_watch(void)
+{
+	static const char usage_msg[] =
+		"\n"
+		"Usage: restool dprc watch [--interval=<ms>] [--count=<polls>]\n"
+		"\n"
+		"Follows changes of the container tree until interrupted, printing\n"
+		"one timestamped line per object added, removed, moved to another\n"
+		"container or changed (plugged state, label). Every poll reads the\n"
+		"objects of each container and only compares the snapshots when\n"
+		"some container's objects changed.\n"
+		"--interval=<ms>\n"
+		"   Time between polls, in milliseconds (default: 1000).\n"
+		"--count=<polls>\n"
+		"   Stop after this number of polls.\n"
+		"e.g. restool dprc watch --interval=200\n"
+		"\n";
+
+	struct topology topo;
+	struct topology next;
+	struct sigaction action;
+	struct sigaction old_int_action;
+	struct sigaction old_term_action;
+	unsigned long interval_ms = 1000;
+	unsigned long count = 0;
+	char *endptr;
+	char *str;
+	long val;
+	int error;
+
+	if (restool_cmd.option_mask & ONE_BIT_MASK(WATCH_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(WATCH_OPT_HELP);
+		return 0;
+	}
+
+	if (restool_cmd.obj_name != NULL) {
+		ERROR_PRINTF(
+			"Unexpected argument: '%s'\n\n", restool_cmd.obj_name);
+		restool_printf(usage_msg);
+		return -EINVAL;
+	}
+
+	if (restool_cmd.option_mask & ONE_BIT_MASK(WATCH_OPT_INTERVAL)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(WATCH_OPT_INTERVAL);
+		errno = 0;
+		str = restool_cmd.option_args[WATCH_OPT_INTERVAL];
+		val = strtol(str, &endptr, 0);
+		if (STRTOL_ERROR(str, endptr, val, errno) || val <= 0 ||
+		    val > 3600000) {
+			ERROR_PRINTF("Invalid interval: %s\n", str);
+			restool_printf(usage_msg);
+			return -EINVAL;
+		}
+
+		interval_ms = val;
+	}
+
+	if (restool_cmd.option_mask & ONE_BIT_MASK(WATCH_OPT_COUNT)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(WATCH_OPT_COUNT);
+		errno = 0;
+		str = restool_cmd.option_args[WATCH_OPT_COUNT];
+		val = strtol(str, &endptr, 0);
+		if (STRTOL_ERROR(str, endptr, val, errno) || val <= 0) {
+			ERROR_PRINTF("Invalid count: %s\n", str);
+			restool_printf(usage_msg);
+			return -EINVAL;
+		}
+
+		count = val;
+	}
+
+	error = topology_build(&topo, restool.root_dprc_id,
+			       restool.root_dprc_handle, NULL);
+	if (error < 0)
+		return error;
+
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = watch_stop_handler;
+	sigemptyset(&action.sa_mask);
+	watch_stopped = 0;
+	(void)sigaction(SIGINT, &action, &old_int_action);
+	(void)sigaction(SIGTERM, &action, &old_term_action);
+
+	for (unsigned long poll = 0; count == 0 || poll < count; poll++) {
+		struct timespec interval = {
+			.tv_sec = interval_ms / 1000,
+			.tv_nsec = (interval_ms % 1000) * 1000000,
+		};
+
+		(void)nanosleep(&interval, NULL);
+		if (watch_stopped)
+			break;
+
+		/*
+		 * Events are only looked for if the objects of some
+		 * container changed
+		 */
+		error = topology_build(&next, restool.root_dprc_id,
+				       restool.root_dprc_handle, &topo);
+		if (error < 0)
+			break;
+
+		DEBUG_PRINTF("poll %lu: %d containers changed\n", poll,
+			     next.num_changed);
+		if (next.num_changed != 0) {
+			print_watch_events(&topo, &next);
+			fflush(stdout);
+		}
+
+		topology_free(&topo);
+		topo = next;
+	}
+
+	(void)sigaction(SIGTERM, &old_term_action, NULL);
+	(void)sigaction(SIGINT, &old_int_action, NULL);
+	topology_free(&topo);
+	return error;
+}
+
 /**
  * DPRC command table
  */
@@ -2241,6 +2748,10 @@ struct object_command dprc_commands[] = {
 	  .options = dprc_disconnect_options,
 	  .cmd_func = cmd_dprc_disconnect },
 
+	{ .cmd_name = "watch",
+	  .options = dprc_watch_options,
+	  .cmd_func = cmd_dprc_watch },
+
 	{ .cmd_name = NULL },
 };
 
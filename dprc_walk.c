@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "dprc_walk.h"
+#include "restool.h"
+#include "utils.h"
+
+/**
+ * struct walk_frame - container being walked
+ */
+struct walk_frame {
+	struct dprc_obj_desc desc;
+	uint16_t handle;
+
+	/**
+	 * handle obtained with open_dprc(), to be closed when leaving
+	 */
+	bool opened;
+
+	int num_objs;
+
+	/**
+	 * index of the next object of the container to visit
+	 */
+	int next;
+
+	/**
+	 * snapshot walk: snapshot index of the next object to visit
+	 */
+	int next_child;
+
+	/**
+	 * live walk: descriptors of objects [chunk_first, chunk_first +
+	 * chunk_count) of the container
+	 */
+	int chunk_first;
+	int chunk_count;
+	struct dprc_obj_desc chunk[DPRC_WALK_CHUNK_SIZE];
+};
+
+/**
+ * struct walk_state - explicit stack of a walk; its size only depends on
+ * the maximum nesting of containers, not on the number of objects
+ */
+struct walk_state {
+	const struct dprc_visitor *visitor;
+
+	/**
+	 * topology snapshot walked, or NULL to walk the MC directly
+	 */
+	const struct topology *topo;
+
+	/**
+	 * index of the top frame; -1 if the stack is empty
+	 */
+	int depth;
+	struct walk_frame frames[MAX_DPRC_NESTING + 1];
+};
+
+static void print_mc_error(int error)
+{
+	enum mc_cmd_status mc_status = flib_error_to_mc_status(error);
+
+	ERROR_PRINTF("MC error: %s (status %#x)\n",
+		     mc_status_to_string(mc_status), mc_status);
+}
+
+static int push_container(struct walk_state *walk,
+			  const struct dprc_obj_desc *desc, int topo_idx)
+{
+	const struct dprc_visitor *visitor = walk->visitor;
+	struct walk_frame *frame;
+	int error;
+
+	if (walk->depth == MAX_DPRC_NESTING) {
+		ERROR_PRINTF("dprc.%u nested too deep\n", desc->id);
+		return -ELOOP;
+	}
+
+	frame = &walk->frames[++walk->depth];
+	frame->desc = *desc;
+	frame->opened = false;
+	frame->num_objs = 0;
+	frame->next = 0;
+	frame->chunk_first = 0;
+	frame->chunk_count = 0;
+
+	if (walk->topo != NULL) {
+		frame->next_child = walk->topo->objs[topo_idx].first_child;
+		for (int i = frame->next_child; i >= 0;
+		     i = walk->topo->objs[i].next_sibling)
+			frame->num_objs++;
+	} else {
+		if ((uint32_t)desc->id == restool.root_dprc_id) {
+			frame->handle = restool.root_dprc_handle;
+		} else {
+			error = open_dprc(desc->id, &frame->handle);
+			if (error < 0)
+				return error;
+
+			frame->opened = true;
+		}
+
+		error = dprc_get_obj_count(&restool.mc_io, 0, frame->handle,
+					   &frame->num_objs);
+		if (error < 0) {
+			print_mc_error(error);
+			return error;
+		}
+	}
+
+	if (visitor->enter == NULL)
+		return DPRC_WALK_CONTINUE;
+
+	error = visitor->enter(&frame->desc, walk->depth, frame->num_objs,
+			       visitor->arg);
+	if (error == DPRC_WALK_SKIP) {
+		frame->next = frame->num_objs;
+		error = DPRC_WALK_CONTINUE;
+	}
+
+	return error;
+}
+
+static int pop_container(struct walk_state *walk)
+{
+	const struct dprc_visitor *visitor = walk->visitor;
+	struct walk_frame *frame = &walk->frames[walk->depth];
+	int error = DPRC_WALK_CONTINUE;
+	int error2;
+
+	if (visitor->leave != NULL)
+		error = visitor->leave(&frame->desc, walk->depth,
+				       visitor->arg);
+
+	if (frame->opened) {
+		error2 = close_dprc(frame->handle);
+		if (error2 < 0 && error >= 0)
+			error = error2;
+	}
+
+	walk->depth--;
+	return error;
+}
+
+/**
+ * Get the next object of the top container, fetching descriptors from the
+ * MC one chunk at a time in a live walk
+ */
+static int next_obj(struct walk_state *walk, struct walk_frame *frame,
+		    struct dprc_obj_desc *obj_desc, int *topo_idx)
+{
+	int error;
+
+	if (walk->topo != NULL) {
+		*topo_idx = frame->next_child;
+		*obj_desc = walk->topo->objs[frame->next_child].desc;
+		frame->next_child =
+			walk->topo->objs[frame->next_child].next_sibling;
+		frame->next++;
+		return 0;
+	}
+
+	if (frame->next >= frame->chunk_first + frame->chunk_count) {
+		frame->chunk_first = frame->next;
+		frame->chunk_count = frame->num_objs - frame->next;
+		if (frame->chunk_count > DPRC_WALK_CHUNK_SIZE)
+			frame->chunk_count = DPRC_WALK_CHUNK_SIZE;
+
+		error = get_dprc_obj_desc_range(frame->desc.id, frame->handle,
+						frame->chunk_first,
+						frame->chunk_count,
+						frame->chunk);
+		if (error < 0) {
+			print_mc_error(error);
+			return error;
+		}
+	}
+
+	*topo_idx = -1;
+	*obj_desc = frame->chunk[frame->next - frame->chunk_first];
+	frame->next++;
+	return 0;
+}
+
+/**
+ * Walk the container tree under 'dprc_id' depth-first, without recursion,
+ * calling the visitor's callbacks along the way. The topology snapshot is
+ * walked if one is available; otherwise the MC is walked directly, fetching
+ * object descriptors a chunk at a time, so that memory use is bounded
+ * whatever the number of objects.
+ *
+ * Returns 0 once the whole tree has been walked, DPRC_WALK_STOP if a
+ * callback ended the walk, or a negative error code.
+ */
+int dprc_walk(uint32_t dprc_id, const struct dprc_visitor *visitor)
+{
+	struct walk_state *walk;
+	struct dprc_obj_desc dprc_desc;
+	int topo_idx = -1;
+	int error;
+
+	walk = calloc(1, sizeof(*walk));
+	if (walk == NULL) {
+		ERROR_PRINTF("calloc() failed\n");
+		return -ENOMEM;
+	}
+
+	walk->visitor = visitor;
+	walk->depth = -1;
+	if (topology_available()) {
+		error = get_topology(&walk->topo);
+		if (error < 0)
+			goto out;
+
+		/*
+		 * Containers outside of the root DPRC's tree can only be
+		 * walked on the MC
+		 */
+		topo_idx = topology_lookup(walk->topo, "dprc", dprc_id);
+		if (topo_idx < 0)
+			walk->topo = NULL;
+	}
+
+	if (walk->topo != NULL) {
+		dprc_desc = walk->topo->objs[topo_idx].desc;
+	} else {
+		memset(&dprc_desc, 0, sizeof(dprc_desc));
+		strcpy(dprc_desc.type, "dprc");
+		dprc_desc.id = dprc_id;
+	}
+
+	error = push_container(walk, &dprc_desc, topo_idx);
+	while (error == DPRC_WALK_CONTINUE && walk->depth >= 0) {
+		struct walk_frame *frame = &walk->frames[walk->depth];
+		struct dprc_obj_desc obj_desc;
+
+		if (frame->next == frame->num_objs) {
+			error = pop_container(walk);
+			continue;
+		}
+
+		error = next_obj(walk, frame, &obj_desc, &topo_idx);
+		if (error < 0)
+			break;
+
+		if (visitor->object != NULL &&
+		    (visitor->type_filter == NULL ||
+		     strcmp(obj_desc.type, visitor->type_filter) == 0))
+			error = visitor->object(&obj_desc, &frame->desc,
+						walk->depth + 1, visitor->arg);
+
+		if (error == DPRC_WALK_SKIP) {
+			error = DPRC_WALK_CONTINUE;
+			continue;
+		}
+
+		if (error == DPRC_WALK_CONTINUE &&
+		    strcmp(obj_desc.type, "dprc") == 0)
+			error = push_container(walk, &obj_desc, topo_idx);
+	}
+
+	/*
+	 * Walk ended early: release the containers still open
+	 */
+	while (walk->depth >= 0) {
+		struct walk_frame *frame = &walk->frames[walk->depth--];
+
+		if (frame->opened)
+			(void)close_dprc(frame->handle);
+	}
+
+out:
+	free(walk);
+	return error;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _DPRC_WALK_H
+#define _DPRC_WALK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fsl_dprc.h"
+
+/**
+ * Values returned by dprc_visitor callbacks, besides negative error codes
+ * which abort the walk:
+ *
+ * DPRC_WALK_CONTINUE	go on with the walk
+ * DPRC_WALK_SKIP	from enter(): do not visit the container's objects;
+ *			from object(): do not enter the object if it is a DPRC
+ * DPRC_WALK_STOP	end the walk; dprc_walk() returns DPRC_WALK_STOP
+ */
+#define DPRC_WALK_CONTINUE	0
+#define DPRC_WALK_SKIP		1
+#define DPRC_WALK_STOP		2
+
+/**
+ * Number of object descriptors fetched at once from a container
+ */
+#define DPRC_WALK_CHUNK_SIZE	64
+
+/**
+ * struct dprc_visitor - callbacks of a depth-first container tree walk
+ *
+ * Every callback is optional. Containers are passed to object() as objects
+ * of their parent container, then to enter() before their own objects and
+ * to leave() after them. 'depth' is 0 for the container the walk starts at.
+ */
+struct dprc_visitor {
+	int (*enter)(const struct dprc_obj_desc *dprc, int depth,
+		     int num_objs, void *arg);
+
+	int (*object)(const struct dprc_obj_desc *obj,
+		      const struct dprc_obj_desc *parent, int depth,
+		      void *arg);
+
+	int (*leave)(const struct dprc_obj_desc *dprc, int depth, void *arg);
+
+	/**
+	 * if not NULL, only objects of this type are passed to object();
+	 * containers are entered all the same
+	 */
+	const char *type_filter;
+
+	void *arg;
+};
+
+int dprc_walk(uint32_t dprc_id, const struct dprc_visitor *visitor);
+
+#endif /* _DPRC_WALK_H */
@@ -39,8 +39,6 @@
 #include "utils.h"
 #include "fsl_dpseci.h"
 
-enum mc_cmd_status mc_status;
-
 /**
  * dpseci info command options
  */
@@ -145,33 +143,18 @@ static int cmd_dpseci_help(void)
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
-static int print_dpseci_attr(uint32_t dpseci_id,
-			struct dprc_obj_desc *target_obj_desc)
+static int print_dpseci_attr(struct obj_info *info)
 {
-	uint16_t dpseci_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dpseci_id = info->desc.id;
+	uint16_t dpseci_handle = info->handle;
 	int error;
 	struct dpseci_attr dpseci_attr;
-	bool dpseci_opened = false;
-
-	error = dpseci_open(&restool.mc_io, 0, dpseci_id, &dpseci_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
-	dpseci_opened = true;
-	if (0 == dpseci_handle) {
-		DEBUG_PRINTF(
-			"dpseci_open() returned invalid handle (auth 0) for dpseci.%u\n",
-			dpseci_id);
-		error = -ENOENT;
-		goto out;
-	}
+	enum mc_cmd_status mc_status;
 
 	memset(&dpseci_attr, 0, sizeof(dpseci_attr));
 	error = dpseci_get_attributes(&restool.mc_io, 0, dpseci_handle,
@@ -184,74 +167,46 @@ static int print_dpseci_attr(uint32_t dpseci_id,
 	}
 	assert(dpseci_id == (uint32_t)dpseci_attr.id);
 
-	printf("dpseci version: %u.%u\n", dpseci_attr.version.major,
-	       dpseci_attr.version.minor);
-	printf("dpseci id: %d\n", dpseci_attr.id);
-	printf("plugged state: %splugged\n",
+	restool_printf("dpseci version: %u.%u\n", dpseci_attr.version.major,
+		       dpseci_attr.version.minor);
+	restool_printf("dpseci id: %d\n", dpseci_attr.id);
+	restool_printf("plugged state: %splugged\n",
 		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
-	printf("number of transmit queues: %u\n", dpseci_attr.num_tx_queues);
-	printf("number of receive queues: %u\n", dpseci_attr.num_rx_queues);
+	restool_printf("number of transmit queues: %u\n", dpseci_attr.num_tx_queues);
+	restool_printf("number of receive queues: %u\n", dpseci_attr.num_rx_queues);
 	print_obj_label(target_obj_desc);
 
 	error = 0;
 
 out:
-	if (dpseci_opened) {
-		int error2;
-
-		error2 = dpseci_close(&restool.mc_io, 0, dpseci_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
 	return error;
 }
 
 static int print_dpseci_info(uint32_t dpseci_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dpseci_id,
-				"dpseci", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (strcmp(target_obj_desc.type, "dpseci")) {
-		printf("dpseci.%d does not exist\n", dpseci_id);
-		return -EINVAL;
-	}
-
-	error = print_dpseci_attr(dpseci_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
-
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dpseci_ops);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-out:
-	return error;
+	return print_obj_info("dpseci", dpseci_id, &dpseci_ops, print_dpseci_attr,
+			      verbose);
 }
 
 static int cmd_dpseci_info(void)
 {
 	static const char usage_msg[] =
 	"\n"
-	"Usage: restool dpseci info <dpseci-object> [--verbose]\n"
+	"Usage: restool dpseci info <dpseci-object>|--label=<label> [--verbose]\n"
 	"   e.g. restool dpseci info dpseci.5\n"
 	"\n"
+	"--label=<label>\n"
+	"   Names the object by its label, in place of <dpseci-object>.\n"
+	"   <dpseci-object> may also be given as label:<label>\n"
+	"   e.g. restool dpseci info --label=my-dpseci\n"
+	"\n"
 	"--verbose\n"
 	"   Shows extended/verbose information about the object\n"
 	"   e.g. restool dpseci info dpseci.5 --verbose\n"
@@ -260,21 +215,21 @@ static int cmd_dpseci_info(void)
 	uint32_t obj_id;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpseci", &obj_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpseci", &obj_id);
 	if (error < 0)
 		goto out;
 
@@ -349,28 +304,29 @@ static int cmd_dpseci_create(void)
 	long val;
 	char *str;
 	char *endptr;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
-			     restool.obj_name);
-		printf(usage_msg);
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if ((restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_NUM_QUEUES)) &&
-	    (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_PRIORITIES))) {
-		restool.cmd_option_mask &=
+	if ((restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_NUM_QUEUES)) &&
+	    (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_PRIORITIES))) {
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_NUM_QUEUES);
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_PRIORITIES);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_NUM_QUEUES];
+		str = restool_cmd.option_args[CREATE_OPT_NUM_QUEUES];
 		val = strtol(str, &endptr, 0);
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
 		    (val < 1 || val > DPSECI_PRIO_NUM)) {
@@ -381,7 +337,7 @@ static int cmd_dpseci_create(void)
 		dpseci_cfg.num_rx_queues = val;
 
 		error = parse_dpseci_priorities(
-			restool.cmd_option_args[CREATE_OPT_PRIORITIES],
+			restool_cmd.option_args[CREATE_OPT_PRIORITIES],
 			dpseci_cfg.priorities, val);
 		if (error < 0) {
 			DEBUG_PRINTF(
@@ -389,19 +345,19 @@ static int cmd_dpseci_create(void)
 				error);
 			return error;
 		}
-	} else if (restool.cmd_option_mask &
+	} else if (restool_cmd.option_mask &
 		   ONE_BIT_MASK(CREATE_OPT_NUM_QUEUES)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_NUM_QUEUES);
 		ERROR_PRINTF("options should be both on or both off");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		return -EINVAL;
-	} else if (restool.cmd_option_mask &
+	} else if (restool_cmd.option_mask &
 		   ONE_BIT_MASK(CREATE_OPT_PRIORITIES)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_PRIORITIES);
 		ERROR_PRINTF("options should be both on or both off");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	} else {
 		dpseci_cfg.num_tx_queues = 2;
@@ -444,8 +400,13 @@ static int cmd_dpseci_destroy(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpseci destroy <dpseci-object>\n"
+		"Usage: restool dpseci destroy <dpseci-object>|--label=<label>\n"
 		"   e.g. restool dpseci destroy dpseci.9\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpseci-object>.\n"
+		"   <dpseci-object> may also be given as label:<label>\n"
+		"   e.g. restool dpseci destroy --label=my-dpseci\n"
 		"\n";
 
 	int error;
@@ -453,26 +414,27 @@ static int cmd_dpseci_destroy(void)
 	uint32_t dpseci_id;
 	uint16_t dpseci_handle;
 	bool dpseci_opened = false;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpseci", &dpseci_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpseci", &dpseci_id);
 	if (error < 0)
 		goto out;
 
@@ -481,7 +443,7 @@ static int cmd_dpseci_destroy(void)
 		goto out;
 	}
 
-	error = dpseci_open(&restool.mc_io, 0, dpseci_id, &dpseci_handle);
+	error = open_obj("dpseci", dpseci_id, &dpseci_ops, &dpseci_handle);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -505,11 +467,12 @@ static int cmd_dpseci_destroy(void)
 		goto out;
 	}
 	dpseci_opened = false;
-	printf("dpseci.%u is destroyed\n", dpseci_id);
+	mc_handle_forget(&restool.handles, "dpseci", dpseci_id);
+	restool_printf("dpseci.%u is destroyed\n", dpseci_id);
 
 out:
 	if (dpseci_opened) {
-		error2 = dpseci_close(&restool.mc_io, 0, dpseci_handle);
+		error2 = close_obj(&dpseci_ops, dpseci_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -46,8 +46,6 @@
 	DPSW_OPT_FLOODING_METERING_DIS |	\
 	DPSW_OPT_METERING_EN)
 
-enum mc_cmd_status mc_status;
-
 /**
  * dpsw info command options
  */
@@ -192,111 +190,114 @@ static int cmd_dpsw_help(void)
 		"For command-specific help, use the --help option of each command.\n"
 		"\n";
 
-	printf(help_msg);
+	restool_printf(help_msg);
 	return 0;
 }
 
 static void print_dpsw_options(uint64_t options)
 {
 	if ((options & ~ALL_DPSW_OPTS) != 0) {
-		printf("\tUnrecognized options found...\n");
+		restool_printf("\tUnrecognized options found...\n");
 		return;
 	}
 
 	if (options & DPSW_OPT_FLOODING_DIS)
-		printf("\tDPSW_OPT_FLOODING_DIS\n");
+		restool_printf("\tDPSW_OPT_FLOODING_DIS\n");
 
 	if (options & DPSW_OPT_MULTICAST_DIS)
-		printf("\tDPSW_OPT_MULTICAST_DIS\n");
+		restool_printf("\tDPSW_OPT_MULTICAST_DIS\n");
 
 	if (options & DPSW_OPT_CTRL_IF_DIS)
-		printf("\tDPSW_OPT_CTRL_IF_DIS\n");
+		restool_printf("\tDPSW_OPT_CTRL_IF_DIS\n");
 
 	if (options & DPSW_OPT_FLOODING_METERING_DIS)
-		printf("\tDPSW_OPT_FLOODING_METERING_DIS\n");
+		restool_printf("\tDPSW_OPT_FLOODING_METERING_DIS\n");
 
 	if (options & DPSW_OPT_METERING_EN)
-		printf("\tDPSW_OPT_METERING_EN\n");
+		restool_printf("\tDPSW_OPT_METERING_EN\n");
 }
 
 static int print_dpsw_endpoint(uint32_t target_id, uint16_t num_ifs)
 {
-	struct dprc_endpoint endpoint1;
-	struct dprc_endpoint endpoint2;
-	int state;
-	int error = 0;
+	struct dprc_endpoint *endpoints1;
+	struct dprc_endpoint *endpoints2;
+	int *states;
+	int error;
 	int k;
+	enum mc_cmd_status mc_status;
+
+	endpoints1 = calloc(num_ifs, sizeof(endpoints1[0]));
+	endpoints2 = calloc(num_ifs, sizeof(endpoints2[0]));
+	states = calloc(num_ifs, sizeof(states[0]));
+	if (endpoints1 == NULL || endpoints2 == NULL || states == NULL) {
+		ERROR_PRINTF("calloc() failed\n");
+		error = -ENOMEM;
+		goto out;
+	}
 
-	printf("endpoints:\n");
 	for (k = 0; k < num_ifs; ++k) {
-		memset(&endpoint1, 0, sizeof(struct dprc_endpoint));
-		memset(&endpoint2, 0, sizeof(struct dprc_endpoint));
-		strncpy(endpoint1.type, "dpsw", EP_OBJ_TYPE_MAX_LEN);
-		endpoint1.type[EP_OBJ_TYPE_MAX_LEN] = '\0';
-		endpoint1.id = target_id;
-		endpoint1.if_id = k;
-
-		error = dprc_get_connection(&restool.mc_io, 0,
-					restool.root_dprc_handle,
-					&endpoint1,
-					&endpoint2,
-					&state);
-		printf("endpoint state: %d\n", state);
-
-		if (error == 0 && state == -1) {
-			printf("\tinterface %d: No object associated\n", k);
-		} else if (error == 0) {
-			if (strcmp(endpoint2.type, "dpsw") == 0 ||
-			    strcmp(endpoint2.type, "dpdmux") == 0) {
-				printf("\tinterface %d: %s.%d.%d",
-					k, endpoint2.type, endpoint2.id,
-					endpoint2.if_id);
-			} else if (endpoint2.if_id == 0) {
-				printf("\tinterface %d: %s.%d",
-					k, endpoint2.type, endpoint2.id);
-			}
+		strncpy(endpoints1[k].type, "dpsw", EP_OBJ_TYPE_MAX_LEN);
+		endpoints1[k].type[EP_OBJ_TYPE_MAX_LEN] = '\0';
+		endpoints1[k].id = target_id;
+		endpoints1[k].if_id = k;
+	}
+
+	/*
+	 * Query the connections of all interfaces at once
+	 */
+	error = dprc_get_connections(&restool.mc_io, 0,
+				     restool.root_dprc_handle, num_ifs,
+				     endpoints1, endpoints2, states);
+	if (error < 0) {
+		mc_status = flib_error_to_mc_status(error);
+		ERROR_PRINTF("MC error: %s (status %#x)\n",
+			mc_status_to_string(mc_status), mc_status);
+		goto out;
+	}
 
-			if (state == 1)
-				printf(", link is up\n");
-			else if (state == 0)
-				printf(", link is down\n");
-			else
-				printf(", link is in error state\n");
+	restool_printf("endpoints:\n");
+	for (k = 0; k < num_ifs; ++k) {
+		struct dprc_endpoint *endpoint2 = &endpoints2[k];
 
-		} else {
-			mc_status = flib_error_to_mc_status(error);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				mc_status_to_string(mc_status), mc_status);
-			return error;
+		restool_printf("endpoint state: %d\n", states[k]);
+		if (states[k] == -1) {
+			restool_printf("\tinterface %d: No object associated\n", k);
+			continue;
 		}
+
+		if (strcmp(endpoint2->type, "dpsw") == 0 ||
+		    strcmp(endpoint2->type, "dpdmux") == 0) {
+			restool_printf("\tinterface %d: %s.%d.%d",
+				k, endpoint2->type, endpoint2->id,
+				endpoint2->if_id);
+		} else if (endpoint2->if_id == 0) {
+			restool_printf("\tinterface %d: %s.%d",
+				k, endpoint2->type, endpoint2->id);
+		}
+
+		if (states[k] == 1)
+			restool_printf(", link is up\n");
+		else if (states[k] == 0)
+			restool_printf(", link is down\n");
+		else
+			restool_printf(", link is in error state\n");
 	}
 
-	return 0;
+out:
+	free(states);
+	free(endpoints2);
+	free(endpoints1);
+	return error;
 }
 
-static int print_dpsw_attr(uint32_t dpsw_id,
-			struct dprc_obj_desc *target_obj_desc)
+static int print_dpsw_attr(struct obj_info *info)
 {
-	uint16_t dpsw_handle;
+	struct dprc_obj_desc *target_obj_desc = &info->desc;
+	uint32_t dpsw_id = info->desc.id;
+	uint16_t dpsw_handle = info->handle;
 	int error;
 	struct dpsw_attr dpsw_attr;
-	bool dpsw_opened = false;
-
-	error = dpsw_open(&restool.mc_io, 0, dpsw_id, &dpsw_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			     mc_status_to_string(mc_status), mc_status);
-		goto out;
-	}
-	dpsw_opened = true;
-	if (0 == dpsw_handle) {
-		DEBUG_PRINTF(
-			"dpsw_open() returned invalid handle (auth 0) for dpsw.%u\n",
-			dpsw_id);
-		error = -ENOENT;
-		goto out;
-	}
+	enum mc_cmd_status mc_status;
 
 	memset(&dpsw_attr, 0, sizeof(dpsw_attr));
 	error = dpsw_get_attributes(&restool.mc_io, 0, dpsw_handle, &dpsw_attr);
@@ -308,83 +309,55 @@ static int print_dpsw_attr(uint32_t dpsw_id,
 	}
 	assert(dpsw_id == (uint32_t)dpsw_attr.id);
 
-	printf("dpsw version: %u.%u\n", dpsw_attr.version.major,
-	       dpsw_attr.version.minor);
-	printf("dpsw id: %d\n", dpsw_attr.id);
-	printf("plugged state: %splugged\n",
+	restool_printf("dpsw version: %u.%u\n", dpsw_attr.version.major,
+		       dpsw_attr.version.minor);
+	restool_printf("dpsw id: %d\n", dpsw_attr.id);
+	restool_printf("plugged state: %splugged\n",
 		(target_obj_desc->state & DPRC_OBJ_STATE_PLUGGED) ? "" : "un");
 	print_dpsw_endpoint(dpsw_id, dpsw_attr.num_ifs);
-	printf("dpsw_attr.options value is: %#llx\n",
-	       (unsigned long long)dpsw_attr.options);
+	restool_printf("dpsw_attr.options value is: %#llx\n",
+		       (unsigned long long)dpsw_attr.options);
 	print_dpsw_options(dpsw_attr.options);
-	printf("max VLANs: %u\n", (uint32_t)dpsw_attr.max_vlans);
-	printf("max FDBs: %u\n", (uint32_t)dpsw_attr.max_fdbs);
-	printf("DPSW frame storage memory size: %u\n",
-	       (uint32_t)dpsw_attr.mem_size);
-	printf("number of interfaces: %u\n", (uint32_t)dpsw_attr.num_ifs);
-	printf("current number of VLANs: %u\n", (uint32_t)dpsw_attr.num_vlans);
-	printf("current number of FDBs: %u\n", (uint32_t)dpsw_attr.num_fdbs);
+	restool_printf("max VLANs: %u\n", (uint32_t)dpsw_attr.max_vlans);
+	restool_printf("max FDBs: %u\n", (uint32_t)dpsw_attr.max_fdbs);
+	restool_printf("DPSW frame storage memory size: %u\n",
+		       (uint32_t)dpsw_attr.mem_size);
+	restool_printf("number of interfaces: %u\n", (uint32_t)dpsw_attr.num_ifs);
+	restool_printf("current number of VLANs: %u\n", (uint32_t)dpsw_attr.num_vlans);
+	restool_printf("current number of FDBs: %u\n", (uint32_t)dpsw_attr.num_fdbs);
 	print_obj_label(target_obj_desc);
 
 	error = 0;
 
 out:
-	if (dpsw_opened) {
-		int error2;
-
-		error2 = dpsw_close(&restool.mc_io, 0, dpsw_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				     mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
-	}
-
 	return error;
 }
 
 static int print_dpsw_info(uint32_t dpsw_id)
 {
-	int error;
-	struct dprc_obj_desc target_obj_desc;
-	uint32_t target_parent_dprc_id;
-	bool found = false;
-
-	memset(&target_obj_desc, 0, sizeof(struct dprc_obj_desc));
-	error = find_target_obj_desc(restool.root_dprc_id,
-				restool.root_dprc_handle, 0, dpsw_id,
-				"dpsw", &target_obj_desc,
-				&target_parent_dprc_id, &found);
-	if (error < 0)
-		goto out;
+	bool verbose = false;
 
-	if (strcmp(target_obj_desc.type, "dpsw")) {
-		printf("dpsw.%d does not exist\n", dpsw_id);
-		return -EINVAL;
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
+		verbose = true;
 	}
 
-	error = print_dpsw_attr(dpsw_id, &target_obj_desc);
-	if (error < 0)
-		goto out;
-
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_VERBOSE)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_VERBOSE);
-		error = print_obj_verbose(&target_obj_desc, &dpsw_ops);
-	}
-
-out:
-	return error;
+	return print_obj_info("dpsw", dpsw_id, &dpsw_ops, print_dpsw_attr,
+			      verbose);
 }
 
 static int cmd_dpsw_info(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpsw info <dpsw-object> [--verbose]\n"
+		"Usage: restool dpsw info <dpsw-object>|--label=<label> [--verbose]\n"
 		"   e.g. restool dpsw info dpsw.2\n"
 		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpsw-object>.\n"
+		"   <dpsw-object> may also be given as label:<label>\n"
+		"   e.g. restool dpsw info --label=my-dpsw\n"
+		"\n"
 		"--verbose\n"
 		"   Shows extended/verbose information about the object\n"
 		"   e.g. restool dpsw info dpsw.2 --verbose\n"
@@ -393,21 +366,21 @@ static int cmd_dpsw_info(void)
 	uint32_t obj_id;
 	int error;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(INFO_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(INFO_OPT_HELP);
 		error = 0;
 		goto out;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpsw", &obj_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpsw", &obj_id);
 	if (error < 0)
 		goto out;
 
@@ -467,24 +440,25 @@ static int create_dpsw(const char *usage_msg)
 	char *str;
 	char *endptr;
 	struct dpsw_attr dpsw_attr;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name != NULL) {
+	if (restool_cmd.obj_name != NULL) {
 		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
-			     restool.obj_name);
-		printf(usage_msg);
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
 		return -EINVAL;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_NUM_IFS)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_NUM_IFS);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_NUM_IFS)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_NUM_IFS);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_NUM_IFS];
+		str = restool_cmd.option_args[CREATE_OPT_NUM_IFS];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -498,10 +472,10 @@ static int create_dpsw(const char *usage_msg)
 		dpsw_cfg.num_ifs = 4; /* Todo: default value not defined */
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_OPTIONS)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_OPTIONS);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_OPTIONS)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_OPTIONS);
 		error = parse_dpsw_create_options(
-				restool.cmd_option_args[CREATE_OPT_OPTIONS],
+				restool_cmd.option_args[CREATE_OPT_OPTIONS],
 				&dpsw_cfg.adv.options);
 		if (error < 0) {
 			DEBUG_PRINTF(
@@ -513,10 +487,10 @@ static int create_dpsw(const char *usage_msg)
 		dpsw_cfg.adv.options = 0;
 	}
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(CREATE_OPT_MAX_VLANS)) {
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(CREATE_OPT_MAX_VLANS);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(CREATE_OPT_MAX_VLANS)) {
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(CREATE_OPT_MAX_VLANS);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_VLANS];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_VLANS];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -530,12 +504,12 @@ static int create_dpsw(const char *usage_msg)
 		dpsw_cfg.adv.max_vlans = 0;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_MAX_FDBS)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAX_FDBS);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_FDBS];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_FDBS];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -549,12 +523,12 @@ static int create_dpsw(const char *usage_msg)
 		dpsw_cfg.adv.max_fdbs = 0;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_MAX_FDB_ENTRIES)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAX_FDB_ENTRIES);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_FDB_ENTRIES];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_FDB_ENTRIES];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -568,12 +542,12 @@ static int create_dpsw(const char *usage_msg)
 		dpsw_cfg.adv.max_fdb_entries = 0;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_FDB_AGING_TIME)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_FDB_AGING_TIME);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_FDB_AGING_TIME];
+		str = restool_cmd.option_args[CREATE_OPT_FDB_AGING_TIME];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -587,12 +561,12 @@ static int create_dpsw(const char *usage_msg)
 		dpsw_cfg.adv.fdb_aging_time = 0;
 	}
 
-	if (restool.cmd_option_mask &
+	if (restool_cmd.option_mask &
 	    ONE_BIT_MASK(CREATE_OPT_MAX_FDB_MC_GROUPS)) {
-		restool.cmd_option_mask &=
+		restool_cmd.option_mask &=
 			~ONE_BIT_MASK(CREATE_OPT_MAX_FDB_MC_GROUPS);
 		errno = 0;
-		str = restool.cmd_option_args[CREATE_OPT_MAX_FDB_MC_GROUPS];
+		str = restool_cmd.option_args[CREATE_OPT_MAX_FDB_MC_GROUPS];
 		val = strtol(str, &endptr, 0);
 
 		if (STRTOL_ERROR(str, endptr, val, errno) ||
@@ -673,8 +647,13 @@ static int cmd_dpsw_destroy(void)
 {
 	static const char usage_msg[] =
 		"\n"
-		"Usage: restool dpsw destroy <dpsw-object>\n"
+		"Usage: restool dpsw destroy <dpsw-object>|--label=<label>\n"
 		"   e.g. restool dpsw destroy dpsw.8\n"
+		"\n"
+		"--label=<label>\n"
+		"   Names the object by its label, in place of <dpsw-object>.\n"
+		"   <dpsw-object> may also be given as label:<label>\n"
+		"   e.g. restool dpsw destroy --label=my-dpsw\n"
 		"\n";
 
 	int error;
@@ -682,26 +661,27 @@ static int cmd_dpsw_destroy(void)
 	uint32_t dpsw_id;
 	uint16_t dpsw_handle;
 	bool dpsw_opened = false;
+	enum mc_cmd_status mc_status;
 
-	if (restool.cmd_option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
-		printf(usage_msg);
-		restool.cmd_option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
+	if (restool_cmd.option_mask & ONE_BIT_MASK(DESTROY_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(DESTROY_OPT_HELP);
 		return 0;
 	}
 
-	if (restool.obj_name == NULL) {
+	if (restool_cmd.obj_name == NULL) {
 		ERROR_PRINTF("<object> argument missing\n");
-		printf(usage_msg);
+		restool_printf(usage_msg);
 		error = -EINVAL;
 		goto out;
 	}
 
-	if (in_use(restool.obj_name, "destroyed")) {
+	if (in_use(restool_cmd.obj_name, "destroyed")) {
 		error = -EBUSY;
 		goto out;
 	}
 
-	error = parse_object_name(restool.obj_name, "dpsw", &dpsw_id);
+	error = parse_object_name(restool_cmd.obj_name, "dpsw", &dpsw_id);
 	if (error < 0)
 		goto out;
 
@@ -710,7 +690,7 @@ static int cmd_dpsw_destroy(void)
 		goto out;
 	}
 
-	error = dpsw_open(&restool.mc_io, 0, dpsw_id, &dpsw_handle);
+	error = open_obj("dpsw", dpsw_id, &dpsw_ops, &dpsw_handle);
 	if (error < 0) {
 		mc_status = flib_error_to_mc_status(error);
 		ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -734,11 +714,12 @@ static int cmd_dpsw_destroy(void)
 		goto out;
 	}
 	dpsw_opened = false;
-	printf("dpsw.%u is destroyed\n", dpsw_id);
+	mc_handle_forget(&restool.handles, "dpsw", dpsw_id);
+	restool_printf("dpsw.%u is destroyed\n", dpsw_id);
 
 out:
 	if (dpsw_opened) {
-		error2 = dpsw_close(&restool.mc_io, 0, dpsw_handle);
+		error2 = close_obj(&dpsw_ops, dpsw_handle);
 		if (error2 < 0) {
 			mc_status = flib_error_to_mc_status(error2);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
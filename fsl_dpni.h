@@ -29,6 +29,8 @@
 #include "fsl_dpkg.h"
 
 struct fsl_mc_io;
+struct mc_async;
+struct mc_ticket;
 
 /**
  * Data Path Network Interface API
@@ -568,6 +570,38 @@ int dpni_get_attributes(struct fsl_mc_io	*mc_io,
 			uint16_t		token,
 			struct dpni_attr	*attr);
 
+/**
+ * dpni_get_attributes_async() - Submit dpni_get_attributes()
+ *			without waiting for the response
+ * @async:	Asynchronous MC command engine
+ * @mc_io:	Pointer to MC portal's I/O object
+ * @cmd_flags:	Command flags; one or more of 'MC_CMD_FLAG_'
+ * @token:	Token of DPNI object
+ * @ticket:	Caller-owned ticket tracking the command
+ *
+ * The response is retrieved with dpni_get_attributes_complete().
+ *
+ * Return:	'0' on Success; Error code otherwise.
+ */
+int dpni_get_attributes_async(struct mc_async	*async,
+			      struct fsl_mc_io	*mc_io,
+			      uint32_t		cmd_flags,
+			      uint16_t		token,
+			      struct mc_ticket	*ticket);
+
+/**
+ * dpni_get_attributes_complete() - Wait for the response
+ *			of dpni_get_attributes_async()
+ * @async:	Asynchronous MC command engine
+ * @ticket:	Ticket passed to dpni_get_attributes_async()
+ * @attr:	Returned object's attributes
+ *
+ * Return:	'0' on Success; Error code otherwise.
+ */
+int dpni_get_attributes_complete(struct mc_async	*async,
+				 struct mc_ticket	*ticket,
+				 struct dpni_attr	*attr);
+
 /* DPNI errors */
 
 /* Extract out of frame header error */
@@ -989,6 +1023,38 @@ int dpni_get_link_state(struct fsl_mc_io	*mc_io,
 			uint16_t		token,
 			struct dpni_link_state	*state);
 
+/**
+ * dpni_get_link_state_async() - Submit dpni_get_link_state()
+ *			without waiting for the response
+ * @async:	Asynchronous MC command engine
+ * @mc_io:	Pointer to MC portal's I/O object
+ * @cmd_flags:	Command flags; one or more of 'MC_CMD_FLAG_'
+ * @token:	Token of DPNI object
+ * @ticket:	Caller-owned ticket tracking the command
+ *
+ * The response is retrieved with dpni_get_link_state_complete().
+ *
+ * Return:	'0' on Success; Error code otherwise.
+ */
+int dpni_get_link_state_async(struct mc_async	*async,
+			      struct fsl_mc_io	*mc_io,
+			      uint32_t		cmd_flags,
+			      uint16_t		token,
+			      struct mc_ticket	*ticket);
+
+/**
+ * dpni_get_link_state_complete() - Wait for the response
+ *			of dpni_get_link_state_async()
+ * @async:	Asynchronous MC command engine
+ * @ticket:	Ticket passed to dpni_get_link_state_async()
+ * @state:	Returned link state
+ *
+ * Return:	'0' on Success; Error code otherwise.
+ */
+int dpni_get_link_state_complete(struct mc_async	*async,
+				 struct mc_ticket	*ticket,
+				 struct dpni_link_state	*state);
+
 /**
  * struct dpni_tx_shaping - Structure representing DPNI tx shaping configuration
  * @rate_limit: rate in Mbps
@@ -1159,6 +1225,38 @@ int dpni_get_primary_mac_addr(struct fsl_mc_io	*mc_io,
 			      uint16_t		token,
 			      uint8_t		mac_addr[6]);
 
+/**
+ * dpni_get_primary_mac_addr_async() - Submit dpni_get_primary_mac_addr()
+ *			without waiting for the response
+ * @async:	Asynchronous MC command engine
+ * @mc_io:	Pointer to MC portal's I/O object
+ * @cmd_flags:	Command flags; one or more of 'MC_CMD_FLAG_'
+ * @token:	Token of DPNI object
+ * @ticket:	Caller-owned ticket tracking the command
+ *
+ * The response is retrieved with dpni_get_primary_mac_addr_complete().
+ *
+ * Return:	'0' on Success; Error code otherwise.
+ */
+int dpni_get_primary_mac_addr_async(struct mc_async	*async,
+				    struct fsl_mc_io	*mc_io,
+				    uint32_t		cmd_flags,
+				    uint16_t		token,
+				    struct mc_ticket	*ticket);
+
+/**
+ * dpni_get_primary_mac_addr_complete() - Wait for the response
+ *			of dpni_get_primary_mac_addr_async()
+ * @async:	Asynchronous MC command engine
+ * @ticket:	Ticket passed to dpni_get_primary_mac_addr_async()
+ * @mac_addr:	Returned MAC address
+ *
+ * Return:	'0' on Success; Error code otherwise.
+ */
+int dpni_get_primary_mac_addr_complete(struct mc_async	*async,
+				       struct mc_ticket	*ticket,
+				       uint8_t		mac_addr[6]);
+
 /**
  * dpni_add_mac_addr() - Add MAC address filter
  * @mc_io:	Pointer to MC portal's I/O object
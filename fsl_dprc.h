@@ -31,6 +31,8 @@
  */
 
 struct fsl_mc_io;
+struct mc_async;
+struct mc_ticket;
 
 /**
  * Set this value as the icid value in dprc_cfg structure when creating a
@@ -705,6 +707,34 @@ int dprc_get_obj(struct fsl_mc_io	*mc_io,
 		 int			obj_index,
 		 struct dprc_obj_desc	*obj_desc);
 
+/**
+ * Number of dprc_get_obj() commands sent together by dprc_get_objs()
+ */
+#define DPRC_GET_OBJS_BATCH_SIZE	32
+
+/**
+ * dprc_get_objs() - Get general information on a range of objects
+ * @mc_io:	Pointer to MC portal's I/O object
+ * @cmd_flags:	Command flags; one or more of 'MC_CMD_FLAG_'
+ * @token:	Token of DPRC object
+ * @first_index: Index of the first object to be queried
+ * @num_objs:	Number of objects to be queried
+ *		(first_index + num_objs <= obj_count)
+ * @obj_descs:	Returns the requested object descriptors; array of
+ *		'num_objs' entries
+ *
+ * Same as calling dprc_get_obj() for each index in the range, but the
+ * commands are submitted to the MC in batches of DPRC_GET_OBJS_BATCH_SIZE.
+ *
+ * Return:	'0' on Success; Error code otherwise.
+ */
+int dprc_get_objs(struct fsl_mc_io	*mc_io,
+		  uint32_t		cmd_flags,
+		  uint16_t		token,
+		  int			first_index,
+		  int			num_objs,
+		  struct dprc_obj_desc	*obj_descs);
+
 /**
  * dprc_get_obj_desc() - Get object descriptor.
  *
@@ -982,4 +1012,65 @@ int dprc_get_connection(struct fsl_mc_io		*mc_io,
 			struct dprc_endpoint		*endpoint2,
 			int				*state);
 
+/**
+ * dprc_get_connection_async() - Submit dprc_get_connection()
+ *			without waiting for the response
+ * @async:	Asynchronous MC command engine
+ * @mc_io:	Pointer to MC portal's I/O object
+ * @cmd_flags:	Command flags; one or more of 'MC_CMD_FLAG_'
+ * @token:	Token of DPRC object
+ * @endpoint1:	Endpoint 1 configuration parameters
+ * @ticket:	Caller-owned ticket tracking the command
+ *
+ * The response is retrieved with dprc_get_connection_complete().
+ *
+ * Return:	'0' on Success; Error code otherwise.
+ */
+int dprc_get_connection_async(struct mc_async			*async,
+			      struct fsl_mc_io			*mc_io,
+			      uint32_t				cmd_flags,
+			      uint16_t				token,
+			      const struct dprc_endpoint	*endpoint1,
+			      struct mc_ticket			*ticket);
+
+/**
+ * dprc_get_connection_complete() - Wait for the response
+ *			of dprc_get_connection_async()
+ * @async:	Asynchronous MC command engine
+ * @ticket:	Ticket passed to dprc_get_connection_async()
+ * @endpoint2:	Returned endpoint 2 configuration parameters
+ * @state:	Returned link state: 1 - link is up, 0 - link is down
+ *
+ * Return:	'0' on Success; -ENAVAIL if connection does not exist.
+ */
+int dprc_get_connection_complete(struct mc_async	*async,
+				 struct mc_ticket	*ticket,
+				 struct dprc_endpoint	*endpoint2,
+				 int			*state);
+
+/**
+ * dprc_get_connections() - Get the connections of several endpoints
+ * @mc_io:	Pointer to MC portal's I/O object
+ * @cmd_flags:	Command flags; one or more of 'MC_CMD_FLAG_'
+ * @token:	Token of DPRC object
+ * @num_endpoints: Number of endpoints to be queried
+ * @endpoints1:	Endpoints configuration parameters; array of
+ *		'num_endpoints' entries
+ * @endpoints2:	Returned connected endpoints configuration parameters
+ * @states:	Returned link states: 1 - link is up, 0 - link is down,
+ *		-1 - no connection
+ *
+ * Same as calling dprc_get_connection() for each endpoint, but the
+ * commands are submitted to the MC in batches of DPRC_GET_OBJS_BATCH_SIZE.
+ *
+ * Return:	'0' on Success; Error code otherwise.
+ */
+int dprc_get_connections(struct fsl_mc_io		*mc_io,
+			 uint32_t			cmd_flags,
+			 uint16_t			token,
+			 int				num_endpoints,
+			 const struct dprc_endpoint	*endpoints1,
+			 struct dprc_endpoint		*endpoints2,
+			 int				*states);
+
 #endif /* _FSL_DPRC_H */
@@ -42,4 +42,30 @@
 #define RESTOOL_SEND_MC_COMMAND \
 	_IOWR(RESTOOL_IOCTL_TYPE, 0x4, struct mc_command)
 
+/**
+ * Maximum number of MC commands that can be passed in a single
+ * RESTOOL_SEND_MC_COMMANDS ioctl
+ */
+#define RESTOOL_MAX_MC_COMMANDS	64
+
+/**
+ * struct restool_mc_commands - vector of MC commands
+ * @cmds: user-space address of an array of 'struct mc_command'
+ * @num_cmds: number of entries in the @cmds array
+ * @reserved: must be 0
+ *
+ * The driver sends each command to the MC in order and writes each
+ * response back in place. The completion status of every command is
+ * returned in its header, so a failing command does not prevent the
+ * remaining ones from being sent.
+ */
+struct restool_mc_commands {
+	uint64_t cmds;
+	uint32_t num_cmds;
+	uint32_t reserved;
+};
+
+#define RESTOOL_SEND_MC_COMMANDS \
+	_IOWR(RESTOOL_IOCTL_TYPE, 0x5, struct restool_mc_commands)
+
 #endif /* _FSL_MC_IOCTL_H_ */
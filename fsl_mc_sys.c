@@ -28,31 +28,260 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
+#include <endian.h>
+#include <time.h>
 #include <fcntl.h>		/* open() */
 #include <unistd.h>		/* close() */
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include "fsl_mc_sys.h"
 #include "fsl_mc_cmd.h"
 #include "fsl_mc_ioctl.h"
+#include "mc_stats.h"
+#include "mc_trace.h"
+#include "mc_emul.h"
+#include "mc_retry.h"
 #include "utils.h"
 
 #define RESTOOL_DEVICE_FILE  "/dev/mc_restool"
+#define PHYS_MEM_DEVICE_FILE "/dev/mem"
 
-int mc_io_init(struct fsl_mc_io *mc_io)
+/**
+ * Maximum time to poll a user-space mapped MC portal for completion
+ */
+#define MC_PORTAL_TIMEOUT_MS	500
+
+static int mc_status_to_error(enum mc_cmd_status status)
+{
+	switch (status) {
+	case MC_CMD_STATUS_OK:
+		return 0;
+	case MC_CMD_STATUS_AUTH_ERR:
+		return -EACCES;
+	case MC_CMD_STATUS_NO_PRIVILEGE:
+		return -EPERM;
+	case MC_CMD_STATUS_DMA_ERR:
+		return -EIO;
+	case MC_CMD_STATUS_CONFIG_ERR:
+		return -ENXIO;
+	case MC_CMD_STATUS_TIMEOUT:
+		return -ETIMEDOUT;
+	case MC_CMD_STATUS_NO_RESOURCE:
+		return -ENAVAIL;
+	case MC_CMD_STATUS_NO_MEMORY:
+		return -ENOMEM;
+	case MC_CMD_STATUS_BUSY:
+		return -EBUSY;
+	case MC_CMD_STATUS_UNSUPPORTED_OP:
+		return -524;	/* ENOTSUPP in Linux */
+	case MC_CMD_STATUS_INVALID_STATE:
+		return -ENODEV;
+	default:
+		break;
+	}
+
+	return -EINVAL;
+}
+
+/**
+ * Get the error code matching the completion status in the header of
+ * an MC command response
+ */
+int mc_read_cmd_error(const struct mc_command *cmd)
+{
+	return mc_status_to_error(MC_CMD_HDR_READ_STATUS(cmd->header));
+}
+
+/*
+ * "ioctl" transport: commands are sent through the restool kernel driver.
+ * The optional argument overrides the device file.
+ */
+static int mc_ioctl_init(struct fsl_mc_io *mc_io, const char *dev_file)
+{
+	int fd;
+
+	if (dev_file == NULL)
+		dev_file = RESTOOL_DEVICE_FILE;
+
+	fd = open(dev_file, O_RDWR | O_SYNC);
+	if (fd < 0) {
+		int error = -errno;
+
+		ERROR_PRINTF("open() failed for %s (error %d)\n",
+			     dev_file, error);
+		return error;
+	}
+
+	mc_io->fd = fd;
+	mc_io->no_batch_ioctl = false;
+	return 0;
+}
+
+static void mc_ioctl_cleanup(struct fsl_mc_io *mc_io)
+{
+	int error;
+
+	assert(mc_io->fd != -1);
+
+	error = close(mc_io->fd);
+	if (error == -1)
+		ERROR_PRINTF("close failed: %s\n", strerror(errno));
+}
+
+static int mc_ioctl_send_command(struct fsl_mc_io *mc_io,
+				 struct mc_command *cmd)
+{
+	int error;
+
+	error = ioctl(mc_io->fd, RESTOOL_SEND_MC_COMMAND, cmd);
+	if (error == -1) {
+		error = -errno;
+		DEBUG_PRINTF(
+			"ioctl(RESTOOL_SEND_MC_COMMAND) failed with error %d\n",
+			error);
+	}
+
+	return error;
+}
+
+/**
+ * Send up to RESTOOL_MAX_MC_COMMANDS commands in one ioctl.
+ * Returns a negative error code only if the batch could not be sent at all.
+ */
+static int mc_ioctl_send_vector(struct fsl_mc_io *mc_io,
+				  struct mc_command *cmds,
+				  int num_cmds, int *statuses)
+{
+	struct restool_mc_commands vector = {
+		.cmds = (uint64_t)(uintptr_t)cmds,
+		.num_cmds = (uint32_t)num_cmds,
+	};
+	int error;
+
+	assert(num_cmds <= RESTOOL_MAX_MC_COMMANDS);
+	error = ioctl(mc_io->fd, RESTOOL_SEND_MC_COMMANDS, &vector);
+	if (error == -1) {
+		error = -errno;
+		DEBUG_PRINTF(
+			"ioctl(RESTOOL_SEND_MC_COMMANDS) failed with error %d\n",
+			error);
+		return error;
+	}
+
+	for (int i = 0; i < num_cmds; i++)
+		statuses[i] = mc_read_cmd_error(&cmds[i]);
+
+	return 0;
+}
+
+static int mc_ioctl_send_commands(struct fsl_mc_io *mc_io,
+				  struct mc_command *cmds,
+				  int num_cmds, int *statuses)
 {
+	int error;
+
+	if (!mc_io->no_batch_ioctl) {
+		error = mc_ioctl_send_vector(mc_io, cmds, num_cmds, statuses);
+		if (error != -ENOTTY && error != -EINVAL)
+			return error;
+
+		DEBUG_PRINTF("falling back to one ioctl per MC command\n");
+		mc_io->no_batch_ioctl = true;
+	}
+
+	for (int i = 0; i < num_cmds; i++)
+		statuses[i] = mc_ioctl_send_command(mc_io, &cmds[i]);
+
+	return 0;
+}
+
+static int mc_ioctl_get_root_dprc_id(struct fsl_mc_io *mc_io,
+				     uint32_t *root_dprc_id)
+{
+	int error;
+
+	DEBUG_PRINTF("calling ioctl(RESTOOL_GET_ROOT_DPRC_INFO)\n");
+	error = ioctl(mc_io->fd, RESTOOL_GET_ROOT_DPRC_INFO, root_dprc_id);
+	if (error == -1)
+		return -errno;
+
+	DEBUG_PRINTF("ioctl returned MC-bus's root_dprc_id: %#x\n",
+		     *root_dprc_id);
+	return 0;
+}
+
+static const struct mc_io_ops mc_ioctl_ops = {
+	.name = "ioctl",
+	.init = mc_ioctl_init,
+	.cleanup = mc_ioctl_cleanup,
+	.send = mc_ioctl_send_command,
+	.send_batch = mc_ioctl_send_commands,
+	.get_root_dprc_id = mc_ioctl_get_root_dprc_id,
+};
+
+/**
+ * "portal" transport: commands are written directly to a dedicated MC
+ * portal mapped in user space and completion is busy-polled, avoiding a
+ * syscall and the driver lock per command.
+ *
+ * Map the MC portal described by 'portal_spec', which is either the path
+ * of a UIO device exposing the portal as its first memory region, or
+ * "dpmcp.<id>" to map portal <id> through /dev/mem (lab setups only).
+ * The portal must not be used by any other software while mapped.
+ */
+static int mc_portal_init(struct fsl_mc_io *mc_io, const char *portal_spec)
+{
+	const char *dev_file = portal_spec;
+	unsigned int portal_id;
+	off_t map_offset = 0;
+	size_t map_size = (size_t)sysconf(_SC_PAGESIZE);
+	void *map_addr;
 	int fd = -1;
 	int error;
 
-	fd = open(RESTOOL_DEVICE_FILE, O_RDWR | O_SYNC);
+	if (portal_spec == NULL) {
+		ERROR_PRINTF(
+			"portal transport requires a UIO device or dpmcp.<id>\n");
+		return -EINVAL;
+	}
+
+	if (sscanf(portal_spec, "dpmcp.%u", &portal_id) == 1) {
+		if (portal_id >= MAX_MC_PORTALS) {
+			ERROR_PRINTF("Invalid MC portal id: %u\n", portal_id);
+			return -EINVAL;
+		}
+
+		dev_file = PHYS_MEM_DEVICE_FILE;
+		map_offset = (off_t)(MC_PORTALS_BASE_PADDR +
+				     portal_id * MC_PORTAL_STRIDE);
+	}
+
+	fd = open(dev_file, O_RDWR | O_SYNC);
 	if (fd < 0) {
 		error = -errno;
-		perror("open() failed for " RESTOOL_DEVICE_FILE);
+		ERROR_PRINTF("open() failed for %s (error %d)\n",
+			     dev_file, error);
 		goto error;
 	}
 
+	map_addr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+			fd, map_offset);
+	if (map_addr == MAP_FAILED) {
+		error = -errno;
+		ERROR_PRINTF("mmap() failed for %s (error %d)\n",
+			     dev_file, error);
+		goto error;
+	}
+
+	DEBUG_PRINTF("MC portal %s mapped at %p\n", portal_spec, map_addr);
 	mc_io->fd = fd;
+	mc_io->portal = map_addr;
+	mc_io->portal_map_size = map_size;
 	return 0;
 error:
 	if (fd != -1)
@@ -61,28 +290,380 @@ error:
 	return error;
 }
 
-void mc_io_cleanup(struct fsl_mc_io *mc_io)
+static void mc_portal_cleanup(struct fsl_mc_io *mc_io)
 {
 	int error;
 
-	assert(mc_io->fd != -1);
+	error = munmap((void *)mc_io->portal, mc_io->portal_map_size);
+	if (error == -1)
+		ERROR_PRINTF("munmap failed: %s\n", strerror(errno));
 
+	mc_io->portal = NULL;
 	error = close(mc_io->fd);
 	if (error == -1)
-		perror("close failed");
+		ERROR_PRINTF("close failed: %s\n", strerror(errno));
 }
 
-int mc_send_command(struct fsl_mc_io *mc_io, struct mc_command *cmd)
+static uint64_t elapsed_ns(const struct timespec *start)
 {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)(now.tv_sec - start->tv_sec) * 1000000000 +
+	       (now.tv_nsec - start->tv_nsec);
+}
+
+static uint64_t elapsed_ms(const struct timespec *start)
+{
+	return elapsed_ns(start) / 1000000;
+}
+
+/**
+ * Busy-poll the header of the MC portal until the MC has processed the
+ * command it holds. Returns -ETIMEDOUT if the MC is still running it
+ * after MC_PORTAL_TIMEOUT_MS.
+ */
+static int mc_portal_wait(volatile struct mc_command *portal,
+			  uint64_t *header)
+{
+	struct timespec start = { 0 };
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for ( ; ; ) {
+		*header = le64toh(portal->header);
+		if (MC_CMD_HDR_READ_STATUS(*header) != MC_CMD_STATUS_READY)
+			return 0;
+
+		if (elapsed_ms(&start) > MC_PORTAL_TIMEOUT_MS)
+			return -ETIMEDOUT;
+	}
+}
+
+/**
+ * Write a command to the user-space mapped MC portal and busy-poll its
+ * header until the MC has processed it.
+ */
+static int mc_portal_send_command(struct fsl_mc_io *mc_io,
+				  struct mc_command *cmd)
+{
+	volatile struct mc_command *portal = mc_io->portal;
+	uint64_t header;
 	int error;
 
-	error = ioctl(mc_io->fd, RESTOOL_SEND_MC_COMMAND, cmd);
-	if (error == -1) {
-		error = -errno;
-		DEBUG_PRINTF(
-			"ioctl(RESTOOL_SEND_MC_COMMAND) failed with error %d\n",
-			error);
+	/*
+	 * The command that timed out may still be running: overwriting it
+	 * would have its response read as the one of the next command
+	 */
+	if (mc_io->portal_timed_out) {
+		error = mc_portal_wait(portal, &header);
+		if (error < 0) {
+			DEBUG_PRINTF("MC portal still busy with command %#llx\n",
+				     (unsigned long long)header);
+			return error;
+		}
+
+		mc_io->portal_timed_out = false;
+	}
+
+	/* parameters must be visible to the MC before the header */
+	for (int i = 0; i < MC_CMD_NUM_OF_PARAMS; i++)
+		portal->params[i] = htole64(cmd->params[i]);
+
+	__sync_synchronize();
+	portal->header = htole64(cmd->header);
+
+	error = mc_portal_wait(portal, &header);
+	if (error < 0) {
+		DEBUG_PRINTF("MC command %#llx timed out\n",
+			     (unsigned long long)cmd->header);
+		mc_io->portal_timed_out = true;
+		return error;
+	}
+
+	__sync_synchronize();
+	cmd->header = header;
+	for (int i = 0; i < MC_CMD_NUM_OF_PARAMS; i++)
+		cmd->params[i] = le64toh(portal->params[i]);
+
+	return mc_status_to_error(MC_CMD_HDR_READ_STATUS(header));
+}
+
+static const struct mc_io_ops mc_portal_ops = {
+	.name = "portal",
+	.init = mc_portal_init,
+	.cleanup = mc_portal_cleanup,
+	.send = mc_portal_send_command,
+};
+
+static const struct mc_io_ops *const mc_transports[] = {
+	&mc_ioctl_ops,
+	&mc_portal_ops,
+	&mc_replay_ops,
+	&mc_emul_ops,
+};
+
+/**
+ * Initialize 'mc_io' with the transport described by 'transport_spec',
+ * "<name>[:<arg>]", or with the "ioctl" transport if it is NULL.
+ */
+int mc_io_init(struct fsl_mc_io *mc_io, const char *transport_spec)
+{
+	const struct mc_io_ops *ops = NULL;
+	const char *arg = NULL;
+	size_t name_len;
+	int error;
+
+	if (transport_spec == NULL)
+		transport_spec = mc_ioctl_ops.name;
+
+	name_len = strcspn(transport_spec, ":");
+	if (transport_spec[name_len] == ':')
+		arg = &transport_spec[name_len + 1];
+
+	for (unsigned int i = 0; i < ARRAY_SIZE(mc_transports); i++) {
+		if (strlen(mc_transports[i]->name) == name_len &&
+		    strncmp(transport_spec, mc_transports[i]->name,
+			    name_len) == 0) {
+			ops = mc_transports[i];
+			break;
+		}
+	}
+
+	if (ops == NULL) {
+		ERROR_PRINTF("Invalid MC transport: \'%s\'\n", transport_spec);
+		restool_eprintf("Valid transports are:");
+		for (unsigned int i = 0; i < ARRAY_SIZE(mc_transports); i++)
+			restool_eprintf(" %s", mc_transports[i]->name);
+
+		restool_eprintf("\n");
+		return -EINVAL;
+	}
+
+	memset(mc_io, 0, sizeof(*mc_io));
+	mc_io->fd = -1;
+	mc_io->ops = ops;
+	error = ops->init(mc_io, arg);
+	if (error < 0) {
+		mc_io->ops = NULL;
+		return error;
+	}
+
+	pthread_mutex_init(&mc_io->lock, NULL);
+
+	DEBUG_PRINTF("using MC transport \'%s\'\n", ops->name);
+	return 0;
+}
+
+void mc_io_cleanup(struct fsl_mc_io *mc_io)
+{
+	assert(mc_io->ops != NULL);
+
+	mc_io->ops->cleanup(mc_io);
+	mc_io->ops = NULL;
+	pthread_mutex_destroy(&mc_io->lock);
+}
+
+int mc_io_get_root_dprc_id(struct fsl_mc_io *mc_io, uint32_t *root_dprc_id)
+{
+	int error;
+
+	if (mc_io->ops->get_root_dprc_id == NULL)
+		return -EOPNOTSUPP;
+
+	error = mc_io->ops->get_root_dprc_id(mc_io, root_dprc_id);
+	if (error == 0 && mc_trace_recording()) {
+		struct mc_trace_record record = {
+			.type = MC_TRACE_ROOT_DPRC_ID,
+			.response.params[0] = *root_dprc_id,
+		};
+
+		mc_trace_record(&record);
 	}
 
 	return error;
 }
+
+/**
+ * Account a completed command in the statistics and in the trace being
+ * recorded, if any
+ */
+static void mc_command_done(const struct mc_command *request,
+			    const struct mc_command *response,
+			    const struct timespec *start,
+			    uint64_t latency_ns, int error)
+{
+	if (mc_stats_enabled())
+		mc_stats_record(request->header, latency_ns, error);
+
+	if (mc_trace_recording()) {
+		struct mc_trace_record record = {
+			.timestamp_ns = (uint64_t)start->tv_sec * 1000000000 +
+					start->tv_nsec,
+			.latency_ns = latency_ns,
+			.type = MC_TRACE_COMMAND,
+			.error = error,
+			.request = *request,
+			.response = *response,
+		};
+
+		mc_trace_record(&record);
+	}
+}
+
+/**
+ * Send one command through the transport, with the portal lock held
+ */
+static int mc_send_locked(struct fsl_mc_io *mc_io, struct mc_command *cmd)
+{
+	bool account = mc_stats_enabled() || mc_trace_recording();
+	struct mc_command request;
+	struct timespec start = { 0 };
+	int error;
+
+	pthread_mutex_lock(&mc_io->lock);
+	if (account) {
+		request = *cmd;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+	}
+
+	error = mc_io->ops->send(mc_io, cmd);
+	if (account)
+		mc_command_done(&request, cmd, &start, elapsed_ns(&start),
+				error);
+
+	pthread_mutex_unlock(&mc_io->lock);
+	return error;
+}
+
+/**
+ * Whether a command that completed with 'error' may be sent again. A
+ * command timing out in a user-space mapped portal may still be running,
+ * so it is not sent again.
+ */
+static bool mc_may_retry(const struct fsl_mc_io *mc_io, int error)
+{
+	return error == -EBUSY ||
+	       (error == -ETIMEDOUT && mc_io->ops != &mc_portal_ops);
+}
+
+/**
+ * Send 'request' again, as long as the retry policy allows it, after its
+ * first attempt, started at 'start', completed with 'error'. The portal is
+ * not held while backing off, so other threads can use it meanwhile.
+ */
+static int mc_retry_command(struct fsl_mc_io *mc_io, struct mc_command *cmd,
+			    const struct mc_command *request,
+			    const struct timespec *start, int error)
+{
+	struct timespec delay;
+	uint64_t backoff_ns;
+
+	for (int attempts = 1; mc_may_retry(mc_io, error); attempts++) {
+		backoff_ns = mc_retry_backoff(request->header, error, attempts,
+					      elapsed_ns(start));
+		if (backoff_ns == 0)
+			break;
+
+		DEBUG_PRINTF("MC command %#llx failed (error %d), retry %d in %llu us\n",
+			     (unsigned long long)request->header, error,
+			     attempts, (unsigned long long)backoff_ns / 1000);
+
+		delay.tv_sec = backoff_ns / 1000000000;
+		delay.tv_nsec = backoff_ns % 1000000000;
+		while (nanosleep(&delay, &delay) == -1 && errno == EINTR)
+			;
+
+		if (mc_stats_enabled())
+			mc_stats_record_retry(request->header, backoff_ns);
+
+		*cmd = *request;
+		error = mc_send_locked(mc_io, cmd);
+	}
+
+	return error;
+}
+
+int mc_send_command(struct fsl_mc_io *mc_io, struct mc_command *cmd)
+{
+	struct mc_command request = *cmd;
+	struct timespec start = { 0 };
+	int error;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	error = mc_send_locked(mc_io, cmd);
+	if (mc_may_retry(mc_io, error))
+		error = mc_retry_command(mc_io, cmd, &request, &start, error);
+
+	return error;
+}
+
+int mc_send_commands(struct fsl_mc_io *mc_io, struct mc_command *cmds,
+		     int num_cmds, int *statuses)
+{
+	bool account = mc_stats_enabled() || mc_trace_recording();
+	struct mc_command requests[RESTOOL_MAX_MC_COMMANDS];
+	struct timespec start = { 0 };
+	int chunk_statuses[RESTOOL_MAX_MC_COMMANDS];
+	int first_error = 0;
+	int error;
+
+	for (int i = 0; i < num_cmds; i += RESTOOL_MAX_MC_COMMANDS) {
+		int n = num_cmds - i;
+
+		if (n > RESTOOL_MAX_MC_COMMANDS)
+			n = RESTOOL_MAX_MC_COMMANDS;
+
+		memcpy(requests, &cmds[i], n * sizeof(cmds[0]));
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		pthread_mutex_lock(&mc_io->lock);
+
+		if (mc_io->ops->send_batch != NULL) {
+			error = mc_io->ops->send_batch(mc_io, &cmds[i], n,
+						       chunk_statuses);
+			if (error < 0) {
+				for (int j = 0; j < n; j++)
+					chunk_statuses[j] = error;
+			}
+		} else {
+			for (int j = 0; j < n; j++)
+				chunk_statuses[j] =
+					mc_io->ops->send(mc_io, &cmds[i + j]);
+		}
+
+		/*
+		 * commands of a batch complete together: account each of
+		 * them with its share of the batch latency
+		 */
+		if (account) {
+			uint64_t latency = elapsed_ns(&start) / n;
+
+			for (int j = 0; j < n; j++)
+				mc_command_done(&requests[j], &cmds[i + j],
+						&start, latency,
+						chunk_statuses[j]);
+		}
+
+		pthread_mutex_unlock(&mc_io->lock);
+
+		/*
+		 * commands of the batch the MC was too busy for are sent
+		 * again one by one
+		 */
+		for (int j = 0; j < n; j++) {
+			if (mc_may_retry(mc_io, chunk_statuses[j]))
+				chunk_statuses[j] =
+					mc_retry_command(mc_io, &cmds[i + j],
+							 &requests[j], &start,
+							 chunk_statuses[j]);
+		}
+
+		for (int j = 0; j < n; j++) {
+			if (statuses != NULL)
+				statuses[i + j] = chunk_statuses[j];
+			if (first_error == 0)
+				first_error = chunk_statuses[j];
+		}
+	}
+
+	return first_error;
+}
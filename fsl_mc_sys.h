@@ -32,20 +32,110 @@
 #define _FSL_MC_SYS_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
 
 struct mc_command;
+struct fsl_mc_io;
+
+/**
+ * Environment variable selecting the MC transport when no --transport
+ * global option is given, e.g. RESTOOL_TRANSPORT=portal:/dev/uio0
+ */
+#define RESTOOL_TRANSPORT_ENV	"RESTOOL_TRANSPORT"
+
+/**
+ * struct mc_io_ops - MC transport operations
+ */
+struct mc_io_ops {
+	/**
+	 * transport name, as given in a "<name>[:<arg>]" transport spec
+	 */
+	const char *name;
+
+	/**
+	 * set up the transport; 'arg' is the part of the spec after ':',
+	 * or NULL if there was none
+	 */
+	int (*init)(struct fsl_mc_io *mc_io, const char *arg);
+
+	void (*cleanup)(struct fsl_mc_io *mc_io);
+
+	/**
+	 * send one command and wait for its response. Returns 0 or the
+	 * negative error code corresponding to the MC completion status.
+	 */
+	int (*send)(struct fsl_mc_io *mc_io, struct mc_command *cmd);
+
+	/**
+	 * optional: send several independent commands, storing each
+	 * command's completion code in statuses[]. A negative return value
+	 * means the batch could not be sent at all.
+	 */
+	int (*send_batch)(struct fsl_mc_io *mc_io, struct mc_command *cmds,
+			  int num_cmds, int *statuses);
+
+	/**
+	 * optional: get the id of the root DPRC the transport gives access to
+	 */
+	int (*get_root_dprc_id)(struct fsl_mc_io *mc_io,
+				uint32_t *root_dprc_id);
+};
 
 /**
  * struct fsl_mc_io - MC I/O object
  */
 struct fsl_mc_io {
+	const struct mc_io_ops *ops;
+
 	int fd;
+
+	/**
+	 * MC portal mapped in user space by the "portal" transport
+	 */
+	volatile struct mc_command *portal;
+
+	/**
+	 * size of the mapping pointed to by portal
+	 */
+	size_t portal_map_size;
+
+	/**
+	 * set when a command timed out in the portal: the MC may still be
+	 * running it, so no command is written to the portal before its
+	 * header leaves the READY state
+	 */
+	bool portal_timed_out;
+
+	/**
+	 * set when the driver does not support RESTOOL_SEND_MC_COMMANDS
+	 */
+	bool no_batch_ioctl;
+
+	/**
+	 * transport-specific state
+	 */
+	void *priv;
+
+	/**
+	 * serializes commands sent through this MC I/O object by several
+	 * threads; a portal only holds one command at a time
+	 */
+	pthread_mutex_t lock;
 };
 
-int mc_io_init(struct fsl_mc_io *mc_io);
+int mc_io_init(struct fsl_mc_io *mc_io, const char *transport_spec);
 
 void mc_io_cleanup(struct fsl_mc_io *mc_io);
 
+int mc_io_get_root_dprc_id(struct fsl_mc_io *mc_io, uint32_t *root_dprc_id);
+
 int mc_send_command(struct fsl_mc_io *mc_io, struct mc_command *cmd);
 
+int mc_send_commands(struct fsl_mc_io *mc_io, struct mc_command *cmds,
+		     int num_cmds, int *statuses);
+
+int mc_read_cmd_error(const struct mc_command *cmd);
+
 #endif /* _FSL_MC_SYS_H */
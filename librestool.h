@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LIBRESTOOL_H
+#define _LIBRESTOOL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * librestool runs restool object commands inside the calling program.
+ *
+ * A context owns an MC portal, with the root DPRC open on it, and the
+ * object handle and topology caches of the commands run on it. Contexts
+ * are independent of each other: a program may keep several of them, e.g.
+ * one per MC portal.
+ *
+ * Several threads may run commands in the same context at the same time.
+ * Their MC commands are interleaved on the portal of the context, one MC
+ * command at a time; the objects they change must not overlap.
+ *
+ * Commands report their results through the output function of their
+ * context rather than printing them. It is called by the thread running
+ * the command, possibly by several threads at the same time.
+ */
+struct restool_ctx;
+
+/**
+ * Streams of command output: what restool prints to stdout (results) and
+ * to stderr (errors and debug traces)
+ */
+enum restool_output_stream {
+	RESTOOL_OUTPUT_RESULT,
+	RESTOOL_OUTPUT_ERROR,
+};
+
+/**
+ * Output function of a context, called with each piece of text a command
+ * outputs ('len' bytes, not null terminated). Lines may be split over
+ * several calls.
+ */
+typedef void restool_output_fn_t(void *arg,
+				 enum restool_output_stream stream,
+				 const char *text, size_t len);
+
+/**
+ * struct restool_ctx_params - settings of a new context
+ */
+struct restool_ctx_params {
+	/**
+	 * MC transport, as with restool --transport; NULL for the restool
+	 * driver
+	 */
+	const char *transport_spec;
+
+	/**
+	 * additional MC portals, as with restool --portal-pool; NULL for none
+	 */
+	const char *portal_pool_spec;
+
+	/**
+	 * output function and its argument; NULL to print to stdout and
+	 * stderr
+	 */
+	restool_output_fn_t *output;
+	void *output_arg;
+
+	/**
+	 * as restool --debug and --script
+	 */
+	bool debug;
+	bool script;
+
+	/**
+	 * do not talk to the MC: only help commands can be run
+	 */
+	bool offline;
+};
+
+int restool_ctx_create(const struct restool_ctx_params *params,
+		       struct restool_ctx **ctx);
+
+int restool_ctx_destroy(struct restool_ctx *ctx);
+
+int restool_ctx_run(struct restool_ctx *ctx, int argc, char *argv[]);
+
+#endif /* _LIBRESTOOL_H */
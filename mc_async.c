@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "mc_async.h"
+#include "utils.h"
+
+static void *mc_async_lane_thread(void *thread_arg)
+{
+	struct mc_async_lane *lane = thread_arg;
+	struct mc_async *async = lane->async;
+	struct mc_ticket *ticket;
+	uint64_t one = 1;
+	int error;
+
+	(void)restool_ctx_switch(async->ctx);
+	pthread_mutex_lock(&async->lock);
+	for ( ; ; ) {
+		while (!async->stopping && lane->head == NULL)
+			pthread_cond_wait(&lane->work_cond, &async->lock);
+
+		ticket = lane->head;
+		if (ticket == NULL)
+			break;
+
+		lane->head = ticket->next;
+		if (lane->head == NULL)
+			lane->tail = NULL;
+
+		pthread_mutex_unlock(&async->lock);
+		error = mc_send_command(lane->mc_io, &ticket->cmd);
+		pthread_mutex_lock(&async->lock);
+
+		ticket->status = error;
+		ticket->state = MC_TICKET_DONE;
+		ticket->next = NULL;
+		if (async->done_tail != NULL)
+			async->done_tail->next = ticket;
+		else
+			async->done_head = ticket;
+
+		async->done_tail = ticket;
+		if (write(async->event_fd, &one, sizeof(one)) != sizeof(one))
+			DEBUG_PRINTF("eventfd write failed (errno %d)\n",
+				     errno);
+
+		pthread_cond_broadcast(&async->done_cond);
+	}
+
+	pthread_mutex_unlock(&async->lock);
+	return NULL;
+}
+
+/**
+ * Remove a completed ticket from the completion list. Called with
+ * async->lock held.
+ */
+static void collect_ticket(struct mc_async *async, struct mc_ticket *ticket)
+{
+	struct mc_ticket **prev = &async->done_head;
+	struct mc_ticket *last = NULL;
+	uint64_t count;
+
+	while (*prev != ticket) {
+		last = *prev;
+		prev = &last->next;
+	}
+
+	*prev = ticket->next;
+	if (async->done_tail == ticket)
+		async->done_tail = last;
+
+	if (read(async->event_fd, &count, sizeof(count)) != sizeof(count))
+		DEBUG_PRINTF("eventfd read failed (errno %d)\n", errno);
+
+	ticket->next = NULL;
+	ticket->state = MC_TICKET_IDLE;
+	async->num_pending--;
+}
+
+int mc_async_init(struct mc_async *async)
+{
+	int error;
+
+	memset(async, 0, sizeof(*async));
+	async->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK |
+					EFD_SEMAPHORE);
+	if (async->event_fd < 0) {
+		error = -errno;
+		ERROR_PRINTF("eventfd() failed (error %d)\n", error);
+		return error;
+	}
+
+	pthread_mutex_init(&async->lock, NULL);
+	pthread_cond_init(&async->done_cond, NULL);
+	async->ctx = restool_current;
+	return 0;
+}
+
+/**
+ * Wait for all submitted commands to be sent and stop the lane threads.
+ * Completions not collected yet are dropped.
+ */
+void mc_async_cleanup(struct mc_async *async)
+{
+	pthread_mutex_lock(&async->lock);
+	async->stopping = true;
+	for (int i = 0; i < async->num_lanes; i++)
+		pthread_cond_signal(&async->lanes[i].work_cond);
+
+	pthread_mutex_unlock(&async->lock);
+
+	for (int i = 0; i < async->num_lanes; i++) {
+		pthread_join(async->lanes[i].thread, NULL);
+		pthread_cond_destroy(&async->lanes[i].work_cond);
+	}
+
+	async->num_lanes = 0;
+	pthread_cond_destroy(&async->done_cond);
+	pthread_mutex_destroy(&async->lock);
+	(void)close(async->event_fd);
+	async->event_fd = -1;
+}
+
+/**
+ * Queue the command prepared in ticket->cmd on 'mc_io' and return without
+ * waiting for its response. Commands submitted to the same MC I/O object
+ * are sent in submission order.
+ */
+int mc_async_submit(struct mc_async *async, struct fsl_mc_io *mc_io,
+		    struct mc_ticket *ticket)
+{
+	struct mc_async_lane *lane = NULL;
+	int error = 0;
+
+	assert(ticket->state == MC_TICKET_IDLE);
+	pthread_mutex_lock(&async->lock);
+	for (int i = 0; i < async->num_lanes; i++) {
+		if (async->lanes[i].mc_io == mc_io) {
+			lane = &async->lanes[i];
+			break;
+		}
+	}
+
+	if (lane == NULL) {
+		if (async->num_lanes == MC_ASYNC_MAX_LANES) {
+			ERROR_PRINTF("too many MC portals (max %u)\n",
+				     MC_ASYNC_MAX_LANES);
+			error = -ENOSPC;
+			goto out;
+		}
+
+		lane = &async->lanes[async->num_lanes];
+		lane->async = async;
+		lane->mc_io = mc_io;
+		lane->head = NULL;
+		lane->tail = NULL;
+		pthread_cond_init(&lane->work_cond, NULL);
+		error = pthread_create(&lane->thread, NULL,
+				       mc_async_lane_thread, lane);
+		if (error != 0) {
+			ERROR_PRINTF("pthread_create() failed (error %d)\n",
+				     error);
+			pthread_cond_destroy(&lane->work_cond);
+			error = -error;
+			goto out;
+		}
+
+		async->num_lanes++;
+	}
+
+	ticket->status = 0;
+	ticket->state = MC_TICKET_QUEUED;
+	ticket->next = NULL;
+	if (lane->tail != NULL)
+		lane->tail->next = ticket;
+	else
+		lane->head = ticket;
+
+	lane->tail = ticket;
+	async->num_pending++;
+	pthread_cond_signal(&lane->work_cond);
+out:
+	pthread_mutex_unlock(&async->lock);
+	return error;
+}
+
+/**
+ * Collect the completion of 'ticket' if it is available. Returns
+ * -EINPROGRESS if the command has not completed yet, or its completion code.
+ */
+int mc_async_poll(struct mc_async *async, struct mc_ticket *ticket)
+{
+	int error;
+
+	pthread_mutex_lock(&async->lock);
+	if (ticket->state == MC_TICKET_QUEUED) {
+		error = -EINPROGRESS;
+	} else {
+		if (ticket->state == MC_TICKET_DONE)
+			collect_ticket(async, ticket);
+
+		error = ticket->status;
+	}
+
+	pthread_mutex_unlock(&async->lock);
+	return error;
+}
+
+/**
+ * Wait for 'ticket' to complete and collect it. Returns its completion code.
+ * Waiting on an already collected ticket returns its completion code again.
+ */
+int mc_async_wait(struct mc_async *async, struct mc_ticket *ticket)
+{
+	int error;
+
+	pthread_mutex_lock(&async->lock);
+	while (ticket->state == MC_TICKET_QUEUED)
+		pthread_cond_wait(&async->done_cond, &async->lock);
+
+	if (ticket->state == MC_TICKET_DONE)
+		collect_ticket(async, ticket);
+
+	error = ticket->status;
+	pthread_mutex_unlock(&async->lock);
+	return error;
+}
+
+/**
+ * Wait for any submitted command to complete and collect it, in completion
+ * order. Returns 0 with *ticket set, or -ENOENT if no command is pending.
+ * The completion code is in (*ticket)->status.
+ */
+int mc_async_wait_any(struct mc_async *async, struct mc_ticket **ticket)
+{
+	struct mc_ticket *done;
+	int error;
+
+	pthread_mutex_lock(&async->lock);
+	while (async->done_head == NULL && async->num_pending != 0)
+		pthread_cond_wait(&async->done_cond, &async->lock);
+
+	done = async->done_head;
+	if (done == NULL) {
+		error = -ENOENT;
+		goto out;
+	}
+
+	collect_ticket(async, done);
+	*ticket = done;
+	error = 0;
+out:
+	pthread_mutex_unlock(&async->lock);
+	return error;
+}
+
+/**
+ * File descriptor that polls readable while some completion has not been
+ * collected yet, for use with poll()/epoll
+ */
+int mc_async_get_fd(struct mc_async *async)
+{
+	return async->event_fd;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MC_ASYNC_H
+#define _MC_ASYNC_H
+
+#include <stdbool.h>
+#include <pthread.h>
+#include "fsl_mc_sys.h"
+#include "fsl_mc_cmd.h"
+#include "mc_pool.h"
+
+struct restool_ctx;
+
+/**
+ * Maximum number of distinct MC portals commands can be submitted to: the
+ * main portal of a context and each portal of its portal pool
+ */
+#define MC_ASYNC_MAX_LANES	(MC_POOL_MAX_PORTALS + 1)
+
+enum mc_ticket_state {
+	MC_TICKET_IDLE = 0,
+	MC_TICKET_QUEUED,
+	MC_TICKET_DONE,
+};
+
+/**
+ * struct mc_ticket - one asynchronous MC command
+ *
+ * The ticket is owned by the caller and must stay valid until its
+ * completion has been collected by mc_async_poll(), mc_async_wait() or
+ * mc_async_wait_any(). Once collected, 'cmd' holds the response and
+ * 'status' the completion code.
+ */
+struct mc_ticket {
+	struct mc_command cmd;
+	int status;
+	enum mc_ticket_state state;
+	struct mc_ticket *next;
+};
+
+/**
+ * struct mc_async_lane - submission queue of one MC portal
+ *
+ * Commands of a lane are sent in submission order by the lane's thread.
+ */
+struct mc_async_lane {
+	struct mc_async *async;
+	struct fsl_mc_io *mc_io;
+	pthread_t thread;
+	pthread_cond_t work_cond;
+	struct mc_ticket *head;
+	struct mc_ticket *tail;
+};
+
+/**
+ * struct mc_async - asynchronous MC command engine
+ */
+struct mc_async {
+	pthread_mutex_t lock;
+	pthread_cond_t done_cond;
+	int num_lanes;
+	struct mc_async_lane lanes[MC_ASYNC_MAX_LANES];
+
+	/**
+	 * tickets completed but not collected yet, in completion order
+	 */
+	struct mc_ticket *done_head;
+	struct mc_ticket *done_tail;
+
+	/**
+	 * number of tickets submitted and not collected yet
+	 */
+	int num_pending;
+
+	/**
+	 * eventfd readable while some completion is not collected yet
+	 */
+	int event_fd;
+	bool stopping;
+
+	/**
+	 * restool context the lane threads report errors in
+	 */
+	struct restool_ctx *ctx;
+};
+
+int mc_async_init(struct mc_async *async);
+
+void mc_async_cleanup(struct mc_async *async);
+
+int mc_async_submit(struct mc_async *async, struct fsl_mc_io *mc_io,
+		    struct mc_ticket *ticket);
+
+int mc_async_poll(struct mc_async *async, struct mc_ticket *ticket);
+
+int mc_async_wait(struct mc_async *async, struct mc_ticket *ticket);
+
+int mc_async_wait_any(struct mc_async *async, struct mc_ticket **ticket);
+
+int mc_async_get_fd(struct mc_async *async);
+
+#endif /* _MC_ASYNC_H */
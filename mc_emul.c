@@ -0,0 +1,1950 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include "mc_emul.h"
+#include "utils.h"
+#include "fsl_mc_cmd.h"
+
+/*
+ * The emulator runs the flib command macros backwards: MC_CMD_OP() extracts
+ * a field from a request and MC_RSP_OP() inserts a field into a response,
+ * so request and response layouts come from the same *_cmd.h files the
+ * flib uses.
+ */
+#undef MC_CMD_OP
+#undef MC_RSP_OP
+
+#define MC_CMD_OP(_cmd, _param, _offset, _width, _type, _arg) \
+	(_arg = (_type)mc_dec((_cmd).params[_param], (_offset), (_width)))
+
+#define MC_RSP_OP(_cmd, _param, _offset, _width, _type, _arg) \
+	((_cmd).params[_param] |= mc_enc((_offset), (_width), _arg))
+
+#include "fsl_dpmng.h"
+#include "fsl_dpmng_cmd.h"
+#include "fsl_dprc.h"
+#include "fsl_dprc_cmd.h"
+#include "fsl_dpni.h"
+#include "fsl_dpni_cmd.h"
+#include "fsl_dpmac.h"
+#include "fsl_dpmac_cmd.h"
+#include "fsl_dpio.h"
+#include "fsl_dpio_cmd.h"
+#include "fsl_dpbp.h"
+#include "fsl_dpbp_cmd.h"
+#include "fsl_dpcon.h"
+#include "fsl_dpcon_cmd.h"
+#include "fsl_dpmcp.h"
+#include "fsl_dpmcp_cmd.h"
+#include "fsl_dpci.h"
+#include "fsl_dpci_cmd.h"
+#include "fsl_dpseci.h"
+#include "fsl_dpseci_cmd.h"
+#include "fsl_dpsw.h"
+#include "fsl_dpsw_cmd.h"
+#include "fsl_dpdmux.h"
+#include "fsl_dpdmux_cmd.h"
+#include "fsl_dpaiop.h"
+#include "fsl_dpaiop_cmd.h"
+#include "fsl_dpdcei.h"
+#include "fsl_dpdcei_cmd.h"
+
+#define EMUL_ROOT_DPRC_ID	1
+
+/**
+ * MC object tokens are 10-bit wide; token 0 is never handed out
+ */
+#define EMUL_MAX_TOKENS		1024
+
+#define EMUL_NUM_CMD_IDS	4096
+#define EMUL_VENDOR_ID		0x1957
+
+/**
+ * Offset between the command IDs of the open and create commands of
+ * an object type
+ */
+#define EMUL_CREATE_CMDID_OFFSET	0x100
+
+#define EMUL_CMDID_CLOSE	0x800
+#define EMUL_CMDID_DESTROY	0x900
+
+enum emul_obj_type {
+	EMUL_DPRC = 0,
+	EMUL_DPNI,
+	EMUL_DPMAC,
+	EMUL_DPIO,
+	EMUL_DPBP,
+	EMUL_DPCON,
+	EMUL_DPMCP,
+	EMUL_DPCI,
+	EMUL_DPSECI,
+	EMUL_DPSW,
+	EMUL_DPDMUX,
+	EMUL_DPAIOP,
+	EMUL_DPDCEI,
+	EMUL_NUM_OBJ_TYPES
+};
+
+struct emul_obj;
+
+struct emul_obj_type_desc {
+	const char *name;
+	uint16_t open_cmdid;
+	uint16_t ver_major;
+	uint16_t ver_minor;
+	uint8_t irq_count;
+	uint8_t region_count;
+
+	/**
+	 * number of objects of this type in each container of the default
+	 * topology
+	 */
+	int default_count;
+	void (*get_attr)(const struct emul_obj *obj, struct mc_command *rsp);
+};
+
+static const struct emul_obj_type_desc emul_obj_types[EMUL_NUM_OBJ_TYPES];
+
+/**
+ * Resource pools of the emulated MC, all of them held by the root container
+ * at start-up
+ */
+static const struct {
+	const char *name;
+	int count;
+} emul_res_types[] = {
+	{ "bp", 64 },
+	{ "cg", 128 },
+	{ "fq", 1024 },
+	{ "qpr", 64 },
+	{ "qd", 256 },
+};
+
+#define EMUL_NUM_RES_TYPES ARRAY_SIZE(emul_res_types)
+
+/**
+ * struct emul_ids - sorted set of resource IDs
+ */
+struct emul_ids {
+	int *ids;
+	int num;
+	int max;
+};
+
+struct emul_obj {
+	enum emul_obj_type type;
+	int id;
+
+	/**
+	 * index of the DPRC object holding this object, -1 for the root DPRC
+	 */
+	int container;
+	bool destroyed;
+	uint32_t state;
+	int open_count;
+	char label[16];
+
+	/**
+	 * create command the object was created with, zeroed for objects of
+	 * the initial topology; attributes are derived from it
+	 */
+	struct mc_command create_cmd;
+	uint32_t irq_mask;
+	uint32_t irq_status;
+
+	/**
+	 * number of counter reads, used to make counters move
+	 */
+	uint64_t counter_reads;
+
+	/**
+	 * DPRC objects only: indexes of the objects held, in assignment order,
+	 * and the resources held
+	 */
+	int *children;
+	int num_children;
+	int max_children;
+	struct emul_ids res[EMUL_NUM_RES_TYPES];
+};
+
+struct emul_link {
+	int obj[2];
+	uint16_t if_id[2];
+	struct dprc_connection_cfg cfg;
+};
+
+struct emul_spec {
+	int counts[EMUL_NUM_OBJ_TYPES];
+	int containers;
+	int depth;
+
+	/**
+	 * label every object after its type and id, e.g. "dpni3"
+	 */
+	bool labels;
+};
+
+/**
+ * struct emul_mc - state of the emulated MC, shared by all "emul" MC I/O
+ * objects of the process
+ */
+struct emul_mc {
+	pthread_mutex_t lock;
+	int refcount;
+
+	/**
+	 * objects are never freed: destroyed ones are left in place so that
+	 * indexes stay valid
+	 */
+	struct emul_obj *objs;
+	int num_objs;
+	int max_objs;
+
+	/**
+	 * object index + 1 of each object ID, per type; 0 if there is none
+	 */
+	int *by_id[EMUL_NUM_OBJ_TYPES];
+	int by_id_size[EMUL_NUM_OBJ_TYPES];
+	int next_id[EMUL_NUM_OBJ_TYPES];
+
+	struct emul_link *links;
+	int num_links;
+	int max_links;
+
+	/**
+	 * object index + 1 of each open token; 0 if the token is free
+	 */
+	int tokens[EMUL_MAX_TOKENS];
+
+	/**
+	 * delays injected before returning responses, in ns; -1 in
+	 * cmd_latency_ns[] means 'latency_ns' applies
+	 */
+	int64_t latency_ns;
+	int64_t cmd_latency_ns[EMUL_NUM_CMD_IDS];
+
+	/**
+	 * percentage of commands completed with MC_CMD_STATUS_BUSY without
+	 * being executed
+	 */
+	int busy_pct;
+	unsigned int busy_seed;
+};
+
+static struct emul_mc *emul_mc;
+static pthread_mutex_t emul_mc_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Grow 'array' to hold at least 'needed' elements of 'elem_size' bytes,
+ * zeroing the new elements. Returns the new array, or NULL (leaving 'array'
+ * untouched) if out of memory.
+ */
+static void *emul_grow(void *array, int *max, int needed, size_t elem_size)
+{
+	char *new_array;
+	int new_max;
+
+	if (needed <= *max)
+		return array;
+
+	new_max = *max != 0 ? *max * 2 : 16;
+	while (new_max < needed)
+		new_max *= 2;
+
+	new_array = realloc(array, new_max * elem_size);
+	if (new_array == NULL)
+		return NULL;
+
+	memset(new_array + *max * elem_size, 0,
+	       (new_max - *max) * elem_size);
+	*max = new_max;
+	return new_array;
+}
+
+static int emul_ids_find(const struct emul_ids *ids, int id)
+{
+	int lo = 0;
+	int hi = ids->num;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (ids->ids[mid] < id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+static int emul_ids_insert(struct emul_ids *ids, int id)
+{
+	int *new_ids;
+	int pos;
+
+	new_ids = emul_grow(ids->ids, &ids->max, ids->num + 1, sizeof(int));
+	if (new_ids == NULL)
+		return -ENOMEM;
+
+	ids->ids = new_ids;
+	pos = emul_ids_find(ids, id);
+	memmove(&ids->ids[pos + 1], &ids->ids[pos],
+		(ids->num - pos) * sizeof(int));
+	ids->ids[pos] = id;
+	ids->num++;
+	return 0;
+}
+
+static bool emul_ids_remove(struct emul_ids *ids, int id)
+{
+	int pos = emul_ids_find(ids, id);
+
+	if (pos == ids->num || ids->ids[pos] != id)
+		return false;
+
+	memmove(&ids->ids[pos], &ids->ids[pos + 1],
+		(ids->num - pos - 1) * sizeof(int));
+	ids->num--;
+	return true;
+}
+
+static int emul_obj_type_by_name(const char *name)
+{
+	for (int i = 0; i < EMUL_NUM_OBJ_TYPES; i++) {
+		if (strcmp(emul_obj_types[i].name, name) == 0)
+			return i;
+	}
+
+	return -1;
+}
+
+static int emul_res_type_by_name(const char *name)
+{
+	for (unsigned int i = 0; i < EMUL_NUM_RES_TYPES; i++) {
+		if (strcmp(emul_res_types[i].name, name) == 0)
+			return i;
+	}
+
+	return -1;
+}
+
+/**
+ * Find a live object by type and ID. Returns its index or -1.
+ */
+static int emul_find(const struct emul_mc *mc, int type, int id)
+{
+	if (type < 0 || id < 0 || id >= mc->by_id_size[type])
+		return -1;
+
+	return mc->by_id[type][id] - 1;
+}
+
+static int emul_find_by_name(const struct emul_mc *mc, const char *type,
+			     int id)
+{
+	return emul_find(mc, emul_obj_type_by_name(type), id);
+}
+
+static void emul_notify(struct emul_mc *mc, int container, uint32_t event)
+{
+	if (container >= 0)
+		mc->objs[container].irq_status |= event;
+}
+
+/**
+ * Make 'container' hold object 'idx', taking it away from its current
+ * container if any
+ */
+static int emul_move(struct emul_mc *mc, int idx, int container)
+{
+	struct emul_obj *dest = &mc->objs[container];
+	int old_container = mc->objs[idx].container;
+	int *children;
+
+	children = emul_grow(dest->children, &dest->max_children,
+			     dest->num_children + 1, sizeof(int));
+	if (children == NULL)
+		return -ENOMEM;
+
+	dest->children = children;
+	if (old_container >= 0) {
+		struct emul_obj *src = &mc->objs[old_container];
+
+		for (int i = 0; i < src->num_children; i++) {
+			if (src->children[i] != idx)
+				continue;
+
+			memmove(&src->children[i], &src->children[i + 1],
+				(src->num_children - i - 1) * sizeof(int));
+			src->num_children--;
+			break;
+		}
+	}
+
+	dest->children[dest->num_children++] = idx;
+	mc->objs[idx].container = container;
+	return 0;
+}
+
+/**
+ * Create an object of the given type in 'container' (-1 for the root DPRC).
+ * 'id' is the requested object ID, or -1 to pick the next free one.
+ * Returns the index of the new object or a negative error code.
+ */
+static int emul_new_obj(struct emul_mc *mc, enum emul_obj_type type, int id,
+			int container, const struct mc_command *create_cmd)
+{
+	struct emul_obj *objs;
+	struct emul_obj *obj;
+	int *by_id;
+	int idx;
+	int error;
+
+	if (id < 0)
+		id = mc->next_id[type];
+	else if (emul_find(mc, type, id) >= 0)
+		return -EEXIST;
+
+	objs = emul_grow(mc->objs, &mc->max_objs, mc->num_objs + 1,
+			 sizeof(struct emul_obj));
+	if (objs == NULL)
+		return -ENOMEM;
+
+	mc->objs = objs;
+	by_id = emul_grow(mc->by_id[type], &mc->by_id_size[type], id + 1,
+			  sizeof(int));
+	if (by_id == NULL)
+		return -ENOMEM;
+
+	mc->by_id[type] = by_id;
+	idx = mc->num_objs;
+	obj = &mc->objs[idx];
+	memset(obj, 0, sizeof(*obj));
+	obj->type = type;
+	obj->id = id;
+	obj->container = -1;
+	if (create_cmd != NULL)
+		obj->create_cmd = *create_cmd;
+
+	if (container >= 0) {
+		error = emul_move(mc, idx, container);
+		if (error < 0)
+			return error;
+	}
+
+	mc->num_objs++;
+	by_id[id] = idx + 1;
+	if (id >= mc->next_id[type])
+		mc->next_id[type] = id + 1;
+
+	return idx;
+}
+
+static int emul_find_link(const struct emul_mc *mc, int idx, uint16_t if_id,
+			  int *side)
+{
+	for (int i = 0; i < mc->num_links; i++) {
+		for (int s = 0; s < 2; s++) {
+			if (mc->links[i].obj[s] == idx &&
+			    mc->links[i].if_id[s] == if_id) {
+				*side = s;
+				return i;
+			}
+		}
+	}
+
+	return -1;
+}
+
+static int emul_add_link(struct emul_mc *mc, int idx1, uint16_t if_id1,
+			 int idx2, uint16_t if_id2,
+			 const struct dprc_connection_cfg *cfg)
+{
+	struct emul_link *links;
+	struct emul_link *link;
+
+	links = emul_grow(mc->links, &mc->max_links, mc->num_links + 1,
+			  sizeof(struct emul_link));
+	if (links == NULL)
+		return -ENOMEM;
+
+	mc->links = links;
+	link = &links[mc->num_links++];
+	link->obj[0] = idx1;
+	link->if_id[0] = if_id1;
+	link->obj[1] = idx2;
+	link->if_id[1] = if_id2;
+	link->cfg = *cfg;
+	return 0;
+}
+
+static void emul_remove_link(struct emul_mc *mc, int link)
+{
+	mc->links[link] = mc->links[--mc->num_links];
+}
+
+static void emul_remove_obj_links(struct emul_mc *mc, int idx)
+{
+	for (int i = 0; i < mc->num_links; ) {
+		if (mc->links[i].obj[0] == idx || mc->links[i].obj[1] == idx)
+			emul_remove_link(mc, i);
+		else
+			i++;
+	}
+}
+
+/**
+ * Take a destroyed object out of its container and of the ID map
+ */
+static void emul_forget_obj(struct emul_mc *mc, int idx)
+{
+	struct emul_obj *obj = &mc->objs[idx];
+	struct emul_obj *container;
+
+	emul_remove_obj_links(mc, idx);
+	if (obj->container >= 0) {
+		container = &mc->objs[obj->container];
+		for (int i = 0; i < container->num_children; i++) {
+			if (container->children[i] != idx)
+				continue;
+
+			memmove(&container->children[i],
+				&container->children[i + 1],
+				(container->num_children - i - 1) *
+				sizeof(int));
+			container->num_children--;
+			break;
+		}
+	}
+
+	mc->by_id[obj->type][obj->id] = 0;
+	obj->destroyed = true;
+	obj->state = 0;
+}
+
+/**
+ * Destroy a container, handing its objects and resources over to
+ * 'target'; nested containers are destroyed as well.
+ */
+static int emul_destroy_container(struct emul_mc *mc, int container,
+				  int target)
+{
+	struct emul_obj *obj;
+	int error;
+
+	while (mc->objs[container].num_children > 0) {
+		int child = mc->objs[container].children[0];
+
+		if (mc->objs[child].type == EMUL_DPRC) {
+			error = emul_destroy_container(mc, child, target);
+		} else {
+			error = emul_move(mc, child, target);
+			mc->objs[child].state &= ~DPRC_OBJ_STATE_PLUGGED;
+		}
+
+		if (error < 0)
+			return error;
+	}
+
+	obj = &mc->objs[container];
+	for (unsigned int r = 0; r < EMUL_NUM_RES_TYPES; r++) {
+		while (obj->res[r].num > 0) {
+			error = emul_ids_insert(&mc->objs[target].res[r],
+						obj->res[r].ids[0]);
+			if (error < 0)
+				return error;
+
+			(void)emul_ids_remove(&obj->res[r], obj->res[r].ids[0]);
+		}
+	}
+
+	emul_forget_obj(mc, container);
+	emul_notify(mc, target, DPRC_IRQ_EVENT_OBJ_ADDED |
+				DPRC_IRQ_EVENT_OBJ_DESTROYED);
+	return 0;
+}
+
+static int emul_populate(struct emul_mc *mc, int container,
+			 const struct emul_spec *spec, int depth)
+{
+	struct dprc_connection_cfg link_cfg = { 0 };
+	int first_obj[EMUL_NUM_OBJ_TYPES];
+	int num_links;
+	int idx;
+	int error;
+
+	for (int t = 0; t < EMUL_NUM_OBJ_TYPES; t++) {
+		first_obj[t] = mc->num_objs;
+		for (int i = 0; i < spec->counts[t]; i++) {
+			idx = emul_new_obj(mc, t, -1, container, NULL);
+			if (idx < 0)
+				return idx;
+
+			mc->objs[idx].state = DPRC_OBJ_STATE_PLUGGED;
+		}
+	}
+
+	/*
+	 * Each DPNI is connected to the DPMAC of the same rank
+	 */
+	num_links = spec->counts[EMUL_DPNI] < spec->counts[EMUL_DPMAC] ?
+		    spec->counts[EMUL_DPNI] : spec->counts[EMUL_DPMAC];
+	for (int i = 0; i < num_links; i++) {
+		error = emul_add_link(mc, first_obj[EMUL_DPNI] + i, 0,
+				      first_obj[EMUL_DPMAC] + i, 0, &link_cfg);
+		if (error < 0)
+			return error;
+	}
+
+	if (depth == 0)
+		return 0;
+
+	for (int i = 0; i < spec->containers; i++) {
+		idx = emul_new_obj(mc, EMUL_DPRC, -1, container, NULL);
+		if (idx < 0)
+			return idx;
+
+		mc->objs[idx].state = DPRC_OBJ_STATE_PLUGGED;
+		error = emul_populate(mc, idx, spec, depth - 1);
+		if (error < 0)
+			return error;
+	}
+
+	return 0;
+}
+
+static int emul_parse_spec(struct emul_mc *mc, const char *arg,
+			   struct emul_spec *spec)
+{
+	char *buf = NULL;
+	char *cursor = NULL;
+	char *key;
+	int error = 0;
+
+	for (int t = 0; t < EMUL_NUM_OBJ_TYPES; t++)
+		spec->counts[t] = emul_obj_types[t].default_count;
+
+	spec->containers = 0;
+	spec->depth = 1;
+	spec->labels = false;
+	mc->latency_ns = 0;
+	mc->busy_pct = 0;
+	mc->busy_seed = 1;
+	for (int i = 0; i < EMUL_NUM_CMD_IDS; i++)
+		mc->cmd_latency_ns[i] = -1;
+
+	if (arg == NULL)
+		return 0;
+
+	buf = strdup(arg);
+	if (buf == NULL) {
+		ERROR_PRINTF("strdup() failed\n");
+		return -ENOMEM;
+	}
+
+	for (key = strtok_r(buf, ",", &cursor); key != NULL;
+	     key = strtok_r(NULL, ",", &cursor)) {
+		char *value = strchr(key, '=');
+		char *endptr;
+		long n;
+		int type;
+
+		if (value == NULL)
+			goto invalid;
+
+		*value++ = '\0';
+		errno = 0;
+		n = strtol(value, &endptr, 0);
+		if (STRTOL_ERROR(value, endptr, n, errno) || n < 0 ||
+		    n > INT32_MAX)
+			goto invalid;
+
+		if (strcmp(key, "containers") == 0) {
+			spec->containers = n;
+		} else if (strcmp(key, "depth") == 0) {
+			spec->depth = n;
+		} else if (strcmp(key, "labels") == 0) {
+			spec->labels = n != 0;
+		} else if (strcmp(key, "latency") == 0) {
+			mc->latency_ns = (int64_t)n * 1000;
+		} else if (strncmp(key, "latency.", 8) == 0) {
+			char *cmdid_str = key + 8;
+			long cmdid;
+
+			errno = 0;
+			cmdid = strtol(cmdid_str, &endptr, 0);
+			if (STRTOL_ERROR(cmdid_str, endptr, cmdid, errno) ||
+			    cmdid < 0 || cmdid >= EMUL_NUM_CMD_IDS)
+				goto invalid;
+
+			mc->cmd_latency_ns[cmdid] = (int64_t)n * 1000;
+		} else if (strcmp(key, "busy") == 0) {
+			if (n > 100)
+				goto invalid;
+
+			mc->busy_pct = n;
+		} else if ((type = emul_obj_type_by_name(key)) > EMUL_DPRC) {
+			spec->counts[type] = n;
+		} else {
+			goto invalid;
+		}
+	}
+
+	goto out;
+invalid:
+	ERROR_PRINTF("Invalid emul transport parameter: %s\n", key);
+	error = -EINVAL;
+out:
+	free(buf);
+	return error;
+}
+
+static void emul_mc_free(struct emul_mc *mc)
+{
+	for (int i = 0; i < mc->num_objs; i++) {
+		free(mc->objs[i].children);
+		for (unsigned int r = 0; r < EMUL_NUM_RES_TYPES; r++)
+			free(mc->objs[i].res[r].ids);
+	}
+
+	for (int t = 0; t < EMUL_NUM_OBJ_TYPES; t++)
+		free(mc->by_id[t]);
+
+	free(mc->links);
+	free(mc->objs);
+	pthread_mutex_destroy(&mc->lock);
+	free(mc);
+}
+
+static int emul_mc_create(const char *arg, struct emul_mc **mc_out)
+{
+	struct emul_spec spec;
+	struct emul_mc *mc;
+	int root;
+	int error;
+
+	mc = calloc(1, sizeof(*mc));
+	if (mc == NULL) {
+		ERROR_PRINTF("calloc() failed\n");
+		return -ENOMEM;
+	}
+
+	pthread_mutex_init(&mc->lock, NULL);
+	error = emul_parse_spec(mc, arg, &spec);
+	if (error < 0)
+		goto error;
+
+	mc->next_id[EMUL_DPRC] = EMUL_ROOT_DPRC_ID;
+	root = emul_new_obj(mc, EMUL_DPRC, EMUL_ROOT_DPRC_ID, -1, NULL);
+	if (root < 0) {
+		error = root;
+		goto out_of_memory;
+	}
+
+	mc->objs[root].state = DPRC_OBJ_STATE_PLUGGED;
+	for (unsigned int r = 0; r < EMUL_NUM_RES_TYPES; r++) {
+		for (int i = 0; i < emul_res_types[r].count; i++) {
+			error = emul_ids_insert(&mc->objs[root].res[r], i);
+			if (error < 0)
+				goto out_of_memory;
+		}
+	}
+
+	error = emul_populate(mc, root, &spec, spec.depth);
+	if (error < 0)
+		goto out_of_memory;
+
+	if (spec.labels) {
+		for (int i = 0; i < mc->num_objs; i++) {
+			struct emul_obj *obj = &mc->objs[i];
+
+			snprintf(obj->label, sizeof(obj->label), "%s%d",
+				 emul_obj_types[obj->type].name, obj->id);
+		}
+	}
+
+	DEBUG_PRINTF("emulated MC ready with %d objects\n", mc->num_objs);
+	*mc_out = mc;
+	return 0;
+out_of_memory:
+	ERROR_PRINTF("Out of memory building the emulated MC topology\n");
+error:
+	emul_mc_free(mc);
+	return error;
+}
+
+/*
+ * Object attributes
+ */
+static void emul_dprc_get_attr(const struct emul_obj *obj,
+			       struct mc_command *rsp)
+{
+	struct dprc_attributes attr = { 0 };
+	struct dprc_attributes *attrp = &attr;
+
+	attr.container_id = obj->id;
+	attr.icid = obj->id;
+	attr.portal_id = obj->id == EMUL_ROOT_DPRC_ID ? 0 : obj->id;
+	attr.version.major = DPRC_VER_MAJOR;
+	attr.version.minor = DPRC_VER_MINOR;
+	DPRC_RSP_GET_ATTRIBUTES((*rsp), attrp);
+}
+
+static void emul_dpni_get_cfg(const struct emul_obj *obj,
+			      struct dpni_cfg *cfg)
+{
+	struct mc_command create_cmd = obj->create_cmd;
+
+	memset(cfg, 0, sizeof(*cfg));
+	DPNI_CMD_CREATE(create_cmd, cfg);
+	if (cfg->adv.max_tcs == 0)
+		cfg->adv.max_tcs = 1;
+
+	if (cfg->adv.max_senders == 0)
+		cfg->adv.max_senders = 1;
+
+	if (cfg->adv.max_dist_per_tc[0] == 0)
+		cfg->adv.max_dist_per_tc[0] = 1;
+
+	if (cfg->mac_addr[0] == 0 && cfg->mac_addr[1] == 0 &&
+	    cfg->mac_addr[2] == 0 && cfg->mac_addr[3] == 0 &&
+	    cfg->mac_addr[4] == 0 && cfg->mac_addr[5] == 0) {
+		cfg->mac_addr[1] = 0x04;
+		cfg->mac_addr[2] = 0x9f;
+		cfg->mac_addr[4] = (uint8_t)(obj->id >> 8);
+		cfg->mac_addr[5] = (uint8_t)obj->id;
+	}
+}
+
+static void emul_dpni_get_attr(const struct emul_obj *obj,
+			       struct mc_command *rsp)
+{
+	struct dpni_attr attr = { 0 };
+	struct dpni_attr *attrp = &attr;
+	struct dpni_cfg cfg;
+
+	emul_dpni_get_cfg(obj, &cfg);
+	attr.id = obj->id;
+	attr.version.major = DPNI_VER_MAJOR;
+	attr.version.minor = DPNI_VER_MINOR;
+	attr.start_hdr = cfg.adv.start_hdr;
+	attr.options = cfg.adv.options;
+	attr.max_senders = cfg.adv.max_senders;
+	attr.max_tcs = cfg.adv.max_tcs;
+	memcpy(attr.max_dist_per_tc, cfg.adv.max_dist_per_tc,
+	       sizeof(attr.max_dist_per_tc));
+	attr.max_unicast_filters = cfg.adv.max_unicast_filters;
+	attr.max_multicast_filters = cfg.adv.max_multicast_filters;
+	attr.max_vlan_filters = cfg.adv.max_vlan_filters;
+	attr.max_qos_entries = cfg.adv.max_qos_entries;
+	attr.max_qos_key_size = cfg.adv.max_qos_key_size;
+	attr.max_dist_key_size = cfg.adv.max_dist_key_size;
+	attr.max_policers = cfg.adv.max_policers;
+	attr.max_congestion_ctrl = cfg.adv.max_congestion_ctrl;
+	attr.ipr_cfg = cfg.adv.ipr_cfg;
+	DPNI_RSP_GET_ATTR((*rsp), attrp);
+}
+
+static void emul_dpmac_get_attr(const struct emul_obj *obj,
+				struct mc_command *rsp)
+{
+	struct dpmac_attr attr = { 0 };
+	struct dpmac_attr *attrp = &attr;
+
+	attr.id = obj->id;
+	attr.phy_id = obj->id;
+	attr.link_type = DPMAC_LINK_TYPE_PHY;
+	attr.eth_if = DPMAC_ETH_IF_SGMII;
+	attr.max_rate = 1000;
+	attr.version.major = DPMAC_VER_MAJOR;
+	attr.version.minor = DPMAC_VER_MINOR;
+	DPMAC_RSP_GET_ATTRIBUTES((*rsp), attrp);
+}
+
+static void emul_dpio_get_attr(const struct emul_obj *obj,
+			       struct mc_command *rsp)
+{
+	struct mc_command create_cmd = obj->create_cmd;
+	struct dpio_cfg cfg = { 0 };
+	struct dpio_cfg *cfgp = &cfg;
+	struct dpio_attr attr = { 0 };
+	struct dpio_attr *attrp = &attr;
+
+	DPIO_CMD_CREATE(create_cmd, cfgp);
+	attr.id = obj->id;
+	attr.qbman_portal_id = obj->id;
+	attr.qbman_portal_ce_offset = (uint64_t)obj->id * MC_PORTAL_STRIDE;
+	attr.qbman_portal_ci_offset = (uint64_t)obj->id * MC_PORTAL_STRIDE;
+	attr.channel_mode = create_cmd.header != 0 ? cfg.channel_mode :
+						     DPIO_LOCAL_CHANNEL;
+	attr.num_priorities = cfg.num_priorities != 0 ? cfg.num_priorities :
+							 8;
+	attr.version.major = DPIO_VER_MAJOR;
+	attr.version.minor = DPIO_VER_MINOR;
+	DPIO_RSP_GET_ATTR((*rsp), attrp);
+}
+
+static void emul_dpbp_get_attr(const struct emul_obj *obj,
+			       struct mc_command *rsp)
+{
+	struct dpbp_attr attr = { 0 };
+	struct dpbp_attr *attrp = &attr;
+
+	attr.id = obj->id;
+	attr.bpid = obj->id;
+	attr.version.major = DPBP_VER_MAJOR;
+	attr.version.minor = DPBP_VER_MINOR;
+	DPBP_RSP_GET_ATTRIBUTES((*rsp), attrp);
+}
+
+static void emul_dpcon_get_attr(const struct emul_obj *obj,
+				struct mc_command *rsp)
+{
+	struct mc_command create_cmd = obj->create_cmd;
+	struct dpcon_cfg cfg = { 0 };
+	struct dpcon_cfg *cfgp = &cfg;
+	struct dpcon_attr attr = { 0 };
+	struct dpcon_attr *attrp = &attr;
+
+	DPCON_CMD_CREATE(create_cmd, cfgp);
+	attr.id = obj->id;
+	attr.qbman_ch_id = obj->id;
+	attr.num_priorities = cfg.num_priorities != 0 ? cfg.num_priorities :
+							 2;
+	attr.version.major = DPCON_VER_MAJOR;
+	attr.version.minor = DPCON_VER_MINOR;
+	DPCON_RSP_GET_ATTR((*rsp), attrp);
+}
+
+static void emul_dpmcp_get_attr(const struct emul_obj *obj,
+				struct mc_command *rsp)
+{
+	struct dpmcp_attr attr = { 0 };
+	struct dpmcp_attr *attrp = &attr;
+
+	attr.id = obj->id;
+	attr.version.major = DPMCP_VER_MAJOR;
+	attr.version.minor = DPMCP_VER_MINOR;
+	DPMCP_RSP_GET_ATTRIBUTES((*rsp), attrp);
+}
+
+static void emul_dpci_get_attr(const struct emul_obj *obj,
+			       struct mc_command *rsp)
+{
+	struct mc_command create_cmd = obj->create_cmd;
+	struct dpci_cfg cfg = { 0 };
+	struct dpci_cfg *cfgp = &cfg;
+	struct dpci_attr attr = { 0 };
+	struct dpci_attr *attrp = &attr;
+
+	DPCI_CMD_CREATE(create_cmd, cfgp);
+	attr.id = obj->id;
+	attr.num_of_priorities = cfg.num_of_priorities != 0 ?
+				 cfg.num_of_priorities : 1;
+	attr.version.major = DPCI_VER_MAJOR;
+	attr.version.minor = DPCI_VER_MINOR;
+	DPCI_RSP_GET_ATTR((*rsp), attrp);
+}
+
+static void emul_dpseci_get_attr(const struct emul_obj *obj,
+				 struct mc_command *rsp)
+{
+	struct mc_command create_cmd = obj->create_cmd;
+	struct dpseci_cfg cfg = { 0 };
+	struct dpseci_cfg *cfgp = &cfg;
+	struct dpseci_attr attr = { 0 };
+	struct dpseci_attr *attrp = &attr;
+
+	DPSECI_CMD_CREATE(create_cmd, cfgp);
+	attr.id = obj->id;
+	attr.num_tx_queues = cfg.num_tx_queues != 0 ? cfg.num_tx_queues : 1;
+	attr.num_rx_queues = cfg.num_rx_queues != 0 ? cfg.num_rx_queues : 1;
+	attr.version.major = DPSECI_VER_MAJOR;
+	attr.version.minor = DPSECI_VER_MINOR;
+	DPSECI_RSP_GET_ATTR((*rsp), attrp);
+}
+
+static void emul_dpsw_get_attr(const struct emul_obj *obj,
+			       struct mc_command *rsp)
+{
+	struct mc_command create_cmd = obj->create_cmd;
+	struct dpsw_cfg cfg = { 0 };
+	struct dpsw_cfg *cfgp = &cfg;
+	struct dpsw_attr attr = { 0 };
+	struct dpsw_attr *attrp = &attr;
+
+	DPSW_CMD_CREATE(create_cmd, cfgp);
+	attr.id = obj->id;
+	attr.num_ifs = cfg.num_ifs != 0 ? cfg.num_ifs : 4;
+	attr.options = cfg.adv.options;
+	attr.max_vlans = cfg.adv.max_vlans;
+	attr.max_meters_per_if = cfg.adv.max_meters_per_if;
+	attr.max_fdbs = cfg.adv.max_fdbs;
+	attr.max_fdb_entries = cfg.adv.max_fdb_entries;
+	attr.fdb_aging_time = cfg.adv.fdb_aging_time;
+	attr.max_fdb_mc_groups = cfg.adv.max_fdb_mc_groups;
+	attr.num_fdbs = cfg.adv.max_fdbs;
+	attr.version.major = DPSW_VER_MAJOR;
+	attr.version.minor = DPSW_VER_MINOR;
+	DPSW_RSP_GET_ATTR((*rsp), attrp);
+}
+
+static void emul_dpdmux_get_attr(const struct emul_obj *obj,
+				 struct mc_command *rsp)
+{
+	struct mc_command create_cmd = obj->create_cmd;
+	struct dpdmux_cfg cfg = { 0 };
+	struct dpdmux_cfg *cfgp = &cfg;
+	struct dpdmux_attr attr = { 0 };
+	struct dpdmux_attr *attrp = &attr;
+
+	DPDMUX_CMD_CREATE(create_cmd, cfgp);
+	attr.id = obj->id;
+	attr.options = cfg.adv.options;
+	attr.method = cfg.method;
+	attr.manip = cfg.manip;
+	attr.num_ifs = cfg.num_ifs != 0 ? cfg.num_ifs : 2;
+	attr.control_if = cfg.control_if;
+	attr.version.major = DPDMUX_VER_MAJOR;
+	attr.version.minor = DPDMUX_VER_MINOR;
+	DPDMUX_RSP_GET_ATTR((*rsp), attrp);
+}
+
+static void emul_dpaiop_get_attr(const struct emul_obj *obj,
+				 struct mc_command *rsp)
+{
+	struct dpaiop_attr attr = { 0 };
+	struct dpaiop_attr *attrp = &attr;
+
+	attr.id = obj->id;
+	attr.version.major = DPAIOP_VER_MAJOR;
+	attr.version.minor = DPAIOP_VER_MINOR;
+	DPAIOP_RSP_GET_ATTRIBUTES((*rsp), attrp);
+}
+
+static void emul_dpdcei_get_attr(const struct emul_obj *obj,
+				 struct mc_command *rsp)
+{
+	struct mc_command create_cmd = obj->create_cmd;
+	struct dpdcei_cfg cfg = { 0 };
+	struct dpdcei_cfg *cfgp = &cfg;
+	struct dpdcei_attr attr = { 0 };
+	struct dpdcei_attr *attrp = &attr;
+
+	DPDCEI_CMD_CREATE(create_cmd, cfgp);
+	attr.id = obj->id;
+	attr.engine = cfg.engine;
+	attr.version.major = DPDCEI_VER_MAJOR;
+	attr.version.minor = DPDCEI_VER_MINOR;
+	DPDCEI_RSP_GET_ATTR((*rsp), attrp);
+}
+
+static const struct emul_obj_type_desc emul_obj_types[EMUL_NUM_OBJ_TYPES] = {
+	[EMUL_DPRC] = { "dprc", DPRC_CMDID_OPEN, DPRC_VER_MAJOR,
+			DPRC_VER_MINOR, 1, 0, 0, emul_dprc_get_attr },
+	[EMUL_DPNI] = { "dpni", DPNI_CMDID_OPEN, DPNI_VER_MAJOR,
+			DPNI_VER_MINOR, 1, 0, 4, emul_dpni_get_attr },
+	[EMUL_DPMAC] = { "dpmac", DPMAC_CMDID_OPEN, DPMAC_VER_MAJOR,
+			 DPMAC_VER_MINOR, 1, 1, 4, emul_dpmac_get_attr },
+	[EMUL_DPIO] = { "dpio", DPIO_CMDID_OPEN, DPIO_VER_MAJOR,
+			DPIO_VER_MINOR, 1, 2, 2, emul_dpio_get_attr },
+	[EMUL_DPBP] = { "dpbp", DPBP_CMDID_OPEN, DPBP_VER_MAJOR,
+			DPBP_VER_MINOR, 1, 0, 2, emul_dpbp_get_attr },
+	[EMUL_DPCON] = { "dpcon", DPCON_CMDID_OPEN, DPCON_VER_MAJOR,
+			 DPCON_VER_MINOR, 1, 0, 2, emul_dpcon_get_attr },
+	[EMUL_DPMCP] = { "dpmcp", DPMCP_CMDID_OPEN, DPMCP_VER_MAJOR,
+			 DPMCP_VER_MINOR, 1, 1, 2, emul_dpmcp_get_attr },
+	[EMUL_DPCI] = { "dpci", DPCI_CMDID_OPEN, DPCI_VER_MAJOR,
+			DPCI_VER_MINOR, 1, 0, 0, emul_dpci_get_attr },
+	[EMUL_DPSECI] = { "dpseci", DPSECI_CMDID_OPEN, DPSECI_VER_MAJOR,
+			  DPSECI_VER_MINOR, 1, 0, 1, emul_dpseci_get_attr },
+	[EMUL_DPSW] = { "dpsw", DPSW_CMDID_OPEN, DPSW_VER_MAJOR,
+			DPSW_VER_MINOR, 1, 0, 0, emul_dpsw_get_attr },
+	[EMUL_DPDMUX] = { "dpdmux", DPDMUX_CMDID_OPEN, DPDMUX_VER_MAJOR,
+			  DPDMUX_VER_MINOR, 1, 0, 0, emul_dpdmux_get_attr },
+	[EMUL_DPAIOP] = { "dpaiop", DPAIOP_CMDID_OPEN, DPAIOP_VER_MAJOR,
+			  DPAIOP_VER_MINOR, 1, 1, 0, emul_dpaiop_get_attr },
+	[EMUL_DPDCEI] = { "dpdcei", DPDCEI_CMDID_OPEN, DPDCEI_VER_MAJOR,
+			  DPDCEI_VER_MINOR, 1, 0, 0, emul_dpdcei_get_attr },
+};
+
+static void emul_get_obj_desc(const struct emul_mc *mc, int idx,
+			      struct dprc_obj_desc *desc)
+{
+	const struct emul_obj *obj = &mc->objs[idx];
+	const struct emul_obj_type_desc *type = &emul_obj_types[obj->type];
+
+	memset(desc, 0, sizeof(*desc));
+	strcpy(desc->type, type->name);
+	desc->id = obj->id;
+	desc->vendor = EMUL_VENDOR_ID;
+	desc->ver_major = type->ver_major;
+	desc->ver_minor = type->ver_minor;
+	desc->irq_count = type->irq_count;
+	desc->region_count = type->region_count;
+	desc->state = obj->state;
+	if (obj->open_count != 0)
+		desc->state |= DPRC_OBJ_STATE_OPEN;
+
+	memcpy(desc->label, obj->label, sizeof(desc->label));
+}
+
+/**
+ * Synthetic counter value: grows every time a counter of the object is read
+ */
+static uint64_t emul_counter_value(struct emul_obj *obj, int counter)
+{
+	obj->counter_reads++;
+	return ((uint64_t)obj->id + 1) * (counter + 1) * 1000 +
+	       obj->counter_reads * (counter + 1) * 64;
+}
+
+/*
+ * Command handlers: 'req' is the request as sent, 'rsp' the response to
+ * fill, with zeroed parameters
+ */
+static enum mc_cmd_status emul_open_obj(struct emul_mc *mc, int idx,
+					uint16_t *token)
+{
+	for (int t = 1; t < EMUL_MAX_TOKENS; t++) {
+		if (mc->tokens[t] == 0) {
+			mc->tokens[t] = idx + 1;
+			mc->objs[idx].open_count++;
+			*token = t;
+			return MC_CMD_STATUS_OK;
+		}
+	}
+
+	return MC_CMD_STATUS_NO_RESOURCE;
+}
+
+static enum mc_cmd_status emul_open(struct emul_mc *mc,
+				    enum emul_obj_type type,
+				    const struct mc_command *req,
+				    uint16_t *token)
+{
+	int id;
+	int idx;
+
+	/*
+	 * All open commands take the object ID in the same place
+	 */
+	DPRC_CMD_OPEN((*req), id);
+	idx = emul_find(mc, type, id);
+	if (idx < 0)
+		return MC_CMD_STATUS_CONFIG_ERR;
+
+	return emul_open_obj(mc, idx, token);
+}
+
+static enum mc_cmd_status emul_create(struct emul_mc *mc,
+				      enum emul_obj_type type,
+				      const struct mc_command *req,
+				      uint16_t *token)
+{
+	int root = emul_find(mc, EMUL_DPRC, EMUL_ROOT_DPRC_ID);
+	int id = -1;
+	int idx;
+
+	/*
+	 * DPMACs are identified by the MAC they stand for
+	 */
+	if (type == EMUL_DPMAC) {
+		struct dpmac_cfg cfg = { 0 };
+		struct dpmac_cfg *cfgp = &cfg;
+
+		DPMAC_CMD_CREATE((*req), cfgp);
+		id = cfg.mac_id;
+	}
+
+	idx = emul_new_obj(mc, type, id, root, req);
+	if (idx == -EEXIST)
+		return MC_CMD_STATUS_CONFIG_ERR;
+	else if (idx < 0)
+		return MC_CMD_STATUS_NO_MEMORY;
+
+	emul_notify(mc, root, DPRC_IRQ_EVENT_OBJ_CREATED);
+
+	/*
+	 * The new object is returned open
+	 */
+	return emul_open_obj(mc, idx, token);
+}
+
+/**
+ * Get the object of a connection endpoint; the endpoint type must be
+ * NUL terminated.
+ */
+static int emul_find_endpoint(const struct emul_mc *mc,
+			      struct dprc_endpoint *endpoint)
+{
+	endpoint->type[sizeof(endpoint->type) - 1] = '\0';
+	return emul_find_by_name(mc, endpoint->type, endpoint->id);
+}
+
+static void emul_set_endpoint(const struct emul_mc *mc, int idx,
+			      uint16_t if_id, struct dprc_endpoint *endpoint)
+{
+	memset(endpoint, 0, sizeof(*endpoint));
+	strcpy(endpoint->type, emul_obj_types[mc->objs[idx].type].name);
+	endpoint->id = mc->objs[idx].id;
+	endpoint->if_id = if_id;
+}
+
+static enum mc_cmd_status emul_dprc_connect(struct emul_mc *mc,
+					    const struct mc_command *req)
+{
+	struct dprc_endpoint endpoint1 = { .id = 0 };
+	struct dprc_endpoint *endpoint1p = &endpoint1;
+	struct dprc_endpoint endpoint2 = { .id = 0 };
+	struct dprc_endpoint *endpoint2p = &endpoint2;
+	struct dprc_connection_cfg cfg = { 0 };
+	struct dprc_connection_cfg *cfgp = &cfg;
+	int idx1, idx2;
+	int side;
+
+	DPRC_CMD_CONNECT((*req), endpoint1p, endpoint2p, cfgp);
+	idx1 = emul_find_endpoint(mc, &endpoint1);
+	idx2 = emul_find_endpoint(mc, &endpoint2);
+	if (idx1 < 0 || idx2 < 0 || idx1 == idx2)
+		return MC_CMD_STATUS_CONFIG_ERR;
+
+	if (emul_find_link(mc, idx1, endpoint1.if_id, &side) >= 0 ||
+	    emul_find_link(mc, idx2, endpoint2.if_id, &side) >= 0)
+		return MC_CMD_STATUS_INVALID_STATE;
+
+	if (emul_add_link(mc, idx1, endpoint1.if_id, idx2, endpoint2.if_id,
+			  &cfg) < 0)
+		return MC_CMD_STATUS_NO_MEMORY;
+
+	return MC_CMD_STATUS_OK;
+}
+
+static enum mc_cmd_status emul_dprc_disconnect(struct emul_mc *mc,
+					       const struct mc_command *req)
+{
+	struct dprc_endpoint endpoint = { .id = 0 };
+	struct dprc_endpoint *endpointp = &endpoint;
+	int link;
+	int side;
+	int idx;
+
+	DPRC_CMD_DISCONNECT((*req), endpointp);
+	idx = emul_find_endpoint(mc, &endpoint);
+	if (idx < 0)
+		return MC_CMD_STATUS_CONFIG_ERR;
+
+	link = emul_find_link(mc, idx, endpoint.if_id, &side);
+	if (link < 0)
+		return MC_CMD_STATUS_INVALID_STATE;
+
+	emul_remove_link(mc, link);
+	return MC_CMD_STATUS_OK;
+}
+
+static enum mc_cmd_status emul_dprc_get_connection(struct emul_mc *mc,
+						   const struct mc_command *req,
+						   struct mc_command *rsp)
+{
+	struct dprc_endpoint endpoint1 = { .id = 0 };
+	struct dprc_endpoint *endpoint1p = &endpoint1;
+	struct dprc_endpoint endpoint2 = { .id = 0 };
+	struct dprc_endpoint *endpoint2p = &endpoint2;
+	int state = -1;
+	int link;
+	int side;
+	int idx;
+
+	DPRC_CMD_GET_CONNECTION((*req), endpoint1p);
+	idx = emul_find_endpoint(mc, &endpoint1);
+	if (idx < 0)
+		return MC_CMD_STATUS_CONFIG_ERR;
+
+	link = emul_find_link(mc, idx, endpoint1.if_id, &side);
+	if (link >= 0) {
+		emul_set_endpoint(mc, mc->links[link].obj[!side],
+				  mc->links[link].if_id[!side], &endpoint2);
+		state = 1;
+	}
+
+	DPRC_RSP_GET_CONNECTION((*rsp), endpoint2p, state);
+	return MC_CMD_STATUS_OK;
+}
+
+/**
+ * Move 'num' resources of type 'res_type' from container 'from' to
+ * container 'to': the ones starting at 'base_id' if 'explicit', else the
+ * lowest ones.
+ */
+static enum mc_cmd_status emul_move_res(struct emul_mc *mc, int res_type,
+					int from, int to, uint32_t num,
+					bool explicit, int base_id)
+{
+	struct emul_ids *src = &mc->objs[from].res[res_type];
+	int *ids;
+
+	if (num == 0 || num > (uint32_t)src->num)
+		return MC_CMD_STATUS_NO_RESOURCE;
+
+	ids = malloc(num * sizeof(int));
+	if (ids == NULL)
+		return MC_CMD_STATUS_NO_MEMORY;
+
+	for (uint32_t i = 0; i < num; i++) {
+		ids[i] = explicit ? base_id + (int)i : src->ids[i];
+		if (explicit) {
+			int pos = emul_ids_find(src, ids[i]);
+
+			if (pos == src->num || src->ids[pos] != ids[i]) {
+				free(ids);
+				return MC_CMD_STATUS_CONFIG_ERR;
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < num; i++) {
+		if (emul_ids_insert(&mc->objs[to].res[res_type], ids[i]) < 0) {
+			free(ids);
+			return MC_CMD_STATUS_NO_MEMORY;
+		}
+
+		(void)emul_ids_remove(&mc->objs[from].res[res_type], ids[i]);
+	}
+
+	free(ids);
+	emul_notify(mc, from, DPRC_IRQ_EVENT_RES_REMOVED);
+	emul_notify(mc, to, DPRC_IRQ_EVENT_RES_ADDED);
+	return MC_CMD_STATUS_OK;
+}
+
+/**
+ * Move objects or resources between container 'from' and its child
+ * container 'to'
+ */
+static enum mc_cmd_status emul_move_objs(struct emul_mc *mc,
+					 const struct dprc_res_req *res_req,
+					 int from, int to, bool plugged)
+{
+	int type = emul_obj_type_by_name(res_req->type);
+	uint32_t num = res_req->num;
+	int res_type;
+	int idx;
+
+	if (type < 0) {
+		res_type = emul_res_type_by_name(res_req->type);
+		if (res_type < 0)
+			return MC_CMD_STATUS_CONFIG_ERR;
+
+		return emul_move_res(mc, res_type, from, to, res_req->num,
+				     res_req->options &
+				     DPRC_RES_REQ_OPT_EXPLICIT,
+				     res_req->id_base_align);
+	}
+
+	/*
+	 * Like the MC, an explicit object request names one object by its
+	 * id, whatever the count says
+	 */
+	if (res_req->options & DPRC_RES_REQ_OPT_EXPLICIT && num == 0)
+		num = 1;
+
+	if (num == 0)
+		return MC_CMD_STATUS_CONFIG_ERR;
+
+	for (uint32_t i = 0; i < num; i++) {
+		idx = emul_find(mc, type, res_req->id_base_align + (int)i);
+		if (idx < 0 || mc->objs[idx].container != from)
+			return MC_CMD_STATUS_CONFIG_ERR;
+
+		if (emul_move(mc, idx, to) < 0)
+			return MC_CMD_STATUS_NO_MEMORY;
+
+		if (plugged)
+			mc->objs[idx].state |= DPRC_OBJ_STATE_PLUGGED;
+		else
+			mc->objs[idx].state &= ~DPRC_OBJ_STATE_PLUGGED;
+	}
+
+	emul_notify(mc, from, DPRC_IRQ_EVENT_OBJ_REMOVED);
+	emul_notify(mc, to, DPRC_IRQ_EVENT_OBJ_ADDED);
+	return MC_CMD_STATUS_OK;
+}
+
+static enum mc_cmd_status emul_dprc_assign(struct emul_mc *mc, int container,
+					   const struct mc_command *req,
+					   bool assign)
+{
+	struct dprc_res_req res_req = { .num = 0 };
+	struct dprc_res_req *res_reqp = &res_req;
+	int child_id;
+	int child;
+	int idx;
+
+	if (assign)
+		DPRC_CMD_ASSIGN((*req), child_id, res_reqp);
+	else
+		DPRC_CMD_UNASSIGN((*req), child_id, res_reqp);
+
+	res_req.type[sizeof(res_req.type) - 1] = '\0';
+
+	/*
+	 * Assigning an object to the container holding it changes its
+	 * plugged state
+	 */
+	if (assign && child_id == mc->objs[container].id) {
+		idx = emul_find_by_name(mc, res_req.type,
+					res_req.id_base_align);
+		if (idx < 0 || mc->objs[idx].container != container)
+			return MC_CMD_STATUS_CONFIG_ERR;
+
+		if (res_req.options & DPRC_RES_REQ_OPT_PLUGGED)
+			mc->objs[idx].state |= DPRC_OBJ_STATE_PLUGGED;
+		else
+			mc->objs[idx].state &= ~DPRC_OBJ_STATE_PLUGGED;
+
+		return MC_CMD_STATUS_OK;
+	}
+
+	child = emul_find(mc, EMUL_DPRC, child_id);
+	if (child < 0 || mc->objs[child].container != container)
+		return MC_CMD_STATUS_CONFIG_ERR;
+
+	if (assign)
+		return emul_move_objs(mc, &res_req, container, child,
+				      res_req.options &
+				      DPRC_RES_REQ_OPT_PLUGGED);
+	else
+		return emul_move_objs(mc, &res_req, child, container, false);
+}
+
+static int emul_cmp_int(const void *a, const void *b)
+{
+	return *(const int *)a - *(const int *)b;
+}
+
+static enum mc_cmd_status emul_dprc_get_res_ids(struct emul_mc *mc,
+						int container,
+						const struct mc_command *req,
+						struct mc_command *rsp)
+{
+	struct dprc_res_ids_range_desc range_desc = { 0 };
+	struct dprc_res_ids_range_desc *range_descp = &range_desc;
+	struct emul_obj *obj = &mc->objs[container];
+	struct emul_ids obj_ids = { 0 };
+	const struct emul_ids *ids;
+	char type_name[16] = { 0 };
+	int type;
+	int i;
+
+	DPRC_CMD_GET_RES_IDS((*req), range_descp, type_name);
+	type_name[sizeof(type_name) - 1] = '\0';
+	type = emul_res_type_by_name(type_name);
+	if (type >= 0) {
+		ids = &obj->res[type];
+	} else {
+		/*
+		 * The IDs of an object type are those of the objects of
+		 * that type in the container
+		 */
+		type = emul_obj_type_by_name(type_name);
+		if (type < 0)
+			return MC_CMD_STATUS_CONFIG_ERR;
+
+		obj_ids.ids = malloc((obj->num_children + 1) * sizeof(int));
+		if (obj_ids.ids == NULL)
+			return MC_CMD_STATUS_NO_MEMORY;
+
+		for (i = 0; i < obj->num_children; i++) {
+			if (mc->objs[obj->children[i]].type == (unsigned)type)
+				obj_ids.ids[obj_ids.num++] =
+					mc->objs[obj->children[i]].id;
+		}
+
+		qsort(obj_ids.ids, obj_ids.num, sizeof(int), emul_cmp_int);
+		ids = &obj_ids;
+	}
+
+	if (range_desc.iter_status == DPRC_ITER_STATUS_FIRST)
+		i = 0;
+	else
+		i = emul_ids_find(ids, range_desc.last_id + 1);
+
+	if (i == ids->num) {
+		range_desc.iter_status = DPRC_ITER_STATUS_LAST;
+	} else {
+		range_desc.base_id = ids->ids[i];
+		while (i + 1 < ids->num && ids->ids[i + 1] == ids->ids[i] + 1)
+			i++;
+
+		range_desc.last_id = ids->ids[i];
+		range_desc.iter_status = i + 1 < ids->num ?
+					 DPRC_ITER_STATUS_MORE :
+					 DPRC_ITER_STATUS_LAST;
+	}
+
+	free(obj_ids.ids);
+	DPRC_RSP_GET_RES_IDS((*rsp), range_descp);
+	return MC_CMD_STATUS_OK;
+}
+
+static enum mc_cmd_status emul_dprc_command(struct emul_mc *mc, int container,
+					    uint16_t cmdid,
+					    const struct mc_command *req,
+					    struct mc_command *rsp)
+{
+	struct emul_obj *obj = &mc->objs[container];
+	struct dprc_obj_desc desc;
+	struct dprc_obj_desc *descp = &desc;
+	char type_name[16] = { 0 };
+	int count;
+	int type;
+	int id;
+	int idx;
+
+	switch (cmdid) {
+	case DPRC_CMDID_GET_OBJ_COUNT:
+		DPRC_RSP_GET_OBJ_COUNT((*rsp), obj->num_children);
+		return MC_CMD_STATUS_OK;
+
+	case DPRC_CMDID_GET_OBJ:
+		DPRC_CMD_GET_OBJ((*req), idx);
+		if (idx < 0 || idx >= obj->num_children)
+			return MC_CMD_STATUS_CONFIG_ERR;
+
+		emul_get_obj_desc(mc, obj->children[idx], &desc);
+		DPRC_RSP_GET_OBJ((*rsp), descp);
+		return MC_CMD_STATUS_OK;
+
+	case DPRC_CMDID_GET_OBJ_DESC:
+		DPRC_CMD_GET_OBJ_DESC((*req), type_name, id);
+		type_name[sizeof(type_name) - 1] = '\0';
+		idx = emul_find_by_name(mc, type_name, id);
+		if (idx < 0 || mc->objs[idx].container != container)
+			return MC_CMD_STATUS_CONFIG_ERR;
+
+		emul_get_obj_desc(mc, idx, &desc);
+		DPRC_RSP_GET_OBJ_DESC((*rsp), descp);
+		return MC_CMD_STATUS_OK;
+
+	case DPRC_CMDID_SET_OBJ_LABEL: {
+		char label[16] = { 0 };
+
+		DPRC_CMD_SET_OBJ_LABEL((*req), type_name, id, label);
+		type_name[sizeof(type_name) - 1] = '\0';
+		idx = emul_find_by_name(mc, type_name, id);
+		if (idx < 0 || mc->objs[idx].container != container)
+			return MC_CMD_STATUS_CONFIG_ERR;
+
+		memcpy(mc->objs[idx].label, label, sizeof(label));
+		return MC_CMD_STATUS_OK;
+	}
+
+	case DPRC_CMDID_GET_RES_COUNT:
+		DPRC_CMD_GET_RES_COUNT((*req), type_name);
+		type_name[sizeof(type_name) - 1] = '\0';
+		type = emul_res_type_by_name(type_name);
+		if (type >= 0) {
+			count = obj->res[type].num;
+		} else {
+			type = emul_obj_type_by_name(type_name);
+			if (type < 0)
+				return MC_CMD_STATUS_CONFIG_ERR;
+
+			count = 0;
+			for (int i = 0; i < obj->num_children; i++) {
+				if (mc->objs[obj->children[i]].type ==
+				    (unsigned)type)
+					count++;
+			}
+		}
+
+		DPRC_RSP_GET_RES_COUNT((*rsp), count);
+		return MC_CMD_STATUS_OK;
+
+	case DPRC_CMDID_GET_RES_IDS:
+		return emul_dprc_get_res_ids(mc, container, req, rsp);
+
+	case DPRC_CMDID_GET_POOL_COUNT:
+		count = 0;
+		for (unsigned int r = 0; r < EMUL_NUM_RES_TYPES; r++) {
+			if (obj->res[r].num != 0)
+				count++;
+		}
+
+		DPRC_RSP_GET_POOL_COUNT((*rsp), count);
+		return MC_CMD_STATUS_OK;
+
+	case DPRC_CMDID_GET_POOL:
+		DPRC_CMD_GET_POOL((*req), idx);
+		for (unsigned int r = 0; r < EMUL_NUM_RES_TYPES; r++) {
+			if (obj->res[r].num == 0 || idx-- != 0)
+				continue;
+
+			strcpy(type_name, emul_res_types[r].name);
+			DPRC_RSP_GET_POOL((*rsp), type_name);
+			return MC_CMD_STATUS_OK;
+		}
+
+		return MC_CMD_STATUS_CONFIG_ERR;
+
+	case DPRC_CMDID_CREATE_CONT: {
+		struct dprc_cfg cfg = { 0 };
+		struct dprc_cfg *cfgp = &cfg;
+		uint64_t portal_offset;
+
+		DPRC_CMD_CREATE_CONTAINER((*req), cfgp);
+		idx = emul_new_obj(mc, EMUL_DPRC, -1, container, req);
+		if (idx < 0)
+			return MC_CMD_STATUS_NO_MEMORY;
+
+		memcpy(mc->objs[idx].label, cfg.label, sizeof(cfg.label));
+		emul_notify(mc, container, DPRC_IRQ_EVENT_OBJ_CREATED);
+		portal_offset = (uint64_t)mc->objs[idx].id * MC_PORTAL_STRIDE;
+		DPRC_RSP_CREATE_CONTAINER((*rsp), mc->objs[idx].id,
+					  portal_offset);
+		return MC_CMD_STATUS_OK;
+	}
+
+	case DPRC_CMDID_DESTROY_CONT:
+		DPRC_CMD_DESTROY_CONTAINER((*req), id);
+		idx = emul_find(mc, EMUL_DPRC, id);
+		if (idx < 0 || mc->objs[idx].container != container)
+			return MC_CMD_STATUS_CONFIG_ERR;
+
+		if (emul_destroy_container(mc, idx, container) < 0)
+			return MC_CMD_STATUS_NO_MEMORY;
+
+		return MC_CMD_STATUS_OK;
+
+	case DPRC_CMDID_ASSIGN:
+		return emul_dprc_assign(mc, container, req, true);
+
+	case DPRC_CMDID_UNASSIGN:
+		return emul_dprc_assign(mc, container, req, false);
+
+	case DPRC_CMDID_SET_RES_QUOTA:
+		return MC_CMD_STATUS_OK;
+
+	case DPRC_CMDID_CONNECT:
+		return emul_dprc_connect(mc, req);
+
+	case DPRC_CMDID_DISCONNECT:
+		return emul_dprc_disconnect(mc, req);
+
+	case DPRC_CMDID_GET_CONNECTION:
+		return emul_dprc_get_connection(mc, req, rsp);
+
+	default:
+		return MC_CMD_STATUS_UNSUPPORTED_OP;
+	}
+}
+
+static enum mc_cmd_status emul_obj_command(struct emul_mc *mc, int idx,
+					   uint16_t cmdid, uint16_t token,
+					   const struct mc_command *req,
+					   struct mc_command *rsp)
+{
+	struct emul_obj *obj = &mc->objs[idx];
+	uint32_t irq_status;
+	uint8_t irq_index;
+	int side;
+
+	switch (cmdid) {
+	case EMUL_CMDID_CLOSE:
+		mc->tokens[token] = 0;
+		obj->open_count--;
+		return MC_CMD_STATUS_OK;
+
+	case EMUL_CMDID_DESTROY:
+		if (obj->type == EMUL_DPRC)
+			return MC_CMD_STATUS_INVALID_STATE;
+
+		emul_notify(mc, obj->container, DPRC_IRQ_EVENT_OBJ_DESTROYED);
+		emul_forget_obj(mc, idx);
+		mc->tokens[token] = 0;
+		obj->open_count--;
+		return MC_CMD_STATUS_OK;
+
+	case DPRC_CMDID_GET_ATTR:
+		emul_obj_types[obj->type].get_attr(obj, rsp);
+		return MC_CMD_STATUS_OK;
+
+	/*
+	 * The IRQ commands are common to all object types; only IRQ status
+	 * changes of DPRCs are modeled
+	 */
+	case DPRC_CMDID_GET_IRQ_MASK:
+		DPRC_RSP_GET_IRQ_MASK((*rsp), obj->irq_mask);
+		return MC_CMD_STATUS_OK;
+
+	case DPRC_CMDID_GET_IRQ_STATUS:
+		DPRC_RSP_GET_IRQ_STATUS((*rsp), obj->irq_status);
+		return MC_CMD_STATUS_OK;
+
+	case DPRC_CMDID_CLEAR_IRQ_STATUS:
+		DPRC_CMD_CLEAR_IRQ_STATUS((*req), irq_index, irq_status);
+		if (irq_index != 0)
+			return MC_CMD_STATUS_CONFIG_ERR;
+
+		obj->irq_status &= ~irq_status;
+		return MC_CMD_STATUS_OK;
+
+	default:
+		break;
+	}
+
+	switch (obj->type) {
+	case EMUL_DPRC:
+		return emul_dprc_command(mc, idx, cmdid, req, rsp);
+
+	case EMUL_DPNI:
+		if (cmdid == DPNI_CMDID_GET_COUNTER) {
+			enum dpni_counter counter;
+
+			DPNI_CMD_GET_COUNTER((*req), counter);
+			DPNI_RSP_GET_COUNTER((*rsp),
+					     emul_counter_value(obj, counter));
+		} else if (cmdid == DPNI_CMDID_GET_LINK_STATE) {
+			struct dpni_link_state state = { 0 };
+			struct dpni_link_state *statep = &state;
+
+			state.up = emul_find_link(mc, idx, 0, &side) >= 0;
+			state.rate = state.up ? 1000 : 0;
+			DPNI_RSP_GET_LINK_STATE((*rsp), statep);
+		} else if (cmdid == DPNI_CMDID_GET_PRIM_MAC) {
+			struct dpni_cfg cfg;
+
+			emul_dpni_get_cfg(obj, &cfg);
+			DPNI_RSP_GET_PRIMARY_MAC_ADDR((*rsp), cfg.mac_addr);
+		} else {
+			return MC_CMD_STATUS_UNSUPPORTED_OP;
+		}
+
+		return MC_CMD_STATUS_OK;
+
+	case EMUL_DPMAC:
+		if (cmdid == DPMAC_CMDID_GET_COUNTER) {
+			enum dpmac_counter counter;
+
+			DPMAC_CMD_GET_COUNTER((*req), counter);
+			DPMAC_RSP_GET_COUNTER((*rsp),
+					      emul_counter_value(obj, counter));
+			return MC_CMD_STATUS_OK;
+		}
+
+		return MC_CMD_STATUS_UNSUPPORTED_OP;
+
+	case EMUL_DPCI:
+		if (cmdid == DPCI_CMDID_GET_LINK_STATE) {
+			int up = emul_find_link(mc, idx, 0, &side) >= 0;
+
+			DPCI_RSP_GET_LINK_STATE((*rsp), up);
+			return MC_CMD_STATUS_OK;
+		} else if (cmdid == DPCI_CMDID_GET_PEER_ATTR) {
+			struct dpci_peer_attr attr = { 0 };
+			struct dpci_peer_attr *attrp = &attr;
+			int link = emul_find_link(mc, idx, 0, &side);
+
+			attr.peer_id = link >= 0 ?
+				mc->objs[mc->links[link].obj[!side]].id : -1;
+			DPCI_RSP_GET_PEER_ATTR((*rsp), attrp);
+			return MC_CMD_STATUS_OK;
+		}
+
+		return MC_CMD_STATUS_UNSUPPORTED_OP;
+
+	case EMUL_DPAIOP:
+		if (cmdid == DPAIOP_CMDID_GET_SL_VERSION ||
+		    cmdid == DPAIOP_CMDID_GET_STATE)
+			return MC_CMD_STATUS_OK;
+
+		return MC_CMD_STATUS_UNSUPPORTED_OP;
+
+	default:
+		return MC_CMD_STATUS_UNSUPPORTED_OP;
+	}
+}
+
+/**
+ * Execute an MC command, writing the response over it
+ */
+static enum mc_cmd_status emul_execute(struct emul_mc *mc,
+				       struct mc_command *cmd)
+{
+	const struct mc_command req = *cmd;
+	uint16_t cmdid = mc_dec(req.header, MC_CMD_HDR_CMDID_O,
+				MC_CMD_HDR_CMDID_S);
+	uint16_t token = MC_CMD_HDR_READ_TOKEN(req.header);
+	enum mc_cmd_status status = MC_CMD_STATUS_UNSUPPORTED_OP;
+	int idx;
+
+	memset(cmd->params, 0, sizeof(cmd->params));
+	if (cmdid == DPMNG_CMDID_GET_VERSION) {
+		struct mc_version version = {
+			.major = MC_VER_MAJOR,
+			.minor = MC_VER_MINOR,
+		};
+		struct mc_version *versionp = &version;
+
+		DPMNG_RSP_GET_VERSION((*cmd), versionp);
+		status = MC_CMD_STATUS_OK;
+		goto out;
+	}
+
+	if (cmdid == DPRC_CMDID_GET_CONT_ID) {
+		DPRC_RSP_GET_CONTAINER_ID((*cmd), EMUL_ROOT_DPRC_ID);
+		status = MC_CMD_STATUS_OK;
+		goto out;
+	}
+
+	for (int t = 0; t < EMUL_NUM_OBJ_TYPES; t++) {
+		uint16_t open_cmdid = emul_obj_types[t].open_cmdid;
+
+		if (cmdid == open_cmdid) {
+			status = emul_open(mc, t, &req, &token);
+			goto out;
+		}
+
+		/*
+		 * DPRCs are created with dprc_create_container()
+		 */
+		if (t != EMUL_DPRC &&
+		    cmdid == open_cmdid + EMUL_CREATE_CMDID_OFFSET) {
+			status = emul_create(mc, t, &req, &token);
+			goto out;
+		}
+	}
+
+	idx = mc->tokens[token] - 1;
+	if (token == 0 || idx < 0 || mc->objs[idx].destroyed) {
+		status = MC_CMD_STATUS_AUTH_ERR;
+		goto out;
+	}
+
+	status = emul_obj_command(mc, idx, cmdid, token, &req, cmd);
+out:
+	cmd->header &= ~(mc_enc(MC_CMD_HDR_TOKEN_O, MC_CMD_HDR_TOKEN_S,
+				UINT64_MAX) |
+			 mc_enc(MC_CMD_HDR_STATUS_O, MC_CMD_HDR_STATUS_S,
+				UINT64_MAX));
+	cmd->header |= mc_enc(MC_CMD_HDR_TOKEN_O, MC_CMD_HDR_TOKEN_S, token) |
+		       mc_enc(MC_CMD_HDR_STATUS_O, MC_CMD_HDR_STATUS_S, status);
+	return status;
+}
+
+static int mc_emul_init(struct fsl_mc_io *mc_io, const char *arg)
+{
+	int error = 0;
+
+	pthread_mutex_lock(&emul_mc_lock);
+	if (emul_mc == NULL)
+		error = emul_mc_create(arg, &emul_mc);
+
+	if (error == 0) {
+		emul_mc->refcount++;
+		mc_io->priv = emul_mc;
+	}
+
+	pthread_mutex_unlock(&emul_mc_lock);
+	return error;
+}
+
+static void mc_emul_cleanup(struct fsl_mc_io *mc_io)
+{
+	pthread_mutex_lock(&emul_mc_lock);
+	if (--emul_mc->refcount == 0) {
+		emul_mc_free(emul_mc);
+		emul_mc = NULL;
+	}
+
+	pthread_mutex_unlock(&emul_mc_lock);
+	mc_io->priv = NULL;
+}
+
+static int mc_emul_send_command(struct fsl_mc_io *mc_io,
+				struct mc_command *cmd)
+{
+	struct emul_mc *mc = mc_io->priv;
+	uint16_t cmdid = mc_dec(cmd->header, MC_CMD_HDR_CMDID_O,
+				MC_CMD_HDR_CMDID_S);
+	int64_t latency_ns;
+
+	pthread_mutex_lock(&mc->lock);
+	if (mc->busy_pct != 0 &&
+	    rand_r(&mc->busy_seed) % 100 < mc->busy_pct) {
+		cmd->header &= ~mc_enc(MC_CMD_HDR_STATUS_O, MC_CMD_HDR_STATUS_S,
+				       UINT64_MAX);
+		cmd->header |= mc_enc(MC_CMD_HDR_STATUS_O, MC_CMD_HDR_STATUS_S,
+				      MC_CMD_STATUS_BUSY);
+	} else {
+		(void)emul_execute(mc, cmd);
+	}
+
+	pthread_mutex_unlock(&mc->lock);
+
+	/*
+	 * The delay is taken outside of the lock, so that commands sent
+	 * through different portals overlap as they would on the MC
+	 */
+	latency_ns = mc->cmd_latency_ns[cmdid] >= 0 ?
+		     mc->cmd_latency_ns[cmdid] : mc->latency_ns;
+	if (latency_ns > 0) {
+		struct timespec delay = {
+			.tv_sec = latency_ns / 1000000000,
+			.tv_nsec = latency_ns % 1000000000,
+		};
+
+		(void)nanosleep(&delay, NULL);
+	}
+
+	return mc_read_cmd_error(cmd);
+}
+
+static int mc_emul_get_root_dprc_id(struct fsl_mc_io *mc_io,
+				    uint32_t *root_dprc_id)
+{
+	(void)mc_io;
+	*root_dprc_id = EMUL_ROOT_DPRC_ID;
+	return 0;
+}
+
+const struct mc_io_ops mc_emul_ops = {
+	.name = "emul",
+	.init = mc_emul_init,
+	.cleanup = mc_emul_cleanup,
+	.send = mc_emul_send_command,
+	.get_root_dprc_id = mc_emul_get_root_dprc_id,
+};
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MC_EMUL_H
+#define _MC_EMUL_H
+
+#include "fsl_mc_sys.h"
+
+/**
+ * "emul" transport: MC commands are executed by an in-process model of the
+ * MC firmware object model (containers, objects, resource pools, labels,
+ * connections and DPRC IRQ status), built from the transport argument:
+ *
+ *	emul[:<key>=<value>[,<key>=<value>...]]
+ *
+ * <object type>=<n>	number of objects of that type in each container
+ * containers=<n>	number of child containers of each container
+ * depth=<n>		levels of nested child containers (default 1)
+ * latency=<us>		delay added to every command
+ * latency.<cmd id>=<us> delay added to one command ID, e.g. latency.0x15a=50
+ * busy=<percent>	share of commands completed with BUSY, not executed
+ *
+ * All "emul" MC I/O objects of a process share the same emulated MC.
+ */
+extern const struct mc_io_ops mc_emul_ops;
+
+#endif /* _MC_EMUL_H */
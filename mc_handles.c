@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include "mc_handles.h"
+#include "utils.h"
+
+void mc_handle_cache_init(struct mc_handle_cache *cache,
+			  struct fsl_mc_io *mc_io)
+{
+	memset(cache, 0, sizeof(*cache));
+	cache->mc_io = mc_io;
+	pthread_mutex_init(&cache->lock, NULL);
+}
+
+/**
+ * Close all tokens of the cache, including the ones still in use.
+ * Returns the first close error, if any.
+ */
+int mc_handle_cache_cleanup(struct mc_handle_cache *cache)
+{
+	int error = 0;
+	int error2;
+
+	if (cache->mc_io == NULL)
+		return 0;
+
+	for (int i = 0; i < cache->num_handles; i++) {
+		struct mc_handle *handle = &cache->handles[i];
+
+		if (handle->refcount != 0)
+			DEBUG_PRINTF("%s.%u still in use (refcount %d)\n",
+				     handle->type, handle->id,
+				     handle->refcount);
+
+		error2 = handle->close(cache->mc_io, 0, handle->token);
+		if (error2 < 0 && error == 0)
+			error = error2;
+	}
+
+	cache->num_handles = 0;
+	cache->mc_io = NULL;
+	pthread_mutex_destroy(&cache->lock);
+	return error;
+}
+
+static struct mc_handle *find_handle(struct mc_handle_cache *cache,
+				     const char *obj_type, uint32_t obj_id)
+{
+	for (int i = 0; i < cache->num_handles; i++) {
+		struct mc_handle *handle = &cache->handles[i];
+
+		if (handle->id == obj_id && strcmp(handle->type, obj_type) == 0)
+			return handle;
+	}
+
+	return NULL;
+}
+
+static void remove_handle(struct mc_handle_cache *cache,
+			  struct mc_handle *handle)
+{
+	*handle = cache->handles[--cache->num_handles];
+}
+
+/**
+ * Make room for one more handle, closing the least recently opened unused
+ * one if the cache is full. Returns false if all cached tokens are in use.
+ */
+static bool make_room(struct mc_handle_cache *cache)
+{
+	struct mc_handle *victim = NULL;
+	int error;
+
+	if (cache->num_handles < MC_HANDLE_CACHE_SIZE)
+		return true;
+
+	for (int i = 0; i < cache->num_handles; i++) {
+		struct mc_handle *handle = &cache->handles[i];
+
+		if (handle->refcount == 0 &&
+		    (victim == NULL || handle->last_use < victim->last_use))
+			victim = handle;
+	}
+
+	if (victim == NULL)
+		return false;
+
+	error = victim->close(cache->mc_io, 0, victim->token);
+	if (error < 0)
+		DEBUG_PRINTF("closing %s.%u failed (error %d)\n",
+			     victim->type, victim->id, error);
+
+	remove_handle(cache, victim);
+	return true;
+}
+
+/**
+ * Get a token for object 'obj_type'.'obj_id', opening it with 'open_fn'
+ * unless the cache already holds one. Every successful call must be paired
+ * with a call to mc_handle_close().
+ */
+int mc_handle_open(struct mc_handle_cache *cache, const char *obj_type,
+		   uint32_t obj_id, mc_handle_open_t *open_fn,
+		   mc_handle_close_t *close_fn, uint16_t *token)
+{
+	struct mc_handle *handle;
+	int error = 0;
+
+	assert(strlen(obj_type) < sizeof(handle->type));
+	pthread_mutex_lock(&cache->lock);
+	handle = find_handle(cache, obj_type, obj_id);
+	if (handle != NULL) {
+		handle->refcount++;
+		handle->last_use = ++cache->use_counter;
+		*token = handle->token;
+		goto out;
+	}
+
+	error = open_fn(cache->mc_io, 0, obj_id, token);
+	if (error < 0 || *token == 0)
+		goto out;
+
+	/*
+	 * If every cached token is in use, the object is handed out
+	 * uncached and closed by mc_handle_close()
+	 */
+	if (!make_room(cache))
+		goto out;
+
+	handle = &cache->handles[cache->num_handles++];
+	strcpy(handle->type, obj_type);
+	handle->id = obj_id;
+	handle->token = *token;
+	handle->refcount = 1;
+	handle->close = close_fn;
+	handle->last_use = ++cache->use_counter;
+out:
+	pthread_mutex_unlock(&cache->lock);
+	return error;
+}
+
+/**
+ * Release a token obtained with mc_handle_open(). Cached tokens are left
+ * open for later users; other tokens are closed with 'close_fn'.
+ */
+int mc_handle_close(struct mc_handle_cache *cache, uint16_t token,
+		    mc_handle_close_t *close_fn)
+{
+	int error = 0;
+
+	pthread_mutex_lock(&cache->lock);
+	for (int i = 0; i < cache->num_handles; i++) {
+		struct mc_handle *handle = &cache->handles[i];
+
+		if (handle->token == token) {
+			assert(handle->refcount > 0);
+			handle->refcount--;
+			goto out;
+		}
+	}
+
+	error = close_fn(cache->mc_io, 0, token);
+out:
+	pthread_mutex_unlock(&cache->lock);
+	return error;
+}
+
+/**
+ * Drop the cached token of an object that has been destroyed, without
+ * closing it: the MC released it along with the object.
+ */
+void mc_handle_forget(struct mc_handle_cache *cache, const char *obj_type,
+		      uint32_t obj_id)
+{
+	struct mc_handle *handle;
+
+	pthread_mutex_lock(&cache->lock);
+	handle = find_handle(cache, obj_type, obj_id);
+	if (handle != NULL)
+		remove_handle(cache, handle);
+
+	pthread_mutex_unlock(&cache->lock);
+}
+
+/**
+ * Close the cached token of an object, if it is not in use, e.g. before
+ * destroying the object through another one.
+ */
+int mc_handle_evict(struct mc_handle_cache *cache, const char *obj_type,
+		    uint32_t obj_id)
+{
+	struct mc_handle *handle;
+	int error = 0;
+
+	pthread_mutex_lock(&cache->lock);
+	handle = find_handle(cache, obj_type, obj_id);
+	if (handle != NULL && handle->refcount == 0) {
+		error = handle->close(cache->mc_io, 0, handle->token);
+		remove_handle(cache, handle);
+	}
+
+	pthread_mutex_unlock(&cache->lock);
+	return error;
+}
+
+/**
+ * Close all cached tokens not in use, except those of objects of type
+ * 'keep_type' (if not NULL)
+ */
+int mc_handle_flush(struct mc_handle_cache *cache, const char *keep_type)
+{
+	int error = 0;
+	int error2;
+
+	pthread_mutex_lock(&cache->lock);
+	for (int i = cache->num_handles - 1; i >= 0; i--) {
+		struct mc_handle *handle = &cache->handles[i];
+
+		if (handle->refcount != 0 ||
+		    (keep_type != NULL && strcmp(handle->type, keep_type) == 0))
+			continue;
+
+		error2 = handle->close(cache->mc_io, 0, handle->token);
+		if (error2 < 0 && error == 0)
+			error = error2;
+
+		remove_handle(cache, handle);
+	}
+
+	pthread_mutex_unlock(&cache->lock);
+	return error;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MC_HANDLES_H
+#define _MC_HANDLES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "fsl_mc_sys.h"
+#include "fsl_dprc.h"
+
+/**
+ * Maximum number of MC object tokens kept open by a handle cache
+ */
+#define MC_HANDLE_CACHE_SIZE	128
+
+typedef int mc_handle_open_t(struct fsl_mc_io *mc_io,
+			     uint32_t cmd_flags,
+			     int obj_id,
+			     uint16_t *token);
+
+typedef int mc_handle_close_t(struct fsl_mc_io *mc_io,
+			      uint32_t cmd_flags,
+			      uint16_t token);
+
+/**
+ * struct mc_handle - MC object token kept open by a handle cache
+ */
+struct mc_handle {
+	char type[16];
+	uint32_t id;
+	uint16_t token;
+
+	/**
+	 * number of users of the token; unused tokens stay open until
+	 * evicted or until the cache is cleaned up
+	 */
+	int refcount;
+
+	mc_handle_close_t *close;
+
+	/**
+	 * value of the cache's use counter when last opened, for eviction
+	 */
+	uint64_t last_use;
+};
+
+/**
+ * struct mc_handle_cache - MC object tokens of one MC portal, keyed by
+ * object (type, id), reused across open/close pairs
+ */
+struct mc_handle_cache {
+	struct fsl_mc_io *mc_io;
+	pthread_mutex_t lock;
+	uint64_t use_counter;
+	int num_handles;
+	struct mc_handle handles[MC_HANDLE_CACHE_SIZE];
+};
+
+void mc_handle_cache_init(struct mc_handle_cache *cache,
+			  struct fsl_mc_io *mc_io);
+
+int mc_handle_cache_cleanup(struct mc_handle_cache *cache);
+
+int mc_handle_open(struct mc_handle_cache *cache, const char *obj_type,
+		   uint32_t obj_id, mc_handle_open_t *open_fn,
+		   mc_handle_close_t *close_fn, uint16_t *token);
+
+int mc_handle_close(struct mc_handle_cache *cache, uint16_t token,
+		    mc_handle_close_t *close_fn);
+
+void mc_handle_forget(struct mc_handle_cache *cache, const char *obj_type,
+		      uint32_t obj_id);
+
+int mc_handle_evict(struct mc_handle_cache *cache, const char *obj_type,
+		    uint32_t obj_id);
+
+int mc_handle_flush(struct mc_handle_cache *cache, const char *keep_type);
+
+#endif /* _MC_HANDLES_H */
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include "mc_pool.h"
+#include "utils.h"
+
+static void *mc_pool_worker_thread(void *thread_arg)
+{
+	struct mc_pool_worker *worker = thread_arg;
+	struct mc_pool *pool = worker->pool;
+	unsigned int generation = 0;
+	int item;
+	int error;
+
+	(void)restool_ctx_switch(pool->ctx);
+	pthread_mutex_lock(&pool->lock);
+	for ( ; ; ) {
+		while (!pool->stopping && pool->generation == generation)
+			pthread_cond_wait(&pool->work_cond, &pool->lock);
+
+		if (pool->stopping)
+			break;
+
+		generation = pool->generation;
+		while (pool->next_item < pool->num_items) {
+			item = pool->next_item++;
+			pthread_mutex_unlock(&pool->lock);
+			error = pool->fn(&worker->mc_io, item, pool->arg);
+			pthread_mutex_lock(&pool->lock);
+			pool->errors[item] = error;
+		}
+
+		if (--pool->busy_workers == 0)
+			pthread_cond_signal(&pool->done_cond);
+	}
+
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+/**
+ * Open the portals of the pool and start one worker thread per portal.
+ * 'pool_spec' is either a number of portals to open with 'transport_spec',
+ * or a comma separated list of transport specs, one per portal.
+ */
+int mc_pool_init(struct mc_pool *pool, const char *pool_spec,
+		 const char *transport_spec)
+{
+	char specs_buf[PATH_MAX];
+	char *specs[MC_POOL_MAX_PORTALS];
+	int num_portals;
+	char *endptr;
+	long n;
+	int error;
+
+	memset(pool, 0, sizeof(*pool));
+	errno = 0;
+	n = strtol(pool_spec, &endptr, 0);
+	if (!STRTOL_ERROR(pool_spec, endptr, n, errno)) {
+		if (n <= 0 || n > MC_POOL_MAX_PORTALS) {
+			ERROR_PRINTF("Invalid number of MC portals: %ld (max %d)\n",
+				     n, MC_POOL_MAX_PORTALS);
+			return -EINVAL;
+		}
+
+		num_portals = n;
+		for (int i = 0; i < num_portals; i++)
+			specs[i] = (char *)transport_spec;
+	} else {
+		char *cursor = NULL;
+		char *spec;
+
+		if (strlen(pool_spec) >= sizeof(specs_buf)) {
+			ERROR_PRINTF("MC portal pool spec too long\n");
+			return -EINVAL;
+		}
+
+		strcpy(specs_buf, pool_spec);
+		num_portals = 0;
+		for (spec = strtok_r(specs_buf, ",", &cursor); spec != NULL;
+		     spec = strtok_r(NULL, ",", &cursor)) {
+			if (num_portals == MC_POOL_MAX_PORTALS) {
+				ERROR_PRINTF("Too many MC portals (max %d)\n",
+					     MC_POOL_MAX_PORTALS);
+				return -EINVAL;
+			}
+
+			specs[num_portals++] = spec;
+		}
+
+		if (num_portals == 0) {
+			ERROR_PRINTF("Empty MC portal pool spec\n");
+			return -EINVAL;
+		}
+	}
+
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_mutex_init(&pool->run_lock, NULL);
+	pthread_cond_init(&pool->work_cond, NULL);
+	pthread_cond_init(&pool->done_cond, NULL);
+	pool->ctx = restool_current;
+
+	for (int i = 0; i < num_portals; i++) {
+		struct mc_pool_worker *worker = &pool->workers[i];
+
+		worker->pool = pool;
+		error = mc_io_init(&worker->mc_io, specs[i]);
+		if (error < 0)
+			goto error;
+
+		error = -pthread_create(&worker->thread, NULL,
+					mc_pool_worker_thread, worker);
+		if (error < 0) {
+			ERROR_PRINTF("pthread_create() failed (error %d)\n",
+				     error);
+			mc_io_cleanup(&worker->mc_io);
+			goto error;
+		}
+
+		pool->num_portals++;
+	}
+
+	DEBUG_PRINTF("MC portal pool of %d portals ready\n",
+		     pool->num_portals);
+	return 0;
+error:
+	mc_pool_cleanup(pool);
+	return error;
+}
+
+void mc_pool_cleanup(struct mc_pool *pool)
+{
+	pthread_mutex_lock(&pool->lock);
+	pool->stopping = true;
+	pthread_cond_broadcast(&pool->work_cond);
+	pthread_mutex_unlock(&pool->lock);
+
+	for (int i = 0; i < pool->num_portals; i++) {
+		(void)pthread_join(pool->workers[i].thread, NULL);
+		mc_io_cleanup(&pool->workers[i].mc_io);
+	}
+
+	pool->num_portals = 0;
+	pthread_cond_destroy(&pool->done_cond);
+	pthread_cond_destroy(&pool->work_cond);
+	pthread_mutex_destroy(&pool->run_lock);
+	pthread_mutex_destroy(&pool->lock);
+}
+
+/**
+ * Run fn(mc_io, item, arg) for every item in [0, num_items), spreading the
+ * items over the pool workers, and wait for all of them to complete.
+ * The return code of each call is stored in errors[item]; the first
+ * non-zero one (in item order) is returned. Jobs of several threads are
+ * run one after the other.
+ */
+int mc_pool_run(struct mc_pool *pool, mc_pool_work_fn_t *fn,
+		int num_items, void *arg, int *errors)
+{
+	assert(pool->num_portals > 0);
+
+	pthread_mutex_lock(&pool->run_lock);
+	pthread_mutex_lock(&pool->lock);
+	assert(pool->busy_workers == 0);
+	pool->fn = fn;
+	pool->arg = arg;
+	pool->num_items = num_items;
+	pool->next_item = 0;
+	pool->errors = errors;
+	pool->busy_workers = pool->num_portals;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->work_cond);
+	while (pool->busy_workers != 0)
+		pthread_cond_wait(&pool->done_cond, &pool->lock);
+
+	pool->fn = NULL;
+	pool->errors = NULL;
+	pthread_mutex_unlock(&pool->lock);
+	pthread_mutex_unlock(&pool->run_lock);
+
+	for (int i = 0; i < num_items; i++) {
+		if (errors[i] != 0)
+			return errors[i];
+	}
+
+	return 0;
+}
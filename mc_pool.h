@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _MC_POOL_H
+#define _MC_POOL_H
+
+#include <stdbool.h>
+#include <pthread.h>
+#include "fsl_mc_sys.h"
+
+/**
+ * Maximum number of MC portals in a portal pool
+ */
+#define MC_POOL_MAX_PORTALS	16
+
+/**
+ * Work function run by the pool workers. 'mc_io' is the portal owned by the
+ * calling worker; MC object tokens are only valid on the portal that
+ * opened them, so any object the function uses must be opened through it.
+ */
+typedef int mc_pool_work_fn_t(struct fsl_mc_io *mc_io, int item, void *arg);
+
+struct mc_pool;
+struct restool_ctx;
+
+/**
+ * struct mc_pool_worker - worker thread bound to one portal of the pool
+ */
+struct mc_pool_worker {
+	struct mc_pool *pool;
+	struct fsl_mc_io mc_io;
+	pthread_t thread;
+};
+
+/**
+ * struct mc_pool - pool of MC portals, each driven by its own worker thread
+ */
+struct mc_pool {
+	int num_portals;
+	struct mc_pool_worker workers[MC_POOL_MAX_PORTALS];
+
+	pthread_mutex_t lock;
+	pthread_cond_t work_cond;
+	pthread_cond_t done_cond;
+
+	/**
+	 * held by the thread whose job the pool is running: jobs of other
+	 * threads wait for it to complete
+	 */
+	pthread_mutex_t run_lock;
+
+	/**
+	 * incremented every time a new job is posted
+	 */
+	unsigned int generation;
+	int busy_workers;
+	bool stopping;
+
+	/**
+	 * restool context the workers run in
+	 */
+	struct restool_ctx *ctx;
+
+	/**
+	 * current job: items [0, num_items) are handed out through next_item
+	 */
+	mc_pool_work_fn_t *fn;
+	void *arg;
+	int num_items;
+	int next_item;
+	int *errors;
+};
+
+int mc_pool_init(struct mc_pool *pool, const char *pool_spec,
+		 const char *transport_spec);
+
+void mc_pool_cleanup(struct mc_pool *pool);
+
+int mc_pool_run(struct mc_pool *pool, mc_pool_work_fn_t *fn,
+		int num_items, void *arg, int *errors);
+
+#endif /* _MC_POOL_H */
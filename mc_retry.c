@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include "mc_retry.h"
+#include "utils.h"
+#include "fsl_mc_cmd.h"
+#include "fsl_dpmng_cmd.h"
+#include "fsl_dprc_cmd.h"
+#include "fsl_dpni_cmd.h"
+#include "fsl_dpmac_cmd.h"
+#include "fsl_dpci_cmd.h"
+#include "fsl_dpaiop_cmd.h"
+
+#define MC_RETRY_NUM_CMD_IDS	(1 << MC_CMD_HDR_CMDID_S)
+
+/*
+ * MC commands that only read MC state, and can therefore be sent again
+ * whether or not a previous attempt was executed. The IDs of the common
+ * object commands (below 0x100) are the same for all object types.
+ */
+static const uint16_t query_cmd_ids[] = {
+	DPRC_CMDID_GET_ATTR,
+	DPNI_CMDID_IS_ENABLED,
+	DPRC_CMDID_GET_IRQ,
+	DPRC_CMDID_GET_IRQ_ENABLE,
+	DPRC_CMDID_GET_IRQ_MASK,
+	DPRC_CMDID_GET_IRQ_STATUS,
+	DPMNG_CMDID_GET_VERSION,
+	DPRC_CMDID_GET_CONT_ID,
+	DPRC_CMDID_GET_RES_QUOTA,
+	DPRC_CMDID_GET_OBJ_COUNT,
+	DPRC_CMDID_GET_OBJ,
+	DPRC_CMDID_GET_RES_COUNT,
+	DPRC_CMDID_GET_RES_IDS,
+	DPRC_CMDID_GET_OBJ_REG,
+	DPRC_CMDID_GET_OBJ_IRQ,
+	DPRC_CMDID_GET_OBJ_DESC,
+	DPRC_CMDID_GET_POOL,
+	DPRC_CMDID_GET_POOL_COUNT,
+	DPRC_CMDID_GET_CONNECTION,
+	DPNI_CMDID_GET_COUNTER,
+	DPNI_CMDID_GET_LINK_STATE,
+	DPNI_CMDID_GET_PRIM_MAC,
+	DPMAC_CMDID_GET_COUNTER,
+	DPCI_CMDID_GET_LINK_STATE,
+	DPCI_CMDID_GET_PEER_ATTR,
+	DPAIOP_CMDID_GET_SL_VERSION,
+	DPAIOP_CMDID_GET_STATE,
+};
+
+static struct mc_retry_policy retry_policy = {
+	.max_attempts = 4,
+	.backoff_us = 1000,
+	.max_backoff_us = 100000,
+	.deadline_ms = 2000,
+	.all_commands = false,
+};
+
+/**
+ * Per command ID number of attempts overriding the policy; 0 if none
+ */
+static uint8_t attempts_override[MC_RETRY_NUM_CMD_IDS];
+
+static __thread unsigned int jitter_seed;
+
+static bool is_query_cmd(uint16_t cmd_id)
+{
+	for (unsigned int i = 0; i < ARRAY_SIZE(query_cmd_ids); i++) {
+		if (query_cmd_ids[i] == cmd_id)
+			return true;
+	}
+
+	return false;
+}
+
+static int parse_retry_value(const char *key, const char *value,
+			     long max, long *result)
+{
+	char *endptr;
+
+	errno = 0;
+	*result = strtol(value, &endptr, 0);
+	if (STRTOL_ERROR(value, endptr, *result, errno) ||
+	    *result < 0 || *result > max) {
+		ERROR_PRINTF("Invalid value for --retry %s: \'%s\'\n",
+			     key, value);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/**
+ * Set up the retry policy from a --retry argument: either "off", or a
+ * comma separated list of:
+ *	attempts=<n>, backoff=<us>, max-backoff=<us>, deadline=<ms>,
+ *	commands=queries|all, <cmd-id>=<attempts>
+ */
+int mc_retry_configure(const char *spec)
+{
+	struct mc_retry_policy policy = retry_policy;
+	char *buf;
+	char *cursor = NULL;
+	char *key;
+	int error = 0;
+
+	if (strcmp(spec, "off") == 0) {
+		retry_policy.max_attempts = 1;
+		memset(attempts_override, 0, sizeof(attempts_override));
+		return 0;
+	}
+
+	buf = strdup(spec);
+	if (buf == NULL) {
+		ERROR_PRINTF("strdup() failed\n");
+		return -ENOMEM;
+	}
+
+	for (key = strtok_r(buf, ",", &cursor); key != NULL;
+	     key = strtok_r(NULL, ",", &cursor)) {
+		char *value = strchr(key, '=');
+		long n;
+
+		if (value == NULL) {
+			ERROR_PRINTF("Invalid --retry parameter: \'%s\'\n",
+				     key);
+			error = -EINVAL;
+			goto out;
+		}
+
+		*value++ = '\0';
+		if (strcmp(key, "commands") == 0) {
+			if (strcmp(value, "queries") == 0) {
+				policy.all_commands = false;
+			} else if (strcmp(value, "all") == 0) {
+				policy.all_commands = true;
+			} else {
+				ERROR_PRINTF("Invalid --retry commands: \'%s\'\n",
+					     value);
+				error = -EINVAL;
+				goto out;
+			}
+
+			continue;
+		}
+
+		if (strcmp(key, "attempts") == 0) {
+			error = parse_retry_value(key, value, UINT8_MAX, &n);
+			policy.max_attempts = n;
+		} else if (strcmp(key, "backoff") == 0) {
+			error = parse_retry_value(key, value, INT32_MAX, &n);
+			policy.backoff_us = n;
+		} else if (strcmp(key, "max-backoff") == 0) {
+			error = parse_retry_value(key, value, INT32_MAX, &n);
+			policy.max_backoff_us = n;
+		} else if (strcmp(key, "deadline") == 0) {
+			error = parse_retry_value(key, value, INT32_MAX, &n);
+			policy.deadline_ms = n;
+		} else {
+			long cmd_id;
+
+			error = parse_retry_value("command ID", key,
+						  MC_RETRY_NUM_CMD_IDS - 1,
+						  &cmd_id);
+			if (error < 0)
+				goto out;
+
+			error = parse_retry_value(key, value, UINT8_MAX, &n);
+			attempts_override[cmd_id] = n != 0 ? n : 1;
+		}
+
+		if (error < 0)
+			goto out;
+	}
+
+	if (policy.max_attempts == 0)
+		policy.max_attempts = 1;
+
+	retry_policy = policy;
+out:
+	free(buf);
+	return error;
+}
+
+/**
+ * Decide whether a command that completed with 'error' after 'attempts'
+ * attempts, the first one 'elapsed_ns' ago, is to be sent again.
+ * Returns the time to wait before the next attempt, in ns, or 0 to give up.
+ */
+uint64_t mc_retry_backoff(uint64_t cmd_header, int error, int attempts,
+			  uint64_t elapsed_ns)
+{
+	uint16_t cmd_id = (uint16_t)mc_dec(cmd_header, MC_CMD_HDR_CMDID_O,
+					   MC_CMD_HDR_CMDID_S);
+	const struct mc_retry_policy *policy = &retry_policy;
+	int max_attempts;
+	uint64_t backoff_ns;
+
+	if (error != -EBUSY && error != -ETIMEDOUT)
+		return 0;
+
+	if (attempts_override[cmd_id] != 0)
+		max_attempts = attempts_override[cmd_id];
+	else if (policy->all_commands || is_query_cmd(cmd_id))
+		max_attempts = policy->max_attempts;
+	else
+		max_attempts = 1;
+
+	if (attempts >= max_attempts)
+		return 0;
+
+	backoff_ns = (uint64_t)policy->backoff_us * 1000;
+	for (int i = 1; i < attempts && backoff_ns < policy->max_backoff_us *
+						     1000ULL; i++)
+		backoff_ns *= 2;
+
+	if (backoff_ns > policy->max_backoff_us * 1000ULL)
+		backoff_ns = policy->max_backoff_us * 1000ULL;
+
+	if (jitter_seed == 0)
+		jitter_seed = (unsigned int)time(NULL) ^
+			      (unsigned int)(uintptr_t)&jitter_seed;
+
+	backoff_ns = backoff_ns / 2 +
+		     (uint64_t)rand_r(&jitter_seed) % (backoff_ns / 2 + 1);
+	if (elapsed_ns + backoff_ns > policy->deadline_ms * 1000000ULL)
+		return 0;
+
+	/*
+	 * 0 means "give up": wait at least 1 ns with a zero backoff
+	 */
+	return backoff_ns != 0 ? backoff_ns : 1;
+}
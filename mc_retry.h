@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MC_RETRY_H
+#define _MC_RETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * struct mc_retry_policy - how MC commands completing with BUSY or TIMEOUT
+ * are sent again
+ */
+struct mc_retry_policy {
+	/**
+	 * total number of attempts per command; 1 disables retries
+	 */
+	int max_attempts;
+
+	/**
+	 * backoff before the first retry, doubled for each further retry up
+	 * to max_backoff_us. The actual delay is drawn in [backoff/2, backoff].
+	 */
+	uint32_t backoff_us;
+	uint32_t max_backoff_us;
+
+	/**
+	 * no retry is started once this long has elapsed since the first
+	 * attempt of a command
+	 */
+	uint32_t deadline_ms;
+
+	/**
+	 * retry every command, not only the idempotent queries
+	 */
+	bool all_commands;
+};
+
+int mc_retry_configure(const char *spec);
+
+uint64_t mc_retry_backoff(uint64_t cmd_header, int error, int attempts,
+			  uint64_t elapsed_ns);
+
+#endif /* _MC_RETRY_H */
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "mc_stats.h"
+#include "fsl_mc_cmd.h"
+#include "utils.h"
+
+#define MC_STATS_NUM_CMD_IDS	(1 << MC_CMD_HDR_CMDID_S)
+
+static bool stats_enabled;
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct mc_cmd_stats *cmd_stats[MC_STATS_NUM_CMD_IDS];
+
+static unsigned int latency_to_bucket(uint64_t ns)
+{
+	unsigned int msb;
+
+	if (ns < (1 << MC_STATS_SUB_BUCKET_BITS))
+		return (unsigned int)ns;
+
+	msb = 63 - __builtin_clzll(ns);
+	return ((msb - MC_STATS_SUB_BUCKET_BITS + 1) <<
+		MC_STATS_SUB_BUCKET_BITS) +
+	       ((ns >> (msb - MC_STATS_SUB_BUCKET_BITS)) &
+		((1 << MC_STATS_SUB_BUCKET_BITS) - 1));
+}
+
+/**
+ * Highest latency, in ns, that falls in the given bucket
+ */
+static uint64_t bucket_to_latency(unsigned int bucket)
+{
+	unsigned int sub = bucket & ((1 << MC_STATS_SUB_BUCKET_BITS) - 1);
+	unsigned int shift;
+
+	if (bucket < (1 << MC_STATS_SUB_BUCKET_BITS))
+		return bucket;
+
+	shift = (bucket >> MC_STATS_SUB_BUCKET_BITS) - 1;
+	return ((((uint64_t)1 << MC_STATS_SUB_BUCKET_BITS) + sub + 1) <<
+		shift) - 1;
+}
+
+/**
+ * Latency at the given percentile, rounded up to its bucket's upper bound
+ */
+static uint64_t percentile(const struct mc_cmd_stats *stats,
+			   unsigned int pct)
+{
+	uint64_t rank = (stats->count * pct + 99) / 100;
+	uint64_t seen = 0;
+	uint64_t latency;
+
+	for (unsigned int i = 0; i < MC_STATS_NUM_BUCKETS; i++) {
+		seen += stats->buckets[i];
+		if (seen >= rank && seen != 0) {
+			latency = bucket_to_latency(i);
+			return latency < stats->max_ns ? latency : stats->max_ns;
+		}
+	}
+
+	return stats->max_ns;
+}
+
+void mc_stats_enable(void)
+{
+	stats_enabled = true;
+}
+
+bool mc_stats_enabled(void)
+{
+	return stats_enabled;
+}
+
+/**
+ * Statistics of the command ID of the given command header, allocated on
+ * first use. Must be called with stats_lock held.
+ */
+static struct mc_cmd_stats *get_cmd_stats(uint64_t cmd_header)
+{
+	unsigned int cmd_id = (unsigned int)mc_dec(cmd_header,
+						   MC_CMD_HDR_CMDID_O,
+						   MC_CMD_HDR_CMDID_S);
+
+	if (cmd_stats[cmd_id] == NULL)
+		cmd_stats[cmd_id] = calloc(1, sizeof(struct mc_cmd_stats));
+
+	return cmd_stats[cmd_id];
+}
+
+/**
+ * Account one completed MC command. 'error' is the value returned to the
+ * flib caller, 0 or the negative error code of the completion status.
+ */
+void mc_stats_record(uint64_t cmd_header, uint64_t latency_ns, int error)
+{
+	struct mc_cmd_stats *stats;
+	int status;
+
+	pthread_mutex_lock(&stats_lock);
+	stats = get_cmd_stats(cmd_header);
+	if (stats == NULL)
+		goto out;
+
+	stats->count++;
+	stats->total_ns += latency_ns;
+	if (latency_ns > stats->max_ns)
+		stats->max_ns = latency_ns;
+
+	stats->buckets[latency_to_bucket(latency_ns)]++;
+
+	status = (int)flib_error_to_mc_status(error);
+	if (status >= 0 && status < MC_STATS_NUM_STATUSES)
+		stats->status_counts[status]++;
+	else
+		stats->other_errors++;
+out:
+	pthread_mutex_unlock(&stats_lock);
+}
+
+/**
+ * Account one retry of an MC command, after backing off for 'backoff_ns'
+ */
+void mc_stats_record_retry(uint64_t cmd_header, uint64_t backoff_ns)
+{
+	struct mc_cmd_stats *stats;
+
+	pthread_mutex_lock(&stats_lock);
+	stats = get_cmd_stats(cmd_header);
+	if (stats != NULL) {
+		stats->retries++;
+		stats->backoff_ns += backoff_ns;
+	}
+
+	pthread_mutex_unlock(&stats_lock);
+}
+
+static void print_cmd_stats_text(FILE *fp, unsigned int cmd_id,
+				 const struct mc_cmd_stats *stats)
+{
+	fprintf(fp, "%#05x %10llu %10.1f %10.1f %10.1f %10.1f",
+		cmd_id, (unsigned long long)stats->count,
+		stats->total_ns / 1000.0 / stats->count,
+		percentile(stats, 50) / 1000.0,
+		percentile(stats, 99) / 1000.0,
+		stats->max_ns / 1000.0);
+
+	for (int i = 1; i < MC_STATS_NUM_STATUSES; i++) {
+		if (stats->status_counts[i] != 0)
+			fprintf(fp, "  %s: %llu",
+				mc_status_to_string((enum mc_cmd_status)i),
+				(unsigned long long)stats->status_counts[i]);
+	}
+
+	if (stats->other_errors != 0)
+		fprintf(fp, "  other errors: %llu",
+			(unsigned long long)stats->other_errors);
+
+	if (stats->retries != 0)
+		fprintf(fp, "  retries: %llu (backoff %.1f us)",
+			(unsigned long long)stats->retries,
+			stats->backoff_ns / 1000.0);
+
+	fprintf(fp, "\n");
+}
+
+static void print_cmd_stats_json(FILE *fp, unsigned int cmd_id,
+				 const struct mc_cmd_stats *stats)
+{
+	bool first = true;
+
+	fprintf(fp, "{\"cmd_id\": %u, \"count\": %llu, \"total_ns\": %llu, "
+		"\"p50_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu, "
+		"\"status\": {",
+		cmd_id, (unsigned long long)stats->count,
+		(unsigned long long)stats->total_ns,
+		(unsigned long long)percentile(stats, 50),
+		(unsigned long long)percentile(stats, 99),
+		(unsigned long long)stats->max_ns);
+
+	for (int i = 0; i < MC_STATS_NUM_STATUSES; i++) {
+		if (stats->status_counts[i] == 0)
+			continue;
+
+		fprintf(fp, "%s\"%#x\": %llu", first ? "" : ", ", i,
+			(unsigned long long)stats->status_counts[i]);
+		first = false;
+	}
+
+	fprintf(fp, "}, \"other_errors\": %llu, \"retries\": %llu, "
+		"\"backoff_ns\": %llu}",
+		(unsigned long long)stats->other_errors,
+		(unsigned long long)stats->retries,
+		(unsigned long long)stats->backoff_ns);
+}
+
+/**
+ * Dump the statistics of all MC command IDs seen so far, either as a table
+ * or as a JSON array. Latencies are printed in microseconds in the table.
+ */
+void mc_stats_print(FILE *fp, bool json)
+{
+	bool first = true;
+
+	pthread_mutex_lock(&stats_lock);
+	if (json)
+		fprintf(fp, "[");
+	else
+		fprintf(fp, "%-5s %10s %10s %10s %10s %10s  %s\n", "cmdid",
+			"count", "avg(us)", "p50(us)", "p99(us)", "max(us)",
+			"errors");
+
+	for (unsigned int i = 0; i < MC_STATS_NUM_CMD_IDS; i++) {
+		if (cmd_stats[i] == NULL)
+			continue;
+
+		if (json) {
+			fprintf(fp, "%s\n  ", first ? "" : ",");
+			print_cmd_stats_json(fp, i, cmd_stats[i]);
+		} else {
+			print_cmd_stats_text(fp, i, cmd_stats[i]);
+		}
+
+		first = false;
+	}
+
+	if (json)
+		fprintf(fp, "\n]\n");
+
+	pthread_mutex_unlock(&stats_lock);
+}
+
+void mc_stats_cleanup(void)
+{
+	for (unsigned int i = 0; i < MC_STATS_NUM_CMD_IDS; i++) {
+		free(cmd_stats[i]);
+		cmd_stats[i] = NULL;
+	}
+}
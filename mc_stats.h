@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MC_STATS_H
+#define _MC_STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Latency histogram buckets: 4 buckets per power of 2 nanoseconds
+ */
+#define MC_STATS_SUB_BUCKET_BITS	2
+#define MC_STATS_NUM_BUCKETS		(64 << MC_STATS_SUB_BUCKET_BITS)
+
+/**
+ * Number of distinct MC completion statuses counted
+ */
+#define MC_STATS_NUM_STATUSES		16
+
+/**
+ * struct mc_cmd_stats - statistics of one MC command ID
+ */
+struct mc_cmd_stats {
+	uint64_t count;
+	uint64_t total_ns;
+	uint64_t max_ns;
+	uint64_t buckets[MC_STATS_NUM_BUCKETS];
+
+	/**
+	 * completions per MC status; errors that do not come from the MC
+	 * itself (e.g. transport errors) are counted in other_errors
+	 */
+	uint64_t status_counts[MC_STATS_NUM_STATUSES];
+	uint64_t other_errors;
+
+	/**
+	 * attempts sent again after a BUSY or TIMEOUT completion, and the
+	 * total time spent backing off before them
+	 */
+	uint64_t retries;
+	uint64_t backoff_ns;
+};
+
+void mc_stats_enable(void);
+
+bool mc_stats_enabled(void);
+
+void mc_stats_record(uint64_t cmd_header, uint64_t latency_ns, int error);
+
+void mc_stats_record_retry(uint64_t cmd_header, uint64_t backoff_ns);
+
+void mc_stats_print(FILE *fp, bool json);
+
+void mc_stats_cleanup(void);
+
+#endif /* _MC_STATS_H */
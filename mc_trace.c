@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/types.h>
+#include <pthread.h>
+#include "mc_trace.h"
+#include "utils.h"
+
+static FILE *trace_file;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Start recording MC commands to 'path'. Records are appended if the file
+ * already holds a trace.
+ */
+int mc_trace_open(const char *path)
+{
+	struct mc_trace_file_header header;
+	int error;
+
+	trace_file = fopen(path, "ab");
+	if (trace_file == NULL) {
+		error = -errno;
+		ERROR_PRINTF("fopen() failed for %s (error %d)\n", path, error);
+		return error;
+	}
+
+	if (ftell(trace_file) == 0) {
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, MC_TRACE_MAGIC, sizeof(header.magic));
+		header.version = MC_TRACE_VERSION;
+		if (fwrite(&header, sizeof(header), 1, trace_file) != 1) {
+			ERROR_PRINTF("failed to write %s\n", path);
+			(void)fclose(trace_file);
+			trace_file = NULL;
+			return -EIO;
+		}
+	}
+
+	return 0;
+}
+
+void mc_trace_close(void)
+{
+	if (trace_file == NULL)
+		return;
+
+	if (fclose(trace_file) != 0)
+		ERROR_PRINTF("fclose failed: %s\n", strerror(errno));
+
+	trace_file = NULL;
+}
+
+bool mc_trace_recording(void)
+{
+	return trace_file != NULL;
+}
+
+void mc_trace_record(const struct mc_trace_record *record)
+{
+	pthread_mutex_lock(&trace_lock);
+	if (fwrite(record, sizeof(*record), 1, trace_file) != 1)
+		DEBUG_PRINTF("failed to write MC trace record\n");
+
+	pthread_mutex_unlock(&trace_lock);
+}
+
+/*
+ * "replay" transport: commands are answered from a trace recorded with
+ * --record. The argument is "<file>[,latency]"; with "latency", each
+ * response is delayed by the latency recorded for it.
+ */
+struct mc_replay {
+	struct mc_trace_record *records;
+	bool *used;
+	size_t num_records;
+
+	/**
+	 * index following the last record replayed
+	 */
+	size_t cursor;
+	bool latency;
+};
+
+static int mc_replay_load(struct mc_replay *replay, const char *path)
+{
+	struct mc_trace_file_header header;
+	long size;
+	FILE *fp;
+	int error;
+
+	fp = fopen(path, "rb");
+	if (fp == NULL) {
+		error = -errno;
+		ERROR_PRINTF("fopen() failed for %s (error %d)\n", path, error);
+		return error;
+	}
+
+	if (fread(&header, sizeof(header), 1, fp) != 1 ||
+	    memcmp(header.magic, MC_TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+	    header.version != MC_TRACE_VERSION) {
+		ERROR_PRINTF("%s is not an MC command trace\n", path);
+		error = -EINVAL;
+		goto out;
+	}
+
+	if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) < 0 ||
+	    fseek(fp, sizeof(header), SEEK_SET) != 0) {
+		error = -errno;
+		ERROR_PRINTF("failed to read %s (error %d)\n", path, error);
+		goto out;
+	}
+
+	replay->num_records = (size - sizeof(header)) /
+			      sizeof(struct mc_trace_record);
+	replay->records = calloc(replay->num_records + 1,
+				 sizeof(struct mc_trace_record));
+	replay->used = calloc(replay->num_records + 1, sizeof(bool));
+	if (replay->records == NULL || replay->used == NULL) {
+		ERROR_PRINTF("calloc() failed\n");
+		error = -ENOMEM;
+		goto out;
+	}
+
+	if (fread(replay->records, sizeof(struct mc_trace_record),
+		  replay->num_records, fp) != replay->num_records) {
+		ERROR_PRINTF("failed to read %s\n", path);
+		error = -EIO;
+		goto out;
+	}
+
+	DEBUG_PRINTF("loaded %zu MC trace records from %s\n",
+		     replay->num_records, path);
+	error = 0;
+out:
+	(void)fclose(fp);
+	return error;
+}
+
+static void mc_replay_cleanup(struct fsl_mc_io *mc_io)
+{
+	struct mc_replay *replay = mc_io->priv;
+
+	free(replay->records);
+	free(replay->used);
+	free(replay);
+	mc_io->priv = NULL;
+}
+
+static int mc_replay_init(struct fsl_mc_io *mc_io, const char *arg)
+{
+	char path[PATH_MAX];
+	struct mc_replay *replay;
+	char *suffix;
+	int error;
+
+	if (arg == NULL) {
+		ERROR_PRINTF("replay transport requires a trace file\n");
+		return -EINVAL;
+	}
+
+	if (strlen(arg) >= sizeof(path)) {
+		ERROR_PRINTF("trace file name too long\n");
+		return -EINVAL;
+	}
+
+	replay = calloc(1, sizeof(*replay));
+	if (replay == NULL) {
+		ERROR_PRINTF("calloc() failed\n");
+		return -ENOMEM;
+	}
+
+	mc_io->priv = replay;
+	strcpy(path, arg);
+	suffix = strrchr(path, ',');
+	if (suffix != NULL && strcmp(suffix, ",latency") == 0) {
+		*suffix = '\0';
+		replay->latency = true;
+	}
+
+	error = mc_replay_load(replay, path);
+	if (error < 0)
+		mc_replay_cleanup(mc_io);
+
+	return error;
+}
+
+static bool record_matches(const struct mc_trace_record *record,
+			   const struct mc_command *cmd)
+{
+	return record->type == MC_TRACE_COMMAND &&
+	       memcmp(&record->request, cmd, sizeof(*cmd)) == 0;
+}
+
+/**
+ * Find the record answering 'cmd': the first unused matching record after
+ * the last one replayed, else the first unused matching record, else the
+ * last matching record, so that repeated queries get an answer.
+ */
+static struct mc_trace_record *find_record(struct mc_replay *replay,
+					   const struct mc_command *cmd)
+{
+	size_t n = replay->num_records;
+	ssize_t last_match = -1;
+	size_t i;
+
+	for (size_t k = 0; k < n; k++) {
+		i = (replay->cursor + k) % n;
+		if (!record_matches(&replay->records[i], cmd))
+			continue;
+
+		if (!replay->used[i])
+			goto found;
+
+		last_match = i;
+	}
+
+	if (last_match < 0)
+		return NULL;
+
+	i = last_match;
+found:
+	replay->used[i] = true;
+	replay->cursor = i + 1;
+	return &replay->records[i];
+}
+
+static int mc_replay_send_command(struct fsl_mc_io *mc_io,
+				  struct mc_command *cmd)
+{
+	struct mc_replay *replay = mc_io->priv;
+	struct mc_trace_record *record;
+
+	record = find_record(replay, cmd);
+	if (record == NULL) {
+		DEBUG_PRINTF("no recorded response for MC command %#llx\n",
+			     (unsigned long long)cmd->header);
+		return -EIO;
+	}
+
+	if (replay->latency) {
+		struct timespec delay = {
+			.tv_sec = record->latency_ns / 1000000000,
+			.tv_nsec = record->latency_ns % 1000000000,
+		};
+
+		(void)nanosleep(&delay, NULL);
+	}
+
+	*cmd = record->response;
+	return record->error;
+}
+
+static int mc_replay_get_root_dprc_id(struct fsl_mc_io *mc_io,
+				      uint32_t *root_dprc_id)
+{
+	struct mc_replay *replay = mc_io->priv;
+
+	for (size_t i = 0; i < replay->num_records; i++) {
+		if (replay->records[i].type == MC_TRACE_ROOT_DPRC_ID) {
+			*root_dprc_id =
+				(uint32_t)replay->records[i].response.params[0];
+			return 0;
+		}
+	}
+
+	return -EOPNOTSUPP;
+}
+
+const struct mc_io_ops mc_replay_ops = {
+	.name = "replay",
+	.init = mc_replay_init,
+	.cleanup = mc_replay_cleanup,
+	.send = mc_replay_send_command,
+	.get_root_dprc_id = mc_replay_get_root_dprc_id,
+};
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _MC_TRACE_H
+#define _MC_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fsl_mc_sys.h"
+#include "fsl_mc_cmd.h"
+
+/**
+ * MC command trace file layout, in host byte order:
+ * one struct mc_trace_file_header followed by struct mc_trace_record
+ * entries, one per MC command, in completion order.
+ */
+#define MC_TRACE_MAGIC		"RSTLTRCE"
+#define MC_TRACE_VERSION	1
+
+struct mc_trace_file_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+};
+
+enum mc_trace_record_type {
+	/**
+	 * MC command: 'request' as sent, 'response' as written back by the MC
+	 */
+	MC_TRACE_COMMAND = 0,
+
+	/**
+	 * root DPRC id given by the transport, in response.params[0]
+	 */
+	MC_TRACE_ROOT_DPRC_ID = 1,
+};
+
+struct mc_trace_record {
+	/**
+	 * CLOCK_MONOTONIC time the command was sent at, in ns
+	 */
+	uint64_t timestamp_ns;
+	uint64_t latency_ns;
+	uint32_t type;
+
+	/**
+	 * value returned to the flib caller: 0 or a negative error code
+	 */
+	int32_t error;
+	struct mc_command request;
+	struct mc_command response;
+};
+
+int mc_trace_open(const char *path);
+
+void mc_trace_close(void);
+
+bool mc_trace_recording(void);
+
+void mc_trace_record(const struct mc_trace_record *record);
+
+extern const struct mc_io_ops mc_replay_ops;
+
+#endif /* _MC_TRACE_H */
@@ -29,49 +29,21 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
 #include <string.h>
 #include <stdint.h>
 #include <errno.h>
 #include <assert.h>
 #include <getopt.h>
+#include <unistd.h>
 #include <sys/ioctl.h>
 #include "restool.h"
+#include "dprc_walk.h"
+#include "cmd_lock.h"
+#include "mc_trace.h"
 #include "utils.h"
 
-static const char restool_version[] = "1.2";
-
-static struct option global_options[] = {
-	[GLOBAL_OPT_HELP] = {
-		.name = "help",
-		.val = 'h',
-	},
-
-	[GLOBAL_OPT_VERSION] = {
-		.name = "version",
-		.val = 'v',
-	},
-
-	[GLOBAL_OPT_MC_VERSION] = {
-		.name = "mc-version",
-		.val = 'm',
-	},
-
-	[GLOBAL_OPT_DEBUG] = {
-		.name = "debug",
-		.val = 'd',
-	},
-
-	[GLOBAL_OPT_SCRIPT] = {
-		.name = "script",
-		.val = 's',
-	},
-
-
-	{ 0 },
-};
-
-C_ASSERT(ARRAY_SIZE(global_options) <= MAX_NUM_CMD_LINE_OPTIONS + 1);
-
 static const struct object_cmd_parser object_cmd_parsers[] = {
 	{ .obj_type = "dprc", .obj_commands = dprc_commands },
 	{ .obj_type = "dpni", .obj_commands = dpni_commands },
@@ -86,10 +58,96 @@ static const struct object_cmd_parser object_cmd_parsers[] = {
 	{ .obj_type = "dpmac", .obj_commands = dpmac_commands },
 	{ .obj_type = "dpdcei", .obj_commands = dpdcei_commands },
 	{ .obj_type = "dpaiop", .obj_commands = dpaiop_commands },
+	{ .obj_type = "topology", .obj_commands = topology_commands },
+
+};
 
+static void restool_default_output(void *arg,
+				   enum restool_output_stream stream,
+				   const char *text, size_t len)
+{
+	(void)arg;
+	fwrite(text, 1, len, stream == RESTOOL_OUTPUT_RESULT ? stdout : stderr);
+}
+
+static struct restool_ctx restool_default_ctx = {
+	.output = restool_default_output,
+	.topology_lock = PTHREAD_MUTEX_INITIALIZER,
 };
 
-struct restool restool;
+__thread struct restool_ctx *restool_current = &restool_default_ctx;
+
+__thread struct restool_cmd restool_cmd;
+
+/**
+ * Make 'ctx' the context of the calling thread, returning the previous one
+ */
+struct restool_ctx *restool_ctx_switch(struct restool_ctx *ctx)
+{
+	struct restool_ctx *prev_ctx = restool_current;
+
+	restool_current = ctx;
+	return prev_ctx;
+}
+
+static int restool_vprintf(enum restool_output_stream stream,
+			   const char *fmt, va_list args)
+{
+	char buf[512];
+	char *text = buf;
+	va_list args_copy;
+	int len;
+
+	va_copy(args_copy, args);
+	len = vsnprintf(buf, sizeof(buf), fmt, args);
+	if (len >= (int)sizeof(buf)) {
+		text = malloc(len + 1);
+		if (text != NULL)
+			(void)vsnprintf(text, len + 1, fmt, args_copy);
+		else
+			len = -ENOMEM;
+	}
+
+	va_end(args_copy);
+	if (len > 0 && restool_cmd.output != NULL)
+		restool_cmd.output(restool_cmd.output_arg, stream, text, len);
+	else if (len > 0)
+		restool.output(restool.output_arg, stream, text, len);
+
+	if (text != buf)
+		free(text);
+
+	return len;
+}
+
+/**
+ * Output a result of the command being run, through the output function
+ * of the current context
+ */
+int restool_printf(const char *fmt, ...)
+{
+	va_list args;
+	int len;
+
+	va_start(args, fmt);
+	len = restool_vprintf(RESTOOL_OUTPUT_RESULT, fmt, args);
+	va_end(args);
+	return len;
+}
+
+/**
+ * Output an error or debug message of the command being run
+ */
+int restool_eprintf(const char *fmt, ...)
+{
+	va_list args;
+	int len;
+
+	va_start(args, fmt);
+	len = restool_vprintf(RESTOOL_OUTPUT_ERROR, fmt, args);
+	va_end(args);
+	return len;
+}
 
 enum mc_cmd_status flib_error_to_mc_status(int error)
 {
@@ -148,26 +206,95 @@ const char *mc_status_to_string(enum mc_cmd_status status)
 	return status_strings[status];
 }
 
-int find_target_obj_desc(uint32_t dprc_id, uint16_t dprc_handle,
-			int nesting_level,
-			uint32_t target_id, char *target_type,
-			struct dprc_obj_desc *target_obj_desc,
-			uint32_t *target_parent_dprc_id, bool *found)
-{
-	int num_child_devices;
-	int error = 0;
-	enum mc_cmd_status mc_status;
+struct obj_descs_job {
+	uint32_t dprc_id;
+	int first;
+	int num_objs;
+	int slice_size;
+	struct dprc_obj_desc *obj_descs;
+};
 
-	assert(nesting_level <= MAX_DPRC_NESTING);
+/**
+ * mc_pool work function: fetch one slice of a container's object
+ * descriptors, through the worker's own MC portal
+ */
+static int get_obj_descs_slice(struct fsl_mc_io *mc_io, int item, void *arg)
+{
+	struct obj_descs_job *job = arg;
+	int first = item * job->slice_size;
+	int n = job->num_objs - first;
+	uint16_t dprc_handle;
+	int error;
+	int error2;
 
-	if (strcmp(target_type, "dprc") == 0 &&
-	    target_id == restool.root_dprc_id) {
-		DEBUG_PRINTF("This is root dprc.\n");
-		strcpy(target_obj_desc->type, "dprc");
-		target_obj_desc->id = 1;
+	if (n <= 0)
 		return 0;
+
+	if (n > job->slice_size)
+		n = job->slice_size;
+
+	error = dprc_open(mc_io, 0, job->dprc_id, &dprc_handle);
+	if (error < 0)
+		return error;
+
+	error = dprc_get_objs(mc_io, 0, dprc_handle, job->first + first, n,
+			      &job->obj_descs[first]);
+	error2 = dprc_close(mc_io, 0, dprc_handle);
+	if (error == 0)
+		error = error2;
+
+	return error;
+}
+
+/**
+ * Fetch the descriptors of objects [first, first + num_objs) of the
+ * container 'dprc_id' referred by 'dprc_handle' into 'obj_descs'. Large
+ * ranges are fetched in parallel when an MC portal pool is available.
+ */
+int get_dprc_obj_desc_range(uint32_t dprc_id, uint16_t dprc_handle,
+			    int first, int num_objs,
+			    struct dprc_obj_desc *obj_descs)
+{
+	int error;
+
+	if (restool.mc_pool.num_portals > 0 &&
+	    num_objs > DPRC_GET_OBJS_BATCH_SIZE) {
+		int errors[MC_POOL_MAX_PORTALS];
+		struct obj_descs_job job = {
+			.dprc_id = dprc_id,
+			.first = first,
+			.num_objs = num_objs,
+			.obj_descs = obj_descs,
+		};
+
+		job.slice_size = (num_objs + restool.mc_pool.num_portals - 1) /
+				 restool.mc_pool.num_portals;
+		error = mc_pool_run(&restool.mc_pool, get_obj_descs_slice,
+				    restool.mc_pool.num_portals, &job, errors);
+	} else {
+		error = dprc_get_objs(&restool.mc_io, 0, dprc_handle, first,
+				      num_objs, obj_descs);
 	}
 
+	if (error < 0)
+		DEBUG_PRINTF("dprc_get_objs() failed with error %d\n", error);
+
+	return error;
+}
+
+/**
+ * Fetch the descriptors of all objects in the container 'dprc_id' referred
+ * by 'dprc_handle'. On success, *obj_descs points to a malloc'ed array of
+ * *num_objs entries that the caller must free().
+ */
+int get_dprc_obj_descs(uint32_t dprc_id, uint16_t dprc_handle,
+			struct dprc_obj_desc **obj_descs, int *num_objs)
+{
+	struct dprc_obj_desc *descs = NULL;
+	int num_child_devices;
+	enum mc_cmd_status mc_status;
+	int error;
+
 	error = dprc_get_obj_count(&restool.mc_io, 0,
 				   dprc_handle,
 				   &num_child_devices);
@@ -178,75 +305,571 @@ int find_target_obj_desc(uint32_t dprc_id, uint16_t dprc_handle,
 		goto out;
 	}
 
-	for (int i = 0; i < num_child_devices; i++) {
-		struct dprc_obj_desc obj_desc;
-		uint16_t child_dprc_handle;
-		int error2;
+	if (num_child_devices > 0) {
+		descs = calloc(num_child_devices, sizeof(*descs));
+		if (descs == NULL) {
+			ERROR_PRINTF("calloc() failed\n");
+			error = -ENOMEM;
+			goto out;
+		}
 
-		error = dprc_get_obj(
-				&restool.mc_io, 0,
-				dprc_handle,
-				i,
-				&obj_desc);
+		error = get_dprc_obj_desc_range(dprc_id, dprc_handle, 0,
+						num_child_devices, descs);
 		if (error < 0) {
-			DEBUG_PRINTF(
-				"dprc_get_object(%u) failed with error %d\n",
-				i, error);
+			free(descs);
+			descs = NULL;
 			goto out;
 		}
+	}
+
+	*obj_descs = descs;
+	*num_objs = num_child_devices;
+out:
+	return error;
+}
+
+/**
+ * Path of the file shared with other restool processes that environment
+ * variable 'env' overrides, or NULL if it is not used. Such files are only
+ * used by default, at 'default_path', with the transports that reach a
+ * real MC.
+ */
+static const char *get_shared_file_path(const char *env,
+					const char *default_path)
+{
+	const char *path = getenv(env);
+	const char *transport;
+
+	/*
+	 * No MC portal, e.g. for --help
+	 */
+	if (restool.mc_io.ops == NULL)
+		return NULL;
+
+	transport = restool.mc_io.ops->name;
+	if (path != NULL) {
+		if (path[0] == '\0' || strcmp(path, "off") == 0)
+			return NULL;
+
+		return path;
+	}
+
+	if (strcmp(transport, "ioctl") != 0 && strcmp(transport, "portal") != 0)
+		return NULL;
+
+	return default_path;
+}
+
+/**
+ * Path of the topology cache file, or NULL if it is not used. The cache is
+ * not used while recording a trace: lookups it serves would be missing
+ * from the trace, for its replay to fail.
+ */
+static const char *get_topology_cache_path(void)
+{
+	if (mc_trace_recording())
+		return NULL;
+
+	return get_shared_file_path(RESTOOL_TOPOLOGY_CACHE_ENV,
+				    RESTOOL_TOPOLOGY_CACHE_PATH);
+}
+
+/**
+ * Drop the cached tokens of the objects of snapshot 'prev' that are gone
+ * from snapshot 'topo': the MC released them along with the objects
+ */
+static void forget_gone_objects(const struct topology *prev,
+				const struct topology *topo)
+{
+	for (int i = 0; i < prev->num_objs; i++) {
+		const struct dprc_obj_desc *desc = &prev->objs[i].desc;
+
+		if (topology_lookup(topo, desc->type, desc->id) < 0)
+			mc_handle_forget(&restool.handles, desc->type,
+					 desc->id);
+	}
+}
+
+/**
+ * Take the snapshot of the container tree. The previous snapshot of this
+ * process, or else the one saved in the topology cache file, is reused as
+ * long as every container still holds as many objects as it records;
+ * otherwise the tree is walked again and the new snapshot replaces it in
+ * the cache file.
+ */
+static int build_topology(struct topology *topo)
+{
+	const char *cache_path = get_topology_cache_path();
+	const char *cached_from = cache_path;
+	struct topology cached;
+	bool have_cached = false;
+	int error;
+
+	if (restool.topology_prev_valid) {
+		restool.topology_prev_valid = false;
+
+		/*
+		 * Another restool process changed the MC objects if it
+		 * removed the cache file
+		 */
+		if (cache_path == NULL || access(cache_path, F_OK) == 0) {
+			cached = restool.topology_prev;
+			cached_from = "previous snapshot";
+			have_cached = true;
+		} else {
+			topology_free(&restool.topology_prev);
+		}
+	}
+
+	if (!have_cached)
+		have_cached = cache_path != NULL &&
+			      topology_load(&cached, cache_path,
+					    restool.root_dprc_id) == 0;
+
+	if (have_cached) {
+		error = topology_check(&cached, restool.root_dprc_handle);
+		if (error == 0) {
+			DEBUG_PRINTF("using topology cache %s\n", cached_from);
+			*topo = cached;
+			topo->reused = true;
+			return 0;
+		}
+
+		DEBUG_PRINTF("topology cache %s is stale (error %d)\n",
+			     cached_from, error);
+	}
+
+	error = topology_build(topo, restool.root_dprc_id,
+			       restool.root_dprc_handle,
+			       have_cached ? &cached : NULL);
+	if (error < 0)
+		goto out;
+
+	if (have_cached)
+		forget_gone_objects(&cached, topo);
+
+	if (cache_path != NULL) {
+		error = topology_save(topo, cache_path, restool.root_dprc_id);
+		if (error < 0)
+			DEBUG_PRINTF("saving topology cache %s failed (error %d)\n",
+				     cache_path, error);
+
+		error = 0;
+	}
+out:
+	if (have_cached)
+		topology_free(&cached);
+
+	return error;
+}
+
+/**
+ * Drop a reference to a snapshot, with topology_lock held
+ */
+static void put_snapshot(struct topology_snapshot *snapshot)
+{
+	assert(snapshot->refcount > 0);
+	if (--snapshot->refcount != 0)
+		return;
+
+	topology_free(&snapshot->topo);
+	free(snapshot);
+}
+
+/**
+ * Get the snapshot of the container tree, taking it if there is no valid
+ * one. The snapshot stays valid until the command of the calling thread
+ * completes, even if another thread drops it meanwhile.
+ */
+int get_topology(const struct topology **topo)
+{
+	struct topology_snapshot *snapshot;
+	int error;
+
+	pthread_mutex_lock(&restool.topology_lock);
+	snapshot = restool.topology;
+	if (snapshot == NULL) {
+		snapshot = malloc(sizeof(*snapshot));
+		if (snapshot == NULL) {
+			ERROR_PRINTF("malloc() failed\n");
+			error = -ENOMEM;
+			goto out;
+		}
+
+		error = build_topology(&snapshot->topo);
+		if (error < 0) {
+			free(snapshot);
+			goto out;
+		}
+
+		snapshot->refcount = 1;
+		restool.topology = snapshot;
+	}
+
+	if (restool_cmd.topology != snapshot) {
+		if (restool_cmd.topology != NULL)
+			put_snapshot(restool_cmd.topology);
+
+		snapshot->refcount++;
+		restool_cmd.topology = snapshot;
+	}
+
+	*topo = &snapshot->topo;
+	error = 0;
+out:
+	pthread_mutex_unlock(&restool.topology_lock);
+	return error;
+}
+
+/**
+ * Release the snapshot the command of the calling thread got from
+ * get_topology(), once the command is done with it
+ */
+void put_topology(void)
+{
+	if (restool_cmd.topology == NULL)
+		return;
+
+	pthread_mutex_lock(&restool.topology_lock);
+	put_snapshot(restool_cmd.topology);
+	restool_cmd.topology = NULL;
+	pthread_mutex_unlock(&restool.topology_lock);
+}
+
+/**
+ * Drop the snapshot of the container tree after a command that may have
+ * changed it, along with the topology cache file
+ */
+void invalidate_topology(void)
+{
+	const char *cache_path;
+
+	pthread_mutex_lock(&restool.topology_lock);
+	if (restool.topology != NULL) {
+		put_snapshot(restool.topology);
+		restool.topology = NULL;
+	}
+
+	if (restool.topology_prev_valid) {
+		topology_free(&restool.topology_prev);
+		restool.topology_prev_valid = false;
+	}
+
+	cache_path = get_topology_cache_path();
+	if (cache_path != NULL)
+		(void)unlink(cache_path);
+
+	pthread_mutex_unlock(&restool.topology_lock);
+}
+
+/**
+ * Keep the snapshot of the container tree only as the base of the next
+ * one, for a long-lived process to check it against the MC before serving
+ * the next command from it. A snapshot still in use by a command is
+ * dropped instead.
+ */
+void age_topology(void)
+{
+	struct topology_snapshot *snapshot;
+
+	pthread_mutex_lock(&restool.topology_lock);
+	snapshot = restool.topology;
+	if (snapshot == NULL)
+		goto out;
+
+	restool.topology = NULL;
+	if (snapshot->refcount != 1) {
+		put_snapshot(snapshot);
+		goto out;
+	}
+
+	if (restool.topology_prev_valid)
+		topology_free(&restool.topology_prev);
+
+	restool.topology_prev = snapshot->topo;
+	restool.topology_prev_valid = true;
+	free(snapshot);
+out:
+	pthread_mutex_unlock(&restool.topology_lock);
+}
+
+/**
+ * Tell if the context holds a snapshot of the container tree
+ */
+bool has_topology(void)
+{
+	bool taken;
+
+	pthread_mutex_lock(&restool.topology_lock);
+	taken = restool.topology != NULL;
+	pthread_mutex_unlock(&restool.topology_lock);
+	return taken;
+}
+
+/**
+ * Tell if container tree walks can be served by the topology snapshot, i.e.
+ * if there is a valid one or one can be taken on top of a previous one or
+ * of the topology cache file
+ */
+bool topology_available(void)
+{
+	bool available;
+
+	pthread_mutex_lock(&restool.topology_lock);
+	available = restool.topology != NULL || restool.topology_prev_valid;
+	pthread_mutex_unlock(&restool.topology_lock);
+	return available || get_topology_cache_path() != NULL;
+}
+
+/**
+ * Get the descriptor of object 'obj_type'.'obj_id' with a single
+ * dprc_get_obj_desc() query on container 'dprc_id'. Returns false if the
+ * object is not in this container or if the query failed for any reason,
+ * for the caller to fall back to scanning containers.
+ */
+bool get_obj_desc_in_dprc(uint32_t dprc_id, const char *obj_type,
+			  uint32_t obj_id, struct dprc_obj_desc *obj_desc)
+{
+	char type[sizeof(obj_desc->type)];
+	uint16_t dprc_handle;
+	bool dprc_opened = false;
+	int error;
+
+	if (restool.obj_desc_query_unsupported ||
+	    strlen(obj_type) >= sizeof(type))
+		return false;
+
+	strcpy(type, obj_type);
+	if (dprc_id == restool.root_dprc_id) {
+		dprc_handle = restool.root_dprc_handle;
+	} else {
+		/*
+		 * The container may be gone: no error message
+		 */
+		error = mc_handle_open(&restool.handles, "dprc", dprc_id,
+				       dprc_open, dprc_close, &dprc_handle);
+		if (error < 0)
+			return false;
+
+		dprc_opened = true;
+	}
+
+	error = dprc_get_obj_desc(&restool.mc_io, 0, dprc_handle, type,
+				  obj_id, obj_desc);
+	if (dprc_opened)
+		(void)close_dprc(dprc_handle);
+
+	if (error < 0) {
+		DEBUG_PRINTF("dprc_get_obj_desc(%s.%u) in dprc.%u failed with error %d\n",
+			     obj_type, obj_id, dprc_id, error);
+		if (flib_error_to_mc_status(error) ==
+		    MC_CMD_STATUS_UNSUPPORTED_OP)
+			restool.obj_desc_query_unsupported = true;
+
+		return false;
+	}
+
+	return (uint32_t)obj_desc->id == obj_id &&
+	       strcmp(obj_desc->type, obj_type) == 0;
+}
+
+static bool get_parent_in(const struct topology *topo, const char *obj_type,
+			  uint32_t obj_id, uint32_t dprc_id,
+			  uint32_t *parent_dprc_id)
+{
+	int idx = topology_lookup(topo, obj_type, obj_id);
+
+	for (int i = idx; i > 0; i = topo->objs[i].parent) {
+		if ((uint32_t)topo->objs[topo->objs[i].parent].desc.id ==
+		    dprc_id) {
+			*parent_dprc_id =
+				topo->objs[topo->objs[idx].parent].desc.id;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Get the container of object 'obj_type'.'obj_id' recorded in the previous
+ * snapshot of this process or in the topology cache file, if any, provided
+ * it is in the container tree under 'dprc_id'. This costs no MC command,
+ * but the object may have moved since.
+ */
+static bool get_cached_parent(const char *obj_type, uint32_t obj_id,
+			      uint32_t dprc_id, uint32_t *parent_dprc_id)
+{
+	const char *cache_path = get_topology_cache_path();
+	struct topology cached;
+	bool found;
+
+	pthread_mutex_lock(&restool.topology_lock);
+	if (restool.topology_prev_valid) {
+		found = get_parent_in(&restool.topology_prev, obj_type, obj_id,
+				      dprc_id, parent_dprc_id);
+		pthread_mutex_unlock(&restool.topology_lock);
+		return found;
+	}
+
+	pthread_mutex_unlock(&restool.topology_lock);
+
+	if (cache_path == NULL ||
+	    topology_load(&cached, cache_path, restool.root_dprc_id) < 0)
+		return false;
+
+	found = get_parent_in(&cached, obj_type, obj_id, dprc_id,
+			      parent_dprc_id);
+	topology_free(&cached);
+	return found;
+}
+
+struct find_obj_ctx {
+	uint32_t target_id;
+	struct dprc_obj_desc *target_obj_desc;
+	uint32_t *target_parent_dprc_id;
+};
+
+static int find_obj_visit(const struct dprc_obj_desc *obj,
+			  const struct dprc_obj_desc *parent, int depth,
+			  void *arg)
+{
+	struct find_obj_ctx *ctx = arg;
+
+	(void)depth;
+	if ((uint32_t)obj->id != ctx->target_id)
+		return DPRC_WALK_CONTINUE;
+
+	*ctx->target_obj_desc = *obj;
+	*ctx->target_parent_dprc_id = parent->id;
+	return DPRC_WALK_STOP;
+}
+
+/**
+ * Find object 'target_type'.'target_id' in the container tree under
+ * 'dprc_id': with direct descriptor queries if possible, else using the
+ * topology snapshot if available or else walking the tree until the
+ * object is found
+ */
+int find_target_obj_desc(uint32_t dprc_id, uint16_t dprc_handle,
+			int nesting_level,
+			uint32_t target_id, char *target_type,
+			struct dprc_obj_desc *target_obj_desc,
+			uint32_t *target_parent_dprc_id, bool *found)
+{
+	const struct topology *topo;
+	int error;
+	int idx;
+
+	(void)dprc_handle;
+	assert(nesting_level <= MAX_DPRC_NESTING);
+
+	if (strcmp(target_type, "dprc") == 0 &&
+	    target_id == restool.root_dprc_id) {
+		DEBUG_PRINTF("This is root dprc.\n");
+		strcpy(target_obj_desc->type, "dprc");
+		target_obj_desc->id = 1;
+		return 0;
+	}
+
+	/*
+	 * Unless the snapshot is at hand, ask the MC directly: first the
+	 * container the search starts at, then the container the object was
+	 * in when the topology cache was saved
+	 */
+	if (!has_topology()) {
+		uint32_t parent_dprc_id = dprc_id;
+
+		if (get_obj_desc_in_dprc(dprc_id, target_type, target_id,
+					 target_obj_desc) ||
+		    (get_cached_parent(target_type, target_id, dprc_id,
+				       &parent_dprc_id) &&
+		     get_obj_desc_in_dprc(parent_dprc_id, target_type,
+					  target_id, target_obj_desc))) {
+			*target_parent_dprc_id = parent_dprc_id;
+			DEBUG_PRINTF("target_parent_dprc_id: dprc.%d\n",
+				     *target_parent_dprc_id);
+			DEBUG_PRINTF("object found\n");
+			*found = true;
+			return 0;
+		}
+	}
 
-		DEBUG_PRINTF("it is %s.%u\n", obj_desc.type, obj_desc.id);
+	if (!topology_available()) {
+		struct find_obj_ctx ctx = {
+			.target_id = target_id,
+			.target_obj_desc = target_obj_desc,
+			.target_parent_dprc_id = target_parent_dprc_id,
+		};
+		struct dprc_visitor visitor = {
+			.object = find_obj_visit,
+			.type_filter = target_type,
+			.arg = &ctx,
+		};
+
+		error = dprc_walk(dprc_id, &visitor);
+		if (error < 0)
+			return error;
 
-		if (strcmp(obj_desc.type, target_type) == 0 &&
-		    target_id == (uint32_t)obj_desc.id) {
-			*target_obj_desc = obj_desc;
-			*target_parent_dprc_id = dprc_id;
+		if (error == DPRC_WALK_STOP) {
 			DEBUG_PRINTF("target_parent_dprc_id: dprc.%d\n",
-					dprc_id);
+				     *target_parent_dprc_id);
 			DEBUG_PRINTF("object found\n");
 			*found = true;
-			goto out;
-		} else if (strcmp(obj_desc.type, "dprc") == 0) {
-			bool found2 = false;
-
-			error = open_dprc(obj_desc.id, &child_dprc_handle);
-			if (error < 0)
-				goto out;
-
-			DEBUG_PRINTF("entering %s.%u\n", obj_desc.type,
-					obj_desc.id);
-			error = find_target_obj_desc(obj_desc.id,
-					child_dprc_handle,
-					nesting_level + 1,
-					target_id,
-					target_type,
-					target_obj_desc,
-					target_parent_dprc_id,
-					&found2);
-
-			error2 = dprc_close(&restool.mc_io, 0,
-						child_dprc_handle);
-			if (error2 < 0) {
-				mc_status = flib_error_to_mc_status(error2);
-				ERROR_PRINTF("MC error: %s (status %#x)\n",
-				mc_status_to_string(mc_status), mc_status);
-				if (error == 0)
-					error = error2;
+		}
 
-				goto out;
+		return 0;
+	}
+
+	/*
+	 * A reused snapshot may miss objects replaced since, and records
+	 * descriptors that may be out of date: objects found in it are
+	 * queried again, and the snapshot is taken again if one is missing
+	 */
+	for (int attempt = 0; attempt < 2; attempt++) {
+		bool reused;
+
+		error = get_topology(&topo);
+		if (error < 0)
+			return error;
+
+		reused = topo->reused;
+		idx = topology_lookup(topo, target_type, target_id);
+		for (int i = idx; i > 0; i = topo->objs[i].parent) {
+			const struct topology_obj *obj = &topo->objs[idx];
+			int parent = topo->objs[i].parent;
+
+			if ((uint32_t)topo->objs[parent].desc.id != dprc_id)
+				continue;
+
+			*target_parent_dprc_id =
+				topo->objs[obj->parent].desc.id;
+			if (reused) {
+				if (!get_obj_desc_in_dprc(
+						*target_parent_dprc_id,
+						target_type, target_id,
+						target_obj_desc))
+					break;
+			} else {
+				*target_obj_desc = obj->desc;
 			}
 
-			DEBUG_PRINTF("exiting %s.%u\n", obj_desc.type,
-					obj_desc.id);
-			if (found2)
-				goto out;
-		} else {
-			continue;
+			DEBUG_PRINTF("target_parent_dprc_id: dprc.%d\n",
+				     *target_parent_dprc_id);
+			DEBUG_PRINTF("object found\n");
+			*found = true;
+			return 0;
 		}
+
+		if (!reused)
+			break;
+
+		DEBUG_PRINTF("topology cache stale for %s.%u\n", target_type,
+			     target_id);
+		invalidate_topology();
 	}
 
-out:
-	return error;
+	return 0;
 }
 
 bool find_obj(char *obj_type, uint32_t obj_id)
@@ -263,7 +886,7 @@ bool find_obj(char *obj_type, uint32_t obj_id)
 				&target_parent_dprc_id, &found);
 
 	if (!found && error < 0) {
-		printf("%s.%u does not exist\n", obj_type, obj_id);
+		restool_printf("%s.%u does not exist\n", obj_type, obj_id);
 		return false;
 	}
 
@@ -276,33 +899,32 @@ void print_obj_label(struct dprc_obj_desc *target_obj_desc)
 	if (!(target_obj_desc->id == (int)restool.root_dprc_id &&
 	    strcmp(target_obj_desc->type, "dprc") == 0) &&
 	    strlen(target_obj_desc->label) > 0)
-		printf("object label: %s\n", target_obj_desc->label);
+		restool_printf("object label: %s\n", target_obj_desc->label);
 }
 
-int print_obj_verbose(struct dprc_obj_desc *target_obj_desc,
-			const struct flib_ops *ops)
+static int print_obj_irqs(const struct obj_info *info,
+			  const struct flib_ops *ops)
 {
-	uint16_t obj_handle;
 	uint32_t irq_mask;
 	uint32_t irq_status;
 	enum mc_cmd_status mc_status;
 	int error = 0;
 
-	if (strcmp(target_obj_desc->type, "dprc") == 0 &&
-	    target_obj_desc->id == (int)restool.root_dprc_id) {
-		printf("number of mappable regions: 1\n");
-		printf("number of interrupts: 1\n");
-		error = dprc_get_irq_mask(&restool.mc_io, 0,
-				restool.root_dprc_handle, 0, &irq_mask);
+	if (strcmp(info->desc.type, "dprc") == 0 &&
+	    info->desc.id == (int)restool.root_dprc_id) {
+		restool_printf("number of mappable regions: 1\n");
+		restool_printf("number of interrupts: 1\n");
+		error = dprc_get_irq_mask(&restool.mc_io, 0, info->handle, 0,
+					  &irq_mask);
 		if (error < 0) {
 			mc_status = flib_error_to_mc_status(error);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
 				mc_status_to_string(mc_status), mc_status);
 		return error;
 		}
-		printf("interrupt[0] mask: %#x\n", irq_mask);
-		error = dprc_get_irq_status(&restool.mc_io, 0,
-				restool.root_dprc_handle, 0, &irq_status);
+		restool_printf("interrupt[0] mask: %#x\n", irq_mask);
+		error = dprc_get_irq_status(&restool.mc_io, 0, info->handle, 0,
+					    &irq_status);
 		if (error < 0) {
 			mc_status = flib_error_to_mc_status(error);
 			ERROR_PRINTF("MC error: %s (status %#x)\n",
@@ -310,37 +932,94 @@ int print_obj_verbose(struct dprc_obj_desc *target_obj_desc,
 		return error;
 		}
 
-		printf("interrupt[0] status: %#x\n", irq_status);
+		restool_printf("interrupt[0] status: %#x\n", irq_status);
 		return 0;
 	}
 
-	printf("number of mappable regions: %u\n",
-		target_obj_desc->region_count);
-	printf("number of interrupts: %u\n", target_obj_desc->irq_count);
+	restool_printf("number of mappable regions: %u\n", info->desc.region_count);
+	restool_printf("number of interrupts: %u\n", info->desc.irq_count);
 
-	error = ops->obj_open(&restool.mc_io, 0, target_obj_desc->id,
-				&obj_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			mc_status_to_string(mc_status), mc_status);
+	for (int j = 0; j < info->desc.irq_count; j++) {
+		ops->obj_get_irq_mask(&restool.mc_io, 0, info->handle, j,
+					&irq_mask);
+		restool_printf("interrupt[%d] mask: %#x\n", j, irq_mask);
+		ops->obj_get_irq_status(&restool.mc_io, 0, info->handle, j,
+					&irq_status);
+		restool_printf("interrupt[%d] status: %#x\n", j, irq_status);
+	}
+
+	return 0;
+}
+
+/**
+ * Common part of the info commands: resolve object 'obj_type'.'obj_id',
+ * open it once and hand it to 'print_attr' to query and print its
+ * attributes, followed by its interrupts if 'verbose', then close it.
+ */
+int print_obj_info(const char *obj_type, uint32_t obj_id,
+		   const struct flib_ops *ops, obj_info_print_t *print_attr,
+		   bool verbose)
+{
+	struct obj_info info;
+	enum mc_cmd_status mc_status;
+	bool found = false;
+	bool obj_opened = false;
+	char type[sizeof(info.desc.type)];
+	int error;
+	int error2;
+
+	memset(&info, 0, sizeof(info));
+	strncpy(type, obj_type, sizeof(type) - 1);
+	type[sizeof(type) - 1] = '\0';
+	error = find_target_obj_desc(restool.root_dprc_id,
+				restool.root_dprc_handle, 0, obj_id,
+				type, &info.desc,
+				&info.parent_dprc_id, &found);
+	if (error < 0)
 		return error;
+
+	if (strcmp(info.desc.type, obj_type)) {
+		restool_printf("%s.%d does not exist\n", obj_type, obj_id);
+		return -EINVAL;
 	}
 
-	for (int j = 0; j < target_obj_desc->irq_count; j++) {
-		ops->obj_get_irq_mask(&restool.mc_io, 0, obj_handle, j,
-					&irq_mask);
-		printf("interrupt[%d] mask: %#x\n", j, irq_mask);
-		ops->obj_get_irq_status(&restool.mc_io, 0, obj_handle, j,
-					&irq_status);
-		printf("interrupt[%d] status: %#x\n", j, irq_status);
+	if (strcmp(obj_type, "dprc") == 0 && obj_id == restool.root_dprc_id) {
+		info.handle = restool.root_dprc_handle;
+	} else {
+		error = open_obj(obj_type, obj_id, ops, &info.handle);
+		if (error < 0) {
+			mc_status = flib_error_to_mc_status(error);
+			ERROR_PRINTF("MC error: %s (status %#x)\n",
+				     mc_status_to_string(mc_status), mc_status);
+			return error;
+		}
+
+		obj_opened = true;
+		if (info.handle == 0) {
+			DEBUG_PRINTF(
+				"%s_open() returned invalid handle (auth 0) for %s.%u\n",
+				obj_type, obj_type, obj_id);
+			error = -ENOENT;
+			goto out;
+		}
 	}
 
-	error = ops->obj_close(&restool.mc_io, 0, obj_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			mc_status_to_string(mc_status), mc_status);
+	error = print_attr(&info);
+	if (error < 0)
+		goto out;
+
+	if (verbose)
+		error = print_obj_irqs(&info, ops);
+out:
+	if (obj_opened) {
+		error2 = close_obj(ops, info.handle);
+		if (error2 < 0) {
+			mc_status = flib_error_to_mc_status(error2);
+			ERROR_PRINTF("MC error: %s (status %#x)\n",
+				     mc_status_to_string(mc_status), mc_status);
+			if (error == 0)
+				error = error2;
+		}
 	}
 
 	return error;
@@ -408,17 +1087,17 @@ bool in_use(const char *obj, const char *situation)
 
 void print_new_obj(char *type, int id, const char *parent)
 {
-	if (restool.script) {
-		printf("%s.%d\n", type, id);
+	if (restool_cmd.script) {
+		restool_printf("%s.%d\n", type, id);
 		return;
 	}
 
 	if (parent == NULL) { /* by default, parent == dprc.1 */
-		printf("%s.%d is created under dprc.1\n", type, id);
+		restool_printf("%s.%d is created under dprc.1\n", type, id);
 		return;
 	}
 
-	printf("%s.%d is created under %s\n", type, id, parent);
+	restool_printf("%s.%d is created under %s\n", type, id, parent);
 }
 
 void print_unexpected_options_error(uint32_t option_mask,
@@ -427,251 +1106,556 @@ void print_unexpected_options_error(uint32_t option_mask,
 	ERROR_PRINTF("Invalid options:\n");
 	for (unsigned int i = 0; i < MAX_NUM_CMD_LINE_OPTIONS; i++) {
 		if (option_mask & ONE_BIT_MASK(i))
-			fprintf(stderr, "\t--%s\n", options[i].name);
-
-	}
-}
-
-static void print_usage(void)
-{
-	static const char usage_msg[] =
-		"\n"
-		"There are 3 levels of help, from up to bottom:\n"
-		"global: restool --help\n"
-		"object: restool dp* help\n"
-		"	tells you all the commands this object support\n"
-		"	e.g. restool dprc help\n"
-		"object-command: restool dp* <command> --help\n"
-		"	tells you how to use this <command>\n"
-		"	e.g. restool dprc create --help\n"
-		"\n"
-		"Usage: restool [<global-options>] <object-type> <command> <object-name> [ARGS...]\n"
-		"\n"
-		"Valid <global-options> are:\n"
-		"   -v,--version   Displays tool version info\n"
-		"   -m,--mc-version Displays mc firmware version.\n"
-		"   -h,-?,--help   Displays general help info\n"
-		"   -d, --debug	   Print out DEBUG info\n"
-		"	--debug option must be used together with an object\n"
-		"	e.g. restool --debug dpni info dpni.11\n"
-		"   -s, --script   Print newly-created object name only instead of whole sentence\n"
-		"	e.g. restool -s dpseci create\n"
-		"	     dpseci.0\n"
-		"\n"
-		"Valid <object-type> values: <dprc|dpni|dpio|dpsw|dpbp|dpci|dpcon|dpseci|dpdmux|dpmcp|dpmac|dpdcei|dpaiop>\n"
-		"\n"
-		"Valid commands vary for each object type.\n"
-		"Use the \'restool dp* help\' command to see detailed usage info for an object.\n"
-		"The following commands are valid for all object types:\n"
-		"   help\n"
-		"   info\n"
-		"   create\n"
-		"   destroy\n"
-		"\n"
-		"The <object-name> arg is a string containing object type\n"
-		"and ID (e.g. dpni.7).\n"
-		"\n"
-		"For valid [ARGS] values, use the \'restool dp* <command> --help\'\n"
-		"\n";
-
-	printf(usage_msg);
-	restool.global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_HELP);
-}
-
-static void print_try_help(void)
+			restool_eprintf("\t--%s\n", options[i].name);
+
+	}
+}
+
+void print_try_help(void)
 {
 	ERROR_PRINTF("try 'restool --help'\n");
 }
 
-static void print_version(void)
+int parse_object_name(const char *obj_name, char *expected_obj_type,
+		      uint32_t *obj_id)
 {
-	printf("Freescale MC restool tool version %s\n", restool_version);
-	restool.global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_VERSION);
+	int n;
+	char obj_type[OBJ_TYPE_MAX_LENGTH + 1];
+
+	assert(expected_obj_type != NULL);
+	n = sscanf(obj_name, "%" STRINGIFY(OBJ_TYPE_MAX_LENGTH) "[a-z].%u",
+		   obj_type, obj_id);
+	if (n != 2) {
+		ERROR_PRINTF("Invalid MC object name: %s\n", obj_name);
+		return -EINVAL;
+	}
+
+	if (strcmp(obj_type, expected_obj_type) != 0) {
+		ERROR_PRINTF("Expected \'%s\' object type\n",
+			     expected_obj_type);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int open_dprc(uint32_t dprc_id, uint16_t *dprc_handle)
+{
+	int error;
+	enum mc_cmd_status mc_status;
+
+	error = mc_handle_open(&restool.handles, "dprc",
+			       dprc_id, dprc_open, dprc_close,
+			       dprc_handle);
+	if (error < 0) {
+		mc_status = flib_error_to_mc_status(error);
+		ERROR_PRINTF("MC error: %s (status %#x)\n",
+			mc_status_to_string(mc_status), mc_status);
+		goto out;
+	}
+
+	if (*dprc_handle == 0) {
+		DEBUG_PRINTF(
+			"dprc_open() returned invalid handle (auth 0) for dprc.%u\n",
+			dprc_id);
+
+		(void)dprc_close(&restool.mc_io, 0, *dprc_handle);
+		error = -ENOENT;
+		goto out;
+	}
+
+	error = 0;
+out:
+	return error;
+}
+
+/**
+ * Release a DPRC handle obtained with open_dprc()
+ */
+int close_dprc(uint16_t dprc_handle)
+{
+	return mc_handle_close(&restool.handles, dprc_handle, dprc_close);
+}
+
+/**
+ * Get a handle for object 'obj_type'.'obj_id' on restool's MC portal.
+ * Handles are cached for the whole restool session, so opening the same
+ * object again does not cost another MC command. Every handle obtained
+ * must be released with close_obj().
+ */
+int open_obj(const char *obj_type, uint32_t obj_id,
+	     const struct flib_ops *ops, uint16_t *obj_handle)
+{
+	return mc_handle_open(&restool.handles, obj_type, obj_id,
+			      ops->obj_open, ops->obj_close, obj_handle);
+}
+
+int close_obj(const struct flib_ops *ops, uint16_t obj_handle)
+{
+	return mc_handle_close(&restool.handles, obj_handle, ops->obj_close);
+}
+
+/**
+ * Get the id of the root DPRC. Transports that do not go through the fsl-mc
+ * bus cannot report it, so the container that owns the MC portal is used.
+ */
+static int get_root_dprc_id(uint32_t *root_dprc_id)
+{
+	int container_id;
+	enum mc_cmd_status mc_status;
+	int error;
+
+	error = mc_io_get_root_dprc_id(&restool.mc_io, root_dprc_id);
+	if (error != -EOPNOTSUPP)
+		return error;
+
+	error = dprc_get_container_id(&restool.mc_io, 0, &container_id);
+	if (error < 0) {
+		mc_status = flib_error_to_mc_status(error);
+		ERROR_PRINTF("MC error: %s (status %#x)\n",
+			mc_status_to_string(mc_status), mc_status);
+		return error;
+	}
+
+	DEBUG_PRINTF("MC portal's container id: %#x\n", container_id);
+	*root_dprc_id = (uint32_t)container_id;
+	return 0;
+}
+
+/**
+ * Look up long option 'name' ('name_len' characters) in 'options': an
+ * exact match, or else the option 'name' abbreviates, as getopt does.
+ * Returns the index of the option, -ENOENT if none matches or -EINVAL
+ * if 'name' abbreviates options taking their argument differently.
+ */
+static int find_cmd_option(const struct option options[], const char *name,
+			   size_t name_len)
+{
+	int found = -ENOENT;
+
+	for (int i = 0; options[i].name != NULL; i++) {
+		if (strncmp(options[i].name, name, name_len) != 0)
+			continue;
+
+		if (strlen(options[i].name) == name_len)
+			return i;
+
+		if (found == -ENOENT)
+			found = i;
+		else if (found >= 0 &&
+			 options[found].has_arg != options[i].has_arg)
+			found = -EINVAL;
+	}
+
+	return found;
+}
+
+/**
+ * Parse the long options of an object command, as getopt_long_only() with
+ * "+" would, but keeping the parsing state in the calling thread's
+ * restool_cmd rather than in getopt's globals. Errors are reported in the
+ * words of getopt.
+ */
+static int parse_cmd_options(int argc, char *argv[],
+			     const struct option options[],
+			     int *next_argv_index)
+{
+	int i;
+
+	restool_cmd.option_mask = 0;
+	assert(options != NULL);
+
+	for (i = 1; i < argc; i++) {
+		const char *prefix = argv[i][1] == '-' ? "--" : "-";
+		char *name = argv[i] + strlen(prefix);
+		char *value = NULL;
+		size_t name_len;
+		int opt_index;
+
+		if (argv[i][0] != '-' || argv[i][1] == '\0')
+			break;
+
+		if (strcmp(argv[i], "--") == 0) {
+			i++;
+			break;
+		}
+
+		name_len = strcspn(name, "=");
+		if (name[name_len] == '=')
+			value = &name[name_len + 1];
+
+		opt_index = find_cmd_option(options, name, name_len);
+		if (opt_index == -ENOENT) {
+			restool_eprintf("%s: unrecognized option '%s'\n",
+					argv[0], argv[i]);
+			return -EINVAL;
+		}
+
+		if (opt_index < 0) {
+			restool_eprintf("%s: option '%s%.*s' is ambiguous; possibilities:",
+					argv[0], prefix, (int)name_len, name);
+			for (int j = 0; options[j].name != NULL; j++) {
+				if (strncmp(options[j].name, name,
+					    name_len) == 0)
+					restool_eprintf(" '%s%s'", prefix,
+							options[j].name);
+			}
+
+			restool_eprintf("\n");
+			return -EINVAL;
+		}
+
+		if (options[opt_index].has_arg == no_argument &&
+		    value != NULL) {
+			restool_eprintf("%s: option '%s%s' doesn't allow an argument\n",
+					argv[0], prefix,
+					options[opt_index].name);
+			return -EINVAL;
+		}
+
+		if (options[opt_index].has_arg == required_argument &&
+		    value == NULL) {
+			if (i + 1 == argc) {
+				restool_eprintf("%s: option '%s%s' requires an argument\n",
+						argv[0], prefix,
+						options[opt_index].name);
+				return -EINVAL;
+			}
+
+			value = argv[++i];
+		}
+
+		assert((unsigned int)opt_index < MAX_NUM_CMD_LINE_OPTIONS);
+		if (restool_cmd.option_mask & ONE_BIT_MASK(opt_index)) {
+			ERROR_PRINTF("Duplicated option: %s\n",
+				     options[opt_index].name);
+			return -EINVAL;
+		}
+
+		restool_cmd.option_mask |= ONE_BIT_MASK(opt_index);
+		restool_cmd.option_args[opt_index] = value;
+	}
+
+	DEBUG_PRINTF("optind: %d, argc: %d\n", i, argc);
+	*next_argv_index = i;
+	return 0;
 }
 
-static void print_mc_version(void)
+/**
+ * Commands whose <object-name> argument can be replaced by --label=<label>
+ */
+static const char *const label_commands[] = {
+	"info",
+	"destroy",
+	"assign",
+	"unassign",
+	"connect",
+	"disconnect",
+};
+
+/**
+ * Take a --label=<label> or --label <label> option out of the command line
+ * of an object command, for parse_cmd_options() not to see it
+ */
+static void take_label_option(int *argc, char *argv[], const char **label)
 {
-	printf("MC firmware version: %u.%u.%u\n",
-	       restool.mc_fw_version.major,
-	       restool.mc_fw_version.minor,
-	       restool.mc_fw_version.revision);
+	static const char label_opt[] = "--label";
+	int num_args;
+
+	*label = NULL;
+	for (int i = 1; i < *argc; i++) {
+		if (strncmp(argv[i], label_opt, sizeof(label_opt) - 1) != 0)
+			continue;
+
+		if (argv[i][sizeof(label_opt) - 1] == '=') {
+			*label = &argv[i][sizeof(label_opt)];
+			num_args = 1;
+		} else if (argv[i][sizeof(label_opt) - 1] == '\0' &&
+			   i + 1 < *argc) {
+			*label = argv[i + 1];
+			num_args = 2;
+		} else {
+			continue;
+		}
+
+		for (int j = i; j + num_args <= *argc; j++)
+			argv[j] = argv[j + num_args];
 
-	restool.global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_MC_VERSION);
+		*argc -= num_args;
+		break;
+	}
 }
 
-int parse_object_name(const char *obj_name, char *expected_obj_type,
-		      uint32_t *obj_id)
+/**
+ * Resolve object label 'label' to the name of the object carrying it,
+ * stored in 'obj_name', through the label index of the topology snapshot.
+ * The object must be of type 'obj_type', unless it is NULL. A snapshot
+ * loaded from the topology cache file is checked against the MC and taken
+ * again if the label moved since.
+ */
+static int resolve_obj_label(const char *obj_type, const char *label,
+			     char *obj_name, size_t obj_name_size)
 {
-	int n;
-	char obj_type[OBJ_TYPE_MAX_LENGTH + 1];
+	const struct topology *topo;
+	int matches[8];
+	int num_matches;
+	int num_found;
+	int found = -1;
+	int error;
 
-	assert(expected_obj_type != NULL);
-	n = sscanf(obj_name, "%" STRINGIFY(OBJ_TYPE_MAX_LENGTH) "[a-z].%u",
-		   obj_type, obj_id);
-	if (n != 2) {
-		ERROR_PRINTF("Invalid MC object name: %s\n", obj_name);
+	if (label[0] == '\0' || strlen(label) > MC_OBJ_LABEL_MAX_LENGTH) {
+		ERROR_PRINTF("Invalid object label '%s'\n", label);
 		return -EINVAL;
 	}
 
-	if (strcmp(obj_type, expected_obj_type) != 0) {
-		ERROR_PRINTF("Expected \'%s\' object type\n",
-			     expected_obj_type);
-		return -EINVAL;
-	}
+	for (int attempt = 0; attempt < 2; attempt++) {
+		bool from_cache;
 
-	return 0;
-}
+		error = get_topology(&topo);
+		if (error < 0)
+			return error;
+
+		from_cache = topo->reused;
+		num_matches = topology_lookup_label(topo, label, matches,
+						    ARRAY_SIZE(matches));
+		num_found = 0;
+		for (int i = 0; i < num_matches &&
+				i < (int)ARRAY_SIZE(matches); i++) {
+			if (obj_type == NULL ||
+			    strcmp(topo->objs[matches[i]].desc.type,
+				   obj_type) == 0)
+				matches[num_found++] = matches[i];
+		}
 
-int open_dprc(uint32_t dprc_id, uint16_t *dprc_handle)
-{
-	int error;
-	enum mc_cmd_status mc_status;
+		if (num_matches > (int)ARRAY_SIZE(matches) || num_found > 1) {
+			ERROR_PRINTF("Object label '%s' is ambiguous:",
+				     label);
+			for (int i = 0; i < num_found; i++)
+				restool_eprintf(" %s.%u",
+						topo->objs[matches[i]].desc.type,
+						topo->objs[matches[i]].desc.id);
+
+			restool_eprintf("%s\n",
+					num_matches > (int)ARRAY_SIZE(matches) ?
+					" ..." : "");
+			return -EINVAL;
+		}
 
-	error = dprc_open(&restool.mc_io, 0,
-			  dprc_id,
-			  dprc_handle);
-	if (error < 0) {
-		mc_status = flib_error_to_mc_status(error);
-		ERROR_PRINTF("MC error: %s (status %#x)\n",
-			mc_status_to_string(mc_status), mc_status);
-		goto out;
+		if (num_found == 1) {
+			const struct topology_obj *obj = &topo->objs[matches[0]];
+			struct dprc_obj_desc obj_desc;
+
+			if (!from_cache || obj->parent < 0 ||
+			    (get_obj_desc_in_dprc(
+					topo->objs[obj->parent].desc.id,
+					obj->desc.type, obj->desc.id,
+					&obj_desc) &&
+			     strncmp(obj_desc.label, label,
+				     sizeof(obj_desc.label)) == 0)) {
+				found = matches[0];
+				break;
+			}
+		}
+
+		if (!from_cache)
+			break;
+
+		DEBUG_PRINTF("topology cache stale for label %s\n", label);
+		invalidate_topology();
 	}
 
-	if (*dprc_handle == 0) {
-		DEBUG_PRINTF(
-			"dprc_open() returned invalid handle (auth 0) for dprc.%u\n",
-			dprc_id);
+	if (found < 0) {
+		if (obj_type != NULL)
+			ERROR_PRINTF("No %s object labeled '%s'\n", obj_type,
+				     label);
+		else
+			ERROR_PRINTF("No object labeled '%s'\n", label);
 
-		(void)dprc_close(&restool.mc_io, 0, *dprc_handle);
-		error = -ENOENT;
-		goto out;
+		return -ENOENT;
 	}
 
-	error = 0;
-out:
-	return error;
+	snprintf(obj_name, obj_name_size, "%s.%u", topo->objs[found].desc.type,
+		 topo->objs[found].desc.id);
+	DEBUG_PRINTF("label %s is %s\n", label, obj_name);
+	return 0;
 }
 
-static int parse_global_options(int argc, char *argv[],
-				int *next_argv_index)
-{
-	int c;
-	int opt_index;
+/**
+ * Options of object commands whose argument names an MC object, and can
+ * then be given as label:<label>
+ */
+struct label_option {
+	const char *name;
 
-	/*
-	 * Initialize getopt global variables:
+	/**
+	 * type the object must be of, or NULL for any type
+	 */
+	const char *obj_type;
+
+	/**
+	 * the argument may end with .<interface>, as in dpsw.1.0
 	 */
-	optind = 1;
-	optarg = NULL;
+	bool endpoint;
+};
 
-	restool.global_option_mask = 0;
-	for ( ; ; ) {
-		opt_index = 0;
-		c = getopt_long(argc, argv, "+h?vmds", global_options, NULL);
-		DEBUG_PRINTF("c=%d\n", c);
-		DEBUG_PRINTF("optopt=%d\n", optopt);
+static const struct label_option label_options[] = {
+	{ .name = "object" },
+	{ .name = "child", .obj_type = "dprc" },
+	{ .name = "child-container", .obj_type = "dprc" },
+	{ .name = "aiop-container", .obj_type = "dprc" },
+	{ .name = "endpoint", .endpoint = true },
+	{ .name = "endpoint1", .endpoint = true },
+	{ .name = "endpoint2", .endpoint = true },
+};
 
-		if (c == -1)
-			break;
+/**
+ * Replace the label:<label> arguments of the object options of the
+ * command by the names of the objects carrying the labels
+ */
+static int resolve_label_option_args(const struct option *options)
+{
+	int num_resolved = 0;
+	int error;
+
+	for (unsigned int i = 0; i < MAX_NUM_CMD_LINE_OPTIONS; i++) {
+		const struct label_option *label_option = NULL;
+		char label[MC_OBJ_LABEL_MAX_LENGTH + 12];
+		const char *if_suffix = "";
+		char *obj_name;
+		char *arg;
+		char *dot;
+
+		if (!(restool_cmd.option_mask & ONE_BIT_MASK(i)))
+			continue;
+
+		arg = restool_cmd.option_args[i];
+		if (arg == NULL ||
+		    strncmp(arg, LABEL_ARG_PREFIX,
+			    sizeof(LABEL_ARG_PREFIX) - 1) != 0)
+			continue;
 
-		switch (c) {
-		case 'h':
-		case '?':
-			if (optopt == 0) {
-				opt_index = GLOBAL_OPT_HELP;
+		for (unsigned int j = 0; j < ARRAY_SIZE(label_options); j++) {
+			if (strcmp(options[i].name, label_options[j].name) == 0) {
+				label_option = &label_options[j];
 				break;
 			}
-			print_try_help();
-			return -EINVAL;
-
-		case 'v':
-			opt_index = GLOBAL_OPT_VERSION;
-			break;
+		}
 
-		case 'm':
-			opt_index = GLOBAL_OPT_MC_VERSION;
-			break;
+		if (label_option == NULL)
+			continue;
 
-		case 'd':
-			opt_index = GLOBAL_OPT_DEBUG;
-			break;
+		arg += sizeof(LABEL_ARG_PREFIX) - 1;
+		if (strlen(arg) >= sizeof(label)) {
+			ERROR_PRINTF("Invalid object label '%s'\n", arg);
+			return -EINVAL;
+		}
 
-		case 's':
-			opt_index = GLOBAL_OPT_SCRIPT;
-			break;
+		strcpy(label, arg);
 
-		default:
-			DEBUG_PRINTF("\n");
-			assert(false);
-			DEBUG_PRINTF("\n");
+		/*
+		 * Split the interface off a labeled endpoint
+		 */
+		dot = strrchr(arg, '.');
+		if (label_option->endpoint && dot != NULL && dot[1] != '\0' &&
+		    strspn(dot + 1, "0123456789") == strlen(dot + 1)) {
+			label[dot - arg] = '\0';
+			if_suffix = dot;
 		}
 
-		assert((unsigned int)opt_index < MAX_NUM_CMD_LINE_OPTIONS);
-		if (restool.global_option_mask & ONE_BIT_MASK(opt_index)) {
-			ERROR_PRINTF("Duplicated option: %s\n",
-				     global_options[opt_index].name);
+		if (num_resolved == MAX_LABEL_OPTION_ARGS) {
+			ERROR_PRINTF("Too many labeled options\n");
 			return -EINVAL;
 		}
 
-		restool.global_option_mask |= ONE_BIT_MASK(opt_index);
-		if (global_options[opt_index].has_arg)
-			restool.global_option_args[opt_index] = optarg;
-		else
-			restool.global_option_args[opt_index] = NULL;
+		obj_name = restool_cmd.label_option_args[num_resolved++];
+		error = resolve_obj_label(label_option->obj_type, label,
+					  obj_name,
+					  sizeof(restool_cmd.label_option_args[0]));
+		if (error < 0)
+			return error;
+
+		if (if_suffix[0] != '\0') {
+			strncat(obj_name, if_suffix,
+				sizeof(restool_cmd.label_option_args[0]) -
+				strlen(obj_name) - 1);
+		}
+
+		restool_cmd.option_args[i] = obj_name;
 	}
 
-	DEBUG_PRINTF("optind: %d, argc: %d\n", optind, argc);
-	*next_argv_index = optind;
-	DEBUG_PRINTF("\n");
 	return 0;
 }
 
-static int parse_cmd_options(int argc, char *argv[],
-			     const struct option options[],
-			     int *next_argv_index)
+/**
+ * Whether command 'cmd_name' leaves the MC objects unchanged
+ */
+static bool is_query_command(const char *cmd_name)
+{
+	return strcmp(cmd_name, "help") == 0 || strcmp(cmd_name, "info") == 0 ||
+	       strcmp(cmd_name, "show") == 0 || strcmp(cmd_name, "list") == 0 ||
+	       strcmp(cmd_name, "graph") == 0 || strcmp(cmd_name, "watch") == 0;
+}
+
+/**
+ * Scope 'lock' to container 'name', if it is a container name
+ */
+static void add_lock_container(struct cmd_lock *lock, const char *name)
+{
+	uint32_t dprc_id;
+	int n = 0;
+
+	if (name != NULL && sscanf(name, "dprc.%u%n", &dprc_id, &n) == 1 &&
+	    name[n] == '\0')
+		cmd_lock_add_container(lock, dprc_id);
+}
+
+/**
+ * Take the lock that keeps other restool processes from changing the MC
+ * objects while command 'cmd_name' runs: shared for queries and exclusive
+ * for anything else. The lock covers the whole container tree, or with
+ * RESTOOL_LOCK_SCOPE=container only the containers named on the command
+ * line, if any. The command is run unlocked when there is no lock file.
+ */
+static int lock_obj_command(const char *cmd_name, struct cmd_lock *lock)
 {
-	int c;
-	int opt_index;
+	const struct option *options = restool_cmd.obj_cmd->options;
+	const char *path = get_shared_file_path(RESTOOL_LOCK_ENV,
+						RESTOOL_LOCK_PATH);
+	const char *scope = getenv(RESTOOL_LOCK_SCOPE_ENV);
 	int error;
 
+	cmd_lock_init(lock, !is_query_command(cmd_name));
+	if (path == NULL)
+		return 0;
+
 	/*
-	 * Initialize getopt global variables:
+	 * Help only prints usage, and dprc watch runs until it is stopped:
+	 * holding a lock that long would block every other command
 	 */
-	optind = 1;
-	optarg = NULL;
-
-	restool.cmd_option_mask = 0;
-	assert(options != NULL);
-
-	for ( ; ; ) {
-		c = getopt_long_only(argc, argv, "+", options, &opt_index);
-		if (c == -1)
-			break;
+	if (strcmp(cmd_name, "help") == 0 || strcmp(cmd_name, "watch") == 0)
+		return 0;
 
-		if (c != 0) {
-			error = -EINVAL;
-			goto error;
-		}
+	if (options != NULL && strcmp(options[0].name, "help") == 0 &&
+	    (restool_cmd.option_mask & ONE_BIT_MASK(0)))
+		return 0;
 
-		assert((unsigned int)opt_index < MAX_NUM_CMD_LINE_OPTIONS);
-		if (restool.cmd_option_mask & ONE_BIT_MASK(opt_index)) {
-			ERROR_PRINTF("Duplicated option: %s\n",
-				     options[opt_index].name);
-			error = -EINVAL;
-			goto error;
+	/*
+	 * Destroying a container also destroys the containers below it
+	 */
+	if (scope != NULL && strcmp(scope, "container") == 0 &&
+	    strcmp(cmd_name, "destroy") != 0) {
+		add_lock_container(lock, restool_cmd.obj_name);
+		for (unsigned int i = 0; i < MAX_NUM_CMD_LINE_OPTIONS; i++) {
+			if (restool_cmd.option_mask & ONE_BIT_MASK(i))
+				add_lock_container(lock,
+						   restool_cmd.option_args[i]);
 		}
-
-		restool.cmd_option_mask |= ONE_BIT_MASK(opt_index);
-		if (options[opt_index].has_arg)
-			restool.cmd_option_args[opt_index] = optarg;
-		else
-			restool.cmd_option_args[opt_index] = NULL;
 	}
 
-	DEBUG_PRINTF("optind: %d, argc: %d\n", optind, argc);
-	*next_argv_index = optind;
-	return 0;
-error:
+	error = cmd_lock_acquire(lock, path);
+	if (error < 0)
+		ERROR_PRINTF("Cannot lock %s: %s\n", path, strerror(-error));
+
 	return error;
 }
 
@@ -689,6 +1673,8 @@ static int parse_obj_command(const char *obj_type,
 	struct timespec start_time = { 0 };
 	struct timespec end_time = { 0 };
 	struct timespec latency = { 0 };
+	struct cmd_lock cmd_lock;
+	const char *label = NULL;
 
 	assert(argv[0] == cmd_name);
 
@@ -728,14 +1714,36 @@ static int parse_obj_command(const char *obj_type,
 		goto out;
 	}
 
-	restool.obj_cmd = obj_cmd;
+	restool_cmd.obj_cmd = obj_cmd;
+
+	for (i = 0; i < ARRAY_SIZE(label_commands); i++) {
+		if (strcmp(cmd_name, label_commands[i]) == 0)
+			break;
+	}
 
 	if (argc >= 2 && argv[1][0] != '-') {
-		restool.obj_name = argv[1];
+		restool_cmd.obj_name = argv[1];
 		argv++;
 		argc--;
+		if (i < ARRAY_SIZE(label_commands) &&
+		    strncmp(restool_cmd.obj_name, LABEL_ARG_PREFIX,
+			    sizeof(LABEL_ARG_PREFIX) - 1) == 0)
+			label = restool_cmd.obj_name +
+				sizeof(LABEL_ARG_PREFIX) - 1;
 	} else {
-		restool.obj_name = NULL;
+		restool_cmd.obj_name = NULL;
+		if (i < ARRAY_SIZE(label_commands))
+			take_label_option(&argc, argv, &label);
+	}
+
+	if (label != NULL) {
+		error = resolve_obj_label(obj_type, label,
+					  restool_cmd.label_obj_name,
+					  sizeof(restool_cmd.label_obj_name));
+		if (error < 0)
+			goto out;
+
+		restool_cmd.obj_name = restool_cmd.label_obj_name;
 	}
 
 	/*
@@ -756,6 +1764,10 @@ static int parse_obj_command(const char *obj_type,
 			error = -EINVAL;
 			goto out;
 		}
+
+		error = resolve_label_option_args(obj_cmd->options);
+		if (error < 0)
+			goto out;
 	} else {
 		if (argc != 1) {
 			ERROR_PRINTF("Invalid command line\n");
@@ -765,6 +1777,10 @@ static int parse_obj_command(const char *obj_type,
 		}
 	}
 
+	error = lock_obj_command(cmd_name, &cmd_lock);
+	if (error < 0)
+		goto out;
+
 	/*
 	 * Execute object-level command:
 	 */
@@ -772,6 +1788,14 @@ static int parse_obj_command(const char *obj_type,
 
 	error = obj_cmd->cmd_func();
 
+	/*
+	 * Anything but a query may have changed the container tree
+	 */
+	if (!is_query_command(cmd_name))
+		invalidate_topology();
+
+	cmd_lock_release(&cmd_lock);
+
 	clock_gettime(CLOCK_REALTIME, &end_time);
 	diff_time(&start_time, &end_time, &latency);
 	DEBUG_PRINTF("It takes %ld.%ld seconds to run command\n",
@@ -779,8 +1803,8 @@ static int parse_obj_command(const char *obj_type,
 
 	if (error < 0)
 		goto out;
-	if (restool.cmd_option_mask != 0) {
-		print_unexpected_options_error(restool.cmd_option_mask,
+	if (restool_cmd.option_mask != 0) {
+		print_unexpected_options_error(restool_cmd.option_mask,
 					       obj_cmd->options);
 		error = -EINVAL;
 	}
@@ -788,188 +1812,201 @@ out:
 	return error;
 }
 
-int main(int argc, char *argv[])
+/**
+ * Run the object command of command line 'argv': <object-type> <command>
+ * [ARGS...]
+ */
+int run_obj_command(int argc, char *argv[])
 {
 	int error;
-	int next_argv_index;
-	const char *obj_type;
-	const char *cmd_name;
-	bool mc_io_initialized = false;
-	bool root_dprc_opened = false;
-	uint32_t root_dprc_id;
-	enum mc_cmd_status mc_status;
-	bool talk_to_mc = true;
-
-	#ifdef DEBUG
-	restool.debug = true;
-	#endif
-
-	for (int i = 0; i < argc; i++) {
-		if (strcmp(argv[i], "-v") == 0 ||
-			strcmp(argv[i], "--version") == 0 ||
-			strcmp(argv[i], "-h") == 0 ||
-			strcmp(argv[i], "-?") == 0 ||
-			strcmp(argv[i], "--help") == 0 ||
-			strcmp(argv[i], "help") == 0) {
-			talk_to_mc = false;
-			break;
-		}
-	}
 
-	DEBUG_PRINTF("talk_to_mc = %d\n", talk_to_mc);
-	if (talk_to_mc) {
-		DEBUG_PRINTF("restool built on " __DATE__ " " __TIME__ "\n");
-		error = mc_io_init(&restool.mc_io);
-		if (error != 0)
-			goto out;
+	if (argc < 2) {
+		ERROR_PRINTF("Incomplete command line\n");
+		print_try_help();
+		return -EINVAL;
+	}
 
-		mc_io_initialized = true;
-		DEBUG_PRINTF("restool.mc_io.fd: %d\n", restool.mc_io.fd);
+	error = parse_obj_command(argv[0], argv[1], argc - 1, &argv[1]);
+	put_topology();
+	return error;
+}
 
-		error = mc_get_version(&restool.mc_io, 0,
-					&restool.mc_fw_version);
-		if (error != 0) {
-			mc_status = flib_error_to_mc_status(error);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				mc_status_to_string(mc_status), mc_status);
-			goto out;
-		}
+/**
+ * Open the MC portal of the current context, with the root DPRC and the
+ * additional portals of 'params'
+ */
+static int open_mc(const struct restool_ctx_params *params)
+{
+	enum mc_cmd_status mc_status;
+	int error;
 
-		DEBUG_PRINTF("MC firmware version: %u.%u.%u\n",
-			     restool.mc_fw_version.major,
-			     restool.mc_fw_version.minor,
-			     restool.mc_fw_version.revision);
+	DEBUG_PRINTF("restool built on " __DATE__ " " __TIME__ "\n");
+	error = mc_io_init(&restool.mc_io, params->transport_spec);
+	if (error != 0)
+		return error;
 
-		DEBUG_PRINTF("calling ioctl(RESTOOL_GET_ROOT_DPRC_INFO)\n");
-		error = ioctl(restool.mc_io.fd, RESTOOL_GET_ROOT_DPRC_INFO,
-			      &root_dprc_id);
-		if (error == -1) {
-			error = -errno;
-			goto out;
-		}
+	mc_handle_cache_init(&restool.handles, &restool.mc_io);
 
-		DEBUG_PRINTF(
-			"ioctl returned MC-bus's root_dprc_id: %#x\n",
-			root_dprc_id);
+	error = mc_async_init(&restool.mc_async);
+	if (error < 0)
+		return error;
 
-		restool.root_dprc_id = root_dprc_id;
-		error = open_dprc(restool.root_dprc_id,
-				&restool.root_dprc_handle);
-		if (error < 0)
-			goto out;
+	restool.mc_async_initialized = true;
 
-		DEBUG_PRINTF("newly opened restool's root_dprc_handle: %#x\n",
-			     restool.root_dprc_handle);
-		root_dprc_opened = true;
+	error = mc_get_version(&restool.mc_io, 0, &restool.mc_fw_version);
+	if (error != 0) {
+		mc_status = flib_error_to_mc_status(error);
+		ERROR_PRINTF("MC error: %s (status %#x)\n",
+			mc_status_to_string(mc_status), mc_status);
+		return error;
 	}
 
-	error = parse_global_options(argc, argv, &next_argv_index);
+	DEBUG_PRINTF("MC firmware version: %u.%u.%u\n",
+		     restool.mc_fw_version.major,
+		     restool.mc_fw_version.minor,
+		     restool.mc_fw_version.revision);
+
+	error = get_root_dprc_id(&restool.root_dprc_id);
 	if (error < 0)
-		goto out;
+		return error;
 
-	if (next_argv_index == argc) {
-		if (restool.global_option_mask == 0) {
-			ERROR_PRINTF("Incomplete command line\n");
-			print_try_help();
-			error = -EINVAL;
-			goto out;
-		}
+	error = open_dprc(restool.root_dprc_id, &restool.root_dprc_handle);
+	if (error < 0)
+		return error;
 
-		if (restool.global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_HELP))
-			print_usage();	/* print help message */
+	DEBUG_PRINTF("newly opened restool's root_dprc_handle: %#x\n",
+		     restool.root_dprc_handle);
+	restool.root_dprc_opened = true;
 
-		if (restool.global_option_mask &
-		    ONE_BIT_MASK(GLOBAL_OPT_VERSION))
-			print_version();
+	if (params->portal_pool_spec != NULL) {
+		error = mc_pool_init(&restool.mc_pool, params->portal_pool_spec,
+				     params->transport_spec);
+		if (error < 0)
+			return error;
+	}
 
-		if (restool.global_option_mask &
-		    ONE_BIT_MASK(GLOBAL_OPT_MC_VERSION))
-			print_mc_version();
+	return 0;
+}
 
-		if (restool.global_option_mask &
-		    ONE_BIT_MASK(GLOBAL_OPT_DEBUG)) {
-			restool.global_option_mask &=
-				~ONE_BIT_MASK(GLOBAL_OPT_DEBUG);
-			print_try_help();
-			error = -EINVAL;
-			goto out;
-		}
+/**
+ * Release what open_mc() set up in the current context, even partially
+ */
+static int close_mc(void)
+{
+	enum mc_cmd_status mc_status;
+	int error = 0;
+	int error2;
 
-		if (restool.global_option_mask &
-		    ONE_BIT_MASK(GLOBAL_OPT_SCRIPT)) {
-			restool.global_option_mask &=
-				~ONE_BIT_MASK(GLOBAL_OPT_SCRIPT);
-			print_try_help();
-			error = -EINVAL;
-			goto out;
-		}
+	if (restool.mc_async_initialized)
+		mc_async_cleanup(&restool.mc_async);
 
+	if (restool.mc_pool.num_portals > 0)
+		mc_pool_cleanup(&restool.mc_pool);
 
-		if (restool.global_option_mask != 0) {
-			print_unexpected_options_error(
-				restool.global_option_mask,
-				global_options);
-			error = -EINVAL;
-		}
-	} else {
-		if (restool.global_option_mask &
-		    ONE_BIT_MASK(GLOBAL_OPT_DEBUG)) {
-			restool.global_option_mask &=
-				~ONE_BIT_MASK(GLOBAL_OPT_DEBUG);
-			restool.debug = true;
+	if (restool.root_dprc_opened) {
+		error = close_dprc(restool.root_dprc_handle);
+		if (error < 0) {
+			mc_status = flib_error_to_mc_status(error);
+			ERROR_PRINTF("MC error: %s (status %#x)\n",
+				mc_status_to_string(mc_status), mc_status);
 		}
+	}
 
-		if (restool.global_option_mask &
-		    ONE_BIT_MASK(GLOBAL_OPT_SCRIPT)) {
-			restool.global_option_mask &=
-				~ONE_BIT_MASK(GLOBAL_OPT_SCRIPT);
-			restool.script = true;
-		}
+	if (restool.topology != NULL)
+		put_snapshot(restool.topology);
 
-		int num_remaining_args;
+	if (restool.topology_prev_valid)
+		topology_free(&restool.topology_prev);
 
-		assert(next_argv_index < argc);
-		if (restool.global_option_mask != 0) {
-			print_unexpected_options_error(
-				restool.global_option_mask,
-				global_options);
-			print_try_help();
-			error = -EINVAL;
-			goto out;
-		}
+	pthread_mutex_destroy(&restool.topology_lock);
+	if (restool.mc_io.ops == NULL)
+		return error;
 
-		num_remaining_args = argc - next_argv_index;
-		if (num_remaining_args < 2) {
-			ERROR_PRINTF("Incomplete command line\n");
-			print_try_help();
-			error = -EINVAL;
-			goto out;
-		}
+	error2 = mc_handle_cache_cleanup(&restool.handles);
+	if (error2 < 0) {
+		mc_status = flib_error_to_mc_status(error2);
+		ERROR_PRINTF("MC error: %s (status %#x)\n",
+			mc_status_to_string(mc_status), mc_status);
+		if (error == 0)
+			error = error2;
+	}
+
+	mc_io_cleanup(&restool.mc_io);
+	return error;
+}
+
+/**
+ * Set up a new restool context: open its MC portal and the root DPRC,
+ * unless 'params' says offline
+ */
+int restool_ctx_create(const struct restool_ctx_params *params,
+		       struct restool_ctx **ctx)
+{
+	struct restool_ctx *new_ctx;
+	struct restool_ctx *prev_ctx;
+	int error = 0;
 
-		obj_type = argv[next_argv_index];
-		cmd_name = argv[next_argv_index + 1];
-		error = parse_obj_command(obj_type,
-					  cmd_name,
-					  num_remaining_args - 1,
-					  &argv[next_argv_index + 1]);
+	new_ctx = calloc(1, sizeof(*new_ctx));
+	if (new_ctx == NULL) {
+		ERROR_PRINTF("calloc() failed\n");
+		return -ENOMEM;
 	}
-out:
-	if (root_dprc_opened) {
-		int error2;
 
-		error2 = dprc_close(&restool.mc_io, 0,
-					restool.root_dprc_handle);
-		if (error2 < 0) {
-			mc_status = flib_error_to_mc_status(error2);
-			ERROR_PRINTF("MC error: %s (status %#x)\n",
-				mc_status_to_string(mc_status), mc_status);
-			if (error == 0)
-				error = error2;
-		}
+	if (params->output != NULL) {
+		new_ctx->output = params->output;
+		new_ctx->output_arg = params->output_arg;
+	} else {
+		new_ctx->output = restool_default_output;
+	}
+
+	new_ctx->debug = params->debug;
+	new_ctx->script = params->script;
+	pthread_mutex_init(&new_ctx->topology_lock, NULL);
+
+	prev_ctx = restool_ctx_switch(new_ctx);
+	if (!params->offline) {
+		error = open_mc(params);
+		if (error < 0)
+			(void)close_mc();
+	}
+
+	(void)restool_ctx_switch(prev_ctx);
+	if (error < 0) {
+		free(new_ctx);
+		return error;
 	}
 
-	if (mc_io_initialized)
-		mc_io_cleanup(&restool.mc_io);
+	*ctx = new_ctx;
+	return 0;
+}
+
+/**
+ * Close the MC portal of 'ctx' and free it. Returns the first error met
+ * closing MC objects, if any.
+ */
+int restool_ctx_destroy(struct restool_ctx *ctx)
+{
+	struct restool_ctx *prev_ctx;
+	int error;
+
+	prev_ctx = restool_ctx_switch(ctx);
+	error = close_mc();
+	(void)restool_ctx_switch(prev_ctx);
+	free(ctx);
+	return error;
+}
+
+/**
+ * Run object command 'argv' (<object-type> <command> [ARGS...]) in 'ctx'
+ */
+int restool_ctx_run(struct restool_ctx *ctx, int argc, char *argv[])
+{
+	struct restool_ctx *prev_ctx;
+	int error;
 
+	prev_ctx = restool_ctx_switch(ctx);
+	restool_cmd.script = ctx->script;
+	error = run_obj_command(argc, argv);
+	(void)restool_ctx_switch(prev_ctx);
 	return error;
 }
@@ -36,10 +36,15 @@
 #include <unistd.h>
 #include <limits.h>
 #include "fsl_mc_sys.h"
+#include "mc_pool.h"
+#include "mc_async.h"
+#include "mc_handles.h"
+#include "topology.h"
 #include "fsl_dpmng.h"
 #include "fsl_dprc.h"
 #include "fsl_mc_ioctl.h"
 #include "fsl_mc_cmd.h"
+#include "librestool.h"
 
 /**
  * MC object type string max length (without including the null terminator)
@@ -56,6 +61,34 @@
  */
 #define MAX_NUM_CMD_LINE_OPTIONS	(sizeof(uint32_t) * 8)
 
+/**
+ * Environment variable overriding the topology cache file, "off" to
+ * disable the cache, and default cache file
+ */
+#define RESTOOL_TOPOLOGY_CACHE_ENV	"RESTOOL_TOPOLOGY_CACHE"
+#define RESTOOL_TOPOLOGY_CACHE_PATH	"/run/restool/topology"
+
+/**
+ * Environment variable overriding the file locking the MC objects against
+ * concurrent restool commands, "off" to run commands unlocked, and default
+ * lock file
+ */
+#define RESTOOL_LOCK_ENV	"RESTOOL_LOCK"
+#define RESTOOL_LOCK_PATH	"/run/restool/lock"
+
+/**
+ * Environment variable scoping the lock of commands to the containers
+ * they name when set to "container"
+ */
+#define RESTOOL_LOCK_SCOPE_ENV	"RESTOOL_LOCK_SCOPE"
+
+/**
+ * Prefix of an object name argument naming the object by its label, and
+ * maximum number of such option arguments in one command
+ */
+#define LABEL_ARG_PREFIX	"label:"
+#define MAX_LABEL_OPTION_ARGS	4
+
 /**
  * Maximum level of nesting of DPRCs
  */
@@ -101,8 +134,6 @@
 #define MC_PORTAL_OFFSET_TO_PORTAL_ID(_portal_offset) \
 	((_portal_offset) / MC_PORTAL_STRIDE)
 
-struct restool;
-
 typedef int restool_cmd_func_t(void);
 
 struct object_command {
@@ -138,46 +169,112 @@ struct object_cmd_parser {
 };
 
 /**
- * Global state of the restool tool
+ * struct topology_snapshot - snapshot of the container tree shared by the
+ * commands of a context, freed once the context and all of them are done
+ * with it
+ */
+struct topology_snapshot {
+	struct topology topo;
+	int refcount;
+};
+
+/**
+ * State of the command a thread is running. Threads sharing a context
+ * each have their own.
  */
-struct restool {
+struct restool_cmd {
 	/**
-	 * Bit mask of command-line options not consumed yet
+	 * Pointer to the command being processed
 	 */
-	uint32_t global_option_mask;
+	struct object_command *obj_cmd;
 
 	/**
-	 * Array of option arguments for global options found in the command line,
-	 * that have arguments. One entry per option.
+	 * object name found in the command line
 	 */
-	const char *global_option_args[MAX_NUM_CMD_LINE_OPTIONS];
+	const char *obj_name;
 
 	/**
-	 * Pointer to the command being processed
+	 * object name an object label given with --label or as
+	 * label:<label> resolved to
 	 */
-	struct object_command *obj_cmd;
+	char label_obj_name[EP_OBJ_TYPE_MAX_LEN + 12];
 
 	/**
-	 * object name found in the command line
+	 * object names that label:<label> option arguments resolved to,
+	 * with the interface of an endpoint
 	 */
-	const char *obj_name;
+	char label_option_args[MAX_LABEL_OPTION_ARGS][EP_OBJ_TYPE_MAX_LEN + 24];
 
 	/**
 	 * Bit mask of command-line options not consumed yet
 	 */
-	uint32_t cmd_option_mask;
+	uint32_t option_mask;
 
 	/**
 	 * Array of option arguments for options found in the command line,
 	 * that have arguments. One entry per option.
 	 */
-	char *cmd_option_args[MAX_NUM_CMD_LINE_OPTIONS];
+	char *option_args[MAX_NUM_CMD_LINE_OPTIONS];
+
+	/**
+	 * print out created object name only, as with --script
+	 */
+	bool script;
+
+	/**
+	 * output function replacing the one of the context, if not NULL
+	 */
+	restool_output_fn_t *output;
+	void *output_arg;
+
+	/**
+	 * topology snapshot the command got from get_topology()
+	 */
+	struct topology_snapshot *topology;
+};
 
+/**
+ * State of a restool context: the MC portal and caches commands run on.
+ * See librestool.h.
+ */
+struct restool_ctx {
 	/**
 	 * MC I/O portal
 	 */
 	struct fsl_mc_io mc_io;
 
+	/**
+	 * Pool of additional MC portals used to parallelize bulk queries.
+	 * Unused if mc_pool.num_portals is 0.
+	 */
+	struct mc_pool mc_pool;
+
+	/**
+	 * Engine for MC commands submitted without waiting for the response
+	 */
+	struct mc_async mc_async;
+
+	/**
+	 * MC object tokens of mc_io kept open across open/close pairs
+	 */
+	struct mc_handle_cache handles;
+
+	/**
+	 * Snapshot of the container tree, taken on first use and dropped
+	 * after any command that may change it; NULL if none. Protected,
+	 * along with topology_prev, by topology_lock.
+	 */
+	struct topology_snapshot *topology;
+	pthread_mutex_t topology_lock;
+
+	/**
+	 * Previous snapshot, kept by a long-lived process (restoold) as the
+	 * base of the next one: only containers that changed since are
+	 * walked again
+	 */
+	struct topology topology_prev;
+	bool topology_prev_valid;
+
 	/**
 	 * MC firmware version
 	 */
@@ -199,22 +296,29 @@ struct restool {
 	bool debug;
 
 	/**
-	 * global flag to enable script printing
-	 * it only print out created object name
-	 * instead of the whole sentence
+	 * default of restool_cmd.script for the commands of the context
 	 */
 	bool script;
-};
 
-/**
- * Command-line option indices for global restool options
- */
-enum global_options {
-	GLOBAL_OPT_HELP = 0,
-	GLOBAL_OPT_VERSION,
-	GLOBAL_OPT_MC_VERSION,
-	GLOBAL_OPT_DEBUG,
-	GLOBAL_OPT_SCRIPT
+	/**
+	 * where the output of commands goes, see restool_printf()
+	 */
+	restool_output_fn_t *output;
+	void *output_arg;
+
+	/**
+	 * resources of the context set up so far, to be released by
+	 * restool_ctx_destroy()
+	 */
+	bool mc_async_initialized;
+	bool root_dprc_opened;
+
+	/**
+	 * set once the MC rejected dprc_get_obj_desc() as unsupported: the
+	 * firmware has no command to get the descriptor of one object of a
+	 * DPRC, so lookups go straight to scanning containers
+	 */
+	bool obj_desc_query_unsupported;
 };
 
 /**
@@ -245,16 +349,54 @@ struct flib_ops {
 	flib_obj_get_irq_status_t *obj_get_irq_status;
 };
 
+/**
+ * struct obj_info - object an info command is run on
+ */
+struct obj_info {
+	struct dprc_obj_desc desc;
+	uint32_t parent_dprc_id;
+
+	/**
+	 * handle of the object, open for the whole command
+	 */
+	uint16_t handle;
+};
+
+typedef int obj_info_print_t(struct obj_info *info);
+
 int parse_object_name(const char *obj_name, char *expected_obj_type,
 		      uint32_t *obj_id);
 
 int open_dprc(uint32_t dprc_id, uint16_t *dprc_handle);
+int close_dprc(uint16_t dprc_handle);
+int open_obj(const char *obj_type, uint32_t obj_id,
+	     const struct flib_ops *ops, uint16_t *obj_handle);
+int close_obj(const struct flib_ops *ops, uint16_t obj_handle);
 
 void print_unexpected_options_error(uint32_t option_mask,
 				    const struct option *options);
+void print_try_help(void);
+int restool_printf(const char *fmt, ...)
+	__attribute__((format(printf, 1, 2)));
+int restool_eprintf(const char *fmt, ...)
+	__attribute__((format(printf, 1, 2)));
 
 enum mc_cmd_status flib_error_to_mc_status(int error);
 const char *mc_status_to_string(enum mc_cmd_status status);
+int get_topology(const struct topology **topo);
+void invalidate_topology(void);
+void age_topology(void);
+void put_topology(void);
+bool has_topology(void);
+bool topology_available(void);
+int run_obj_command(int argc, char *argv[]);
+bool get_obj_desc_in_dprc(uint32_t dprc_id, const char *obj_type,
+			  uint32_t obj_id, struct dprc_obj_desc *obj_desc);
+int get_dprc_obj_desc_range(uint32_t dprc_id, uint16_t dprc_handle,
+			    int first, int num_objs,
+			    struct dprc_obj_desc *obj_descs);
+int get_dprc_obj_descs(uint32_t dprc_id, uint16_t dprc_handle,
+			struct dprc_obj_desc **obj_descs, int *num_objs);
 int find_target_obj_desc(uint32_t dprc_id, uint16_t dprc_handle,
 			int nesting_level,
 			uint32_t target_id, char *target_type,
@@ -262,13 +404,28 @@ int find_target_obj_desc(uint32_t dprc_id, uint16_t dprc_handle,
 			uint32_t *target_parent_dprc_id, bool *found);
 bool find_obj(char *obj_type, uint32_t obj_id);
 void print_obj_label(struct dprc_obj_desc *target_obj_desc);
-int print_obj_verbose(struct dprc_obj_desc *target_obj_desc,
-			const struct flib_ops *ops);
+int print_obj_info(const char *obj_type, uint32_t obj_id,
+		   const struct flib_ops *ops, obj_info_print_t *print_attr,
+		   bool verbose);
 int check_resource_type(char *res_type);
 bool in_use(const char *obj, const char *situation);
 void print_new_obj(char *type, int id, const char *parent);
 
-extern struct restool restool;
+struct restool_ctx *restool_ctx_switch(struct restool_ctx *ctx);
+
+/**
+ * Context the calling thread runs commands in, referred to as 'restool'
+ * by the command code. Threads start in a default context, which only
+ * holds the output settings used before any other context is set up.
+ */
+extern __thread struct restool_ctx *restool_current;
+#define restool (*restool_current)
+
+/**
+ * Command the calling thread is running
+ */
+extern __thread struct restool_cmd restool_cmd;
+
 extern struct object_command dprc_commands[];
 extern struct object_command dpni_commands[];
 extern struct object_command dpio_commands[];
@@ -282,5 +439,6 @@ extern struct object_command dpmcp_commands[];
 extern struct object_command dpmac_commands[];
 extern struct object_command dpdcei_commands[];
 extern struct object_command dpaiop_commands[];
+extern struct object_command topology_commands[];
 
 #endif /* _RESTOOL_H_ */
@@ -0,0 +1,627 @@
+/*
+ * Copyright (C) 2014 Freescale Semiconductor, Inc.
+ * Author: German Rivera <German.Rivera@freescale.com>
+ *	   Lijun Pan <Lijun.Pan@freescale.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include "restool.h"
+#include "restoold.h"
+#include "batch.h"
+#include "utils.h"
+#include "mc_stats.h"
+#include "mc_trace.h"
+#include "mc_retry.h"
+
+static const char restool_version[] = "1.2";
+
+/**
+ * Command-line option indices for global restool options
+ */
+enum global_options {
+	GLOBAL_OPT_HELP = 0,
+	GLOBAL_OPT_VERSION,
+	GLOBAL_OPT_MC_VERSION,
+	GLOBAL_OPT_DEBUG,
+	GLOBAL_OPT_SCRIPT,
+	GLOBAL_OPT_TRANSPORT,
+	GLOBAL_OPT_PORTAL_POOL,
+	GLOBAL_OPT_MC_STATS,
+	GLOBAL_OPT_RECORD,
+	GLOBAL_OPT_RETRY,
+	GLOBAL_OPT_DAEMON,
+	GLOBAL_OPT_BATCH
+};
+
+static struct option global_options[] = {
+	[GLOBAL_OPT_HELP] = {
+		.name = "help",
+		.val = 'h',
+	},
+
+	[GLOBAL_OPT_VERSION] = {
+		.name = "version",
+		.val = 'v',
+	},
+
+	[GLOBAL_OPT_MC_VERSION] = {
+		.name = "mc-version",
+		.val = 'm',
+	},
+
+	[GLOBAL_OPT_DEBUG] = {
+		.name = "debug",
+		.val = 'd',
+	},
+
+	[GLOBAL_OPT_SCRIPT] = {
+		.name = "script",
+		.val = 's',
+	},
+
+	[GLOBAL_OPT_TRANSPORT] = {
+		.name = "transport",
+		.has_arg = 1,
+		.val = 't',
+	},
+
+	[GLOBAL_OPT_PORTAL_POOL] = {
+		.name = "portal-pool",
+		.has_arg = 1,
+		.val = 'p',
+	},
+
+	[GLOBAL_OPT_MC_STATS] = {
+		.name = "mc-stats",
+		.has_arg = 2,
+		.val = 'S',
+	},
+
+	[GLOBAL_OPT_RECORD] = {
+		.name = "record",
+		.has_arg = 1,
+		.val = 'r',
+	},
+
+	[GLOBAL_OPT_RETRY] = {
+		.name = "retry",
+		.has_arg = 1,
+		.val = 'R',
+	},
+
+	[GLOBAL_OPT_DAEMON] = {
+		.name = "daemon",
+		.has_arg = 2,
+		.val = 'D',
+	},
+
+	[GLOBAL_OPT_BATCH] = {
+		.name = "batch",
+		.has_arg = 1,
+		.val = 'b',
+	},
+
+	{ 0 },
+};
+
+C_ASSERT(ARRAY_SIZE(global_options) <= MAX_NUM_CMD_LINE_OPTIONS + 1);
+
+/**
+ * Bit mask of global options not consumed yet
+ */
+static uint32_t global_option_mask;
+
+/**
+ * Array of option arguments for global options found in the command line,
+ * that have arguments. One entry per option.
+ */
+static const char *global_option_args[MAX_NUM_CMD_LINE_OPTIONS];
+
+static void print_usage(void)
+{
+	static const char usage_msg[] =
+		"\n"
+		"There are 3 levels of help, from up to bottom:\n"
+		"global: restool --help\n"
+		"object: restool dp* help\n"
+		"	tells you all the commands this object support\n"
+		"	e.g. restool dprc help\n"
+		"object-command: restool dp* <command> --help\n"
+		"	tells you how to use this <command>\n"
+		"	e.g. restool dprc create --help\n"
+		"\n"
+		"Usage: restool [<global-options>] <object-type> <command> <object-name> [ARGS...]\n"
+		"\n"
+		"Valid <global-options> are:\n"
+		"   -v,--version   Displays tool version info\n"
+		"   -m,--mc-version Displays mc firmware version.\n"
+		"   -h,-?,--help   Displays general help info\n"
+		"   -d, --debug	   Print out DEBUG info\n"
+		"	--debug option must be used together with an object\n"
+		"	e.g. restool --debug dpni info dpni.11\n"
+		"   -s, --script   Print newly-created object name only instead of whole sentence\n"
+		"	e.g. restool -s dpseci create\n"
+		"	     dpseci.0\n"
+		"   -t, --transport=<name>[:<arg>]\n"
+		"	Selects how MC commands are sent (default: $" RESTOOL_TRANSPORT_ENV " or ioctl):\n"
+		"	ioctl[:<device>]	through the restool driver (/dev/mc_restool)\n"
+		"	portal:<uio-device>|dpmcp.<id>\n"
+		"			through a dedicated MC portal mapped in user space\n"
+		"	replay:<file>[,latency]\n"
+		"			answers commands from a trace made with --record,\n"
+		"			optionally delayed by the recorded latencies\n"
+		"	emul[:<key>=<value>,...]\n"
+		"			in-process MC emulator; keys: <object-type>=<count>\n"
+		"			per container, containers=<count>, depth=<levels>,\n"
+		"			latency=<us>, latency.<cmd-id>=<us>, busy=<percent>,\n"
+		"			labels=1 (label objects after their name, e.g. dpni3)\n"
+		"	e.g. restool --transport=portal:/dev/uio0 dprc list\n"
+		"	     restool --transport=emul:containers=8,dpni=64 dprc list\n"
+		"   -p, --portal-pool=<count>|<transport>[,<transport>...]\n"
+		"	Opens additional MC portals, each served by a worker thread, to\n"
+		"	parallelize bulk queries. Either <count> portals of the selected\n"
+		"	transport, or one portal per listed transport.\n"
+		"	e.g. restool -t portal:dpmcp.2 -p portal:dpmcp.3,portal:dpmcp.4 dprc show dprc.1\n"
+		"   -S, --mc-stats[=text|json]\n"
+		"	Print per MC command ID latency statistics (count, average, p50,\n"
+		"	p99, max) and MC error status counts to stderr on exit\n"
+		"	e.g. restool --mc-stats=json dprc show dprc.1\n"
+		"   -r, --record=<file>\n"
+		"	Append every MC command sent and its response, with timestamps,\n"
+		"	to the binary trace <file>, to be replayed later with\n"
+		"	--transport=replay:<file>[,latency]\n"
+		"	e.g. restool --record=/tmp/board.trace dprc list\n"
+		"   -R, --retry=off|<key>=<value>[,<key>=<value>...]\n"
+		"	Retry policy for MC commands completing with BUSY or TIMEOUT.\n"
+		"	Keys: attempts=<n> (default 4), backoff=<us> (1000),\n"
+		"	max-backoff=<us> (100000), deadline=<ms> (2000),\n"
+		"	commands=queries|all (queries), <cmd-id>=<attempts>\n"
+		"	e.g. restool --retry=attempts=8,deadline=5000 dprc list\n"
+		"   -D, --daemon[=<socket>]\n"
+		"	Runs as restoold: keeps the MC portal, root container, object\n"
+		"	handles and topology snapshot open and serves the commands of\n"
+		"	restool clients on a Unix socket (default: $" RESTOOLD_SOCKET_ENV " or\n"
+		"	" RESTOOLD_SOCKET_PATH ") until SIGINT or SIGTERM. restool forwards\n"
+		"	its command to restoold when one listens there, unless other\n"
+		"	global options than -d and -s, or $" RESTOOL_TRANSPORT_ENV ", are given.\n"
+		"	" RESTOOLD_SOCKET_ENV "=off turns forwarding off.\n"
+		"	e.g. restool --transport=portal:dpmcp.2 --daemon &\n"
+		"   -b, --batch=<file>|-\n"
+		"	Runs the commands of <file>, or of stdin, one per line, in this\n"
+		"	process, stopping at the first one that fails, and reports the\n"
+		"	status of each line to stderr (only failures with -s). Lines are\n"
+		"	\'[<name>=]<object-type> <command> [ARGS...]\' or \'echo [ARGS...]\';\n"
+		"	<name>= stores the output of the command, as printed with -s,\n"
+		"	in variable <name>, referenced as $<name> or ${<name>} by later\n"
+		"	lines. Arguments may be quoted; lines starting with # are skipped.\n"
+		"	e.g. printf \'bp=dpbp create\\ndprc assign dprc.2 --object=$bp\\n\' |\n"
+		"	     restool --batch=-\n"
+		"\n"
+		"Valid <object-type> values: <dprc|dpni|dpio|dpsw|dpbp|dpci|dpcon|dpseci|dpdmux|dpmcp|dpmac|dpdcei|dpaiop>\n"
+		"\n"
+		"The container tree as a whole is handled with the \'topology\' object type:\n"
+		"   restool topology graph [--format=<dot|json>]\n"
+		"	displays the links between all connectable objects\n"
+		"\n"
+		"Valid commands vary for each object type.\n"
+		"Use the \'restool dp* help\' command to see detailed usage info for an object.\n"
+		"The following commands are valid for all object types:\n"
+		"   help\n"
+		"   info\n"
+		"   create\n"
+		"   destroy\n"
+		"\n"
+		"The <object-name> arg is a string containing object type\n"
+		"and ID (e.g. dpni.7). For the info, destroy, assign, unassign,\n"
+		"connect and disconnect commands it can be replaced by\n"
+		"--label=<label>, naming the object by its label.\n"
+		"	e.g. restool dpni info --label=eth0\n"
+		"\n"
+		"For valid [ARGS] values, use the \'restool dp* <command> --help\'\n"
+		"\n";
+
+	printf(usage_msg);
+	global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_HELP);
+}
+
+static void print_version(void)
+{
+	printf("Freescale MC restool tool version %s\n", restool_version);
+	global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_VERSION);
+}
+
+static void print_mc_version(const struct restool_ctx *ctx)
+{
+	printf("MC firmware version: %u.%u.%u\n",
+	       ctx->mc_fw_version.major,
+	       ctx->mc_fw_version.minor,
+	       ctx->mc_fw_version.revision);
+
+	global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_MC_VERSION);
+}
+
+static int parse_global_options(int argc, char *argv[],
+				int *next_argv_index)
+{
+	int c;
+	int opt_index;
+
+	/*
+	 * Initialize getopt global variables:
+	 */
+	optind = 1;
+	optarg = NULL;
+
+	global_option_mask = 0;
+	for ( ; ; ) {
+		opt_index = 0;
+		c = getopt_long(argc, argv, "+h?vmdst:p:S::r:R:D::b:", global_options, NULL);
+		DEBUG_PRINTF("c=%d\n", c);
+		DEBUG_PRINTF("optopt=%d\n", optopt);
+
+		if (c == -1)
+			break;
+
+		switch (c) {
+		case 'h':
+		case '?':
+			if (optopt == 0) {
+				opt_index = GLOBAL_OPT_HELP;
+				break;
+			}
+			print_try_help();
+			return -EINVAL;
+
+		case 'v':
+			opt_index = GLOBAL_OPT_VERSION;
+			break;
+
+		case 'm':
+			opt_index = GLOBAL_OPT_MC_VERSION;
+			break;
+
+		case 'd':
+			opt_index = GLOBAL_OPT_DEBUG;
+			break;
+
+		case 's':
+			opt_index = GLOBAL_OPT_SCRIPT;
+			break;
+
+		case 't':
+			opt_index = GLOBAL_OPT_TRANSPORT;
+			break;
+
+		case 'p':
+			opt_index = GLOBAL_OPT_PORTAL_POOL;
+			break;
+
+		case 'S':
+			opt_index = GLOBAL_OPT_MC_STATS;
+			break;
+
+		case 'r':
+			opt_index = GLOBAL_OPT_RECORD;
+			break;
+
+		case 'R':
+			opt_index = GLOBAL_OPT_RETRY;
+			break;
+
+		case 'D':
+			opt_index = GLOBAL_OPT_DAEMON;
+			break;
+
+		case 'b':
+			opt_index = GLOBAL_OPT_BATCH;
+			break;
+
+		default:
+			DEBUG_PRINTF("\n");
+			assert(false);
+			DEBUG_PRINTF("\n");
+		}
+
+		assert((unsigned int)opt_index < MAX_NUM_CMD_LINE_OPTIONS);
+		if (global_option_mask & ONE_BIT_MASK(opt_index)) {
+			ERROR_PRINTF("Duplicated option: %s\n",
+				     global_options[opt_index].name);
+			return -EINVAL;
+		}
+
+		global_option_mask |= ONE_BIT_MASK(opt_index);
+		if (global_options[opt_index].has_arg)
+			global_option_args[opt_index] = optarg;
+		else
+			global_option_args[opt_index] = NULL;
+	}
+
+	DEBUG_PRINTF("optind: %d, argc: %d\n", optind, argc);
+	*next_argv_index = optind;
+	DEBUG_PRINTF("\n");
+	return 0;
+}
+
+/**
+ * Have restoold run the command of this process, unless global options
+ * ask for a setup of their own or the command is dprc watch, which runs
+ * until it is stopped and would keep restoold from serving anyone else.
+ * Returns -ENOTCONN if the command is to be run by this process.
+ */
+static int forward_to_restoold(int argc, char *argv[], int *cmd_error)
+{
+	const uint32_t forwarded_options = ONE_BIT_MASK(GLOBAL_OPT_DEBUG) |
+					   ONE_BIT_MASK(GLOBAL_OPT_SCRIPT);
+	const char *path;
+	uint32_t flags = 0;
+
+	if ((global_option_mask & ~forwarded_options) != 0 ||
+	    getenv(RESTOOL_TRANSPORT_ENV) != NULL)
+		return -ENOTCONN;
+
+	if (argc >= 2 && strcmp(argv[1], "watch") == 0)
+		return -ENOTCONN;
+
+	path = restoold_socket_path(NULL);
+	if (path == NULL)
+		return -ENOTCONN;
+
+	if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_DEBUG))
+		flags |= RESTOOLD_FLAG_DEBUG;
+
+	if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_SCRIPT))
+		flags |= RESTOOLD_FLAG_SCRIPT;
+
+	return restoold_forward(path, flags, argc, argv, cmd_error);
+}
+
+int main(int argc, char *argv[])
+{
+	struct restool_ctx_params params = { 0 };
+	struct restool_ctx *ctx = NULL;
+	int error;
+	int next_argv_index;
+	bool mc_stats_json = false;
+	bool talk_to_mc = true;
+	const char *program_name;
+
+	#ifdef DEBUG
+	restool.debug = true;
+	#endif
+
+	for (int i = 0; i < argc; i++) {
+		if (strcmp(argv[i], "-v") == 0 ||
+			strcmp(argv[i], "--version") == 0 ||
+			strcmp(argv[i], "-h") == 0 ||
+			strcmp(argv[i], "-?") == 0 ||
+			strcmp(argv[i], "--help") == 0 ||
+			strcmp(argv[i], "help") == 0) {
+			talk_to_mc = false;
+			break;
+		}
+	}
+
+	error = parse_global_options(argc, argv, &next_argv_index);
+	if (error < 0)
+		goto out;
+
+	/*
+	 * Invoked as restoold: restool --daemon
+	 */
+	program_name = strrchr(argv[0], '/');
+	program_name = program_name != NULL ? program_name + 1 : argv[0];
+	if (strcmp(program_name, "restoold") == 0 &&
+	    !(global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_DAEMON))) {
+		global_option_mask |= ONE_BIT_MASK(GLOBAL_OPT_DAEMON);
+		global_option_args[GLOBAL_OPT_DAEMON] = NULL;
+	}
+
+	if (talk_to_mc && next_argv_index < argc) {
+		int cmd_error;
+
+		error = forward_to_restoold(argc - next_argv_index,
+					    &argv[next_argv_index],
+					    &cmd_error);
+		if (error == 0)
+			error = cmd_error;
+
+		if (error != -ENOTCONN)
+			goto out;
+
+		error = 0;
+	}
+
+	if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_TRANSPORT)) {
+		global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_TRANSPORT);
+		params.transport_spec = global_option_args[GLOBAL_OPT_TRANSPORT];
+	} else {
+		params.transport_spec = getenv(RESTOOL_TRANSPORT_ENV);
+	}
+
+	if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_PORTAL_POOL)) {
+		global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_PORTAL_POOL);
+		params.portal_pool_spec =
+			global_option_args[GLOBAL_OPT_PORTAL_POOL];
+	}
+
+	if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_MC_STATS)) {
+		const char *format = global_option_args[GLOBAL_OPT_MC_STATS];
+
+		global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_MC_STATS);
+		if (format == NULL || strcmp(format, "text") == 0) {
+			mc_stats_json = false;
+		} else if (strcmp(format, "json") == 0) {
+			mc_stats_json = true;
+		} else {
+			ERROR_PRINTF("Invalid --mc-stats format: \'%s\'\n",
+				     format);
+			print_try_help();
+			error = -EINVAL;
+			goto out;
+		}
+
+		mc_stats_enable();
+	}
+
+	if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_RECORD)) {
+		global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_RECORD);
+		error = mc_trace_open(global_option_args[GLOBAL_OPT_RECORD]);
+		if (error < 0)
+			goto out;
+	}
+
+	if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_RETRY)) {
+		global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_RETRY);
+		error = mc_retry_configure(
+				global_option_args[GLOBAL_OPT_RETRY]);
+		if (error < 0) {
+			print_try_help();
+			goto out;
+		}
+	}
+
+	/*
+	 * -d and -s only go with a command, checked below
+	 */
+	params.debug = restool.debug ||
+		       (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_DEBUG));
+	params.script = global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_SCRIPT);
+	params.offline = !talk_to_mc;
+	DEBUG_PRINTF("talk_to_mc = %d\n", talk_to_mc);
+	error = restool_ctx_create(&params, &ctx);
+	if (error < 0)
+		goto out;
+
+	if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_DAEMON)) {
+		const char *path;
+
+		global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_DAEMON);
+		if (next_argv_index != argc || global_option_mask &
+		    ~(ONE_BIT_MASK(GLOBAL_OPT_DEBUG) |
+		      ONE_BIT_MASK(GLOBAL_OPT_SCRIPT))) {
+			ERROR_PRINTF("--daemon takes no command\n");
+			print_try_help();
+			error = -EINVAL;
+			goto out;
+		}
+
+		global_option_mask = 0;
+		path = restoold_socket_path(
+				global_option_args[GLOBAL_OPT_DAEMON]);
+		if (path == NULL) {
+			ERROR_PRINTF("No restoold socket\n");
+			error = -EINVAL;
+			goto out;
+		}
+
+		error = restoold_serve(ctx, path);
+	} else if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_BATCH)) {
+		global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_BATCH);
+		if (next_argv_index != argc || global_option_mask &
+		    ~(ONE_BIT_MASK(GLOBAL_OPT_DEBUG) |
+		      ONE_BIT_MASK(GLOBAL_OPT_SCRIPT))) {
+			ERROR_PRINTF("--batch takes no command\n");
+			print_try_help();
+			error = -EINVAL;
+			goto out;
+		}
+
+		global_option_mask = 0;
+		error = run_batch(ctx, global_option_args[GLOBAL_OPT_BATCH]);
+	} else if (next_argv_index == argc) {
+		if (global_option_mask == 0) {
+			ERROR_PRINTF("Incomplete command line\n");
+			print_try_help();
+			error = -EINVAL;
+			goto out;
+		}
+
+		if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_HELP))
+			print_usage();	/* print help message */
+
+		if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_VERSION))
+			print_version();
+
+		if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_MC_VERSION))
+			print_mc_version(ctx);
+
+		if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_DEBUG)) {
+			global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_DEBUG);
+			print_try_help();
+			error = -EINVAL;
+			goto out;
+		}
+
+		if (global_option_mask & ONE_BIT_MASK(GLOBAL_OPT_SCRIPT)) {
+			global_option_mask &= ~ONE_BIT_MASK(GLOBAL_OPT_SCRIPT);
+			print_try_help();
+			error = -EINVAL;
+			goto out;
+		}
+
+		if (global_option_mask != 0) {
+			print_unexpected_options_error(global_option_mask,
+						       global_options);
+			error = -EINVAL;
+		}
+	} else {
+		global_option_mask &= ~(ONE_BIT_MASK(GLOBAL_OPT_DEBUG) |
+					ONE_BIT_MASK(GLOBAL_OPT_SCRIPT));
+		if (global_option_mask != 0) {
+			print_unexpected_options_error(global_option_mask,
+						       global_options);
+			print_try_help();
+			error = -EINVAL;
+			goto out;
+		}
+
+		error = restool_ctx_run(ctx, argc - next_argv_index,
+					&argv[next_argv_index]);
+	}
+out:
+	if (mc_stats_enabled()) {
+		mc_stats_print(stderr, mc_stats_json);
+		mc_stats_cleanup();
+	}
+
+	if (ctx != NULL) {
+		int error2;
+
+		error2 = restool_ctx_destroy(ctx);
+		if (error == 0)
+			error = error2;
+	}
+
+	mc_trace_close();
+	return error;
+}
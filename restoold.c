@@ -0,0 +1,536 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "restool.h"
+#include "restoold.h"
+#include "utils.h"
+
+/**
+ * Number of file descriptors passed with each request: stdin, stdout and
+ * stderr of the client
+ */
+#define RESTOOLD_NUM_FDS	3
+
+/**
+ * Set by SIGINT and SIGTERM, for restoold to stop
+ */
+static volatile sig_atomic_t restoold_stopped;
+
+static void restoold_stop_handler(int signum)
+{
+	(void)signum;
+	restoold_stopped = 1;
+}
+
+/**
+ * Socket of restoold: 'path_arg' if given, else $RESTOOL_SOCKET, else the
+ * default one. Returns NULL if forwarding to restoold is turned off.
+ */
+const char *restoold_socket_path(const char *path_arg)
+{
+	const char *path = path_arg;
+
+	if (path == NULL)
+		path = getenv(RESTOOLD_SOCKET_ENV);
+
+	if (path == NULL)
+		return RESTOOLD_SOCKET_PATH;
+
+	if (path[0] == '\0' || strcmp(path, "off") == 0)
+		return NULL;
+
+	return path;
+}
+
+static int restoold_addr(const char *path, struct sockaddr_un *addr)
+{
+	memset(addr, 0, sizeof(*addr));
+	addr->sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(addr->sun_path)) {
+		ERROR_PRINTF("restoold socket path too long: %s\n", path);
+		return -ENAMETOOLONG;
+	}
+
+	strcpy(addr->sun_path, path);
+	return 0;
+}
+
+static int read_full(int fd, void *buf, size_t size)
+{
+	size_t done = 0;
+
+	while (done < size) {
+		ssize_t n = read(fd, (char *)buf + done, size - done);
+
+		if (n == 0)
+			return -EPIPE;
+
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+
+			return -errno;
+		}
+
+		done += n;
+	}
+
+	return 0;
+}
+
+static int write_full(int fd, const void *buf, size_t size)
+{
+	size_t done = 0;
+
+	while (done < size) {
+		ssize_t n = write(fd, (const char *)buf + done, size - done);
+
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+
+			return -errno;
+		}
+
+		done += n;
+	}
+
+	return 0;
+}
+
+/**
+ * Have the command of a client run by restoold. Returns -ENOTCONN if no
+ * restoold listens on 'path', for the caller to run the command itself;
+ * otherwise 0 and the value the command returned in 'cmd_error', or a
+ * negative error code if restoold could not be talked to.
+ */
+int restoold_forward(const char *path, uint32_t flags, int argc,
+		     char *argv[], int *cmd_error)
+{
+	union {
+		struct cmsghdr align;
+		char buf[CMSG_SPACE(RESTOOLD_NUM_FDS * sizeof(int))];
+	} control;
+	static const int fds[RESTOOLD_NUM_FDS] = {
+		STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO
+	};
+	struct restoold_request request;
+	struct restoold_reply reply;
+	struct sockaddr_un addr;
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	struct iovec iov;
+	size_t args_size = 0;
+	char *args = NULL;
+	int sock;
+	int error;
+
+	if (argc > RESTOOLD_MAX_ARGC)
+		return -ENOTCONN;
+
+	for (int i = 0; i < argc; i++)
+		args_size += strlen(argv[i]) + 1;
+
+	if (args_size > RESTOOLD_MAX_ARGS_SIZE)
+		return -ENOTCONN;
+
+	error = restoold_addr(path, &addr);
+	if (error < 0)
+		return error;
+
+	sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (sock < 0) {
+		error = -errno;
+		ERROR_PRINTF("socket() failed (error %d)\n", error);
+		return error;
+	}
+
+	if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		DEBUG_PRINTF("no restoold at %s (errno %d)\n", path, errno);
+		error = -ENOTCONN;
+		goto out;
+	}
+
+	args = malloc(args_size);
+	if (args == NULL) {
+		ERROR_PRINTF("malloc() failed\n");
+		error = -ENOMEM;
+		goto out;
+	}
+
+	args_size = 0;
+	for (int i = 0; i < argc; i++) {
+		size_t len = strlen(argv[i]) + 1;
+
+		memcpy(&args[args_size], argv[i], len);
+		args_size += len;
+	}
+
+	memset(&request, 0, sizeof(request));
+	memcpy(request.magic, RESTOOLD_MAGIC, sizeof(request.magic));
+	request.flags = flags;
+	request.argc = argc;
+	request.args_size = args_size;
+
+	iov.iov_base = &request;
+	iov.iov_len = sizeof(request);
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control.buf;
+	msg.msg_controllen = sizeof(control.buf);
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+	memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+	if (sendmsg(sock, &msg, 0) != (ssize_t)sizeof(request)) {
+		error = -errno;
+		goto io_error;
+	}
+
+	error = write_full(sock, args, args_size);
+	if (error < 0)
+		goto io_error;
+
+	error = read_full(sock, &reply, sizeof(reply));
+	if (error < 0)
+		goto io_error;
+
+	if (memcmp(reply.magic, RESTOOLD_MAGIC, sizeof(reply.magic)) != 0) {
+		ERROR_PRINTF("Invalid reply from restoold at %s\n", path);
+		error = -EPROTO;
+		goto out;
+	}
+
+	DEBUG_PRINTF("restoold at %s ran the command (error %d)\n", path,
+		     reply.error);
+	*cmd_error = reply.error;
+	goto out;
+io_error:
+	ERROR_PRINTF("Talking to restoold at %s failed (error %d)\n", path,
+		     error);
+out:
+	free(args);
+	(void)close(sock);
+	return error;
+}
+
+/**
+ * Receive the request of a client, along with its file descriptors, and
+ * split its arguments into 'argv'
+ */
+static int receive_request(int sock, struct restoold_request *request,
+			   int fds[RESTOOLD_NUM_FDS], char **args,
+			   char *argv[RESTOOLD_MAX_ARGC + 1])
+{
+	union {
+		struct cmsghdr align;
+		char buf[CMSG_SPACE(RESTOOLD_NUM_FDS * sizeof(int))];
+	} control;
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	struct iovec iov;
+	uint32_t argc = 0;
+	ssize_t n;
+	int error;
+
+	iov.iov_base = request;
+	iov.iov_len = sizeof(*request);
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control.buf;
+	msg.msg_controllen = sizeof(control.buf);
+	n = recvmsg(sock, &msg, MSG_WAITALL);
+	if (n < 0)
+		return -errno;
+
+	cmsg = CMSG_FIRSTHDR(&msg);
+	if (cmsg == NULL || cmsg->cmsg_level != SOL_SOCKET ||
+	    cmsg->cmsg_type != SCM_RIGHTS ||
+	    cmsg->cmsg_len != CMSG_LEN(RESTOOLD_NUM_FDS * sizeof(int)))
+		return -EPROTO;
+
+	memcpy(fds, CMSG_DATA(cmsg), RESTOOLD_NUM_FDS * sizeof(int));
+	if (n != (ssize_t)sizeof(*request) ||
+	    memcmp(request->magic, RESTOOLD_MAGIC,
+		   sizeof(request->magic)) != 0 ||
+	    request->argc == 0 || request->argc > RESTOOLD_MAX_ARGC ||
+	    request->args_size == 0 ||
+	    request->args_size > RESTOOLD_MAX_ARGS_SIZE)
+		return -EPROTO;
+
+	*args = malloc(request->args_size);
+	if (*args == NULL)
+		return -ENOMEM;
+
+	error = read_full(sock, *args, request->args_size);
+	if (error < 0)
+		return error;
+
+	if ((*args)[request->args_size - 1] != '\0')
+		return -EPROTO;
+
+	for (uint32_t i = 0; i < request->args_size; i++) {
+		if (i == 0 || (*args)[i - 1] == '\0') {
+			if (argc == request->argc)
+				return -EPROTO;
+
+			argv[argc++] = &(*args)[i];
+		}
+	}
+
+	if (argc != request->argc)
+		return -EPROTO;
+
+	argv[argc] = NULL;
+	return 0;
+}
+
+/**
+ * Run the command of a client with the client's stdin, stdout and stderr
+ * standing in for restoold's own
+ */
+static int run_request(const struct restoold_request *request,
+		       const int fds[RESTOOLD_NUM_FDS], char *argv[],
+		       const int saved_fds[RESTOOLD_NUM_FDS])
+{
+	bool debug = restool.debug;
+	int error;
+
+	fflush(stdout);
+	fflush(stderr);
+	for (int i = 0; i < RESTOOLD_NUM_FDS; i++)
+		(void)dup2(fds[i], i);
+
+	restool.debug = debug || (request->flags & RESTOOLD_FLAG_DEBUG);
+	restool_cmd.script = (request->flags & RESTOOLD_FLAG_SCRIPT) != 0;
+
+	/*
+	 * dprc watch never ends on its own and would hold up every other
+	 * client: clients run it themselves
+	 */
+	if (request->argc >= 2 && strcmp(argv[1], "watch") == 0) {
+		ERROR_PRINTF("dprc watch is not run by restoold\n");
+		error = -EINVAL;
+		goto out;
+	}
+
+	/*
+	 * The MC may have changed since the previous command
+	 */
+	age_topology();
+	error = run_obj_command(request->argc, argv);
+
+	/*
+	 * Objects may be destroyed behind restoold's back: only container
+	 * tokens, checked along with the topology snapshot, are kept
+	 */
+	(void)mc_handle_flush(&restool.handles, "dprc");
+out:
+	fflush(stdout);
+	fflush(stderr);
+	for (int i = 0; i < RESTOOLD_NUM_FDS; i++)
+		(void)dup2(saved_fds[i], i);
+
+	restool.debug = debug;
+	return error;
+}
+
+static void serve_client(int sock, const int saved_fds[RESTOOLD_NUM_FDS])
+{
+	struct restoold_request request;
+	struct restoold_reply reply;
+	int fds[RESTOOLD_NUM_FDS] = { -1, -1, -1 };
+	char *argv[RESTOOLD_MAX_ARGC + 1];
+	char *args = NULL;
+	int error;
+
+	error = receive_request(sock, &request, fds, &args, argv);
+	if (error < 0) {
+		DEBUG_PRINTF("invalid restoold request (error %d)\n", error);
+		goto out;
+	}
+
+	memset(&reply, 0, sizeof(reply));
+	memcpy(reply.magic, RESTOOLD_MAGIC, sizeof(reply.magic));
+	reply.error = run_request(&request, fds, argv, saved_fds);
+	error = write_full(sock, &reply, sizeof(reply));
+	if (error < 0)
+		DEBUG_PRINTF("restoold reply failed (error %d)\n", error);
+out:
+	for (int i = 0; i < RESTOOLD_NUM_FDS; i++) {
+		if (fds[i] >= 0)
+			(void)close(fds[i]);
+	}
+
+	free(args);
+}
+
+static int serve(const char *path)
+{
+	struct sockaddr_un addr;
+	struct sigaction action;
+	struct sigaction old_int_action;
+	struct sigaction old_term_action;
+	struct sigaction old_pipe_action;
+	const struct topology *topo;
+	int saved_fds[RESTOOLD_NUM_FDS] = { -1, -1, -1 };
+	char dir[PATH_MAX];
+	char *slash;
+	int listen_sock;
+	int error;
+
+	error = restoold_addr(path, &addr);
+	if (error < 0)
+		return error;
+
+	strcpy(dir, path);
+	slash = strrchr(dir, '/');
+	if (slash != NULL && slash != dir) {
+		*slash = '\0';
+		if (mkdir(dir, 0755) == -1 && errno != EEXIST) {
+			error = -errno;
+			ERROR_PRINTF("mkdir(%s) failed (error %d)\n", dir,
+				     error);
+			return error;
+		}
+	}
+
+	listen_sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listen_sock < 0) {
+		error = -errno;
+		ERROR_PRINTF("socket() failed (error %d)\n", error);
+		return error;
+	}
+
+	/*
+	 * A socket left behind by a restoold that did not exit cleanly
+	 */
+	(void)unlink(path);
+	if (bind(listen_sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    chmod(path, 0600) < 0 || listen(listen_sock, 64) < 0) {
+		error = -errno;
+		ERROR_PRINTF("Listening on %s failed (error %d)\n", path,
+			     error);
+		(void)close(listen_sock);
+		return error;
+	}
+
+	for (int i = 0; i < RESTOOLD_NUM_FDS; i++) {
+		saved_fds[i] = dup(i);
+		if (saved_fds[i] < 0) {
+			error = -errno;
+			ERROR_PRINTF("dup() failed (error %d)\n", error);
+			goto out;
+		}
+	}
+
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = restoold_stop_handler;
+	sigemptyset(&action.sa_mask);
+	restoold_stopped = 0;
+	(void)sigaction(SIGINT, &action, &old_int_action);
+	(void)sigaction(SIGTERM, &action, &old_term_action);
+
+	/*
+	 * Clients going away must not kill restoold
+	 */
+	action.sa_handler = SIG_IGN;
+	(void)sigaction(SIGPIPE, &action, &old_pipe_action);
+
+	/*
+	 * Take the snapshot of the container tree upfront: commands are
+	 * served from it, checked against the MC, rather than from walks
+	 */
+	error = get_topology(&topo);
+	put_topology();
+	if (error < 0)
+		goto out_signals;
+
+	DEBUG_PRINTF("restoold listening on %s\n", path);
+	while (!restoold_stopped) {
+		int sock = accept(listen_sock, NULL, NULL);
+
+		if (sock < 0) {
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+
+			error = -errno;
+			ERROR_PRINTF("accept() failed (error %d)\n", error);
+			break;
+		}
+
+		serve_client(sock, saved_fds);
+		(void)close(sock);
+	}
+
+out_signals:
+	(void)sigaction(SIGPIPE, &old_pipe_action, NULL);
+	(void)sigaction(SIGTERM, &old_term_action, NULL);
+	(void)sigaction(SIGINT, &old_int_action, NULL);
+out:
+	for (int i = 0; i < RESTOOLD_NUM_FDS; i++) {
+		if (saved_fds[i] >= 0)
+			(void)close(saved_fds[i]);
+	}
+
+	(void)unlink(path);
+	(void)close(listen_sock);
+	return error;
+}
+
+/**
+ * Serve the commands of restool clients on Unix socket 'path', one at a
+ * time, until SIGINT or SIGTERM. The MC portal, root DPRC, handle cache
+ * and topology snapshot of context 'ctx' are shared by all commands.
+ */
+int restoold_serve(struct restool_ctx *ctx, const char *path)
+{
+	struct restool_ctx *prev_ctx;
+	int error;
+
+	prev_ctx = restool_ctx_switch(ctx);
+	error = serve(path);
+	(void)restool_ctx_switch(prev_ctx);
+	return error;
+}
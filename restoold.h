@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _RESTOOLD_H
+#define _RESTOOLD_H
+
+#include <stdint.h>
+
+struct restool_ctx;
+
+/**
+ * Environment variable overriding the restoold socket, "off" to never
+ * forward commands to restoold, and default socket
+ */
+#define RESTOOLD_SOCKET_ENV	"RESTOOL_SOCKET"
+#define RESTOOLD_SOCKET_PATH	"/run/restool/restoold.sock"
+
+/**
+ * restoold protocol, over a Unix stream socket, in host byte order: for
+ * each command, the client sends one struct restoold_request, along with
+ * its stdin, stdout and stderr file descriptors as SCM_RIGHTS ancillary
+ * data, followed by 'args_size' bytes holding the 'argc' null terminated
+ * arguments of the command (<object-type> <command> [ARGS...]).
+ * restoold runs the command with its output going to the client's file
+ * descriptors and answers with one struct restoold_reply.
+ */
+#define RESTOOLD_MAGIC		"RSTLD001"
+#define RESTOOLD_MAX_ARGC	256
+#define RESTOOLD_MAX_ARGS_SIZE	65536
+
+/**
+ * restoold_request flags, for the global options applying to one command
+ */
+#define RESTOOLD_FLAG_DEBUG	0x00000001
+#define RESTOOLD_FLAG_SCRIPT	0x00000002
+
+struct restoold_request {
+	char magic[8];
+	uint32_t flags;
+	uint32_t argc;
+	uint32_t args_size;
+	uint32_t reserved;
+};
+
+struct restoold_reply {
+	char magic[8];
+
+	/**
+	 * value the command returned: 0 or a negative error code
+	 */
+	int32_t error;
+	uint32_t reserved;
+};
+
+const char *restoold_socket_path(const char *path_arg);
+
+int restoold_serve(struct restool_ctx *ctx, const char *path);
+
+int restoold_forward(const char *path, uint32_t flags, int argc,
+		     char *argv[], int *cmd_error);
+
+#endif /* _RESTOOLD_H */
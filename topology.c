@@ -0,0 +1,930 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "topology.h"
+#include "restool.h"
+#include "utils.h"
+
+#define TOPOLOGY_CACHE_MAGIC	"rstopo3"
+
+/**
+ * struct topology_cache_header - header of a topology cache file
+ *
+ * The header is followed by the 'num_objs' objects of the snapshot and by
+ * its object and label hash indexes of 'index_size' entries each, laid out
+ * as in memory, so that a mapped cache file can be used as is.
+ */
+struct topology_cache_header {
+	char magic[8];
+	uint32_t obj_size;
+	uint32_t root_dprc_id;
+	uint32_t num_objs;
+	uint32_t index_size;
+};
+
+static unsigned int hash_obj(const char *obj_type, uint32_t obj_id)
+{
+	uint32_t hash = 2166136261u;	/* FNV-1a */
+
+	for (const char *c = obj_type; *c != '\0'; c++)
+		hash = (hash ^ (uint8_t)*c) * 16777619u;
+
+	for (int i = 0; i < 4; i++)
+		hash = (hash ^ ((obj_id >> (i * 8)) & 0xff)) * 16777619u;
+
+	return hash;
+}
+
+static unsigned int hash_label(const char *label)
+{
+	uint32_t hash = 2166136261u;	/* FNV-1a */
+
+	for (int i = 0; i < MC_OBJ_LABEL_MAX_LENGTH && label[i] != '\0'; i++)
+		hash = (hash ^ (uint8_t)label[i]) * 16777619u;
+
+	return hash;
+}
+
+static int add_obj(struct topology *topo, const struct dprc_obj_desc *desc,
+		   int parent, int depth)
+{
+	struct topology_obj *obj;
+	int idx;
+
+	if (topo->num_objs == topo->max_objs) {
+		int max_objs = topo->max_objs != 0 ? topo->max_objs * 2 : 64;
+		struct topology_obj *objs;
+
+		objs = realloc(topo->objs, max_objs * sizeof(*objs));
+		if (objs == NULL) {
+			ERROR_PRINTF("realloc() failed\n");
+			return -ENOMEM;
+		}
+
+		topo->objs = objs;
+		topo->max_objs = max_objs;
+	}
+
+	idx = topo->num_objs++;
+	obj = &topo->objs[idx];
+	obj->desc = *desc;
+	obj->parent = parent;
+	obj->first_child = -1;
+	obj->next_sibling = -1;
+	obj->depth = depth;
+	return idx;
+}
+
+/**
+ * struct topology_walk - how a walk reaches the MC
+ *
+ * The main walk goes through restool's MC portal, with its handle cache and
+ * portal pool. Subtrees walked by portal pool workers go through the
+ * worker's own portal, on which restool's handles are not valid.
+ */
+struct topology_walk {
+	struct fsl_mc_io *mc_io;
+	bool main_portal;
+	const struct topology *prev;
+};
+
+static int walk_open_dprc(const struct topology_walk *walk, uint32_t dprc_id,
+			  uint16_t *dprc_handle)
+{
+	int error;
+
+	if (walk->main_portal)
+		return open_dprc(dprc_id, dprc_handle);
+
+	error = dprc_open(walk->mc_io, 0, dprc_id, dprc_handle);
+	if (error == 0 && *dprc_handle == 0) {
+		(void)dprc_close(walk->mc_io, 0, *dprc_handle);
+		error = -ENOENT;
+	}
+
+	return error;
+}
+
+static int walk_close_dprc(const struct topology_walk *walk,
+			   uint16_t dprc_handle)
+{
+	if (walk->main_portal)
+		return close_dprc(dprc_handle);
+
+	return dprc_close(walk->mc_io, 0, dprc_handle);
+}
+
+static int walk_get_obj_descs(const struct topology_walk *walk,
+			      uint32_t dprc_id, uint16_t dprc_handle,
+			      struct dprc_obj_desc **obj_descs, int *num_objs)
+{
+	struct dprc_obj_desc *descs = NULL;
+	int num_child_devices;
+	int error;
+
+	if (walk->main_portal)
+		return get_dprc_obj_descs(dprc_id, dprc_handle, obj_descs,
+					  num_objs);
+
+	error = dprc_get_obj_count(walk->mc_io, 0, dprc_handle,
+				   &num_child_devices);
+	if (error < 0)
+		return error;
+
+	if (num_child_devices > 0) {
+		descs = calloc(num_child_devices, sizeof(*descs));
+		if (descs == NULL) {
+			ERROR_PRINTF("calloc() failed\n");
+			return -ENOMEM;
+		}
+
+		error = dprc_get_objs(walk->mc_io, 0, dprc_handle, 0,
+				      num_child_devices, descs);
+		if (error < 0) {
+			free(descs);
+			return error;
+		}
+	}
+
+	*obj_descs = descs;
+	*num_objs = num_child_devices;
+	return 0;
+}
+
+static int count_children(const struct topology *topo, int dprc_idx)
+{
+	int n = 0;
+
+	for (int i = topo->objs[dprc_idx].first_child; i >= 0;
+	     i = topo->objs[i].next_sibling)
+		n++;
+
+	return n;
+}
+
+static bool obj_desc_equal(const struct dprc_obj_desc *desc1,
+			   const struct dprc_obj_desc *desc2)
+{
+	return strncmp(desc1->type, desc2->type, sizeof(desc1->type)) == 0 &&
+	       desc1->id == desc2->id &&
+	       desc1->vendor == desc2->vendor &&
+	       desc1->ver_major == desc2->ver_major &&
+	       desc1->ver_minor == desc2->ver_minor &&
+	       desc1->irq_count == desc2->irq_count &&
+	       desc1->region_count == desc2->region_count &&
+	       desc1->state == desc2->state &&
+	       strncmp(desc1->label, desc2->label, sizeof(desc1->label)) == 0;
+}
+
+/**
+ * Tell if container 'dprc_idx' changed since the previous snapshot: unknown
+ * to it, or holding other objects than 'obj_descs', in another order or
+ * with other descriptors. Any object added, removed, replaced, plugged,
+ * unplugged or relabeled counts as a change.
+ */
+static bool container_changed(const struct topology *topo, int dprc_idx,
+			      const struct topology *prev,
+			      const struct dprc_obj_desc *obj_descs,
+			      int num_objs)
+{
+	int prev_idx;
+	int i = 0;
+
+	if (prev == NULL)
+		return true;
+
+	prev_idx = topology_lookup(prev, "dprc", topo->objs[dprc_idx].desc.id);
+	if (prev_idx < 0 || count_children(prev, prev_idx) != num_objs)
+		return true;
+
+	for (int j = prev->objs[prev_idx].first_child; j >= 0;
+	     j = prev->objs[j].next_sibling) {
+		if (!obj_desc_equal(&prev->objs[j].desc, &obj_descs[i++]))
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Get the descriptors of the objects held by container 'dprc_idx' from the
+ * MC, and tell from them whether the container changed since the previous
+ * snapshot. The MC offers no change counter that restool could read
+ * instead: DPRC IRQ status bits are cleared by the kernel DPRC driver, and
+ * moving, relabeling or replacing objects keeps the number of objects.
+ */
+static int get_container_objs(struct topology *topo, int dprc_idx,
+			      uint16_t dprc_handle,
+			      const struct topology_walk *walk,
+			      struct dprc_obj_desc **obj_descs, int *num_objs)
+{
+	uint32_t dprc_id = topo->objs[dprc_idx].desc.id;
+	int error;
+
+	if (topo->objs[dprc_idx].depth >= MAX_DPRC_NESTING) {
+		ERROR_PRINTF("dprc.%u nested too deep\n", dprc_id);
+		return -ELOOP;
+	}
+
+	error = walk_get_obj_descs(walk, dprc_id, dprc_handle, obj_descs,
+				   num_objs);
+	if (error < 0)
+		return error;
+
+	if (container_changed(topo, dprc_idx, walk->prev, *obj_descs,
+			      *num_objs))
+		topo->num_changed++;
+
+	return 0;
+}
+
+static void link_child(struct topology *topo, int dprc_idx, int *last_child,
+		       int idx)
+{
+	if (*last_child < 0)
+		topo->objs[dprc_idx].first_child = idx;
+	else
+		topo->objs[*last_child].next_sibling = idx;
+
+	*last_child = idx;
+}
+
+/**
+ * Append the objects of container 'dprc_idx' to the snapshot, each nested
+ * container being followed by its own objects
+ */
+static int add_container(struct topology *topo, int dprc_idx,
+			 uint16_t dprc_handle,
+			 const struct topology_walk *walk)
+{
+	int depth = topo->objs[dprc_idx].depth + 1;
+	struct dprc_obj_desc *obj_descs = NULL;
+	int num_child_devices;
+	int last_child = -1;
+	int error;
+
+	error = get_container_objs(topo, dprc_idx, dprc_handle, walk,
+				   &obj_descs, &num_child_devices);
+	if (error < 0)
+		goto out;
+
+	for (int i = 0; i < num_child_devices; i++) {
+		struct dprc_obj_desc *obj_desc = &obj_descs[i];
+		uint16_t child_dprc_handle;
+		int error2;
+		int idx;
+
+		idx = add_obj(topo, obj_desc, dprc_idx, depth);
+		if (idx < 0) {
+			error = idx;
+			goto out;
+		}
+
+		link_child(topo, dprc_idx, &last_child, idx);
+		if (strcmp(obj_desc->type, "dprc") != 0)
+			continue;
+
+		error = walk_open_dprc(walk, obj_desc->id, &child_dprc_handle);
+		if (error < 0)
+			goto out;
+
+		error = add_container(topo, idx, child_dprc_handle, walk);
+		error2 = walk_close_dprc(walk, child_dprc_handle);
+		if (error == 0)
+			error = error2;
+
+		if (error < 0)
+			goto out;
+	}
+
+out:
+	free(obj_descs);
+	return error;
+}
+
+/**
+ * struct subtree_job - child containers of the root DPRC, each walked into
+ * its own snapshot by a portal pool worker
+ */
+struct subtree_job {
+	const struct topology *prev;
+	int num_subtrees;
+	struct topology *subtrees;
+};
+
+/**
+ * mc_pool work function: take the snapshot of one child container subtree
+ * through the worker's own MC portal. The subtree's object 0, the child
+ * container itself, is set up by the caller.
+ */
+static int walk_subtree(struct fsl_mc_io *mc_io, int item, void *arg)
+{
+	struct subtree_job *job = arg;
+	struct topology *subtree = &job->subtrees[item];
+	struct topology_walk walk = {
+		.mc_io = mc_io,
+		.main_portal = false,
+		.prev = job->prev,
+	};
+	uint16_t dprc_handle;
+	int error;
+	int error2;
+
+	error = walk_open_dprc(&walk, subtree->objs[0].desc.id, &dprc_handle);
+	if (error < 0)
+		return error;
+
+	error = add_container(subtree, 0, dprc_handle, &walk);
+	error2 = walk_close_dprc(&walk, dprc_handle);
+	if (error == 0)
+		error = error2;
+
+	return error;
+}
+
+/**
+ * Append subtree snapshot 'subtree', whose object 0 is a child of
+ * container 'dprc_idx', to the snapshot
+ */
+static int splice_subtree(struct topology *topo, int dprc_idx,
+			  int *last_child, const struct topology *subtree)
+{
+	int base = topo->num_objs;
+
+	for (int i = 0; i < subtree->num_objs; i++) {
+		const struct topology_obj *sub_obj = &subtree->objs[i];
+		struct topology_obj *obj;
+		int idx;
+
+		idx = add_obj(topo, &sub_obj->desc, 0, sub_obj->depth);
+		if (idx < 0)
+			return idx;
+
+		obj = &topo->objs[idx];
+		*obj = *sub_obj;
+		obj->parent = i == 0 ? dprc_idx : sub_obj->parent + base;
+		if (sub_obj->first_child >= 0)
+			obj->first_child += base;
+
+		if (sub_obj->next_sibling >= 0)
+			obj->next_sibling += base;
+	}
+
+	link_child(topo, dprc_idx, last_child, base);
+	topo->num_changed += subtree->num_changed;
+	return 0;
+}
+
+/**
+ * Append the objects of the root DPRC to the snapshot, the subtrees of its
+ * child containers being walked in parallel by the portal pool workers and
+ * then appended in order, so that the snapshot is the same as the one a
+ * sequential walk would give.
+ */
+static int add_root_container_parallel(struct topology *topo,
+				       uint16_t dprc_handle,
+				       const struct topology_walk *walk)
+{
+	struct subtree_job job = {
+		.prev = walk->prev,
+	};
+	struct dprc_obj_desc *obj_descs = NULL;
+	int *errors = NULL;
+	int num_child_devices;
+	int last_child = -1;
+	int sub = 0;
+	int error;
+
+	error = get_container_objs(topo, 0, dprc_handle, walk, &obj_descs,
+				   &num_child_devices);
+	if (error < 0)
+		goto out;
+
+	for (int i = 0; i < num_child_devices; i++) {
+		if (strcmp(obj_descs[i].type, "dprc") == 0)
+			job.num_subtrees++;
+	}
+
+	if (job.num_subtrees > 0) {
+		job.subtrees = calloc(job.num_subtrees,
+				      sizeof(job.subtrees[0]));
+		errors = calloc(job.num_subtrees, sizeof(errors[0]));
+		if (job.subtrees == NULL || errors == NULL) {
+			ERROR_PRINTF("calloc() failed\n");
+			error = -ENOMEM;
+			goto out;
+		}
+	}
+
+	for (int i = 0; i < num_child_devices; i++) {
+		if (strcmp(obj_descs[i].type, "dprc") != 0)
+			continue;
+
+		error = add_obj(&job.subtrees[sub++], &obj_descs[i], -1, 1);
+		if (error < 0)
+			goto out;
+	}
+
+	if (job.num_subtrees > 0) {
+		error = mc_pool_run(&restool.mc_pool, walk_subtree,
+				    job.num_subtrees, &job, errors);
+		if (error < 0)
+			goto out;
+	}
+
+	sub = 0;
+	for (int i = 0; i < num_child_devices; i++) {
+		int idx;
+
+		if (strcmp(obj_descs[i].type, "dprc") == 0) {
+			error = splice_subtree(topo, 0, &last_child,
+					       &job.subtrees[sub++]);
+			if (error < 0)
+				goto out;
+
+			continue;
+		}
+
+		idx = add_obj(topo, &obj_descs[i], 0, 1);
+		if (idx < 0) {
+			error = idx;
+			goto out;
+		}
+
+		link_child(topo, 0, &last_child, idx);
+	}
+
+	error = 0;
+out:
+	for (int i = 0; i < job.num_subtrees && job.subtrees != NULL; i++)
+		topology_free(&job.subtrees[i]);
+
+	free(job.subtrees);
+	free(errors);
+	free(obj_descs);
+	return error;
+}
+
+static int build_index(struct topology *topo)
+{
+	unsigned int size = 16;
+
+	while (size < (unsigned int)topo->num_objs * 2)
+		size *= 2;
+
+	/*
+	 * both indexes in one allocation, as in the cache file
+	 */
+	topo->index = calloc(size * 2, sizeof(topo->index[0]));
+	if (topo->index == NULL) {
+		ERROR_PRINTF("calloc() failed\n");
+		return -ENOMEM;
+	}
+
+	topo->index_size = size;
+	topo->label_index = &topo->index[size];
+	for (int i = 0; i < topo->num_objs; i++) {
+		const struct dprc_obj_desc *desc = &topo->objs[i].desc;
+		unsigned int slot = hash_obj(desc->type, desc->id) & (size - 1);
+
+		while (topo->index[slot] != 0)
+			slot = (slot + 1) & (size - 1);
+
+		topo->index[slot] = i + 1;
+		if (desc->label[0] == '\0')
+			continue;
+
+		slot = hash_label(desc->label) & (size - 1);
+		while (topo->label_index[slot] != 0)
+			slot = (slot + 1) & (size - 1);
+
+		topo->label_index[slot] = i + 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Take a snapshot of the container tree under the root DPRC, with one
+ * walk of the MC. Object 0 of the snapshot is the root DPRC itself.
+ * If 'prev' is not NULL, the containers whose objects differ from those
+ * it holds are counted in 'num_changed', for the caller to keep using
+ * 'prev' if there are none.
+ */
+int topology_build(struct topology *topo, uint32_t root_dprc_id,
+		   uint16_t root_dprc_handle, const struct topology *prev)
+{
+	struct topology_walk walk = {
+		.mc_io = &restool.mc_io,
+		.main_portal = true,
+		.prev = prev,
+	};
+	struct dprc_obj_desc root_desc;
+	int error;
+
+	memset(topo, 0, sizeof(*topo));
+	memset(&root_desc, 0, sizeof(root_desc));
+	strcpy(root_desc.type, "dprc");
+	root_desc.id = root_dprc_id;
+	root_desc.state = DPRC_OBJ_STATE_PLUGGED;
+
+	error = add_obj(topo, &root_desc, -1, 0);
+	if (error < 0)
+		goto error;
+
+	/*
+	 * With a portal pool, the subtrees of the root's child containers
+	 * are walked concurrently
+	 */
+	if (restool.mc_pool.num_portals > 0)
+		error = add_root_container_parallel(topo, root_dprc_handle,
+						    &walk);
+	else
+		error = add_container(topo, 0, root_dprc_handle, &walk);
+	if (error < 0)
+		goto error;
+
+	error = build_index(topo);
+	if (error < 0)
+		goto error;
+
+	DEBUG_PRINTF("topology snapshot of %d objects, %d containers changed\n",
+		     topo->num_objs, topo->num_changed);
+	return 0;
+error:
+	topology_free(topo);
+	return error;
+}
+
+/**
+ * Check the snapshot against the MC, with one dprc_get_obj_count() query
+ * per container instead of a walk. Fails with -ESTALE if a container is
+ * gone or holds another number of objects. Objects replaced, relabeled or
+ * plugged without changing the number of objects of their container are
+ * not noticed: the caller marks the snapshot as reused, for lookups to
+ * check the objects they find.
+ */
+int topology_check(const struct topology *topo, uint16_t root_dprc_handle)
+{
+	uint16_t dprc_handle;
+	int num_objs;
+	int error;
+
+	for (int i = 0; i < topo->num_objs; i++) {
+		const struct dprc_obj_desc *desc = &topo->objs[i].desc;
+
+		if (strcmp(desc->type, "dprc") != 0)
+			continue;
+
+		if (i == 0) {
+			dprc_handle = root_dprc_handle;
+		} else {
+			/*
+			 * The container may be gone: no error message
+			 */
+			error = mc_handle_open(&restool.handles, "dprc",
+					       desc->id, dprc_open, dprc_close,
+					       &dprc_handle);
+			if (error < 0)
+				return -ESTALE;
+		}
+
+		error = dprc_get_obj_count(&restool.mc_io, 0, dprc_handle,
+					   &num_objs);
+		if (i != 0)
+			(void)close_dprc(dprc_handle);
+
+		if (error < 0)
+			return error;
+
+		if (num_objs != count_children(topo, i)) {
+			DEBUG_PRINTF("dprc.%u holds %d objects instead of %d\n",
+				     desc->id, num_objs,
+				     count_children(topo, i));
+			return -ESTALE;
+		}
+	}
+
+	return 0;
+}
+
+void topology_free(struct topology *topo)
+{
+	if (topo->map != NULL) {
+		(void)munmap(topo->map, topo->map_size);
+	} else {
+		free(topo->objs);
+		free(topo->index);
+	}
+
+	memset(topo, 0, sizeof(*topo));
+}
+
+/**
+ * Check that the objects of a snapshot mapped from a cache file form the
+ * tree under root DPRC 'root_dprc_id', in depth-first order, with every
+ * link in range and every string terminated
+ */
+static bool cache_objs_valid(const struct topology *topo,
+			     uint32_t root_dprc_id)
+{
+	for (int i = 0; i < topo->num_objs; i++) {
+		const struct topology_obj *obj = &topo->objs[i];
+
+		if (memchr(obj->desc.type, '\0', sizeof(obj->desc.type)) ==
+		    NULL ||
+		    memchr(obj->desc.label, '\0', sizeof(obj->desc.label)) ==
+		    NULL)
+			return false;
+
+		if (i == 0) {
+			if (obj->parent != -1 || obj->depth != 0 ||
+			    (uint32_t)obj->desc.id != root_dprc_id ||
+			    strcmp(obj->desc.type, "dprc") != 0)
+				return false;
+		} else if (obj->parent < 0 || obj->parent >= i ||
+			   strcmp(topo->objs[obj->parent].desc.type,
+				  "dprc") != 0 ||
+			   obj->depth != topo->objs[obj->parent].depth + 1 ||
+			   obj->depth > MAX_DPRC_NESTING) {
+			return false;
+		}
+
+		if (obj->first_child != -1 &&
+		    (obj->first_child <= i ||
+		     obj->first_child >= topo->num_objs ||
+		     topo->objs[obj->first_child].parent != i))
+			return false;
+
+		if (obj->next_sibling != -1 &&
+		    (i == 0 || obj->next_sibling <= i ||
+		     obj->next_sibling >= topo->num_objs ||
+		     topo->objs[obj->next_sibling].parent != obj->parent))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Check that a hash index mapped from a cache file only holds object
+ * indexes in range, and has a free slot for lookups to stop at
+ */
+static bool cache_index_valid(const int *index, unsigned int index_size,
+			      int num_objs)
+{
+	int num_used = 0;
+
+	for (unsigned int slot = 0; slot < index_size; slot++) {
+		if (index[slot] < 0 || index[slot] > num_objs)
+			return false;
+
+		if (index[slot] != 0)
+			num_used++;
+	}
+
+	return num_used <= num_objs;
+}
+
+/**
+ * Map the snapshot saved in cache file 'path'. The snapshot is read-only
+ * and must be released with topology_free(). Fails with -ESTALE if the
+ * file was not written by this version of restool for the same root DPRC,
+ * or if it is truncated or corrupted.
+ */
+int topology_load(struct topology *topo, const char *path,
+		  uint32_t root_dprc_id)
+{
+	const struct topology_cache_header *header;
+	struct stat st;
+	size_t max_objs;
+	size_t size;
+	void *map;
+	int fd;
+	int error;
+
+	fd = open(path, O_RDONLY);
+	if (fd == -1)
+		return -errno;
+
+	if (fstat(fd, &st) == -1) {
+		error = -errno;
+		goto out;
+	}
+
+	if ((size_t)st.st_size < sizeof(*header)) {
+		error = -ESTALE;
+		goto out;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		error = -errno;
+		goto out;
+	}
+
+	/*
+	 * Bound the counts by the file size before computing the size they
+	 * imply, so that it cannot wrap around
+	 */
+	header = map;
+	size = st.st_size - sizeof(*header);
+	max_objs = size / sizeof(struct topology_obj);
+	if (memcmp(header->magic, TOPOLOGY_CACHE_MAGIC,
+		   sizeof(header->magic)) != 0 ||
+	    header->obj_size != sizeof(struct topology_obj) ||
+	    header->root_dprc_id != root_dprc_id ||
+	    header->num_objs == 0 ||
+	    header->num_objs > max_objs ||
+	    header->num_objs > INT_MAX ||
+	    header->index_size <= header->num_objs ||
+	    header->index_size > size / (2 * sizeof(int)) ||
+	    (header->index_size & (header->index_size - 1)) != 0 ||
+	    (size_t)header->num_objs * sizeof(struct topology_obj) +
+	    (size_t)header->index_size * 2 * sizeof(int) != size)
+		goto stale;
+
+	memset(topo, 0, sizeof(*topo));
+	topo->map = map;
+	topo->map_size = st.st_size;
+	topo->objs = (struct topology_obj *)(header + 1);
+	topo->num_objs = header->num_objs;
+	topo->max_objs = header->num_objs;
+	topo->index = (int *)&topo->objs[topo->num_objs];
+	topo->index_size = header->index_size;
+	topo->label_index = &topo->index[topo->index_size];
+	if (!cache_objs_valid(topo, root_dprc_id) ||
+	    !cache_index_valid(topo->index, topo->index_size,
+			       topo->num_objs) ||
+	    !cache_index_valid(topo->label_index, topo->index_size,
+			       topo->num_objs)) {
+		memset(topo, 0, sizeof(*topo));
+		goto stale;
+	}
+
+	error = 0;
+	goto out;
+stale:
+	DEBUG_PRINTF("discarding invalid topology cache %s\n", path);
+	(void)munmap(map, st.st_size);
+	error = -ESTALE;
+out:
+	(void)close(fd);
+	return error;
+}
+
+/**
+ * Save the snapshot to cache file 'path', creating its directory if needed.
+ * The file is replaced atomically, so that concurrent readers either map
+ * the old snapshot or the new one.
+ */
+int topology_save(const struct topology *topo, const char *path,
+		  uint32_t root_dprc_id)
+{
+	struct topology_cache_header header;
+	char tmp_path[PATH_MAX];
+	char *slash;
+	FILE *file;
+	int error = 0;
+
+	if (snprintf(tmp_path, sizeof(tmp_path), "%s", path) >=
+	    (int)sizeof(tmp_path))
+		return -ENAMETOOLONG;
+
+	slash = strrchr(tmp_path, '/');
+	if (slash != NULL && slash != tmp_path) {
+		*slash = '\0';
+		if (mkdir(tmp_path, 0755) == -1 && errno != EEXIST)
+			return -errno;
+	}
+
+	if (snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, getpid()) >=
+	    (int)sizeof(tmp_path))
+		return -ENAMETOOLONG;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TOPOLOGY_CACHE_MAGIC, sizeof(header.magic));
+	header.obj_size = sizeof(struct topology_obj);
+	header.root_dprc_id = root_dprc_id;
+	header.num_objs = topo->num_objs;
+	header.index_size = topo->index_size;
+
+	file = fopen(tmp_path, "w");
+	if (file == NULL)
+		return -errno;
+
+	if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+	    fwrite(topo->objs, sizeof(topo->objs[0]), topo->num_objs,
+		   file) != (size_t)topo->num_objs ||
+	    fwrite(topo->index, sizeof(topo->index[0]),
+		   topo->index_size * 2, file) != topo->index_size * 2)
+		error = -EIO;
+
+	if (fclose(file) != 0 && error == 0)
+		error = -errno;
+
+	if (error == 0 && rename(tmp_path, path) == -1)
+		error = -errno;
+
+	if (error < 0)
+		(void)unlink(tmp_path);
+
+	return error;
+}
+
+/**
+ * Index of object 'obj_type'.'obj_id' in the snapshot, or -1 if the
+ * snapshot does not hold it
+ */
+int topology_lookup(const struct topology *topo, const char *obj_type,
+		    uint32_t obj_id)
+{
+	unsigned int mask = topo->index_size - 1;
+	unsigned int slot;
+
+	if (topo->index_size == 0)
+		return -1;
+
+	slot = hash_obj(obj_type, obj_id) & mask;
+	while (topo->index[slot] != 0) {
+		const struct dprc_obj_desc *desc =
+			&topo->objs[topo->index[slot] - 1].desc;
+
+		if ((uint32_t)desc->id == obj_id &&
+		    strcmp(desc->type, obj_type) == 0)
+			return topo->index[slot] - 1;
+
+		slot = (slot + 1) & mask;
+	}
+
+	return -1;
+}
+
+/**
+ * Find the objects labeled 'label' in the snapshot. Fills 'matches' with
+ * the indexes of up to 'max_matches' of them and returns how many there
+ * are in all.
+ */
+int topology_lookup_label(const struct topology *topo, const char *label,
+			  int *matches, int max_matches)
+{
+	unsigned int mask = topo->index_size - 1;
+	unsigned int slot;
+	int num_matches = 0;
+
+	if (topo->index_size == 0 || label[0] == '\0')
+		return 0;
+
+	slot = hash_label(label) & mask;
+	while (topo->label_index[slot] != 0) {
+		int idx = topo->label_index[slot] - 1;
+
+		if (strncmp(topo->objs[idx].desc.label, label,
+			    MC_OBJ_LABEL_MAX_LENGTH + 1) == 0) {
+			if (num_matches < max_matches)
+				matches[num_matches] = idx;
+
+			num_matches++;
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	return num_matches;
+}
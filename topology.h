@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _TOPOLOGY_H
+#define _TOPOLOGY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fsl_dprc.h"
+
+/**
+ * struct topology_obj - one MC object of a topology snapshot
+ */
+struct topology_obj {
+	struct dprc_obj_desc desc;
+
+	/**
+	 * index of the container holding the object; -1 for the root DPRC
+	 */
+	int parent;
+
+	/**
+	 * first object held by the object if it is a DPRC, and next object
+	 * held by the same container; -1 if none
+	 */
+	int first_child;
+	int next_sibling;
+
+	/**
+	 * nesting level of the object; 0 for the root DPRC
+	 */
+	int depth;
+};
+
+/**
+ * struct topology - snapshot of the whole container tree, taken in one walk
+ *
+ * Objects are stored in depth-first order, each container followed by its
+ * objects in the order the MC reports them, so that walking 'objs' in
+ * order visits the tree the way a recursive walk of the MC would.
+ */
+struct topology {
+	struct topology_obj *objs;
+	int num_objs;
+	int max_objs;
+
+	/**
+	 * open addressing hash index on (type, id): object index + 1 per
+	 * slot, 0 for empty slots. 'index_size' is a power of 2.
+	 */
+	int *index;
+	unsigned int index_size;
+
+	/**
+	 * open addressing hash index on labels, of 'index_size' slots too;
+	 * objects without a label are not indexed
+	 */
+	int *label_index;
+
+	/**
+	 * number of containers whose objects differ from those of the
+	 * previous snapshot the snapshot was built on, or of all containers
+	 * if there was none
+	 */
+	int num_changed;
+
+	/**
+	 * set when the snapshot was reused after only checking the number of
+	 * objects of each container against the MC: the descriptors it holds,
+	 * e.g. labels and states, may be out of date
+	 */
+	bool reused;
+
+	/**
+	 * mapping of the cache file 'objs' and the indexes point into, if the
+	 * snapshot was loaded with topology_load(); NULL otherwise
+	 */
+	void *map;
+	size_t map_size;
+};
+
+int topology_build(struct topology *topo, uint32_t root_dprc_id,
+		   uint16_t root_dprc_handle, const struct topology *prev);
+
+int topology_check(const struct topology *topo, uint16_t root_dprc_handle);
+
+int topology_load(struct topology *topo, const char *path,
+		  uint32_t root_dprc_id);
+
+int topology_save(const struct topology *topo, const char *path,
+		  uint32_t root_dprc_id);
+
+void topology_free(struct topology *topo);
+
+int topology_lookup(const struct topology *topo, const char *obj_type,
+		    uint32_t obj_id);
+
+int topology_lookup_label(const struct topology *topo, const char *label,
+			  int *matches, int max_matches);
+
+#endif /* _TOPOLOGY_H */
@@ -0,0 +1,571 @@
+/*
+ * Copyright (C) 2016 Freescale Semiconductor, Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation  and/or other materials provided with the distribution.
+ * 3. Neither the names of the copyright holders nor the names of any
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include "restool.h"
+#include "utils.h"
+#include "fsl_dpsw.h"
+#include "fsl_dpdmux.h"
+
+/**
+ * topology graph command options
+ */
+enum topology_graph_options {
+	GRAPH_OPT_HELP = 0,
+	GRAPH_OPT_FORMAT,
+};
+
+static struct option topology_graph_options[] = {
+	[GRAPH_OPT_HELP] = {
+		.name = "help",
+		.has_arg = 0,
+		.flag = NULL,
+		.val = 0,
+	},
+
+	[GRAPH_OPT_FORMAT] = {
+		.name = "format",
+		.has_arg = 1,
+		.flag = NULL,
+		.val = 0,
+	},
+
+	{ 0 },
+};
+
+C_ASSERT(ARRAY_SIZE(topology_graph_options) <= MAX_NUM_CMD_LINE_OPTIONS + 1);
+
+/**
+ * struct conn_graph - connections between the interfaces of all the
+ * connectable objects of the container tree
+ */
+struct conn_graph {
+	const struct topology *topo;
+
+	/**
+	 * number of interfaces of each snapshot object, 0 if the object is
+	 * not connectable
+	 */
+	int *num_obj_ifs;
+
+	/**
+	 * interfaces, grouped by object in snapshot order, and the endpoint
+	 * each one is connected to along with the link state: 1 - up,
+	 * 0 - down, -1 - not connected
+	 */
+	int num_ifs;
+	struct dprc_endpoint *endpoints;
+	struct dprc_endpoint *peers;
+	int *states;
+};
+
+struct connections_job {
+	struct conn_graph *graph;
+	int slice_size;
+};
+
+static int cmd_topology_help(void)
+{
+	static const char help_msg[] =
+		"\n"
+		"restool topology <command> [--help] [ARGS...]\n"
+		"Where <command> can be:\n"
+		"   graph - displays the connections between all objects of the container tree.\n"
+		"\n"
+		"For command-specific help, use the --help option of each command.\n"
+		"\n";
+
+	restool_printf(help_msg);
+	return 0;
+}
+
+static void print_mc_error(int error)
+{
+	enum mc_cmd_status mc_status;
+
+	mc_status = flib_error_to_mc_status(error);
+	ERROR_PRINTF("MC error: %s (status %#x)\n",
+		     mc_status_to_string(mc_status), mc_status);
+}
+
+static int get_dpsw_num_ifs(int dpsw_id)
+{
+	struct dpsw_attr dpsw_attr;
+	uint16_t dpsw_handle;
+	int error;
+	int error2;
+
+	error = dpsw_open(&restool.mc_io, 0, dpsw_id, &dpsw_handle);
+	if (error < 0)
+		goto out;
+
+	memset(&dpsw_attr, 0, sizeof(dpsw_attr));
+	error = dpsw_get_attributes(&restool.mc_io, 0, dpsw_handle,
+				    &dpsw_attr);
+	error2 = dpsw_close(&restool.mc_io, 0, dpsw_handle);
+	if (error == 0)
+		error = error2;
+out:
+	if (error < 0) {
+		print_mc_error(error);
+		return error;
+	}
+
+	return dpsw_attr.num_ifs;
+}
+
+static int get_dpdmux_num_ifs(int dpdmux_id)
+{
+	struct dpdmux_attr dpdmux_attr;
+	uint16_t dpdmux_handle;
+	int error;
+	int error2;
+
+	error = dpdmux_open(&restool.mc_io, 0, dpdmux_id, &dpdmux_handle);
+	if (error < 0)
+		goto out;
+
+	memset(&dpdmux_attr, 0, sizeof(dpdmux_attr));
+	error = dpdmux_get_attributes(&restool.mc_io, 0, dpdmux_handle,
+				      &dpdmux_attr);
+	error2 = dpdmux_close(&restool.mc_io, 0, dpdmux_handle);
+	if (error == 0)
+		error = error2;
+out:
+	if (error < 0) {
+		print_mc_error(error);
+		return error;
+	}
+
+	/*
+	 * num_ifs excludes the uplink interface 0
+	 */
+	return dpdmux_attr.num_ifs + 1;
+}
+
+/**
+ * Number of interfaces of an object, 0 if it cannot be connected
+ */
+static int get_num_obj_ifs(const struct dprc_obj_desc *obj_desc)
+{
+	if (strcmp(obj_desc->type, "dpni") == 0 ||
+	    strcmp(obj_desc->type, "dpmac") == 0 ||
+	    strcmp(obj_desc->type, "dpci") == 0)
+		return 1;
+
+	if (strcmp(obj_desc->type, "dpsw") == 0)
+		return get_dpsw_num_ifs(obj_desc->id);
+
+	if (strcmp(obj_desc->type, "dpdmux") == 0)
+		return get_dpdmux_num_ifs(obj_desc->id);
+
+	return 0;
+}
+
+/**
+ * mc_pool work function: get the connections of one slice of the
+ * interfaces, through the worker's own MC portal
+ */
+static int get_connections_slice(struct fsl_mc_io *mc_io, int item,
+				 void *arg)
+{
+	struct connections_job *job = arg;
+	struct conn_graph *graph = job->graph;
+	int first = item * job->slice_size;
+	int n = graph->num_ifs - first;
+	uint16_t dprc_handle;
+	int error;
+	int error2;
+
+	if (n <= 0)
+		return 0;
+
+	if (n > job->slice_size)
+		n = job->slice_size;
+
+	error = dprc_open(mc_io, 0, restool.root_dprc_id, &dprc_handle);
+	if (error < 0)
+		return error;
+
+	error = dprc_get_connections(mc_io, 0, dprc_handle, n,
+				     &graph->endpoints[first],
+				     &graph->peers[first],
+				     &graph->states[first]);
+	error2 = dprc_close(mc_io, 0, dprc_handle);
+	if (error == 0)
+		error = error2;
+
+	return error;
+}
+
+/**
+ * Get the connection of every interface of the graph, spreading the
+ * queries over the MC portal pool if there is one
+ */
+static int get_connections(struct conn_graph *graph)
+{
+	int error;
+
+	if (restool.mc_pool.num_portals > 0 &&
+	    graph->num_ifs > DPRC_GET_OBJS_BATCH_SIZE) {
+		int errors[MC_POOL_MAX_PORTALS];
+		struct connections_job job = {
+			.graph = graph,
+		};
+
+		job.slice_size = (graph->num_ifs +
+				  restool.mc_pool.num_portals - 1) /
+				 restool.mc_pool.num_portals;
+		error = mc_pool_run(&restool.mc_pool, get_connections_slice,
+				    restool.mc_pool.num_portals, &job, errors);
+	} else {
+		error = dprc_get_connections(&restool.mc_io, 0,
+					     restool.root_dprc_handle,
+					     graph->num_ifs, graph->endpoints,
+					     graph->peers, graph->states);
+	}
+
+	if (error < 0)
+		print_mc_error(error);
+
+	return error;
+}
+
+static void free_conn_graph(struct conn_graph *graph)
+{
+	free(graph->states);
+	free(graph->peers);
+	free(graph->endpoints);
+	free(graph->num_obj_ifs);
+}
+
+/**
+ * Enumerate the interfaces of all connectable objects of the container
+ * tree and get their connections
+ */
+static int build_conn_graph(struct conn_graph *graph)
+{
+	const struct topology *topo;
+	int num_ifs;
+	int error;
+	int k;
+
+	memset(graph, 0, sizeof(*graph));
+	error = get_topology(&topo);
+	if (error < 0)
+		return error;
+
+	graph->topo = topo;
+	graph->num_obj_ifs = calloc(topo->num_objs,
+				    sizeof(graph->num_obj_ifs[0]));
+	if (graph->num_obj_ifs == NULL) {
+		ERROR_PRINTF("calloc() failed\n");
+		return -ENOMEM;
+	}
+
+	for (int i = 0; i < topo->num_objs; i++) {
+		num_ifs = get_num_obj_ifs(&topo->objs[i].desc);
+		if (num_ifs < 0) {
+			error = num_ifs;
+			goto error;
+		}
+
+		graph->num_obj_ifs[i] = num_ifs;
+		graph->num_ifs += num_ifs;
+	}
+
+	if (graph->num_ifs == 0)
+		return 0;
+
+	graph->endpoints = calloc(graph->num_ifs, sizeof(graph->endpoints[0]));
+	graph->peers = calloc(graph->num_ifs, sizeof(graph->peers[0]));
+	graph->states = calloc(graph->num_ifs, sizeof(graph->states[0]));
+	if (graph->endpoints == NULL || graph->peers == NULL ||
+	    graph->states == NULL) {
+		ERROR_PRINTF("calloc() failed\n");
+		error = -ENOMEM;
+		goto error;
+	}
+
+	k = 0;
+	for (int i = 0; i < topo->num_objs; i++) {
+		for (int j = 0; j < graph->num_obj_ifs[i]; j++) {
+			struct dprc_endpoint *endpoint = &graph->endpoints[k++];
+
+			strcpy(endpoint->type, topo->objs[i].desc.type);
+			endpoint->id = topo->objs[i].desc.id;
+			endpoint->if_id = j;
+		}
+	}
+
+	error = get_connections(graph);
+	if (error < 0)
+		goto error;
+
+	return 0;
+error:
+	free_conn_graph(graph);
+	return error;
+}
+
+/**
+ * Tell if interface 'i' is the end of a link that must be printed: every
+ * link is seen from both of its ends but is only printed once
+ */
+static bool is_printed_link_end(const struct conn_graph *graph, int i)
+{
+	const struct dprc_endpoint *endpoint = &graph->endpoints[i];
+	const struct dprc_endpoint *peer = &graph->peers[i];
+	int cmp;
+
+	if (graph->states[i] == -1)
+		return false;
+
+	/*
+	 * peers outside of the container tree are only seen from this end
+	 */
+	if (topology_lookup(graph->topo, peer->type, peer->id) < 0)
+		return true;
+
+	cmp = strcmp(endpoint->type, peer->type);
+	if (cmp == 0)
+		cmp = endpoint->id - peer->id;
+	if (cmp == 0)
+		cmp = endpoint->if_id - peer->if_id;
+
+	return cmp < 0;
+}
+
+static bool has_multiple_ifs(const char *obj_type)
+{
+	return strcmp(obj_type, "dpsw") == 0 || strcmp(obj_type, "dpdmux") == 0;
+}
+
+/**
+ * Print an endpoint name the way the info commands do: dpsw.1.2 for
+ * objects with several interfaces, dpni.1 for the others
+ */
+static void print_endpoint_name(const struct dprc_endpoint *endpoint)
+{
+	if (has_multiple_ifs(endpoint->type))
+		restool_printf("%s.%d.%d", endpoint->type, endpoint->id,
+			       endpoint->if_id);
+	else
+		restool_printf("%s.%d", endpoint->type, endpoint->id);
+}
+
+static const char *link_state_to_string(int state)
+{
+	switch (state) {
+	case 1:
+		return "up";
+	case 0:
+		return "down";
+	case -1:
+		return "none";
+	default:
+		return "error";
+	}
+}
+
+/**
+ * Print a string as a JSON or DOT quoted string
+ */
+static void print_quoted(const char *str)
+{
+	restool_printf("\"");
+	for (; *str != '\0'; str++) {
+		if (*str == '"' || *str == '\\')
+			restool_printf("\\%c", *str);
+		else if ((unsigned char)*str < 0x20)
+			restool_printf("\\u%04x", *str);
+		else
+			restool_printf("%c", *str);
+	}
+
+	restool_printf("\"");
+}
+
+static void print_conn_graph_dot(const struct conn_graph *graph)
+{
+	const struct topology *topo = graph->topo;
+
+	restool_printf("graph restool {\n");
+	for (int i = 0; i < topo->num_objs; i++) {
+		const struct dprc_obj_desc *obj_desc = &topo->objs[i].desc;
+
+		if (graph->num_obj_ifs[i] == 0)
+			continue;
+
+		restool_printf("\t\"%s.%d\"", obj_desc->type, obj_desc->id);
+		if (obj_desc->label[0] != '\0') {
+			restool_printf(" [label=");
+			print_quoted(obj_desc->label);
+			restool_printf("]");
+		}
+
+		restool_printf(";\n");
+	}
+
+	for (int i = 0; i < graph->num_ifs; i++) {
+		const struct dprc_endpoint *endpoint = &graph->endpoints[i];
+		const struct dprc_endpoint *peer = &graph->peers[i];
+
+		if (!is_printed_link_end(graph, i))
+			continue;
+
+		restool_printf("\t\"%s.%d\" -- \"%s.%d\" [",
+			       endpoint->type, endpoint->id, peer->type, peer->id);
+		if (has_multiple_ifs(endpoint->type))
+			restool_printf("taillabel=\"%d\", ", endpoint->if_id);
+		if (has_multiple_ifs(peer->type))
+			restool_printf("headlabel=\"%d\", ", peer->if_id);
+
+		restool_printf("label=\"%s\"%s];\n",
+			       link_state_to_string(graph->states[i]),
+			       graph->states[i] == 1 ? "" : ", style=dashed");
+	}
+
+	restool_printf("}\n");
+}
+
+static void print_conn_graph_json(const struct conn_graph *graph)
+{
+	const struct topology *topo = graph->topo;
+	const char *sep = "";
+
+	restool_printf("{\n\t\"objects\": [");
+	for (int i = 0; i < topo->num_objs; i++) {
+		const struct topology_obj *obj = &topo->objs[i];
+		const struct dprc_obj_desc *parent_desc;
+
+		if (graph->num_obj_ifs[i] == 0)
+			continue;
+
+		parent_desc = &topo->objs[obj->parent].desc;
+		restool_printf("%s\n\t\t{ \"name\": \"%s.%d\", \"container\": \"dprc.%d\", "
+			       "\"label\": ", sep, obj->desc.type, obj->desc.id,
+			       parent_desc->id);
+		print_quoted(obj->desc.label);
+		restool_printf(", \"interfaces\": %d }", graph->num_obj_ifs[i]);
+		sep = ",";
+	}
+
+	restool_printf("\n\t],\n\t\"links\": [");
+	sep = "";
+	for (int i = 0; i < graph->num_ifs; i++) {
+		if (!is_printed_link_end(graph, i))
+			continue;
+
+		restool_printf("%s\n\t\t{ \"endpoint1\": \"", sep);
+		print_endpoint_name(&graph->endpoints[i]);
+		restool_printf("\", \"endpoint2\": \"");
+		print_endpoint_name(&graph->peers[i]);
+		restool_printf("\", \"state\": \"%s\" }",
+			       link_state_to_string(graph->states[i]));
+		sep = ",";
+	}
+
+	restool_printf("\n\t]\n}\n");
+}
+
+static int cmd_topology_graph(void)
+{
+	static const char usage_msg[] =
+		"\n"
+		"Usage: restool topology graph [--format=<dot|json>]\n"
+		"\n"
+		"--format=<dot|json>\n"
+		"   Output format, Graphviz DOT (default) or JSON.\n"
+		"\n"
+		"Displays every connectable object (DPNI, DPMAC, DPCI, DPSW, DPDMUX)\n"
+		"of the container tree and the links between their interfaces.\n"
+		"e.g. restool topology graph | dot -Tsvg > topology.svg\n"
+		"\n";
+
+	struct conn_graph graph;
+	bool json = false;
+	int error;
+
+	if (restool_cmd.option_mask & ONE_BIT_MASK(GRAPH_OPT_HELP)) {
+		restool_printf(usage_msg);
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(GRAPH_OPT_HELP);
+		return 0;
+	}
+
+	if (restool_cmd.obj_name != NULL) {
+		ERROR_PRINTF("Unexpected argument: \'%s\'\n\n",
+			     restool_cmd.obj_name);
+		restool_printf(usage_msg);
+		return -EINVAL;
+	}
+
+	if (restool_cmd.option_mask & ONE_BIT_MASK(GRAPH_OPT_FORMAT)) {
+		const char *format = restool_cmd.option_args[GRAPH_OPT_FORMAT];
+
+		restool_cmd.option_mask &= ~ONE_BIT_MASK(GRAPH_OPT_FORMAT);
+		if (strcmp(format, "json") == 0) {
+			json = true;
+		} else if (strcmp(format, "dot") != 0) {
+			ERROR_PRINTF("Invalid format: \'%s\'\n", format);
+			restool_printf(usage_msg);
+			return -EINVAL;
+		}
+	}
+
+	error = build_conn_graph(&graph);
+	if (error < 0)
+		return error;
+
+	if (json)
+		print_conn_graph_json(&graph);
+	else
+		print_conn_graph_dot(&graph);
+
+	free_conn_graph(&graph);
+	return 0;
+}
+
+struct object_command topology_commands[] = {
+	{ .cmd_name = "help",
+	  .options = NULL,
+	  .cmd_func = cmd_topology_help },
+
+	{ .cmd_name = "graph",
+	  .options = topology_graph_options,
+	  .cmd_func = cmd_topology_graph },
+
+	{ .cmd_name = NULL },
+};
@@ -47,17 +47,17 @@
 #define ERROR_PRINTF(_fmt, ...) \
 do { \
 	if (restool.debug) \
-		fprintf(stderr, "%s:%d " _fmt, \
-			__func__, __LINE__, ##__VA_ARGS__); \
+		restool_eprintf("%s:%d " _fmt, \
+				__func__, __LINE__, ##__VA_ARGS__); \
 	else \
-		fprintf(stderr, _fmt, ##__VA_ARGS__); \
+		restool_eprintf(_fmt, ##__VA_ARGS__); \
 } while (0)
 
 #define DEBUG_PRINTF(_fmt, ...)	\
 do { \
 	if (restool.debug) \
-		fprintf(stderr, "DBG: %s:%d: " _fmt, \
-			__func__, __LINE__, ##__VA_ARGS__); \
+		restool_eprintf("DBG: %s:%d: " _fmt, \
+				__func__, __LINE__, ##__VA_ARGS__); \
 } while (0)
 
 #define STRINGIFY(_x)	__STRINGIFY_EXPANDED(_x)